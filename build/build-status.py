@@ -0,0 +1,8 @@
+#! /usr/bin/env python
+
+# Programs that are runnable.
+ns3_runnable_programs = ['build/src/aodv/examples/ns3.21-aodv-optimized', 'build/src/bridge/examples/ns3.21-csma-bridge-optimized', 'build/src/bridge/examples/ns3.21-csma-bridge-one-hop-optimized', 'build/src/buildings/examples/ns3.21-buildings-pathloss-profiler-optimized', 'build/src/config-store/examples/ns3.21-config-store-save-optimized', 'build/src/core/examples/ns3.21-main-callback-optimized', 'build/src/core/examples/ns3.21-sample-simulator-optimized', 'build/src/core/examples/ns3.21-main-ptr-optimized', 'build/src/core/examples/ns3.21-main-random-variable-optimized', 'build/src/core/examples/ns3.21-main-random-variable-stream-optimized', 'build/src/core/examples/ns3.21-sample-random-variable-optimized', 'build/src/core/examples/ns3.21-sample-random-variable-stream-optimized', 'build/src/core/examples/ns3.21-command-line-example-optimized', 'build/src/core/examples/ns3.21-hash-example-optimized', 'build/src/core/examples/ns3.21-main-test-sync-optimized', 'build/src/csma/examples/ns3.21-csma-one-subnet-optimized', 'build/src/csma/examples/ns3.21-csma-broadcast-optimized', 'build/src/csma/examples/ns3.21-csma-packet-socket-optimized', 'build/src/csma/examples/ns3.21-csma-multicast-optimized', 'build/src/csma/examples/ns3.21-csma-raw-ip-socket-optimized', 'build/src/csma/examples/ns3.21-csma-ping-optimized', 'build/src/csma-layout/examples/ns3.21-csma-star-optimized', 'build/src/dsdv/examples/ns3.21-dsdv-manet-optimized', 'build/src/dsr/examples/ns3.21-dsr-optimized', 'build/src/emu/examples/ns3.21-emu-udp-echo-optimized', 'build/src/emu/examples/ns3.21-emu-ping-optimized', 'build/src/energy/examples/ns3.21-li-ion-energy-source-optimized', 'build/src/fd-net-device/examples/ns3.21-dummy-network-optimized', 'build/src/fd-net-device/examples/ns3.21-fd2fd-onoff-optimized', 'build/src/fd-net-device/examples/ns3.21-realtime-dummy-network-optimized', 'build/src/fd-net-device/examples/ns3.21-realtime-fd2fd-onoff-optimized', 'build/src/fd-net-device/examples/ns3.21-fd-emu-ping-optimized', 'build/src/fd-net-device/examples/ns3.21-fd-emu-udp-echo-optimized', 'build/src/fd-net-device/examples/ns3.21-fd-emu-onoff-optimized', 'build/src/fd-net-device/examples/ns3.21-fd-tap-ping-optimized', 'build/src/fd-net-device/examples/ns3.21-fd-tap-ping6-optimized', 'build/src/internet/examples/ns3.21-main-simple-optimized', 'build/src/internet/examples/ns3.21-codel-vs-droptail-basic-test-optimized', 'build/src/internet/examples/ns3.21-codel-vs-droptail-asymmetric-optimized', 'build/src/lr-wpan/examples/ns3.21-lr-wpan-packet-print-optimized', 'build/src/lr-wpan/examples/ns3.21-lr-wpan-phy-test-optimized', 'build/src/lr-wpan/examples/ns3.21-lr-wpan-data-optimized', 'build/src/lr-wpan/examples/ns3.21-lr-wpan-error-model-plot-optimized', 'build/src/lr-wpan/examples/ns3.21-lr-wpan-error-distance-plot-optimized', 'build/src/lte/examples/ns3.21-lena-cqi-threshold-optimized', 'build/src/lte/examples/ns3.21-lena-dual-stripe-optimized', 'build/src/lte/examples/ns3.21-lena-fading-optimized', 'build/src/lte/examples/ns3.21-lena-intercell-interference-optimized', 'build/src/lte/examples/ns3.21-lena-pathloss-traces-optimized', 'build/src/lte/examples/ns3.21-lena-profiling-optimized', 'build/src/lte/examples/ns3.21-lena-rem-optimized', 'build/src/lte/examples/ns3.21-lena-rem-sector-antenna-optimized', 'build/src/lte/examples/ns3.21-lena-rlc-traces-optimized', 'build/src/lte/examples/ns3.21-lena-simple-optimized', 'build/src/lte/examples/ns3.21-lena-simple-epc-optimized', 'build/src/lte/examples/ns3.21-lena-x2-handover-optimized', 'build/src/lte/examples/ns3.21-lena-x2-handover-measures-optimized', 'build/src/lte/examples/ns3.21-lena-simple-epc-emu-optimized', 'build/src/lte/examples/ns3.21-lena-frequency-reuse-optimized', 'build/src/lte/examples/ns3.21-lena-distributed-ffr-optimized', 'build/src/lte/examples/ns3.21-lena-uplink-power-control-optimized', 'build/src/mesh/examples/ns3.21-mesh-optimized', 'build/src/mobility/examples/ns3.21-main-grid-topology-optimized', 'build/src/mobility/examples/ns3.21-main-random-topology-optimized', 'build/src/mobility/examples/ns3.21-main-random-walk-optimized', 'build/src/mobility/examples/ns3.21-mobility-trace-example-optimized', 'build/src/mobility/examples/ns3.21-ns2-mobility-trace-optimized', 'build/src/mobility/examples/ns3.21-bonnmotion-ns2-example-optimized', 'build/src/mpi/examples/ns3.21-simple-distributed-optimized', 'build/src/mpi/examples/ns3.21-third-distributed-optimized', 'build/src/mpi/examples/ns3.21-nms-p2p-nix-distributed-optimized', 'build/src/mpi/examples/ns3.21-simple-distributed-empty-node-optimized', 'build/src/netanim/examples/ns3.21-dumbbell-animation-optimized', 'build/src/netanim/examples/ns3.21-grid-animation-optimized', 'build/src/netanim/examples/ns3.21-star-animation-optimized', 'build/src/netanim/examples/ns3.21-wireless-animation-optimized', 'build/src/netanim/examples/ns3.21-uan-animation-optimized', 'build/src/netanim/examples/ns3.21-dynamic_linknode-optimized', 'build/src/netanim/examples/ns3.21-resources_demo-optimized', 'build/src/network/examples/ns3.21-main-packet-header-optimized', 'build/src/network/examples/ns3.21-main-packet-tag-optimized', 'build/src/network/examples/ns3.21-red-tests-optimized', 'build/src/network/examples/ns3.21-droptail_vs_red-optimized', 'build/src/network/examples/ns3.21-packet-socket-apps-optimized', 'build/src/nix-vector-routing/examples/ns3.21-nix-simple-optimized', 'build/src/nix-vector-routing/examples/ns3.21-nms-p2p-nix-optimized', 'build/src/olsr/examples/ns3.21-simple-point-to-point-olsr-optimized', 'build/src/olsr/examples/ns3.21-olsr-hna-optimized', 'build/src/point-to-point/examples/ns3.21-main-attribute-value-optimized', 'build/src/propagation/examples/ns3.21-main-propagation-loss-optimized', 'build/src/propagation/examples/ns3.21-jakes-propagation-model-example-optimized', 'build/src/sixlowpan/examples/ns3.21-example-sixlowpan-optimized', 'build/src/sixlowpan/examples/ns3.21-example-ping-lr-wpan-optimized', 'build/src/spectrum/examples/ns3.21-adhoc-aloha-ideal-phy-optimized', 'build/src/spectrum/examples/ns3.21-adhoc-aloha-ideal-phy-matrix-propagation-loss-model-optimized', 'build/src/spectrum/examples/ns3.21-adhoc-aloha-ideal-phy-with-microwave-oven-optimized', 'build/src/stats/examples/ns3.21-gnuplot-example-optimized', 'build/src/stats/examples/ns3.21-double-probe-example-optimized', 'build/src/stats/examples/ns3.21-gnuplot-aggregator-example-optimized', 'build/src/stats/examples/ns3.21-gnuplot-helper-example-optimized', 'build/src/stats/examples/ns3.21-file-aggregator-example-optimized', 'build/src/stats/examples/ns3.21-file-helper-example-optimized', 'build/src/tap-bridge/examples/ns3.21-tap-csma-optimized', 'build/src/tap-bridge/examples/ns3.21-tap-csma-virtual-machine-optimized', 'build/src/tap-bridge/examples/ns3.21-tap-wifi-virtual-machine-optimized', 'build/src/tap-bridge/examples/ns3.21-tap-wifi-dumbbell-optimized', 'build/src/topology-read/examples/ns3.21-topology-read-optimized', 'build/src/uan/examples/ns3.21-uan-cw-example-optimized', 'build/src/uan/examples/ns3.21-uan-rc-example-optimized', 'build/src/virtual-net-device/examples/ns3.21-virtual-net-device-optimized', 'build/src/wave/examples/ns3.21-wave-simple-80211p-optimized', 'build/src/wifi/examples/ns3.21-wifi-phy-test-optimized', 'build/src/wimax/examples/ns3.21-wimax-ipv4-optimized', 'build/src/wimax/examples/ns3.21-wimax-multicast-optimized', 'build/src/wimax/examples/ns3.21-wimax-simple-optimized', 'build/examples/tcp/ns3.21-tcp-large-transfer-optimized', 'build/examples/tcp/ns3.21-tcp-nsc-lfn-optimized', 'build/examples/tcp/ns3.21-tcp-nsc-zoo-optimized', 'build/examples/tcp/ns3.21-tcp-star-server-optimized', 'build/examples/tcp/ns3.21-star-optimized', 'build/examples/tcp/ns3.21-tcp-bulk-send-optimized', 'build/examples/tcp/ns3.21-tcp-nsc-comparison-optimized', 'build/examples/tcp/ns3.21-tcp-variants-comparison-optimized', 'build/examples/energy/ns3.21-energy-model-example-optimized', 'build/examples/energy/ns3.21-energy-model-with-harvesting-example-optimized', 'build/examples/routing/ns3.21-dynamic-global-routing-optimized', 'build/examples/routing/ns3.21-static-routing-slash32-optimized', 'build/examples/routing/ns3.21-global-routing-slash32-optimized', 'build/examples/routing/ns3.21-global-injection-slash32-optimized', 'build/examples/routing/ns3.21-simple-global-routing-optimized', 'build/examples/routing/ns3.21-simple-alternate-routing-optimized', 'build/examples/routing/ns3.21-mixed-global-routing-optimized', 'build/examples/routing/ns3.21-simple-routing-ping6-optimized', 'build/examples/routing/ns3.21-manet-routing-compare-optimized', 'build/examples/routing/ns3.21-ripng-simple-network-optimized', 'build/examples/stats/ns3.21-wifi-example-sim-optimized', 'build/examples/udp-client-server/ns3.21-udp-client-server-optimized', 'build/examples/udp-client-server/ns3.21-udp-trace-client-server-optimized', 'build/examples/error-model/ns3.21-simple-error-model-optimized', 'build/examples/wireless/ns3.21-mixed-wireless-optimized', 'build/examples/wireless/ns3.21-wifi-adhoc-optimized', 'build/examples/wireless/ns3.21-wifi-clear-channel-cmu-optimized', 'build/examples/wireless/ns3.21-wifi-ap-optimized', 'build/examples/wireless/ns3.21-wifi-wired-bridging-optimized', 'build/examples/wireless/ns3.21-simple-wifi-frame-aggregation-optimized', 'build/examples/wireless/ns3.21-multirate-optimized', 'build/examples/wireless/ns3.21-wifi-simple-adhoc-optimized', 'build/examples/wireless/ns3.21-wifi-simple-adhoc-grid-optimized', 'build/examples/wireless/ns3.21-wifi-simple-infra-optimized', 'build/examples/wireless/ns3.21-wifi-simple-interference-optimized', 'build/examples/wireless/ns3.21-wifi-blockack-optimized', 'build/examples/wireless/ns3.21-ofdm-validation-optimized', 'build/examples/wireless/ns3.21-wifi-hidden-terminal-optimized', 'build/examples/wireless/ns3.21-ht-wifi-network-optimized', 'build/examples/tutorial/ns3.21-hello-simulator-optimized', 'build/examples/tutorial/ns3.21-first-optimized', 'build/examples/tutorial/ns3.21-second-optimized', 'build/examples/tutorial/ns3.21-third-optimized', 'build/examples/tutorial/ns3.21-fourth-optimized', 'build/examples/tutorial/ns3.21-fifth-optimized', 'build/examples/tutorial/ns3.21-sixth-optimized', 'build/examples/tutorial/ns3.21-seventh-optimized', 'build/examples/udp/ns3.21-udp-echo-optimized', 'build/examples/socket/ns3.21-socket-bound-static-routing-optimized', 'build/examples/socket/ns3.21-socket-bound-tcp-static-routing-optimized', 'build/examples/socket/ns3.21-socket-options-ipv4-optimized', 'build/examples/socket/ns3.21-socket-options-ipv6-optimized', 'build/examples/realtime/ns3.21-realtime-udp-echo-optimized', 'build/examples/xfabric/ns3.21-ls_arrivals-optimized', 'build/examples/xfabric/ns3.21-ls_dynamic-optimized', 'build/examples/xfabric/ns3.21-ls_more_arrivals-optimized', 'build/examples/xfabric/ns3.21-ls_dctcp_arrivals-optimized', 'build/examples/xfabric/ns3.21-ls_less_arrivals-optimized', 'build/examples/xfabric/ns3.21-startstopflow-optimized', 'build/examples/naming/ns3.21-object-names-optimized', 'build/examples/ipv6/ns3.21-icmpv6-redirect-optimized', 'build/examples/ipv6/ns3.21-ping6-optimized', 'build/examples/ipv6/ns3.21-radvd-optimized', 'build/examples/ipv6/ns3.21-radvd-two-prefix-optimized', 'build/examples/ipv6/ns3.21-test-ipv6-optimized', 'build/examples/ipv6/ns3.21-fragmentation-ipv6-optimized', 'build/examples/ipv6/ns3.21-fragmentation-ipv6-two-MTU-optimized', 'build/examples/ipv6/ns3.21-loose-routing-ipv6-optimized', 'build/examples/ipv6/ns3.21-wsn-ping6-optimized', 'build/examples/matrix-topology/ns3.21-matrix-topology-optimized', 'build/scratch/ns3.21-udp-client-server-optimized', 'build/scratch/subdir/ns3.21-subdir-optimized', 'build/scratch/ns3.21-scratch-simulator-optimized']
+
+# Scripts that are runnable.
+ns3_runnable_scripts = ['csma-bridge.py', 'sample-simulator.py', 'wifi-olsr-flowmon.py', 'tap-csma-virtual-machine.py', 'tap-wifi-virtual-machine.py', 'simple-routing-ping6.py', 'mixed-wireless.py', 'wifi-ap.py', 'first.py', 'realtime-udp-echo.py']
+
@@ -0,0 +1,170 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+
+// Define an object to create leaf-spine and fat-tree (Clos) topologies.
+
+#ifndef CLOS_TOPOLOGY_HELPER_H
+#define CLOS_TOPOLOGY_HELPER_H
+
+#include <vector>
+
+#include "point-to-point-helper.h"
+#include "internet-stack-helper.h"
+#include "ipv4-interface-container.h"
+#include "ipv4-fabric-address-helper.h"
+
+namespace ns3 {
+
+class Ipv4GlobalRouting;
+
+/**
+ * \ingroup point-to-point-layout
+ *
+ * \brief A helper to build leaf-spine and fat-tree fabrics in bulk
+ *
+ * The fabric has up to three tiers of switches.  Hosts hang off leaves,
+ * every leaf of a pod connects to every spine of that pod, and core c
+ * connects to spine c / nCoresPerSpine of every pod.  A two tier
+ * leaf-spine is a single pod without cores; a k-ary fat-tree has k pods
+ * of k/2 leaves and k/2 spines, k/2 hosts per leaf and (k/2)^2 cores.
+ *
+ * Nodes are created hosts first, then leaves, spines and cores, so node
+ * ids follow that order.  Links are created spine to leaf, core to spine
+ * and then leaf to host, with the upper node first in every container.
+ * Each tier of links comes from its own PointToPointHelper, which carries
+ * that tier's data rate, delay and queue.
+ *
+ * Addresses come from an Ipv4FabricAddressHelper.  PopulateRoutes then
+ * fills the global routing tables straight from the structure, with one
+ * route per leaf prefix, per pod prefix and per equal cost next hop, in
+ * spine (or core) order.  Do not also run
+ * Ipv4GlobalRoutingHelper::PopulateRoutingTables on these nodes.  Only
+ * the host links are routed; the switch to switch link addresses are not
+ * reachable from other nodes.
+ */
+class ClosTopologyHelper
+{
+public:
+  /**
+   * Create a two tier leaf-spine fabric.
+   *
+   * \param nSpines number of spines
+   * \param nLeaves number of leaves
+   * \param nHostsPerLeaf number of hosts below every leaf
+   * \param fabricHelper the helper for the spine to leaf links
+   * \param edgeHelper the helper for the leaf to host links
+   */
+  ClosTopologyHelper (uint32_t nSpines, uint32_t nLeaves, uint32_t nHostsPerLeaf,
+                      PointToPointHelper fabricHelper, PointToPointHelper edgeHelper);
+
+  /**
+   * Create a three tier fabric of pods joined by cores.
+   *
+   * \param nPods number of pods
+   * \param nSpinesPerPod number of spines (aggregation switches) in a pod
+   * \param nLeavesPerPod number of leaves (edge switches) in a pod
+   * \param nHostsPerLeaf number of hosts below every leaf
+   * \param nCoresPerSpine number of core uplinks of every spine
+   * \param coreHelper the helper for the core to spine links
+   * \param fabricHelper the helper for the spine to leaf links
+   * \param edgeHelper the helper for the leaf to host links
+   */
+  ClosTopologyHelper (uint32_t nPods, uint32_t nSpinesPerPod, uint32_t nLeavesPerPod,
+                      uint32_t nHostsPerLeaf, uint32_t nCoresPerSpine,
+                      PointToPointHelper coreHelper, PointToPointHelper fabricHelper,
+                      PointToPointHelper edgeHelper);
+
+  ~ClosTopologyHelper ();
+
+  /**
+   * \param k an even port count
+   * \param coreHelper the helper for the core to spine links
+   * \param fabricHelper the helper for the spine to leaf links
+   * \param edgeHelper the helper for the leaf to host links
+   * \returns a k-ary fat-tree
+   */
+  static ClosTopologyHelper FatTree (uint32_t k, PointToPointHelper coreHelper,
+                                     PointToPointHelper fabricHelper,
+                                     PointToPointHelper edgeHelper);
+
+public:
+  NodeContainer GetHosts (void) const;
+  NodeContainer GetLeaves (void) const;
+  NodeContainer GetSpines (void) const;
+  NodeContainer GetCores (void) const;
+
+  /**
+   * \param i index of the host, numbered pod, then leaf, then host
+   * \returns the host
+   */
+  Ptr<Node> GetHost (uint32_t i) const;
+
+  /**
+   * \param i index of the host
+   * \returns the address of the host on its edge link
+   */
+  Ipv4Address GetHostIpv4Address (uint32_t i) const;
+
+  /**
+   * \returns the leaf to host links, leaf device first
+   */
+  const std::vector<NetDeviceContainer> &GetEdgeLinks (void) const;
+
+  /**
+   * \returns the spine to leaf links, spine device first
+   */
+  const std::vector<NetDeviceContainer> &GetFabricLinks (void) const;
+
+  /**
+   * \returns the core to spine links, core device first
+   */
+  const std::vector<NetDeviceContainer> &GetCoreLinks (void) const;
+
+  /**
+   * \param stack an InternetStackHelper which is used to install
+   *              on every node of the fabric
+   */
+  void InstallStack (InternetStackHelper stack);
+
+  /**
+   * Address the fabric links, then the core links, then the host links.
+   *
+   * \param address the plan to carve the link prefixes from; its topology
+   *                is set from the fabric
+   */
+  void AssignIpv4Addresses (Ipv4FabricAddressHelper address);
+
+  /**
+   * Add the ECMP routes of every node to its Ipv4GlobalRouting.
+   */
+  void PopulateRoutes (void);
+
+private:
+  void Build (PointToPointHelper &coreHelper, PointToPointHelper &fabricHelper,
+              PointToPointHelper &edgeHelper);
+  Ptr<Ipv4GlobalRouting> GetRouting (Ptr<Node> node) const;
+  /* route the prefix from end 'from' of a link (0 or 1) to the other end */
+  void AddRoute (const Ipv4InterfaceContainer &link, uint32_t from,
+                 Ipv4Address network, Ipv4Mask mask);
+
+  uint32_t m_nPods;
+  uint32_t m_nSpinesPerPod;
+  uint32_t m_nLeavesPerPod;
+  uint32_t m_nHostsPerLeaf;
+  uint32_t m_nCoresPerSpine;
+
+  NodeContainer m_hosts;
+  NodeContainer m_leaves;
+  NodeContainer m_spines;
+  NodeContainer m_cores;
+  std::vector<NetDeviceContainer> m_edgeLinks;
+  std::vector<NetDeviceContainer> m_fabricLinks;
+  std::vector<NetDeviceContainer> m_coreLinks;
+  std::vector<Ipv4InterfaceContainer> m_edgeInterfaces;
+  std::vector<Ipv4InterfaceContainer> m_fabricInterfaces;
+  std::vector<Ipv4InterfaceContainer> m_coreInterfaces;
+  Ipv4FabricAddressHelper m_address;
+};
+
+} // namespace ns3
+
+#endif /* CLOS_TOPOLOGY_HELPER_H */
@@ -0,0 +1,82 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+
+#ifndef CONVERGENCE_TRACKER_H
+#define CONVERGENCE_TRACKER_H
+
+#include <map>
+#include <vector>
+#include "ns3/object.h"
+#include "ns3/callback.h"
+
+namespace ns3 {
+
+/**
+ * \ingroup internet
+ *
+ * \brief Detects when the measured rates of the active flows have converged
+ * to their ideal rates.
+ *
+ * A flow is within tolerance when |ideal - measured| / ideal is below the
+ * Tolerance attribute.  The tracker keeps that state per flow together with
+ * a running count of flows within tolerance, updated as measured or ideal
+ * rates change (UpdateRate is meant to be hooked to the MeasurementRate trace
+ * of Ipv4L3Protocol).  Tick () is called once per sampling interval and only
+ * checks the count; once at least Fraction of the flows have been within
+ * tolerance for more than Window consecutive ticks the converged callback is
+ * invoked and the window starts over.  An empty flow set never counts as
+ * converged.
+ */
+class ConvergenceTracker : public Object
+{
+public:
+  static TypeId GetTypeId (void);
+
+  ConvergenceTracker ();
+  virtual ~ConvergenceTracker ();
+
+  void AddFlow (uint32_t fid, double ideal);
+  void RemoveFlow (uint32_t fid);
+  void SetIdealRate (uint32_t fid, double ideal);
+  /** New measured rate of fid, ignored for flows that are not tracked. */
+  void UpdateRate (uint32_t fid, double measured);
+
+  /**
+   * Account for one sampling interval.
+   * \returns true if the flows have been converged for the whole window
+   */
+  bool Tick (void);
+  /** Restart the window, e.g. after the flow set changed. */
+  void Reset (void);
+  void SetConvergedCallback (Callback<void> cb);
+
+  uint32_t GetNFlows (void) const;
+  uint32_t GetNWithinTolerance (void) const;
+  /** Number of consecutive ticks the percentile condition has held. */
+  uint32_t GetConsecutive (void) const;
+  double GetMeasuredRate (uint32_t fid) const;
+  double GetIdealRate (uint32_t fid) const;
+  std::vector<uint32_t> GetFlowIds (void) const;
+
+private:
+  struct FlowState
+  {
+    double measured;
+    double ideal;
+    bool within;
+  };
+
+  bool IsWithin (double measured, double ideal) const;
+  void Refresh (FlowState &flow);
+
+  std::map<uint32_t, FlowState> m_flows;
+  uint32_t m_within;
+  uint32_t m_consecutive;
+  double m_tolerance;
+  double m_fraction;
+  uint32_t m_window;
+  Callback<void> m_converged;
+};
+
+} // namespace ns3
+
+#endif /* CONVERGENCE_TRACKER_H */
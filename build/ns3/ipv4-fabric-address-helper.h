@@ -0,0 +1,132 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+
+#ifndef IPV4_FABRIC_ADDRESS_HELPER_H
+#define IPV4_FABRIC_ADDRESS_HELPER_H
+
+#include "ns3/ipv4-address.h"
+#include "ns3/net-device-container.h"
+#include "ns3/node.h"
+#include "ns3/node-container.h"
+#include "ipv4-interface-container.h"
+
+namespace ns3 {
+
+/**
+ * \brief Hierarchical IPv4 address plan for pod / leaf / host fabrics.
+ *
+ * Every point-to-point link gets a /30.  The base prefix (10.0.0.0/8 by
+ * default) is split in two halves.  The lower half holds the host links,
+ * numbered pod | leaf | host so that all the hosts below a leaf share one
+ * leaf prefix and all the leaves of a pod share one pod prefix.  The upper
+ * half holds the switch to switch links, numbered in the order they are
+ * assigned.  With the default base a fabric can have 2^21 host links and
+ * 2^21 fabric links.
+ *
+ * Because the plan follows the topology, the routes global routing computes
+ * for the /30s below one leaf or pod can be folded into a single route; see
+ * AggregateRoutes.
+ */
+class Ipv4FabricAddressHelper
+{
+public:
+  Ipv4FabricAddressHelper ();
+
+  /**
+   * \param network the base network
+   * \param mask the base mask
+   */
+  Ipv4FabricAddressHelper (Ipv4Address network, Ipv4Mask mask);
+
+  /**
+   * \brief Set the prefix the plan is carved out of.
+   * \param network the base network
+   * \param mask the base mask
+   */
+  void SetBase (Ipv4Address network, Ipv4Mask mask);
+
+  /**
+   * \brief Size the pod, leaf and host fields of the host links.
+   *
+   * Each field gets just enough bits for its count.  Aborts if the fields
+   * do not fit in the lower half of the base prefix.
+   *
+   * \param nPods number of pods, 1 for a two tier leaf-spine
+   * \param nLeavesPerPod number of leaves in every pod
+   * \param nHostsPerLeaf number of host links below every leaf
+   */
+  void SetTopology (uint32_t nPods, uint32_t nLeavesPerPod, uint32_t nHostsPerLeaf);
+
+  /**
+   * \brief Address the link between a leaf and one of its hosts.
+   * \param c the two devices of the link
+   * \param pod the pod of the leaf
+   * \param leaf the leaf within its pod
+   * \param host the host within its leaf
+   * \returns the interfaces the addresses were assigned to
+   */
+  Ipv4InterfaceContainer AssignHostLink (const NetDeviceContainer &c, uint32_t pod,
+                                         uint32_t leaf, uint32_t host);
+
+  /**
+   * \brief Address the next link between two switches.
+   * \param c the two devices of the link
+   * \returns the interfaces the addresses were assigned to
+   */
+  Ipv4InterfaceContainer AssignFabricLink (const NetDeviceContainer &c);
+
+  /**
+   * \returns the prefix of every host link below the leaf
+   * \param pod the pod of the leaf
+   * \param leaf the leaf within its pod
+   */
+  Ipv4Address GetLeafNetwork (uint32_t pod, uint32_t leaf) const;
+  Ipv4Mask GetLeafMask (void) const;
+
+  /**
+   * \returns the prefix of every host link in the pod
+   * \param pod the pod
+   */
+  Ipv4Address GetPodNetwork (uint32_t pod) const;
+  Ipv4Mask GetPodMask (void) const;
+
+  /**
+   * \returns the lower half of the base prefix, which holds every host link
+   */
+  Ipv4Address GetHostLinksNetwork (void) const;
+  Ipv4Mask GetHostLinksMask (void) const;
+
+  /**
+   * \brief Fold the global routes of a node into leaf and pod prefixes.
+   *
+   * Call after Ipv4GlobalRoutingHelper::PopulateRoutingTables.  Lookups
+   * are unchanged; see Ipv4GlobalRouting::AggregateNetworkRoutes.
+   *
+   * \param node a node with global routing
+   * \returns the number of routes removed from its table
+   */
+  uint32_t AggregateRoutes (Ptr<Node> node) const;
+
+  /**
+   * \brief Fold the global routes of every node in the container.
+   * \param c the nodes
+   * \returns the number of routes removed
+   */
+  uint32_t AggregateRoutes (const NodeContainer &c) const;
+
+private:
+  static uint32_t FieldBits (uint32_t n);
+  Ipv4InterfaceContainer AssignLink (const NetDeviceContainer &c, uint32_t network);
+
+  uint32_t m_network;   //!< base network
+  uint32_t m_hostBits;  //!< bits below the base mask
+  uint32_t m_leafShift; //!< shift of the leaf field of a host link
+  uint32_t m_podShift;  //!< shift of the pod field of a host link
+  uint32_t m_nPods;
+  uint32_t m_nLeavesPerPod;
+  uint32_t m_nHostsPerLeaf;
+  uint32_t m_nFabricLinks; //!< fabric links assigned so far
+};
+
+} // namespace ns3
+
+#endif /* IPV4_FABRIC_ADDRESS_HELPER_H */
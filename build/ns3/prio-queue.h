@@ -0,0 +1,349 @@
+
+/* Priority Queue functions are not implemented in NS-3. Implementing them */
+
+#ifndef PRIO_QUEUE_H
+#define PRIO_QUEUE_H
+
+#include <queue>
+#include <set>
+#include <vector>
+#include "ns3/packet.h"
+#include "ns3/object.h"
+#include "ns3/queue.h"
+#include "ns3/header.h"
+#include "ns3/ipv4-address.h"
+#include "ns3/ipv4-header.h"
+#include "ns3/prio-header.h"
+#include "ns3/data-rate.h"
+#include "ns3/boolean.h"
+#include "tcp-header.h"
+#include "ns3/tag.h"
+#include "ns3/event-id.h"
+#include "ns3/nstime.h"
+#include "ns3/traced-callback.h"
+#include "queue-histograms.h"
+#include "rate-estimator.h"
+
+
+//#include <tr1/unordered_map>
+//#include <tr1/functional>
+
+using std::queue;
+//using std::tr1::unordered_map;
+
+
+namespace ns3 {
+struct tag_elem {
+    uint64_t pktid;
+    double deadline;
+};
+
+class Ipv4Address;
+class Ipv4Header;
+
+typedef struct Flowkey {
+  Ipv4Address src;
+  Ipv4Address dst;
+  int fid;
+} FlowKey;
+
+class TraceContainer;
+
+/* one more class for the packet id */
+
+class MyTag : public Tag
+ {
+ public:
+   static TypeId GetTypeId (void);
+   virtual TypeId GetInstanceTypeId (void) const;
+   virtual uint32_t GetSerializedSize (void) const;
+   virtual void Serialize (TagBuffer i) const;
+   virtual void Deserialize (TagBuffer i);
+   virtual void Print (std::ostream &os) const;
+ 
+   // these are our accessors to our tag structure
+   void SetValue (double tag_value, double arr_time);
+   double GetValue (void) const;
+   double GetArrival (void) const;
+   
+ private:
+   double m_Value;
+   double m_ArrTime;
+ };
+ 
+
+
+/*
+ * ns3::PrioQueue picks its price controller, scheduling order and ECN
+ * marking from attributes, per packet.  The same disciplines are also
+ * registered with the choice made at compile time, one TypeId per
+ * combination: ns3::PrioQueue<Price,Order,Mark> with Price one of
+ * NumFabric, Dgd or Rcp, Order one of Fifo, TagWfq or PFabric and Mark
+ * one of No or Ecn, e.g. ns3::PrioQueue<NumFabric,TagWfq,No>.  They take
+ * the attributes of ns3::PrioQueue but ignore xfabric_price,
+ * alpha_fair_rcp, m_pkt_tag and m_pfabricdequeue.
+ */
+class PrioQueue : public Queue {
+public:
+
+  /* policies the disciplines are composed of, see prio-queue.cc */
+  struct NumFabricPrice;
+  struct DgdPrice;
+  struct RcpPrice;
+  struct FifoOrder;
+  struct TagWfqOrder;
+  struct PFabricOrder;
+  struct NoMark;
+  struct EcnMark;
+
+  static TypeId GetTypeId (void);
+  PrioQueue ();
+  virtual ~PrioQueue ();
+
+  /* Stopped flows.  Every flow key seen by a PrioQueue gets a dense id in
+     a table shared by all queues, holding whether the flow was stopped and
+     which queues have carried it; each queue chains the packets it holds
+     per flow.  PurgeFlow stops a flow: it visits only the queues that
+     carried it and there only the flow's own packets, and from then on
+     every PrioQueue drops the flow's packets on arrival.
+     dropFlowPackets does the same for this queue only, after marking the
+     flow stopped everywhere. */
+  static void PurgeFlow (const std::string &flowkey);
+  void dropFlowPackets(std::string);
+    
+  double averaged_ratio;
+  double g; 
+
+  bool IsEmpty (void) const;
+  void SetMode (PrioQueue::QueueMode mode);
+  uint32_t nodeid;
+  uint32_t linkid;
+  std::string linkid_string;
+  virtual void SetNodeID (uint32_t nodeid);
+  virtual void setdesync(bool);
+  void SetLinkID (uint32_t linkid);
+  void SetLinkIDString (std::string linkid_string);
+  std::string GetLinkIDString(void);
+  std::string GetFlowKey(Ptr<Packet> p);
+  PrioHeader GetPrioHeader(Ptr<Packet> p);
+  Ipv4Header GetIPHeader(Ptr<Packet> p);
+  std::vector<std::string> sort_by_priority(std::map<std::string, double> prios);
+  double eps;
+  Time m_updateMinPrioTime;
+  Time m_updatePriceTime;
+  Time m_guardTime;
+  Time m_departureRateTau;
+  RateDecay m_departureDecay;
+  void UpdateDepartureRate (uint32_t pktsize);
+  double xfabric_beta;
+  double latest_avg_prio, running_avg_prio;
+  double fct_alpha;
+  int total_samples;
+  double latest_min_prio, running_min_prio;
+  void updateMinPrio(void);
+  double incoming_rate;
+  double outgoing_rate;
+  double incoming_bytes;
+  double outgoing_bytes;
+
+  /* departure rate in Mbps, an EWMA over DepartureRateTau updated at every
+     dequeue; it stays 0 while DepartureRateTau is 0 */
+  EwmaRate departure_rate;
+  double previous_departure;
+  void SetDepartureRateTau (Time tau);
+  Time GetDepartureRateTau (void) const;
+   
+  uint32_t getFlowID(Ptr<Packet> p);
+  int getflowid_temp(std::string);
+  void setFlowID(std::string flowkey, uint32_t fid, double fweight, uint32_t a=1);
+  std::map<std::string, uint32_t>flow_ids;
+  std::map<uint32_t, double>flow_weights;
+  bool init_reset;
+  double m_dgd_a, m_numfabric_eta, m_dgd_b; 
+  double m_rcp_beta, m_rcp_alpha;
+  double m_target_queue;
+
+  bool update_minimum;
+  void enableUpdates(void);
+  bool host_compensate;
+  bool alpha_fair_rcp;
+
+  void updateAvgRtt(double);
+  double getAvgRtt(void);
+  double meanQueueSize(double);
+  double last_link_rate;
+  double switch_fsr;
+  //double rcp_a;
+  //double rcp_b;
+  double avg_rtt;
+
+  EventId m_updateEvent;
+
+
+  /**
+   * Get the encapsulation mode of this device.
+   *
+   * \returns The encapsulation mode of this device.
+   */
+  bool m_desynchronize;
+  PrioQueue::QueueMode GetMode (void);
+  uint32_t GetMaxPackets(void);
+  uint32_t GetMaxBytes(void);
+  uint32_t GetCurCount(void);
+  uint32_t GetCurSize(void);
+  double getCurrentPrice(void);
+  double getCurrentDepartureRate(void);
+  double getCurrentUtilTerm(void);
+  double short_ewma_const;
+  double current_util;
+
+  uint32_t m_ECNThreshBytes;  
+  uint32_t m_ECNThreshPackets;
+
+  double ecn_delaythreshold;
+  bool delay_mark;
+  bool xfabric_price;
+  double current_price;
+
+
+  virtual void updateLinkPrice(void);
+  /* fluid traffic, see ns3::FluidSimulator: the bytes that arrived and
+     left since the last call, the fluid backlog in bytes and the smallest
+     residue of the fluid flows, counted as if packets had carried them */
+  void AccountFluid (double arrived, double departed, double backlog, double residue);
+  double m_fluidBacklog;
+  /* packet flows sharing the link with fluid traffic: once tracking is on,
+     the rate each data packet's wfq_weight stands for (the link rate when
+     it has none) is kept per flow, and GetPacketDemand sums it over the
+     flows seen within window, in Mbps */
+  void TrackPacketDemand (bool track);
+  double GetPacketDemand (Time window);
+  bool m_trackPacketDemand;
+  std::map<std::string, std::pair<double, Time> > m_packetDemand;
+  /* with the Histograms attribute, the sojourn time of every dequeued
+     packet and the bytes of packets already queued at every arrival are
+     kept in log-linear histograms; the Histograms trace gets them, and they
+     restart, every HistogramEpoch and on DumpHistograms */
+  void DumpHistograms (void);
+  const QueueHistograms &GetHistograms (void) const;
+  double getRateDifference(Time t);
+  double getRateDifferenceNormalized(Time t);
+
+  /* data structure to maintain prev_deadline for every flow */
+  std::map<std::string , double> flow_prevdeadlines;
+  std::map<uint64_t, double> pkt_tag;
+  std::map<uint64_t, double> pkt_arrival;
+  double get_stored_deadline(std::string fkey);
+  void set_stored_deadline(std::string fkey, double new_deadline);
+  double get_virtualtime(void);
+  double get_controlvirtualtime(void);
+  double current_slope;
+  double CalcSlope(void);
+  void SetVPkts(uint32_t vpkts);
+  double last_virtualtime_time;
+  double last_virtualtime;
+  uint32_t vpackets;
+  uint32_t virtualtime_updated;
+  double getCurrentSlope();
+  double updated_virtual_time;
+  bool remove_tag(uint64_t pktid);
+  Ptr<Packet> get_packet_with_id(uint64_t pktid);
+  struct tag_elem get_lowest_tagid();
+  struct tag_elem get_highest_tagid();
+  double get_lowest_deadline();
+  TcpHeader GetTCPHeader(Ptr<Packet> p);
+  Ptr<Packet> get_lowest_tag_packet();
+
+protected:
+  template <class Price, class Order, class Mark>
+  bool EnqueueWith (Ptr<Packet> p);
+  template <class Order>
+  Ptr<Packet> DequeueWith (void);
+  template <class Price>
+  void UpdatePriceWith (void);
+
+private:
+  /* the policies of ns3::PrioQueue, which follow the attributes */
+  struct RuntimePrice;
+  struct RuntimeOrder;
+  struct RuntimeMark;
+
+  virtual bool DoEnqueue (Ptr<Packet> p);
+  virtual Ptr<Packet> DoDequeue (void);
+  virtual Ptr<const Packet> DoPeek (void) const;
+
+  bool enqueue(Ptr<Packet> p, uint32_t flow);
+  bool remove(Ptr<Packet> p);
+  void PurgeChain (uint32_t flow);
+
+  /* copies of a packet share its uid, so queued packets are found by
+     pointer, the same packet queued twice in arrival order */
+  typedef std::list<Ptr<Packet> >::iterator PacketQueueI;
+  typedef std::list<PacketQueueI> FlowChain;
+  struct QueuedPacket
+  {
+    uint32_t flow;
+    PacketQueueI position;
+    FlowChain::iterator link;
+  };
+  typedef std::multimap<const Packet *, QueuedPacket> QueuedPackets;
+  QueuedPackets::iterator FindQueued (PacketQueueI position);
+  QueuedPackets m_queued;                        //!< every queued packet
+  std::map<uint32_t, FlowChain> m_flowChains;    //!< packets queued per flow
+  std::set<uint32_t> m_carriedFlows;             //!< flows registered as carried here
+
+  static uint32_t GetFlowSlot (const std::string &flowkey);
+  static std::map<std::string, uint32_t> s_flowSlots;
+  static std::vector<uint8_t> s_flowStopped;
+  static std::vector<std::vector<PrioQueue *> > s_flowQueues;
+  static uint32_t s_liveQueues;
+
+  void UpdateRcpPrice (void);
+  void UpdateDgdPrice (void);
+  void UpdateNumFabricPrice (void);
+  void TagPacket (Ptr<Packet> p, const std::string &flowkey, bool control_packet, double wfq_weight);
+  Ptr<Packet> GetLowestWeightPacket (void);
+  Ptr<Packet> GetHighestWeightPacket (Ptr<Packet> p, double wfq_weight);
+  void HistogramEpoch (void);
+
+  std::list<Ptr<Packet> > m_packets; //!< the packets in the queue
+  uint32_t m_maxPackets;              //!< max packets in the queue
+  uint32_t m_maxBytes;                //!< max bytes in the queue
+  uint32_t m_bytesInQueue;            //!< actual bytes in the queue
+  uint32_t m_size;
+  uint32_t m_pFabric;
+  bool m_fluid_model;
+  bool m_subtract_min;
+  bool m_recv_marks;
+  bool m_pkt_tagged;
+  bool m_onlydctcp;
+  bool m_pfabricdequeue;
+  bool m_price_multiply;
+  bool m_strawmancc;
+  bool m_dctcp_mark;
+  DataRate m_bps;
+  QueueMode m_mode;                   //!< queue mode (packets or bytes limited)
+  uint64_t  current_virtualtime;
+  uint64_t  control_virtualtime;
+
+  bool m_histogramsEnabled;
+  Time m_histogramEpoch;
+  EventId m_histogramEvent;
+  QueueHistograms m_histograms;
+  TracedCallback<std::string, const QueueHistograms &> m_histogramTrace;
+
+//  unsigned int sq_limit_;
+//  unordered_map<size_t, int> sq_counts_;
+//  std::queue<size_t> sq_queue_;
+  
+  std::map<std::string, double>prios;
+  std::map<std::string, double>rates;
+
+
+
+};
+
+} // namespace ns3
+
+#endif /* PRIO_QUEUE_H */
+
@@ -0,0 +1,97 @@
+#ifndef __FLOW_TRACKER__
+#define __FLOW_TRACKER__
+
+#include <map>
+#include "ns3/object.h"
+#include "ns3/traced-callback.h"
+#include "ns3/sgi-hashmap.h"
+
+using namespace ns3;
+
+class FlowData {
+ public:
+  uint32_t flow_id;
+  double flow_size;
+  uint32_t source_node;
+  uint32_t dest_node;
+  double flow_weight;
+  uint32_t flow_tcp;
+  uint32_t flow_known;
+  double flow_start;
+  double flow_rem_size;
+  double flow_deadline;
+  double flow_deadline_delta;
+
+  bool flow_running;
+  bool flow_deadline_bound;
+
+  FlowData(uint32_t fid);
+  FlowData(uint32_t source, int32_t dest, double flw_start, double
+  flw_size, uint32_t flw_id, double fweight, uint32_t tcp, uint32_t
+  flw_known, double flw_rem_size, double flw_deadline, double
+  flw_deadline_delta, bool deadline_bound = false);
+
+};
+
+/*
+ * Table of the flows known to the scheduler.  Flows are stored once, in a
+ * hash table keyed by flow_id, and threaded on two ordered indexes:
+ * deadline bound flows by flow_deadline (EDF order) and all other flows by
+ * flow_rem_size (SRPT order).  Start, stop and remaining size updates cost
+ * O(log n) and the head of either order is available in O(1).
+ *
+ * The FlowData pointers handed out stay valid until the flow is stopped.
+ * Callers may change flow_running or flow_weight through them, but not the
+ * fields an index is keyed on.
+ */
+class Tracker : public Object
+{
+  public:
+    typedef std::multimap<double, FlowData *> FlowOrder;
+
+    static TypeId GetTypeId(void);
+
+    void (*scheduler_func)(uint32_t);
+    Tracker();
+    virtual ~Tracker();
+    void registerEvent(uint32_t, FlowData);
+    /* fires the FlowDump trace once per tracked flow */
+    void dataDump();
+    void register_callback(void (*f)(uint32_t));
+    void registered_callback(uint32_t);
+    void UpdateFlowRemainingSize(FlowData, double, uint32_t);
+
+    /* 0 if fid is not tracked */
+    FlowData *GetFlow(uint32_t fid);
+    /* head of the EDF order, 0 if there are no deadline bound flows */
+    FlowData *GetEarliestDeadlineFlow(void);
+    /* head of the SRPT order, 0 if there are no flows without deadline */
+    FlowData *GetShortestRemainingFlow(void);
+    uint32_t GetNFlows(void) const;
+    uint32_t GetNDeadlineFlows(void) const;
+    const FlowOrder &GetDeadlineOrder(void) const;
+    const FlowOrder &GetRemainingSizeOrder(void) const;
+
+  protected:
+    virtual void DoDispose(void);
+
+  private:
+    struct Entry {
+      Entry(const FlowData &fd);
+      FlowData data;
+      FlowOrder::iterator order;   // position in m_deadlineOrder or m_sizeOrder
+    };
+    typedef sgi::hash_map<uint32_t, Entry *> FlowTable;
+
+    void AddFlow(const FlowData &fd);
+    bool RemoveFlow(uint32_t fid);
+
+    FlowTable m_flows;
+    FlowOrder m_deadlineOrder;
+    FlowOrder m_sizeOrder;
+    TracedCallback<const FlowData &> m_dumpTrace;
+    TracedCallback<const FlowData &> m_startTrace;
+    TracedCallback<uint32_t> m_stopTrace;
+};
+
+#endif
@@ -2,6 +2,10 @@
 #include <string>
 #include <iostream>
 #include <fstream>
+#include <cstdio>
+#include <deque>
+#include <unistd.h>
+#include <sys/wait.h>
 
 using namespace ns3;
 
@@ -52,6 +56,48 @@ void sinkInstallNodeEvent(uint32_t sourceN, uint32_t sinkN, uint16_t port, uint3
   NS_LOG_UNCOND("sink attributed set : numbytes "<<nb.Get()<<" flowid "<<fid.Get()<<" nodeid "<<n1.Get()<<" source nodeid "<<n2.Get());
   
 }
+/* Destination ports, per sink host.  Fresh ports are handed out in order
+ * (2, 3, ...).  Once they run out, the ports of finished flows are reused,
+ * oldest first, after the sink's connections have left TIME_WAIT.  A port
+ * is unique per sink rather than per (source, sink) pair because the sinks
+ * listen on the any address.
+ */
+struct SinkPorts {
+  SinkPorts() : next(2) {}
+  uint32_t next;
+  std::deque<std::pair<double, uint16_t> > released; // (release time, port)
+};
+static std::vector<SinkPorts> sink_ports;
+
+static double portReuseDelay(void)
+{
+  struct TypeId::AttributeInformation info;
+  TypeId::LookupByName("ns3::TcpSocketBase").LookupAttributeByName("MaxSegLifetime", &info);
+  return 2 * DynamicCast<const DoubleValue>(info.initialValue)->Get();
+}
+
+uint16_t allocatePort(uint32_t sinkN)
+{
+  if(sinkN >= sink_ports.size()) {
+    sink_ports.resize(sinkN + 1);
+  }
+  SinkPorts &sp = sink_ports[sinkN];
+  if(sp.next <= 65535) {
+    return sp.next++;
+  }
+  if(sp.released.empty() || Simulator::Now().GetSeconds() - sp.released.front().first < portReuseDelay()) {
+    NS_FATAL_ERROR("out of destination ports at sink "<<sinkN<<": 65534 flows in use or in TIME_WAIT");
+  }
+  uint16_t port = sp.released.front().second;
+  sp.released.pop_front();
+  return port;
+}
+
+void releasePort(uint32_t sinkN, uint16_t port, uint32_t flow_id)
+{
+  sink_ports[sinkN].released.push_back(std::make_pair(Simulator::Now().GetSeconds(), port));
+}
+
 Ptr<PacketSink> sinkInstallNode(uint32_t sourceN, uint32_t sinkN, uint16_t port, uint32_t flow_id, double startTime, uint32_t numBytes, uint32_t tcp)
 {
   // Create a packet sink on the star "hub" to receive these packets
@@ -75,6 +121,10 @@ Ptr<PacketSink> sinkInstallNode(uint32_t sourceN, uint32_t sinkN, uint16_t port,
   pSink->SetAttribute("nodeid", UintegerValue(sinkNodes.Get(sinkN)->GetId()));
   pSink->SetAttribute("peernodeid", UintegerValue(sourceNodes.Get(sourceN)->GetId()));
   pSink->setTracker(flowTracker);
+  pSink->TraceConnectWithoutContext("Finished", MakeBoundCallback(&releasePort, sinkN, port));
+  if(fctCollector != 0) {
+    pSink->TraceConnectWithoutContext("Finished", MakeCallback(&FctCollector::FlowFinished, fctCollector));
+  }
 
 
   /* Debug... Check what we set */
@@ -89,6 +139,20 @@ Ptr<PacketSink> sinkInstallNode(uint32_t sourceN, uint32_t sinkN, uint16_t port,
   
 }
 
+/* the compiled PrioQueue discipline for the xfabric and alpha_fair_rcp
+   options, instead of ns3::PrioQueue branching on them per packet */
+std::string
+prioQueueType(void)
+{
+  if(alpha_fair_rcp) {
+    return xfabric ? "ns3::PrioQueue<Rcp,TagWfq,No>" : "ns3::PrioQueue<Rcp,Fifo,No>";
+  }
+  if(xfabric) {
+    return "ns3::PrioQueue<NumFabric,TagWfq,No>";
+  }
+  return "ns3::PrioQueue<Dgd,Fifo,Ecn>";
+}
+
 void
 CheckQueueSize (Ptr<Queue> queue)
 {
@@ -161,6 +225,12 @@ CheckQueueSize (Ptr<Queue> queue)
   
     Simulator::Schedule (Seconds (sampling_interval), &CheckQueueSize, queue);
     if(Simulator::Now().GetSeconds() >= sim_time+1.0) {
+      if(queue_histograms && queue_type == "WFQ") {
+        StaticCast<PrioQueue> (queue)->DumpHistograms();
+      }
+      if(queue_histograms && queue_type == "W2FQ") {
+        StaticCast<W2FQ> (queue)->DumpHistograms();
+      }
       Simulator::Stop();
     }
  
@@ -230,6 +300,20 @@ CommandLine addCmdOptions(void)
   cmd.AddValue ("desynchronize", "desynchronize", desynchronize);
   cmd.AddValue ("dgd_m", "dgd_m", multiplier);
   cmd.AddValue ("opt_rates_file", "opt_rates_file", opt_rates_file);
+  cmd.AddValue ("num_oracle", "compute ideal rates in the simulator instead of reading opt_rates_file", num_oracle);
+  cmd.AddValue ("fluid", "simulate the flows as fluid instead of sending packets", fluid);
+  cmd.AddValue ("fluid_step", "time step of the fluid model in seconds", fluid_step);
+  cmd.AddValue ("hybrid", "simulate the background flows as fluid and the foreground flows with packets", hybrid);
+  cmd.AddValue ("foreground_every", "in hybrid runs, every foreground_every-th flow id sends packets, 0 for none", foreground_every);
+  cmd.AddValue ("convergence_window", "sampling intervals 95% of the flows must be within 10% of their ideal rate", convergence_window);
+  cmd.AddValue ("sweep_file", "run one forked worker per line of option=value pairs, sharing the topology", sweep_file);
+  cmd.AddValue ("sweep_workers", "number of sweep points run in parallel, 0 for one per cpu", sweep_workers);
+  cmd.AddValue ("checkpoint_time", "fork the sweep points from the simulation at this time instead of after building the topology", checkpoint_time);
+  cmd.AddValue ("tracker_dump", "print the scheduler flow table whenever it is dumped", tracker_dump);
+  cmd.AddValue ("queue_histograms", "print sojourn time and occupancy histograms of the queues", queue_histograms);
+  cmd.AddValue ("histogram_epoch", "print and restart the queue histograms this often in seconds, 0 at the end only", histogram_epoch);
+  cmd.AddValue ("fct_stats", "print flow completion time and slowdown histograms by flow size", fct_stats);
+  cmd.AddValue ("fct_window", "also print the flows finished in every window this long in seconds, 0 for none", fct_window);
 
   cmd.AddValue ("rcp_alpha", "rcp_alpha", rcp_alpha);
   cmd.AddValue ("rcp_beta", "rcp_beta", rcp_beta);
@@ -253,6 +337,11 @@ void dump_config(void)
   std::cout<<"kvalue_price "<<kvalue_price<<std::endl;
   std::cout<<"kvalue_measurement "<<kvalue_measurement<<std::endl;
   std::cout<<"opt_rates_file "<<opt_rates_file<<std::endl;
+  std::cout<<"num_oracle "<<num_oracle<<std::endl;
+  std::cout<<"fluid "<<fluid<<" fluid_step "<<fluid_step<<std::endl;
+  std::cout<<"hybrid "<<hybrid<<" foreground_every "<<foreground_every<<std::endl;
+  std::cout<<"queue_histograms "<<queue_histograms<<" histogram_epoch "<<histogram_epoch<<std::endl;
+  std::cout<<"fct_stats "<<fct_stats<<" fct_window "<<fct_window<<std::endl;
   std::cout<<"util_method "<<util_method<<std::endl;
   std::cout<<"fct_alpha "<<fct_alpha<<std::endl;
 
@@ -274,9 +363,10 @@ void dump_config(void)
   std::cout<<"topo_info "<<num_leafs<<" "<<num_spines<<" "<<num_hosts_per_leaf<<" 1 "<<fabric_data<<std::endl;
 }
 
-void common_config(void)
+// everything derived from the command line options that only reaches the
+// simulation through attribute defaults
+static void config_attributes(void)
 {
-
   // get link rate from edge_datarate string
   link_rate = ONEG * atof(get_datarate(edge_datarate).c_str());
   double total_rtt = link_delay * 8.0 *1.0; 
@@ -297,10 +387,10 @@ void common_config(void)
   LastEventTime = 1.0;
   pkt_tag = xfabric; 
   
-  dgd_a = dgd_a*multiplier;
-  dgd_b = dgd_b*multiplier;
+  double scaled_dgd_a = dgd_a*multiplier;
+  double scaled_dgd_b = dgd_b*multiplier;
 
-  std::cout<<"dgd_b "<<dgd_b<<" dgd_a "<<dgd_a<<" multiplier "<<multiplier<<std::endl;
+  std::cout<<"dgd_b "<<scaled_dgd_b<<" dgd_a "<<scaled_dgd_a<<" multiplier "<<multiplier<<std::endl;
 
   std::cout<<"Setting ssthresh = "<<ssthresh<<" initcwnd = "<<initcwnd<<" link_delay  "<<link_delay<<" bdproduct "<<bdproduct<<" total_rtt "<<total_rtt<<" link_rate "<<link_rate<<std::endl;  
 
@@ -343,14 +433,18 @@ void common_config(void)
   Config::SetDefault ("ns3::PrioQueue::ECNThreshBytes", UintegerValue (max_ecn_thresh));
   Config::SetDefault ("ns3::PrioQueue::delay_mark", BooleanValue(delay_mark_value));
   Config::SetDefault("ns3::PrioQueue::xfabric_price",BooleanValue(xfabric));
-  Config::SetDefault("ns3::PrioQueue::dgd_a", DoubleValue(dgd_a));
-  Config::SetDefault("ns3::PrioQueue::dgd_b",DoubleValue(dgd_b));
+  Config::SetDefault("ns3::PrioQueue::dgd_a", DoubleValue(scaled_dgd_a));
+  Config::SetDefault("ns3::PrioQueue::dgd_b",DoubleValue(scaled_dgd_b));
   Config::SetDefault("ns3::PrioQueue::target_queue", DoubleValue(target_queue));
   Config::SetDefault("ns3::PrioQueue::guardTime",TimeValue(Seconds(guard_time)));
   Config::SetDefault("ns3::PrioQueue::PriceUpdateTime",TimeValue(Seconds(price_update_time)));
   Config::SetDefault("ns3::PrioQueue::numfabric_eta",DoubleValue(xfabric_eta));
   Config::SetDefault("ns3::PrioQueue::xfabric_beta",DoubleValue(xfabric_beta));
   Config::SetDefault("ns3::PrioQueue::price_multiply",BooleanValue(price_multiply));
+  Config::SetDefault("ns3::PrioQueue::Histograms", BooleanValue(queue_histograms));
+  Config::SetDefault("ns3::PrioQueue::HistogramEpoch", TimeValue(Seconds(histogram_epoch)));
+  Config::SetDefault("ns3::W2FQ::Histograms", BooleanValue(queue_histograms));
+  Config::SetDefault("ns3::W2FQ::HistogramEpoch", TimeValue(Seconds(histogram_epoch)));
 
 
   Config::SetDefault ("ns3::FifoQueue::Mode", StringValue("QUEUE_MODE_BYTES"));
@@ -379,13 +473,38 @@ void common_config(void)
 
   Config::SetDefault("ns3::Ipv4GlobalRouting::RandomEcmpRouting", BooleanValue(packet_spraying));
   Config::SetDefault("ns3::Ipv4GlobalRouting::FlowEcmpRouting", BooleanValue(flow_ecmp));
+}
 
-  // tcp newreno
-
+static void printFctWindow(const FctStats &stats)
+{
+  std::stringstream ss;
+  ss<<"FctWindow "<<Simulator::Now().GetSeconds();
+  stats.Print(std::cout, ss.str());
+}
 
+void common_config(void)
+{
+  config_attributes();
 
-  flowTracker = new Tracker();
+  flowTracker = CreateObject<Tracker> ();
   flowTracker->register_callback(scheduler_wrapper);
+  if(tracker_dump) {
+    flowTracker->TraceConnectWithoutContext("FlowDump", MakeCallback(&dumpTrackedFlow));
+  }
+
+  if(fct_stats) {
+    fctCollector = CreateObject<FctCollector> ();
+    fctCollector->SetAttribute("LineRate", DataRateValue(DataRate(link_rate)));
+    fctCollector->SetAttribute("BaseRtt", TimeValue(MicroSeconds(link_delay * 8.0)));
+    fctCollector->SetAttribute("Window", TimeValue(Seconds(fct_window)));
+    fctCollector->TraceConnectWithoutContext("Window", MakeCallback(&printFctWindow));
+  }
+
+  flowConvergence = CreateObject<ConvergenceTracker> ();
+  flowConvergence->SetAttribute("Tolerance", DoubleValue(0.1));
+  flowConvergence->SetAttribute("Fraction", DoubleValue(0.95));
+  flowConvergence->SetAttribute("Window", UintegerValue(convergence_window));
+  flowConvergence->SetConvergedCallback(MakeCallback(&flowsConverged));
 
   std::stringstream opt_rates_full; 
   opt_rates_full<<"./opt_rates/"<<opt_rates_file;
@@ -403,6 +522,38 @@ void common_config(void)
       std::cout<<" at epoch "<<epoch<<" datarate "<<datarate<<" flow "<<flowid<<std::endl;
     }
   }
+
+  // without precomputed rates, solve for them as flows come and go
+  if(opt_drates.empty()) {
+    num_oracle = true;
+  }
+  if(num_oracle) {
+    numOracle = CreateObject<NumSolver> ();
+    uint32_t oracle_method = util_method;
+    if(alpha_fair_rcp || oracle_method > 3) {
+      oracle_method = 3;
+    }
+    numOracle->SetAttribute("UtilFunction", UintegerValue(oracle_method));
+    numOracle->SetAttribute("fct_alpha", DoubleValue(fct_alpha));
+    std::cout<<" computing optimal rates in the simulator, util_method "<<oracle_method<<std::endl;
+  }
+
+  // the fluid rates stand in for the measured ones, the queues still set
+  // the prices; weighted fair sharing where the queues order by tags.
+  // In hybrid runs the fluid rates are reserved on the links and the
+  // foreground flows send packets over what is left
+  if(fluid || hybrid) {
+    fluidSim = CreateObject<FluidSimulator> ();
+    uint32_t fluid_method = (alpha_fair_rcp || util_method > 3) ? 3 : util_method;
+    fluidSim->SetAttribute("UtilFunction", UintegerValue(fluid_method));
+    fluidSim->SetAttribute("fct_alpha", DoubleValue(fct_alpha));
+    fluidSim->SetAttribute("TimeStep", TimeValue(Seconds(fluid_step)));
+    fluidSim->SetAttribute("Sharing", EnumValue(xfabric ? FluidSimulator::WEIGHTED_FAIR : FluidSimulator::FIFO));
+    fluidSim->SetAttribute("Hybrid", BooleanValue(hybrid));
+    fluidSim->TraceConnectWithoutContext("Rate", MakeCallback(&ConvergenceTracker::UpdateRate, flowConvergence));
+    fluidSim->TraceConnectWithoutContext("FlowCompleted", MakeCallback(&scheduler_wrapper));
+    std::cout<<" fluid model, step "<<fluid_step<<" hybrid "<<hybrid<<std::endl;
+  }
       
   std::ifstream FAFile ("flow_arrivals", std::ifstream::in);
   if(FAFile.is_open()) {
@@ -442,9 +593,267 @@ void common_config(void)
 
 }
 
+/* Parameter sweeps.
+ *
+ * With --sweep_file the topology and routing tables are built once; each
+ * line of the file is a sweep point, a list of option=value pairs given on
+ * top of the command line.  runSweep forks one worker per point, at most
+ * sweep_workers at a time, so the workers share the topology copy-on-write
+ * and start from the untouched simulator state.  A worker re-parses its
+ * options, re-applies the attribute defaults and pushes the ones that
+ * changed to the live stacks and queues, then goes on to set up traffic and
+ * run with its output in <prefix>.out/.err (prefix_<n> if the point does not
+ * set prefix).  Options used while building the topology (datarates, leaf
+ * and spine counts, input files) can't be swept.
+ *
+ * With --checkpoint_time as well, the process first simulates the warm-up
+ * and the workers are forked from the simulation state at that time
+ * (event list, queue contents and prices, sockets, rate estimators and
+ * random streams included), so every point continues from the same
+ * converged state.  Traffic is already set up at that point, only
+ * attributes and options read later on take effect.  Output up to the
+ * checkpoint stays in the parent's output.
+ */
+
+// attribute defaults of the live stacks and queues when the topology was built
+static std::map<std::string, std::string> snapshot_defaults;
+
+static void forEachStackAndQueue(void (*f)(Ptr<Object>))
+{
+  for(NodeList::Iterator n = NodeList::Begin(); n != NodeList::End(); n++) {
+    Ptr<Ipv4L3Protocol> ipv4 = (*n)->GetObject<Ipv4L3Protocol> ();
+    if(ipv4) {
+      f(ipv4);
+    }
+    for(uint32_t d = 0; d < (*n)->GetNDevices(); d++) {
+      Ptr<PointToPointNetDevice> dev = DynamicCast<PointToPointNetDevice> ((*n)->GetDevice(d));
+      if(dev && dev->GetQueue()) {
+        f(dev->GetQueue());
+      }
+    }
+  }
+}
+
+static void recordDefaults(Ptr<Object> obj)
+{
+  for(TypeId tid = obj->GetInstanceTypeId(); ; tid = tid.GetParent()) {
+    for(uint32_t i = 0; i < tid.GetAttributeN(); i++) {
+      struct TypeId::AttributeInformation info = tid.GetAttribute(i);
+      snapshot_defaults[tid.GetAttributeFullName(i)] = info.initialValue->SerializeToString(info.checker);
+    }
+    if(tid == tid.GetParent()) {
+      break;
+    }
+  }
+}
+
+static void applyChangedDefaults(Ptr<Object> obj)
+{
+  for(TypeId tid = obj->GetInstanceTypeId(); ; tid = tid.GetParent()) {
+    for(uint32_t i = 0; i < tid.GetAttributeN(); i++) {
+      struct TypeId::AttributeInformation info = tid.GetAttribute(i);
+      if(!(info.flags & TypeId::ATTR_SET)) {
+        continue;
+      }
+      if(info.initialValue->SerializeToString(info.checker) != snapshot_defaults[tid.GetAttributeFullName(i)]) {
+        obj->SetAttribute(info.name, *info.initialValue);
+      }
+    }
+    if(tid == tid.GetParent()) {
+      break;
+    }
+  }
+}
+
+static void sweepWorker(CommandLine &cmd, std::string point, uint32_t index)
+{
+  std::vector<std::string> args;
+  args.push_back("sweep");
+  std::istringstream tokens(point);
+  std::string token;
+  while(tokens >> token) {
+    if(token.compare(0, 2, "--") != 0) {
+      token = "--" + token;
+    }
+    args.push_back(token);
+  }
+  std::vector<char *> argv;
+  for(uint32_t i = 0; i < args.size(); i++) {
+    argv.push_back(const_cast<char *> (args[i].c_str()));
+  }
+  argv.push_back(0);
+
+  std::string base_prefix = prefix;
+  cmd.Parse(args.size(), &argv[0]);
+  if(prefix == base_prefix) {
+    std::stringstream ss;
+    ss<<prefix<<"_"<<index;
+    prefix = ss.str();
+  }
+  if(!freopen((prefix+".out").c_str(), "w", stdout) || !freopen((prefix+".err").c_str(), "w", stderr)) {
+    NS_FATAL_ERROR("cannot open output files for sweep point " << index);
+  }
+  std::cout<<"sweep point "<<index<<" "<<point<<std::endl;
+  dump_config();
+
+  config_attributes();
+  forEachStackAndQueue(&applyChangedDefaults);
+  flowConvergence->SetAttribute("Window", UintegerValue(convergence_window));
+  if(numOracle) {
+    numOracle->SetAttribute("fct_alpha", DoubleValue(fct_alpha));
+  }
+  if(fluidSim) {
+    fluidSim->SetAttribute("fct_alpha", DoubleValue(fct_alpha));
+    fluidSim->SetAttribute("TimeStep", TimeValue(Seconds(fluid_step)));
+  }
+}
+
+// forks the workers, returns true in the workers and false in the parent
+// once all of them are done
+static bool forkSweepWorkers(CommandLine &cmd)
+{
+  std::vector<std::string> points;
+  std::ifstream SweepFile (sweep_file.c_str(), std::ifstream::in);
+  if(!SweepFile.is_open()) {
+    NS_FATAL_ERROR("cannot open sweep file " << sweep_file);
+  }
+  std::string line;
+  while(std::getline(SweepFile, line)) {
+    if(line.find_first_not_of(" \t") == std::string::npos || line[line.find_first_not_of(" \t")] == '#') {
+      continue;
+    }
+    points.push_back(line);
+  }
+
+  forEachStackAndQueue(&recordDefaults);
+  if(sweep_workers == 0) {
+    long ncpus = sysconf(_SC_NPROCESSORS_ONLN);
+    sweep_workers = (ncpus > 0) ? ncpus : 1;
+  }
+
+  // nothing buffered may be written twice by the workers
+  std::cout.flush();
+  fflush(stdout);
+  fflush(stderr);
+
+  uint32_t running = 0;
+  for(uint32_t i = 0; i < points.size(); i++) {
+    if(running == sweep_workers) {
+      wait(NULL);
+      running--;
+    }
+    pid_t pid = fork();
+    if(pid < 0) {
+      NS_FATAL_ERROR("fork failed for sweep point " << i);
+    }
+    if(pid == 0) {
+      sweepWorker(cmd, points[i], i);
+      return true;
+    }
+    running++;
+    std::cout<<"sweep point "<<i<<" pid "<<pid<<" "<<points[i]<<std::endl;
+  }
+  while(running > 0) {
+    wait(NULL);
+    running--;
+  }
+  std::cout<<"sweep done, "<<points.size()<<" points"<<std::endl;
+  return false;
+}
+
+static CommandLine *checkpoint_cmd;
+
+static void branchAtCheckpoint(void)
+{
+  std::cout<<"CHECKPOINT "<<Simulator::Now().GetSeconds()<<std::endl;
+  if(!forkSweepWorkers(*checkpoint_cmd)) {
+    Simulator::Stop();
+  }
+}
+
+bool runSweep(CommandLine &cmd)
+{
+  if(sweep_file == "") {
+    return true;
+  }
+  if(checkpoint_time > 0.0) {
+    checkpoint_cmd = &cmd;
+    Simulator::Schedule(Seconds(checkpoint_time), &branchAtCheckpoint);
+    return true;
+  }
+  return forkSweepWorkers(cmd);
+}
+
+void dumpTrackedFlow(const FlowData &fd)
+{
+  std::cout<<"fid "<<fd.flow_id<<" src "<<fd.source_node<<" dst "<<fd.dest_node<<" size "<<fd.flow_size<< " rem_size " << fd.flow_rem_size << " deadline " << fd.flow_deadline << " deadline_duration " << fd.flow_deadline_delta << " flow_start " << fd.flow_start << std::endl;
+}
+
 void scheduler_wrapper(uint32_t fid)
 {
      std::cout<<"trackercalled "<<fid<<" stopped "<<std::endl;
+     flowStopped(fid);
+}
+
+bool fluidFlow(uint32_t fid)
+{
+  if(fluidSim == 0) {
+    return false;
+  }
+  if(!hybrid) {
+    return true;
+  }
+  return foreground_every == 0 || (fid % foreground_every) != 0;
+}
+
+// ideal rates of the tracked flows are refreshed lazily, at the next sample
+static bool ideal_rates_stale = true;
+static uint32_t ideal_rates_epoch = 0;
+
+void flowStarted(uint32_t fid, Ptr<Node> src, Ipv4Address srcAddr, Ipv4Address dstAddr, uint16_t srcPort, uint16_t dstPort, double size, double weight)
+{
+  if(numOracle != 0) {
+    numOracle->AddFlow(fid, src, srcAddr, dstAddr, srcPort, dstPort, size, weight);
+  }
+  if(fluidFlow(fid)) {
+    fluidSim->AddFlow(fid, src, srcAddr, dstAddr, srcPort, dstPort, size, weight);
+  }
+  if(fctCollector != 0 && size > 0) {
+    fctCollector->FlowStarted(fid, size);
+  }
+  flowConvergence->AddFlow(fid, 0.0);
+  ideal_rates_stale = true;
+}
+
+void flowStopped(uint32_t fid)
+{
+  if(numOracle != 0) {
+    numOracle->RemoveFlow(fid);
+    ideal_rates_stale = true;
+  }
+  if(fluidSim != 0) {
+    fluidSim->RemoveFlow(fid);
+  }
+  flowConvergence->RemoveFlow(fid);
+}
+
+void refreshIdealRates(void)
+{
+  std::vector<uint32_t> fids = flowConvergence->GetFlowIds();
+  for(uint32_t i=0; i<fids.size(); i++) {
+    flowConvergence->SetIdealRate(fids[i], getIdealRate(epoch_number, fids[i]));
+  }
+  ideal_rates_stale = false;
+  ideal_rates_epoch = epoch_number;
+}
+
+// ideal rate of a flow in Mbps, the unit of the measured rates
+double getIdealRate(uint32_t epoch, uint32_t fid)
+{
+  if(numOracle != 0) {
+    return numOracle->GetRate(fid) / 1000000.0;
+  }
+  return opt_drates[epoch][fid] * 10000.0;
 }
 
 static void
@@ -471,8 +880,28 @@ void setuptracing(uint32_t sindex, Ptr<Socket> skt)
   
 }
 
+static void printQueueHistograms(std::string link, const QueueHistograms &histograms)
+{
+  std::stringstream ss;
+  ss<<"QueueHistogram "<<link<<" "<<Simulator::Now().GetSeconds();
+  histograms.Print(std::cout, ss.str());
+}
+
+static void printFctStats(void)
+{
+  fctCollector->Print(std::cout);
+}
+
 void setUpMonitoring(void)
 {
+  if(queue_histograms) {
+    for(uint32_t i=0; i<AllQueues.size(); i++) {
+      AllQueues[i]->TraceConnectWithoutContext("Histograms", MakeCallback(&printQueueHistograms));
+    }
+  }
+  if(fctCollector != 0) {
+    Simulator::Schedule(Seconds(sim_time+1.0), &printFctStats);
+  }
   
   uint32_t Ntrue = allNodes.GetN(); 
   for(uint32_t nid=0; nid<Ntrue; nid++)
@@ -496,6 +925,7 @@ void setUpMonitoring(void)
      
      //StaticCast<Ipv4L3Protocol> (ipv4)->setEpochUpdate(epoch_update_time);
      StaticCast<Ipv4L3Protocol> (ipv4)->setfctAlpha(fct_alpha);
+     ipv4->TraceConnectWithoutContext("MeasurementRate", MakeCallback(&ConvergenceTracker::UpdateRate, flowConvergence));
   }
      
   //apps.Start (Seconds (1.0));
@@ -518,93 +948,49 @@ void move_to_next()
  next_epoch_event = Simulator::ScheduleNow(startflowwrapper, sourcenodes, sinknodes);
 }  
 
+void flowsConverged(void)
+{
+  double max_iterations = convergence_window;
+  std::cout<<" More than "<<max_iterations<<" iterations of goodness.. moving on "<<Simulator::Now().GetSeconds()<<std::endl;
+  std::cout<<"95TH CONVERGED TIME "<<Simulator::Now().GetSeconds()-LastEventTime-max_iterations*sampling_interval<<" "<<Simulator::Now().GetSeconds()<<" epoch "<<getEpochNumber()<<std::endl;
+  std::cout<<"Details "<<Simulator::Now().GetSeconds()<<" Lastevent "<<LastEventTime<<std::endl;
+  move_to_next();
+}
+
 void
 CheckIpv4Rates (NodeContainer &allNodes)
 {
   double current_rate = 0.0;
-  std::vector<double> error_vector;
-  std::vector<double> nonerror_vector;
 
-/*
-  // iterate over all the sinkapp objects
-  for(unsigned int i=0; i<sink_objects.size(); i++) {
-      Ptr<PacketSink> sobj = sink_objects[i];
-      uint32_t epoch_num = getEpochNumber();
-      double ideal_rate = opt_drates[epoch_number][sobj->m_flowID] * 10000.0;
-      std::cout<<"sinkdata "<<Simulator::Now().GetSeconds()<<" flowid "<<sobj->m_flowID<<" totalRx "<<sobj->GetTotalRx()*8<<" epoch "<<epoch_num<<" ideal_rate "<<ideal_rate<<std::endl;
+  int epoch_number = getEpochNumber();
+  if(flowConvergence->GetNFlows() > 0 && (epoch_number == num_events || epoch_number == 100)) {
+    std::cout<<" LAST EPOCH "<<Simulator::Now().GetSeconds()<<std::endl;
+    Simulator::Stop();
   }
-*/
-
-  uint32_t N = allNodes.GetN(); 
-  for(uint32_t nid=0; nid < N ; nid++)
-  {
-
-    Ptr<Ipv4L3Protocol> ipv4 = StaticCast<Ipv4L3Protocol> ((allNodes.Get(nid))->GetObject<Ipv4> ());
-    std::map<std::string,uint32_t>::iterator it;
-    for (std::map<std::string,uint32_t>::iterator it=ipv4->flowids.begin(); it!=ipv4->flowids.end(); ++it)
-    {
-    
-     double rate = ipv4->GetStoreDestRate (it->first);
-//      double long_rate = ipv4->GetCSFQRate (it->first);
-//      double short_rate = ipv4->GetShortTermRate(it->first);
-      double measured_rate = ipv4->GetMeasurementRate(it->first);
-
-      uint32_t s = it->second;
-
-      /* check if this flowid is from this source */
-      if (std::find((source_flow[nid]).begin(), (source_flow[nid]).end(), s)!=(source_flow[nid]).end()) {
-     int epoch_number = getEpochNumber();
-	 if(epoch_number == num_events || epoch_number == 100) 
-	 { 
-	    std::cout<<" LAST EPOCH "<<Simulator::Now().GetSeconds()<<std::endl; 
-	    Simulator::Stop();
-	 }
-         // ideal rates vector
-         double ideal_rate = opt_drates[epoch_number][s] * 10000.0;
-         std::cout<<"DestRate flowid "<<it->second<<" "<<Simulator::Now ().GetSeconds () << " " << measured_rate <<" "<<ideal_rate<<" epoch "<<epoch_number<<std::endl;
-        current_rate += measured_rate;
-         double error = abs(ideal_rate - measured_rate)/ideal_rate;
-         if(error < 0.1) {
-           error_vector.push_back(error);
-         } else {
-           nonerror_vector.push_back(error);
-         } 
-      }
-//    std::cout<<"finding flow "<<s<<" in destination node "<<nid<<std::endl;
-    if (std::find((dest_flow[nid]).begin(), (dest_flow[nid]).end(), s)!=(dest_flow[nid]).end()) {
-       //
-/*       std::cout<<"DestRate flowid "<<it->second<<" "<<Simulator::Now ().GetSeconds () << " " << destRate <<" "<<csfq_rate<<" "<< nid << " " << N << " " << short_rate << std::endl; */
-      
-        //current_rate += rate;
-
-      }
-
-    }
+  if(ideal_rates_stale || ideal_rates_epoch != (uint32_t) epoch_number) {
+    refreshIdealRates();
   }
-  uint32_t total_flows = error_vector.size() + nonerror_vector.size();
-  std::cout<<" flows less than 0.1 error "<<error_vector.size()<<std::endl;
-  if(error_vector.size() >= 0.95 * total_flows) {
-    // 95th percentile reached.. how many epochs since 95th percentile reached?
-    std::cout<<" 95th percentil flows match continuous count "<<ninety_fifth<<" epoch "<<getEpochNumber()<<std::endl;
-    ninety_fifth++;
-  } else {
-    ninety_fifth = 0;
+
+  // measured rates reach flowConvergence through the MeasurementRate trace,
+  // only the active flows are visited here and only to log them
+  std::vector<uint32_t> fids = flowConvergence->GetFlowIds();
+  for(uint32_t i=0; i<fids.size(); i++) {
+    double measured_rate = flowConvergence->GetMeasuredRate(fids[i]);
+    double ideal_rate = flowConvergence->GetIdealRate(fids[i]);
+    std::cout<<"DestRate flowid "<<fids[i]<<" "<<Simulator::Now ().GetSeconds () << " " << measured_rate <<" "<<ideal_rate<<" epoch "<<epoch_number<<std::endl;
+    current_rate += measured_rate;
   }
 
-  double max_iterations= 250.0;
-  if(ninety_fifth > max_iterations) {
-    std::cout<<" More than "<<max_iterations<<" iterations of goodness.. moving on "<<Simulator::Now().GetSeconds()<<std::endl;
-    std::cout<<"95TH CONVERGED TIME "<<Simulator::Now().GetSeconds()-LastEventTime-max_iterations*sampling_interval<<" "<<Simulator::Now().GetSeconds()<<" epoch "<<getEpochNumber()<<std::endl;
-    std::cout<<"Details "<<Simulator::Now().GetSeconds()<<" Lastevent "<<LastEventTime<<std::endl;
-    move_to_next();
+  std::cout<<" flows less than 0.1 error "<<flowConvergence->GetNWithinTolerance()<<std::endl;
+  // calls flowsConverged once the window is complete
+  flowConvergence->Tick();
+  if(flowConvergence->GetConsecutive() > 0) {
+    std::cout<<" 95th percentil flows match continuous count "<<flowConvergence->GetConsecutive()-1<<" epoch "<<getEpochNumber()<<std::endl;
   }
   std::cout<<Simulator::Now().GetSeconds()<<" TotalRate "<<current_rate<<std::endl;
   
   // check queue size every sampling_interval seconds
   Simulator::Schedule (Seconds (sampling_interval), &CheckIpv4Rates, allNodes);
-  /*if(Simulator::Now().GetSeconds() >= sim_time) {
-    Simulator::Stop();
-  }*/
 }
 
 void printlink(Ptr<Node> n1, Ptr<Node> n2)
@@ -621,7 +1007,9 @@ Ipv4InterfaceContainer assignAddress(NetDeviceContainer dev, uint32_t subnet_ind
     std::ostringstream subnet;
     Ipv4AddressHelper ipv4;
     NS_LOG_UNCOND("Assigning subnet index "<<subnet_index);
-    subnet<<"10.1."<<subnet_index<<".0";
+    // 10.1.x.0 for the first 256 links, then on into 10.2.0.0 and up
+    NS_ABORT_MSG_IF(subnet_index >= 254*256, "assignAddress: out of /24 subnets, use ClosTopologyHelper");
+    subnet<<"10."<<1 + subnet_index/256<<"."<<subnet_index%256<<".0";
     ipv4.SetBase (subnet.str ().c_str (), "255.255.255.0");
     intf = ipv4.Assign (dev);
     return intf;
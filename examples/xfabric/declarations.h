@@ -10,6 +10,7 @@
 #include "ns3/network-module.h"
 #include "ns3/internet-module.h"
 #include "ns3/point-to-point-module.h"
+#include "ns3/point-to-point-layout-module.h"
 #include "ns3/applications-module.h"
 #include "ns3/ipv4-global-routing-helper.h"
 #include "ns3/prio-queue.h"
@@ -101,6 +102,7 @@ extern double UNKNOWN_FLOW_SIZE_CUTOFF;
 extern std::string empirical_dist_file_DCTCP_light;
 extern Ptr<EmpiricalRandomVariable>  SetUpEmpirical(std::string fname);
 extern void scheduler_wrapper(uint32_t);
+extern void dumpTrackedFlow(const FlowData &);
 
 extern std::string link_twice_string ;
 
@@ -142,7 +144,9 @@ extern void setUpMonitoring(void);
 extern void CheckIpv4Rates (NodeContainer &allNodes);
 extern void printlink(Ptr<Node> n1, Ptr<Node> n2);
 extern Ipv4InterfaceContainer assignAddress(NetDeviceContainer dev, uint32_t subnet_index);
+extern uint16_t allocatePort(uint32_t sinkN);
 extern void CheckQueueSize (Ptr<Queue> queue);
+extern std::string prioQueueType(void);
 void setuptracing(uint32_t sindex, Ptr<Socket> skt);
 void run_scheduler(FlowData fdata, uint32_t eventtype);
 void run_scheduler_edf(FlowData fdata, uint32_t eventtype);
@@ -185,10 +189,33 @@ typedef struct OptDataRate_ {
 extern std::map<uint32_t, std::map<uint32_t, double> > opt_drates;
 extern uint32_t epoch_number;
 extern EventId next_epoch_event;
+extern bool num_oracle;
+extern Ptr<NumSolver> numOracle;
+extern bool fluid;
+extern double fluid_step;
+extern Ptr<FluidSimulator> fluidSim;
+extern bool hybrid;
+extern uint32_t foreground_every;
+bool fluidFlow(uint32_t fid);
+void flowStarted(uint32_t fid, Ptr<Node> src, Ipv4Address srcAddr, Ipv4Address dstAddr, uint16_t srcPort, uint16_t dstPort, double size, double weight);
+void flowStopped(uint32_t fid);
+double getIdealRate(uint32_t epoch, uint32_t fid);
+void flowsConverged(void);
 void startflowwrapper(std::vector<uint32_t>, std::vector<uint32_t>);
 extern std::vector<uint32_t> sourcenodes;//(max_system_flows, 0);
 extern std::vector<uint32_t> sinknodes;//(max_system_flows, 0);
-extern uint32_t ninety_fifth;
+extern Ptr<ConvergenceTracker> flowConvergence;
+extern uint32_t convergence_window;
+extern bool tracker_dump;
+extern bool queue_histograms;
+extern double histogram_epoch;
+extern bool fct_stats;
+extern double fct_window;
+extern Ptr<FctCollector> fctCollector;
+extern std::string sweep_file;
+extern uint32_t sweep_workers;
+extern double checkpoint_time;
+extern bool runSweep(CommandLine &cmd);
 extern bool alpha_fair_rcp;
 
 extern double LastEventTime;
@@ -145,6 +145,18 @@ std::string opt_rates_file="opt_rates_nonexistent";
 std::map<uint32_t, std::map<uint32_t, double> > opt_drates;
 EventId next_epoch_event;
 
+// ideal rates computed in the simulator instead of read from opt_rates_file
+bool num_oracle = false;
+Ptr<NumSolver> numOracle;
+
+// flow-level run: no packets, rates and prices from the fluid model
+bool fluid = false;
+double fluid_step = 0.00002;
+Ptr<FluidSimulator> fluidSim;
+// hybrid run: fluid background flows, every foreground_every-th flow sends packets
+bool hybrid = false;
+uint32_t foreground_every = 10;
+
 std::string link_twice_string = "40Gbps";
 
 NodeContainer bottleNeckNode;
@@ -184,7 +196,19 @@ bool desynchronize = false;
 uint32_t epoch_number = 0;
 std::vector<uint32_t> sourcenodes;//(max_system_flows, 0);
 std::vector<uint32_t> sinknodes;//(max_system_flows, 0);
-uint32_t ninety_fifth;
+Ptr<ConvergenceTracker> flowConvergence;
+uint32_t convergence_window = 250;
+bool tracker_dump = false;
+// sojourn and occupancy histograms of the queues, every histogram_epoch seconds (0: at the end)
+bool queue_histograms = false;
+double histogram_epoch = 0.0;
+// flow completion time and slowdown histograms, also every fct_window seconds if not 0
+bool fct_stats = false;
+double fct_window = 0.0;
+Ptr<FctCollector> fctCollector;
+std::string sweep_file = "";
+uint32_t sweep_workers = 0;
+double checkpoint_time = 0.0;
 double LastEventTime;
 std::list<uint32_t> flows_to_start;
 std::list<uint32_t> flows_to_stop;
@@ -20,14 +20,6 @@ NS_LOG_COMPONENT_DEFINE ("pfabric");
 uint32_t global_flow_id = 1;
 std::map<uint32_t, uint32_t> flow_known;
 
-bool compare_flow_deadlines(const FlowData &a, const FlowData &b)
-{
-  if(a.flow_deadline < b.flow_deadline) {
-    return true;
-  }
-  return false;
-}
-
 void config_queue(Ptr<Queue> Q, uint32_t nid, uint32_t vpackets, std::string fkey1)
 {
       Q->SetNodeID(nid);
@@ -433,26 +425,23 @@ void run_scheduler_edf(FlowData fdata, uint32_t eventType)
     /* adding the flow temporarily so that the scheduler can take it into account */
     flowTracker->registerEvent(1, fdata);
   }
-  /* order flows by their deadlines */
-  flowTracker->deadline_flows_set.sort(compare_flow_deadlines);
- 
-  /* sorted in order of their deadlines */
-  std::list<FlowData>::iterator itr;
-  itr = (flowTracker->deadline_flows_set).begin();
+  /* the tracker keeps deadline bound flows in order of their deadlines */
+  Tracker::FlowOrder::const_iterator itr;
+  itr = flowTracker->GetDeadlineOrder().begin();
 
   double total_rate_required = 0.0;
   double available_rate = (1-controller_estimated_unknown_load) * link_rate;
-  while(itr != flowTracker->deadline_flows_set.end()) 
+  while(itr != flowTracker->GetDeadlineOrder().end()) 
   {
     double nanoseconds = 1000000000.0;
-    double time_till_deadline = (itr->flow_deadline) * nanoseconds - Simulator::Now().GetNanoSeconds();
+    double time_till_deadline = (itr->second->flow_deadline) * nanoseconds - Simulator::Now().GetNanoSeconds();
     double rate_required = 0.0;
     if(time_till_deadline > 0.0) {
-      rate_required = itr->flow_rem_size/(time_till_deadline/nanoseconds);
+      rate_required = itr->second->flow_rem_size/(time_till_deadline/nanoseconds);
       total_rate_required += rate_required;
     }
-    uint32_t nid = itr->source_node;
-    std::cout<<"trying to access node "<<nid<<" fid "<<itr->flow_id<<std::endl;
+    uint32_t nid = itr->second->source_node;
+    std::cout<<"trying to access node "<<nid<<" fid "<<itr->second->flow_id<<std::endl;
     Ptr<Ipv4L3Protocol> ipv4 = StaticCast<Ipv4L3Protocol> ((allNodes.Get(nid))->GetObject<Ipv4> ());
 
     if(rate_required > available_rate) {
@@ -468,18 +457,18 @@ void run_scheduler_edf(FlowData fdata, uint32_t eventType)
       rate_required = partial;
       total_rate_required += partial;
     } 
-    flow_rate_local[itr->flow_id] = rate_required;
-    std::cout<<"EDF DEADLINE TrueRate "<<Simulator::Now().GetSeconds()<<" "<<itr->flow_id<<" "<<rate_required<<std::endl;
-    std::cout<<"EDF DEADLINE setting realrate "<<rate_required<<" for flow "<<itr->flow_id<<" in node "<<itr->source_node<<std::endl;
+    flow_rate_local[itr->second->flow_id] = rate_required;
+    std::cout<<"EDF DEADLINE TrueRate "<<Simulator::Now().GetSeconds()<<" "<<itr->second->flow_id<<" "<<rate_required<<std::endl;
+    std::cout<<"EDF DEADLINE setting realrate "<<rate_required<<" for flow "<<itr->second->flow_id<<" in node "<<itr->second->source_node<<std::endl;
 
-    std::cout<<"EDF DEBUG rate_required "<< rate_required <<" for flow "<<itr->flow_id<<" in node "<<itr->source_node<< " flow size " << itr->flow_size << " total rate required " << total_rate_required << " available rate " << available_rate << std::endl;
+    std::cout<<"EDF DEBUG rate_required "<< rate_required <<" for flow "<<itr->second->flow_id<<" in node "<<itr->second->source_node<< " flow size " << itr->second->flow_size << " total rate required " << total_rate_required << " available rate " << available_rate << std::endl;
 
-    ipv4->setFlowIdealRate(itr->flow_id, rate_required);
+    ipv4->setFlowIdealRate(itr->second->flow_id, rate_required);
 
-    if(!itr->flow_running) {
-      flow_weight_local[itr->flow_id] = 1.0;
-      startFlowEvent(itr->source_node, itr->dest_node, Simulator::Now().GetSeconds(), itr->flow_size, itr->flow_id, flow_weight_local[itr->flow_id], itr->flow_tcp, itr->flow_known);
-      itr->flow_running = true;
+    if(!itr->second->flow_running) {
+      flow_weight_local[itr->second->flow_id] = 1.0;
+      startFlowEvent(itr->second->source_node, itr->second->dest_node, Simulator::Now().GetSeconds(), itr->second->flow_size, itr->second->flow_id, flow_weight_local[itr->second->flow_id], itr->second->flow_tcp, itr->second->flow_known);
+      itr->second->flow_running = true;
     }
     itr++;
    }
@@ -488,22 +477,22 @@ void run_scheduler_edf(FlowData fdata, uint32_t eventType)
    double remaining_capacity = available_rate - total_rate_required;
    double per_flow_cap = 0.0;
    if(remaining_capacity > 0.0) {
-    per_flow_cap = remaining_capacity / (flowTracker->flows_set).size();
+    per_flow_cap = remaining_capacity / flowTracker->GetNFlows();
    }
-   itr = (flowTracker->flows_set).begin();
+   itr = flowTracker->GetRemainingSizeOrder().begin();
 
-    while(itr != flowTracker->flows_set.end())  {
-      uint32_t nid = itr->source_node;
+    while(itr != flowTracker->GetRemainingSizeOrder().end())  {
+      uint32_t nid = itr->second->source_node;
       Ptr<Ipv4L3Protocol> ipv4 = StaticCast<Ipv4L3Protocol> ((allNodes.Get(nid))->GetObject<Ipv4> ());
-      flow_rate_local[itr->flow_id] = per_flow_cap;
-      std::cout<<" EDF NO_DEADLINE TrueRate "<<Simulator::Now().GetSeconds()<<" "<<itr->flow_id<<" "<<per_flow_cap<<std::endl;
-      std::cout<<" EDF NO_DEADLINE setting realrate "<<per_flow_cap<<" for flow "<<itr->flow_id<<" in node "<<itr->source_node<<std::endl;
-      ipv4->setFlowIdealRate(itr->flow_id, per_flow_cap);
-
-      if(!itr->flow_running) {
-        flow_weight_local[itr->flow_id] = 1.0;
-        startFlowEvent(itr->source_node, itr->dest_node, Simulator::Now().GetSeconds(), itr->flow_size, itr->flow_id, flow_weight_local[itr->flow_id], itr->flow_tcp, itr->flow_known);
-        itr->flow_running = true;
+      flow_rate_local[itr->second->flow_id] = per_flow_cap;
+      std::cout<<" EDF NO_DEADLINE TrueRate "<<Simulator::Now().GetSeconds()<<" "<<itr->second->flow_id<<" "<<per_flow_cap<<std::endl;
+      std::cout<<" EDF NO_DEADLINE setting realrate "<<per_flow_cap<<" for flow "<<itr->second->flow_id<<" in node "<<itr->second->source_node<<std::endl;
+      ipv4->setFlowIdealRate(itr->second->flow_id, per_flow_cap);
+
+      if(!itr->second->flow_running) {
+        flow_weight_local[itr->second->flow_id] = 1.0;
+        startFlowEvent(itr->second->source_node, itr->second->dest_node, Simulator::Now().GetSeconds(), itr->second->flow_size, itr->second->flow_id, flow_weight_local[itr->second->flow_id], itr->second->flow_tcp, itr->second->flow_known);
+        itr->second->flow_running = true;
       }
       itr++;
    }
@@ -538,19 +527,19 @@ void run_scheduler(FlowData fdata, uint32_t eventType)
   std::map<uint32_t, double> flow_weight_local;
   double min_weight = 100.0;
 
-  std::list<FlowData>::iterator itr;
-  itr = (flowTracker->flows_set).begin();
+  Tracker::FlowOrder::const_iterator itr;
+  itr = flowTracker->GetRemainingSizeOrder().begin();
 
-  while(itr != flowTracker->flows_set.end()) 
+  while(itr != flowTracker->GetRemainingSizeOrder().end()) 
   {
       uint32_t rand_num = uv->GetInteger(1.0, 10.0);
       double new_weight = rand_num*1.0;
-      if(itr->flow_running) {
+      if(itr->second->flow_running) {
         /* flow already running - don't reassign weight */ 
-        new_weight = itr->flow_weight;
+        new_weight = itr->second->flow_weight;
       }
       
-      flow_weight_local[itr->flow_id] = new_weight;
+      flow_weight_local[itr->second->flow_id] = new_weight;
       if(new_weight < min_weight) {
         min_weight = new_weight;
       }
@@ -558,30 +547,30 @@ void run_scheduler(FlowData fdata, uint32_t eventType)
   } // end flows_set
 
   /* start a new loop to normalize weights, if configured to do so */
-  itr = flowTracker->flows_set.begin();
+  itr = flowTracker->GetRemainingSizeOrder().begin();
 
-  while(itr != flowTracker->flows_set.end()) 
+  while(itr != flowTracker->GetRemainingSizeOrder().end()) 
   {
-    uint32_t nid = itr->source_node;
+    uint32_t nid = itr->second->source_node;
     Ptr<Ipv4L3Protocol> ipv4 = StaticCast<Ipv4L3Protocol> ((allNodes.Get(nid))->GetObject<Ipv4> ());
-    double new_weight = flow_weight_local[itr->flow_id];
+    double new_weight = flow_weight_local[itr->second->flow_id];
     if(weight_normalized) {
       new_weight = new_weight/min_weight;
     }
-    flow_weight_local[itr->flow_id]  = new_weight;
+    flow_weight_local[itr->second->flow_id]  = new_weight;
  
-    std::cout<<Simulator::Now().GetSeconds()<<" setting weight of flow "<<itr->flow_id<<" at node "<<nid<<" to "<<new_weight<<" at "<<Simulator::Now().GetSeconds()<<std::endl;
+    std::cout<<Simulator::Now().GetSeconds()<<" setting weight of flow "<<itr->second->flow_id<<" at node "<<nid<<" to "<<new_weight<<" at "<<Simulator::Now().GetSeconds()<<std::endl;
     total_weight += new_weight;
-    ipv4->setFlowWeight(itr->flow_id, new_weight);
-    flowweights[itr->flow_id] = new_weight;
+    ipv4->setFlowWeight(itr->second->flow_id, new_weight);
+    flowweights[itr->second->flow_id] = new_weight;
 
-    if(itr->flow_running) {
+    if(itr->second->flow_running) {
       //nothing to do
       itr++;
       continue;
     } else {
-      startFlowEvent(itr->source_node, itr->dest_node, Simulator::Now().GetSeconds(), itr->flow_size, itr->flow_id, flow_weight_local[itr->flow_id], itr->flow_tcp, itr->flow_known);
-      itr->flow_running = true;
+      startFlowEvent(itr->second->source_node, itr->second->dest_node, Simulator::Now().GetSeconds(), itr->second->flow_size, itr->second->flow_id, flow_weight_local[itr->second->flow_id], itr->second->flow_tcp, itr->second->flow_known);
+      itr->second->flow_running = true;
     }
     itr++;
   } //end flows_set
@@ -589,21 +578,21 @@ void run_scheduler(FlowData fdata, uint32_t eventType)
    std::cout<<"BASE RATE "<<Simulator::Now().GetSeconds()<<" "<<(1.0/total_weight)*link_rate<<std::endl; 
    // get the right allocation of rates - another loop
    //
-  itr = flowTracker->flows_set.begin();
+  itr = flowTracker->GetRemainingSizeOrder().begin();
 
-  while(itr != flowTracker->flows_set.end()) 
+  while(itr != flowTracker->GetRemainingSizeOrder().end()) 
   {
-    uint32_t nid = itr->source_node;
+    uint32_t nid = itr->second->source_node;
     Ptr<Ipv4L3Protocol> ipv4 = StaticCast<Ipv4L3Protocol> ((allNodes.Get(nid))->GetObject<Ipv4> ());
 
-    uint32_t fid = itr->flow_id;
+    uint32_t fid = itr->second->flow_id;
     double weight = flow_weight_local[fid];
 
     double rate = (weight/total_weight) * (1 - controller_estimated_unknown_load) * link_rate;
     
     if(weight_change == 0) { // UDP with rate control
        Ptr<MyApp> local_SendingApp;
-       for(uint32_t aIndx=0; aIndx< (allNodes.Get(itr->source_node))->GetNApplications(); aIndx++) { // check all apps on this node
+       for(uint32_t aIndx=0; aIndx< (allNodes.Get(itr->second->source_node))->GetNApplications(); aIndx++) { // check all apps on this node
           local_SendingApp = StaticCast <MyApp> ( (allNodes.Get(nid))->GetApplication(aIndx) ); 
          //  if((rate_based == 0) && (local_SendingApp->getFlowId() == fid)) { //if this is the app associated with this fid, change data rate
            //    local_SendingApp ->ChangeRate(DataRate (rate) ); 
@@ -611,7 +600,7 @@ void run_scheduler(FlowData fdata, uint32_t eventType)
         } // end for
      }
      std::cout<<"TrueRate "<<Simulator::Now().GetSeconds()<<" "<<fid<<" "<<rate<<" weight "<<weight<<" totalweight "<<total_weight<<std::endl;
-     std::cout<<" setting realrate "<<rate<<" for flow "<<fid<<" in node "<<itr->source_node<<std::endl;
+     std::cout<<" setting realrate "<<rate<<" for flow "<<fid<<" in node "<<itr->second->source_node<<std::endl;
         
      ipv4->setFlowIdealRate(fid, rate);
     itr++;
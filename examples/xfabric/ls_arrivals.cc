@@ -32,10 +32,8 @@ uint32_t max_flows_allowed = 20;
 
 void dropFlowFromQueues(uint32_t f)
 {
-    for(uint32_t i=0; i<AllQueues.size(); i++) {
-      Ptr<Queue> q = AllQueues[i];
-      StaticCast<PrioQueue> (q)->dropFlowPackets(flowkeys[f]);
-    }
+    // only the queues that carried the flow hold its packets
+    PrioQueue::PurgeFlow(flowkeys[f]);
 }
     
 
@@ -50,21 +48,7 @@ void createTopology(void)
 {
 
   std::cout<<"Creating "<<num_spines<<" spines "<<num_leafs<<" leaves "<<num_hosts_per_leaf<<" hosts  per leaf "<<std::endl;
-  hosts.Create(num_hosts_per_leaf*num_leafs);
-  leafnodes.Create(num_leafs);
-  spines.Create(num_spines);
-  
-  ports = new uint16_t [hosts.GetN()];
-   
-  for (uint32_t i=0; i <hosts.GetN(); i++) {
-    ports[i] = 1;
-  }
-  allNodes = NodeContainer (hosts,  leafnodes, spines);
-  InternetStackHelper internet;
-  internet.Install (allNodes);
 
-  // We create the channels first without any IP addressing information
-  //
   // Queue, Channel and link characteristics
   NS_LOG_INFO ("Create channels.");
   PointToPointHelper fabriclink;
@@ -78,55 +62,21 @@ void createTopology(void)
 
   if(queue_type == "WFQ") {
     std::cout<<"setting queue to WFQ"<<std::endl;
-    fabriclink.SetQueue("ns3::PrioQueue", "pFabric", StringValue("1"),"DataRate", StringValue(fabric_datarate), "MaxBytes", UintegerValue(max_queue_size), "Mode", StringValue("QUEUE_MODE_BYTES"));
-    edgelink.SetQueue("ns3::PrioQueue", "pFabric", StringValue("1"),"DataRate", StringValue(edge_datarate), "MaxBytes", UintegerValue(max_queue_size), "Mode", StringValue("QUEUE_MODE_BYTES"));
+    fabriclink.SetQueue(prioQueueType(), "pFabric", StringValue("1"),"DataRate", StringValue(fabric_datarate), "MaxBytes", UintegerValue(max_queue_size), "Mode", StringValue("QUEUE_MODE_BYTES"));
+    edgelink.SetQueue(prioQueueType(), "pFabric", StringValue("1"),"DataRate", StringValue(edge_datarate), "MaxBytes", UintegerValue(max_queue_size), "Mode", StringValue("QUEUE_MODE_BYTES"));
   }
 
-  // Create links between all sourcenodes and bottleneck switch
-  //
-  std::vector<NetDeviceContainer> fabric_devs;
-  std::vector<NetDeviceContainer> edge_devs;
-
-  std::cout<<"Creating fabric links.."<<std::endl;
-
-  for(uint32_t sidx = 0; sidx < spines.GetN(); sidx++) {
-    for(uint32_t lidx = 0; lidx < leafnodes.GetN(); lidx++) {
-      NetDeviceContainer net_dev = fabriclink.Install(spines.Get(sidx), leafnodes.Get(lidx));
-      fabric_devs.push_back(net_dev);
-
-      // debug information
-      printlink(spines.Get(sidx), leafnodes.Get(lidx));
-      Ptr<PointToPointNetDevice> ptr1(dynamic_cast<PointToPointNetDevice*>(PeekPointer(net_dev.Get(0))));
-      std::cout<<" fabric link datarate "<<ptr1->GetDataRate()<<std::endl;
-      
-    }
-  }
-
-  std::cout<<"Creating edge links.."<<std::endl;
-
-  
-  for(uint32_t lidx = 0; lidx < leafnodes.GetN(); lidx++) {
-    uint32_t start_index = lidx * num_hosts_per_leaf;
-    for(uint32_t hidx = start_index; hidx < start_index + num_hosts_per_leaf; hidx++) {
-      NetDeviceContainer net_dev = edgelink.Install(leafnodes.Get(lidx), hosts.Get(hidx));
-      edge_devs.push_back(net_dev);
-      // debug information
-      printlink(leafnodes.Get(lidx), hosts.Get(hidx));
-      Ptr<PointToPointNetDevice> ptr1(dynamic_cast<PointToPointNetDevice*>(PeekPointer(net_dev.Get(0))));
-      std::cout<<" edge link datarate "<<ptr1->GetDataRate()<<std::endl;
-      
-    }
-  }
-
-  uint32_t cur_subnet = 0;
+  // nodes are created hosts, leaves, spines: node ids keep that order
+  ClosTopologyHelper clos(num_spines, num_leafs, num_hosts_per_leaf, fabriclink, edgelink);
+  hosts = clos.GetHosts();
+  leafnodes = clos.GetLeaves();
+  spines = clos.GetSpines();
+  allNodes = NodeContainer (hosts,  leafnodes, spines);
+  clos.InstallStack(InternetStackHelper());
+  clos.AssignIpv4Addresses(Ipv4FabricAddressHelper());
 
   for (uint32_t index=0; index<2; index++) {
-    std::vector<NetDeviceContainer> dev_cont;
-    if(index == 0) {
-      dev_cont = fabric_devs;
-    } else if (index==1) {
-      dev_cont = edge_devs;
-    }
+    const std::vector<NetDeviceContainer> &dev_cont = (index == 0) ? clos.GetFabricLinks() : clos.GetEdgeLinks();
 
     for(uint32_t i=0; i < dev_cont.size(); ++i)
     {
@@ -163,16 +113,11 @@ void createTopology(void)
 
      Simulator::Schedule (Seconds (1.0), &CheckQueueSize, queue);
      Simulator::Schedule (Seconds (1.0), &CheckQueueSize, queue1);
-     
-
-     // assign ip address
-     assignAddress(dev_cont[i], cur_subnet);
-     cur_subnet++;
    }
   }
 
-  //Turn on global static routing
-  Ipv4GlobalRoutingHelper::PopulateRoutingTables ();
+  // ECMP routes straight from the fabric structure, one per leaf
+  clos.PopulateRoutes();
 }
 
 void setQFlows()
@@ -196,16 +141,16 @@ void setQFlows()
 Ptr<MyApp> startFlow(uint32_t sourceN, uint32_t sinkN, double flow_start, uint32_t flow_size, uint32_t flow_id, uint32_t rand_weight)
 {
 
-    ports[sinkN]++;
+    uint16_t port = allocatePort(sinkN);
     Ptr<Ipv4L3Protocol> sink_node_ipv4 = StaticCast<Ipv4L3Protocol> ((sinkNodes.Get(sinkN))->GetObject<Ipv4> ());
     Ipv4Address remoteIp = sink_node_ipv4->GetAddress (1,0).GetLocal();
-    Address remoteAddress = (InetSocketAddress (remoteIp, ports[sinkN]));
+    Address remoteAddress = (InetSocketAddress (remoteIp, port));
     Ptr<Ipv4> source_node_ipv4 = (sourceNodes.Get(sourceN))->GetObject<Ipv4> (); 
     Ipv4Address sourceIp = source_node_ipv4->GetAddress (1,0).GetLocal();
-    Address sourceAddress = (InetSocketAddress (sourceIp, ports[sinkN]));
+    Address sourceAddress = (InetSocketAddress (sourceIp, port));
     // Socket at the source
-    //sinkInstallNode(sourceN, sinkN, ports[sinkN], flow_id, flow_start, flow_size, clientNodes);
-    sinkInstallNode(sourceN, sinkN, ports[sinkN], flow_id, flow_start, flow_size, 1);
+    //sinkInstallNode(sourceN, sinkN, port, flow_id, flow_start, flow_size, clientNodes);
+    sinkInstallNode(sourceN, sinkN, port, flow_id, flow_start, flow_size, 1);
 
 
     Ptr<MyApp> SendingApp = CreateObject<MyApp> ();
@@ -217,18 +162,18 @@ Ptr<MyApp> startFlow(uint32_t sourceN, uint32_t sinkN, double flow_start, uint32
     (source_flow[(sourceNodes.Get(sourceN))->GetId()]).push_back(flow_id);
     (dest_flow[(sinkNodes.Get(sinkN))->GetId()]).push_back(flow_id);
     std::stringstream ss;
-    ss<<addr<<":"<<remoteIp<<":"<<ports[sinkN];
+    ss<<addr<<":"<<remoteIp<<":"<<port;
     std::string s = ss.str(); 
     flowids[s] = flow_id;
     flowkeys[flow_id] = s;
 
-    //flow_dest_port[clientNodes.Get(sourceN)->GetId()] = ports[sinkN];
+    //flow_dest_port[clientNodes.Get(sourceN)->GetId()] = port;
     //
 
     ipv4->setFlow(s, flow_id, flow_size, rand_weight);
     sink_node_ipv4->setFlow(s, flow_id, flow_size, rand_weight);
       
-  std::cout<<"FLOW_INFO source_node "<<(sourceNodes.Get(sourceN))->GetId()<<" sink_node "<<(sinkNodes.Get(sinkN))->GetId()<<" "<<addr<<":"<<remoteIp<<" flow_id "<<flow_id<<" start_time "<<flow_start<<" dest_port "<<ports[sinkN]<<" flow_size "<<flow_size<<" "<<rand_weight<<std::endl;
+  std::cout<<"FLOW_INFO source_node "<<(sourceNodes.Get(sourceN))->GetId()<<" sink_node "<<(sinkNodes.Get(sinkN))->GetId()<<" "<<addr<<":"<<remoteIp<<" flow_id "<<flow_id<<" start_time "<<flow_start<<" dest_port "<<port<<" flow_size "<<flow_size<<" "<<rand_weight<<std::endl;
   //flow_id++;
   return SendingApp;
 }
@@ -394,7 +339,7 @@ void startflowwrapper( std::vector<uint32_t> sourcenodes, std::vector<uint32_t>
   double delay = 0.01;
   //if(num_flows < number_flows) { delay = 0.0;}
   epoch_number++;
-  ninety_fifth = 0;
+  flowConvergence->Reset();
   next_epoch_event = Simulator::Schedule (Seconds (delay), &startflowwrapper, sourcenodes, sinknodes);
 }
 
@@ -455,6 +400,10 @@ main(int argc, char *argv[])
 //  rocket_createTopology();
   
   createTopology();
+  // with --sweep_file the sweep points run in forked workers, see runSweep
+  if(!runSweep(cmd)) {
+    return 0;
+  }
   setUpTraffic();
   setUpMonitoring();
 
@@ -101,29 +101,36 @@ MyApp::StartApplication (void)
   m_packetsSent = 0;
   m_totBytes = 0;
 
-  Ptr<Socket> ns3TcpSocket;
-  if(m_udp) {
-    ns3TcpSocket = Socket::CreateSocket (srcNode, UdpSocketFactory::GetTypeId());
+  uint16_t local_port;
+  bool fluid_flow = fluidFlow(m_fid);
+  if(fluid_flow) {
+    // a fluid flow has no socket, it only needs a port to be hashed by ECMP
+    local_port = 49152 + m_fid % 16384;
   } else {
-    ns3TcpSocket = Socket::CreateSocket (srcNode, TcpSocketFactory::GetTypeId ());
-    Ptr<TcpNewReno> nReno = StaticCast<TcpNewReno> (ns3TcpSocket);
-  }
-  //setuptracing(m_fid, ns3TcpSocket);
-  m_socket = ns3TcpSocket;
-  if (InetSocketAddress::IsMatchingType (m_peer))
-  { 
-    //NS_LOG_UNCOND("flow_start "<<m_fid<<" time "<<(Simulator::Now()).GetSeconds());
-    //m_socket->Bind (myAddress);
-    m_socket->Bind ();
-  }
-  else
-  {
-    m_socket->Bind6 ();
-  }
-  m_socket->Connect (m_peer);
-    
+    Ptr<Socket> ns3TcpSocket;
+    if(m_udp) {
+      ns3TcpSocket = Socket::CreateSocket (srcNode, UdpSocketFactory::GetTypeId());
+    } else {
+      ns3TcpSocket = Socket::CreateSocket (srcNode, TcpSocketFactory::GetTypeId ());
+      Ptr<TcpNewReno> nReno = StaticCast<TcpNewReno> (ns3TcpSocket);
+    }
+    //setuptracing(m_fid, ns3TcpSocket);
+    m_socket = ns3TcpSocket;
+    if (InetSocketAddress::IsMatchingType (m_peer))
+    { 
+      //NS_LOG_UNCOND("flow_start "<<m_fid<<" time "<<(Simulator::Now()).GetSeconds());
+      //m_socket->Bind (myAddress);
+      m_socket->Bind ();
+    }
+    else
+    {
+      m_socket->Bind6 ();
+    }
+    m_socket->Connect (m_peer);
+
 
-  uint16_t local_port = StaticCast<TcpSocketBase>(ns3TcpSocket)->m_endPoint->GetLocalPort();
+    local_port = StaticCast<TcpSocketBase>(ns3TcpSocket)->m_endPoint->GetLocalPort();
+  }
 
   uint32_t tcp_protocol_number = 6;
 
@@ -137,8 +144,11 @@ MyApp::StartApplication (void)
 
 //std::cout<<"flow_start "<<m_fid<<" start_time "<<Simulator::Now().GetNanoSeconds()<<" flow_size "<<m_maxBytes<<" "<<srcNode->GetId()<<" "<<destNode->GetId()<<" port "<< InetSocketAddress::ConvertFrom (m_peer).GetPort () <<" "<<m_weight<<" "<<ecmp_hash_value<<" "<<std::endl;
   std::cout<<"flow_start "<<m_fid<<" start_time "<<Simulator::Now().GetNanoSeconds()<<" flow_size "<<m_maxBytes<<" "<<srcNode->GetId()<<" "<<destNode->GetId() <<" "<<m_weight<<" "<<ecmp_hash_value<<" "<<std::endl;
+  flowStarted(m_fid, srcNode, InetSocketAddress::ConvertFrom(myAddress).GetIpv4(), InetSocketAddress::ConvertFrom(m_peer).GetIpv4(), local_port, InetSocketAddress::ConvertFrom(m_peer).GetPort(), m_maxBytes, m_weight);
   
-  SendPacket ();
+  if(!fluid_flow) {
+    SendPacket ();
+  }
   //FlowData dt(m_fid, m_maxBytes, flow_known, srcNode->GetId(), destNode->GetId(), fweight);
   //flowTracker->registerEvent(1);
 }
@@ -168,6 +178,10 @@ MyApp::StopApplication (void)
 //  ipv4->addToDropList(m_fid);
 
   std::cout<<Simulator::Now().GetSeconds()<<" flowid "<<m_fid<<" stopped sending after sending "<<m_totBytes<<std::endl;
+  // finite flows leave the oracle when the sink has received everything
+  if(m_maxBytes == 0) {
+    flowStopped(m_fid);
+  }
 }
 
 bool
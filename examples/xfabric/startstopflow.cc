@@ -56,17 +56,17 @@ uint32_t global_flowid = 0;
 
 Ptr<MyApp> startFlow(uint32_t sourceN, uint32_t sinkN, double flow_start, uint32_t flow_size, uint32_t flow_id)
 {
-  ports[sinkN]++;
+  uint16_t port = allocatePort(sinkN);
   // Socket at the source
   Ptr<Ipv4L3Protocol> sink_node_ipv4 = StaticCast<Ipv4L3Protocol> ((clientNodes.Get(sinkN))->GetObject<Ipv4> ());
   Ipv4Address remoteIp = sink_node_ipv4->GetAddress (1,0).GetLocal();
-  Address remoteAddress = (InetSocketAddress (remoteIp, ports[sinkN]));
-  sinkInstallNode(sourceN, sinkN, ports[sinkN], flow_id, flow_start, flow_size, 1);
+  Address remoteAddress = (InetSocketAddress (remoteIp, port));
+  sinkInstallNode(sourceN, sinkN, port, flow_id, flow_start, flow_size, 1);
 
   // Get source address
   Ptr<Ipv4> source_node_ipv4 = (clientNodes.Get(sourceN))->GetObject<Ipv4> (); 
   Ipv4Address sourceIp = source_node_ipv4->GetAddress (1,0).GetLocal();
-  Address sourceAddress = (InetSocketAddress (sourceIp, ports[sinkN]));
+  Address sourceAddress = (InetSocketAddress (sourceIp, port));
 
   Ptr<MyApp> SendingApp = CreateObject<MyApp> ();
   SendingApp->Setup (remoteAddress, pkt_size, DataRate (link_rate_string), flow_size, flow_start, sourceAddress, clientNodes.Get(sourceN), flow_id, clientNodes.Get(sinkN), 1, 1);
@@ -78,13 +78,13 @@ Ptr<MyApp> startFlow(uint32_t sourceN, uint32_t sinkN, double flow_start, uint32
   (source_flow[(clientNodes.Get(sourceN))->GetId()]).push_back(flow_id);
   (dest_flow[(clientNodes.Get(sinkN))->GetId()]).push_back(flow_id);
   std::stringstream ss;
-  ss<<addr<<":"<<remoteIp<<":"<<ports[sinkN];
+  ss<<addr<<":"<<remoteIp<<":"<<port;
   std::string s = ss.str(); 
   flowids[s] = flow_id;
 
   ipv4->setFlow(s, flow_id, flow_size, 1.0);
   sink_node_ipv4->setFlow(s, flow_id, flow_size, 1.0);
-  std::cout<<"FLOW_INFO source_node "<<(clientNodes.Get(sourceN))->GetId()<<" sink_node "<<(clientNodes.Get(sinkN))->GetId()<<" "<<addr<<":"<<remoteIp<<" flow_id "<<flow_id<<" start_time "<<flow_start<<" dest_port "<<ports[sinkN]<<" flow_size "<<flow_size<<" "<<std::endl;
+  std::cout<<"FLOW_INFO source_node "<<(clientNodes.Get(sourceN))->GetId()<<" sink_node "<<(clientNodes.Get(sinkN))->GetId()<<" "<<addr<<":"<<remoteIp<<" flow_id "<<flow_id<<" start_time "<<flow_start<<" dest_port "<<port<<" flow_size "<<flow_size<<" "<<std::endl;
   //flow_id++;
   return SendingApp;
 }
@@ -195,12 +195,12 @@ void createTopology()
   PointToPointHelper p2paccess;
   p2paccess.SetDeviceAttribute ("DataRate", StringValue (link_rate_string));
   p2paccess.SetChannelAttribute ("Delay", TimeValue(MicroSeconds(link_delay)));
-  p2paccess.SetQueue("ns3::PrioQueue", "pFabric", StringValue("1"), "DataRate", StringValue(link_rate_string));
+  p2paccess.SetQueue(prioQueueType(), "pFabric", StringValue("1"), "DataRate", StringValue(link_rate_string));
 
   PointToPointHelper p2pbottleneck;
   p2pbottleneck.SetDeviceAttribute ("DataRate", StringValue (link_rate_string));
   p2pbottleneck.SetChannelAttribute ("Delay", TimeValue(MicroSeconds(link_delay)));
-  p2pbottleneck.SetQueue("ns3::PrioQueue", "pFabric", StringValue("1"),"DataRate", StringValue(link_rate_string));
+  p2pbottleneck.SetQueue(prioQueueType(), "pFabric", StringValue("1"),"DataRate", StringValue(link_rate_string));
 
 
 
@@ -332,11 +332,6 @@ void createTopology()
     cur_subnet++;
   }
   
-   ports = new uint16_t [clientNodes.GetN()];
-   for (uint32_t i=0; i <clientNodes.GetN(); i++) {
-       ports[i] = 1;
-   }
-
   //Turn on global static routing
   Ipv4GlobalRoutingHelper::PopulateRoutingTables ();
 
@@ -83,6 +83,8 @@ PacketSink::GetTypeId (void)
 
     .AddTraceSource ("Rx", "A packet has been received",
                      MakeTraceSourceAccessor (&PacketSink::m_rxTrace))
+    .AddTraceSource ("Finished", "The flow received all its numBytes; passes the flow id",
+                     MakeTraceSourceAccessor (&PacketSink::m_finishedTrace))
   ;
   return tid;
 }
@@ -246,6 +248,7 @@ void PacketSink::HandleRead (Ptr<Socket> socket)
           if(!flow_finished) {
             GetTotalRx();
             StopApplication();
+            m_finishedTrace(m_flowID);
           }
         } 
       //} 
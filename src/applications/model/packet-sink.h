@@ -147,6 +147,8 @@ private:
 
   /// Traced Callback: received packets, source address.
   TracedCallback<Ptr<const Packet>, const Address &> m_rxTrace;
+  /// Traced Callback: the flow is complete, flow id.
+  TracedCallback<uint32_t> m_finishedTrace;
 
 
 };
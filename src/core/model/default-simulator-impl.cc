@@ -22,6 +22,7 @@
 #include "default-simulator-impl.h"
 #include "scheduler.h"
 #include "event-impl.h"
+#include "event-profiler.h"
 
 #include "ptr.h"
 #include "pointer.h"
@@ -29,6 +30,7 @@
 #include "log.h"
 
 #include <cmath>
+#include <iostream>
 
 // Note:  Logging in this file is largely avoided due to the
 // number of calls that are made to these functions and the possibility
@@ -66,6 +68,7 @@ DefaultSimulatorImpl::DefaultSimulatorImpl ()
   m_unscheduledEvents = 0;
   m_eventsWithContextEmpty = true;
   m_main = SystemThread::Self();
+  EventProfiler::EnableFromGlobalValue ();
 }
 
 DefaultSimulatorImpl::~DefaultSimulatorImpl ()
@@ -99,6 +102,11 @@ DefaultSimulatorImpl::Destroy ()
           ev->Invoke ();
         }
     }
+  if (EventProfiler::IsEnabled ())
+    {
+      EventProfiler::Report (std::cerr);
+      EventProfiler::Enable (false);
+    }
 }
 
 void
@@ -137,7 +145,14 @@ DefaultSimulatorImpl::ProcessOneEvent (void)
   m_currentTs = next.key.m_ts;
   m_currentContext = next.key.m_context;
   m_currentUid = next.key.m_uid;
-  next.impl->Invoke ();
+  if (EventProfiler::IsEnabled ())
+    {
+      EventProfiler::Invoke (next.impl, static_cast<uint32_t> (m_unscheduledEvents));
+    }
+  else
+    {
+      next.impl->Invoke ();
+    }
   next.impl->Unref ();
 
   ProcessEventsWithContext ();
@@ -185,6 +200,8 @@ DefaultSimulatorImpl::Run (void)
   NS_LOG_FUNCTION (this);
   // Set the current threadId as the main threadId
   m_main = SystemThread::Self();
+  // the GlobalValue may have been set after the simulator was created
+  EventProfiler::EnableFromGlobalValue ();
   ProcessEventsWithContext ();
   m_stop = false;
 
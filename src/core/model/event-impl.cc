@@ -31,7 +31,8 @@ EventImpl::~EventImpl ()
 }
 
 EventImpl::EventImpl ()
-  : m_cancel (false)
+  : m_cancel (false),
+    m_profileLabel (0)
 {
   NS_LOG_FUNCTION (this);
 }
@@ -60,4 +61,16 @@ EventImpl::IsCancelled (void)
   return m_cancel;
 }
 
+void
+EventImpl::SetProfileLabel (uint32_t label)
+{
+  m_profileLabel = label;
+}
+
+uint32_t
+EventImpl::GetProfileLabel (void) const
+{
+  return m_profileLabel;
+}
+
 } // namespace ns3
@@ -57,12 +57,21 @@ public:
    * Invoked by the simulation engine before calling Invoke.
    */
   bool IsCancelled (void);
+  /**
+   * \param label the callback of the event, see EventProfiler
+   */
+  void SetProfileLabel (uint32_t label);
+  /**
+   * \returns the callback of the event, 0 if it has none
+   */
+  uint32_t GetProfileLabel (void) const;
 
 protected:
   virtual void Notify (void) = 0;
 
 private:
   bool m_cancel;
+  uint32_t m_profileLabel;
 };
 
 } // namespace ns3
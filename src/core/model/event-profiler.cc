@@ -0,0 +1,297 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+
+#include "ns3/core-config.h"
+#include "event-profiler.h"
+#include "simulator.h"
+#include "global-value.h"
+#include "boolean.h"
+#include "log.h"
+
+#include <map>
+#include <vector>
+#include <string>
+#include <sstream>
+#include <iomanip>
+#include <algorithm>
+#include <cstdlib>
+#include <ctime>
+#include <cxxabi.h>
+#ifdef HAVE_DLFCN_H
+#include <dlfcn.h>
+#endif
+#if defined (__x86_64__) || defined (__i386__)
+#include <x86intrin.h>
+#endif
+
+NS_LOG_COMPONENT_DEFINE ("EventProfiler");
+
+namespace ns3 {
+
+static GlobalValue g_eventProfile = GlobalValue ("EventProfile",
+                                                 "Profile the wall-clock time spent in each event "
+                                                 "callback, reported at Simulator::Destroy",
+                                                 BooleanValue (false),
+                                                 MakeBooleanChecker ());
+
+bool EventProfiler::m_enabled = false;
+uint64_t EventProfiler::m_allocations = 0;
+
+namespace {
+
+struct Entry
+{
+  const std::type_info *type;
+  const void *code;
+  uint64_t count;
+  uint64_t cycles;
+  uint64_t allocations;
+};
+
+// a resolved callback is keyed by its code, others by their raw pointer
+struct LabelKey
+{
+  const void *code;
+  std::string type;
+  std::string raw;
+  bool operator < (const LabelKey &o) const
+  {
+    if (code != o.code)
+      {
+        return code < o.code;
+      }
+    if (type != o.type)
+      {
+        return type < o.type;
+      }
+    return raw < o.raw;
+  }
+};
+
+struct Sample
+{
+  Time time;
+  uint32_t pending;
+};
+
+// keep at most this many samples of the pending events, halving their
+// rate whenever it is reached
+const uint32_t MAX_SAMPLES = 64;
+
+std::vector<Entry> g_entries;
+std::map<LabelKey, uint32_t> g_labelIds;
+std::vector<Sample> g_samples;
+uint64_t g_events = 0;
+uint64_t g_sampleEvery = 1024;
+uint64_t g_pendingSum = 0;
+uint32_t g_pendingMax = 0;
+
+uint64_t
+ReadCycles (void)
+{
+#if defined (__x86_64__) || defined (__i386__)
+  return __rdtsc ();
+#else
+  struct timespec ts;
+  clock_gettime (CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+#endif
+}
+
+std::string
+Demangle (const char *name)
+{
+  int status;
+  char *demangled = abi::__cxa_demangle (name, 0, 0, &status);
+  if (demangled == 0)
+    {
+      return name;
+    }
+  std::string result = demangled;
+  std::free (demangled);
+  return result;
+}
+
+std::string
+GetName (const Entry &entry)
+{
+  if (entry.type == 0)
+    {
+      return "(unlabelled)";
+    }
+#ifdef HAVE_DLFCN_H
+  Dl_info info;
+  if (entry.code != 0 && dladdr (entry.code, &info) != 0 && info.dli_sname != 0)
+    {
+      return Demangle (info.dli_sname);
+    }
+#endif
+  // not exported, e.g. a function of the program itself
+  std::ostringstream oss;
+  oss << Demangle (entry.type->name ());
+  if (entry.code != 0)
+    {
+      oss << " @" << entry.code;
+    }
+  return oss.str ();
+}
+
+bool
+ByCycles (const Entry *a, const Entry *b)
+{
+  return a->cycles > b->cycles;
+}
+
+} // anonymous namespace
+
+void
+EventProfiler::Enable (bool enable)
+{
+  NS_LOG_FUNCTION (enable);
+  if (enable && !m_enabled)
+    {
+      Reset ();
+    }
+  m_enabled = enable;
+}
+
+void
+EventProfiler::EnableFromGlobalValue (void)
+{
+  BooleanValue enable;
+  g_eventProfile.GetValue (enable);
+  if (enable.Get ())
+    {
+      Enable (true);
+    }
+}
+
+uint32_t
+EventProfiler::GetLabel (const std::type_info &type, const void *raw, uint32_t size, const void *code)
+{
+  // every labelled event was just allocated
+  NoteAllocation ();
+  LabelKey key;
+  key.code = code;
+  if (code == 0)
+    {
+      key.type = type.name ();
+      key.raw.assign (static_cast<const char *> (raw), size);
+    }
+  std::map<LabelKey, uint32_t>::iterator it = g_labelIds.find (key);
+  if (it != g_labelIds.end ())
+    {
+      return it->second;
+    }
+  Entry entry;
+  entry.type = &type;
+  entry.code = code;
+  entry.count = entry.cycles = entry.allocations = 0;
+  uint32_t id = g_entries.size ();
+  g_entries.push_back (entry);
+  g_labelIds[key] = id;
+  return id;
+}
+
+void
+EventProfiler::Invoke (EventImpl *event, uint32_t pending)
+{
+  uint32_t id = event->GetProfileLabel ();
+  if (id >= g_entries.size ())
+    {
+      // labelled before a Reset
+      id = 0;
+    }
+  uint64_t allocations = m_allocations;
+  uint64_t start = ReadCycles ();
+  event->Invoke ();
+  uint64_t cycles = ReadCycles () - start;
+
+  Entry &entry = g_entries[id];
+  entry.count++;
+  entry.cycles += cycles;
+  entry.allocations += m_allocations - allocations;
+
+  g_pendingSum += pending;
+  g_pendingMax = std::max (g_pendingMax, pending);
+  if (++g_events % g_sampleEvery == 0)
+    {
+      if (g_samples.size () == MAX_SAMPLES)
+        {
+          for (uint32_t i = 0; i < MAX_SAMPLES / 2; i++)
+            {
+              g_samples[i] = g_samples[2 * i + 1];
+            }
+          g_samples.resize (MAX_SAMPLES / 2);
+          g_sampleEvery *= 2;
+        }
+      if (g_events % g_sampleEvery == 0)
+        {
+          Sample sample;
+          sample.time = Simulator::Now ();
+          sample.pending = pending;
+          g_samples.push_back (sample);
+        }
+    }
+}
+
+void
+EventProfiler::Report (std::ostream &os)
+{
+  std::vector<const Entry *> sorted;
+  uint64_t total = 0;
+  for (uint32_t i = 0; i < g_entries.size (); i++)
+    {
+      if (g_entries[i].count > 0)
+        {
+          sorted.push_back (&g_entries[i]);
+          total += g_entries[i].cycles;
+        }
+    }
+  std::sort (sorted.begin (), sorted.end (), ByCycles);
+  std::ios_base::fmtflags flags = os.flags ();
+  std::streamsize precision = os.precision ();
+
+  os << "EventProfile events " << g_events << " cycles " << total
+     << " pending_max " << g_pendingMax
+     << " pending_mean " << (g_events > 0 ? (double) g_pendingSum / g_events : 0.0) << std::endl;
+  os << "EventProfile " << std::setw (6) << "share" << std::setw (14) << "calls"
+     << std::setw (14) << "cycles/call" << std::setw (12) << "allocs/call" << "  callback" << std::endl;
+  for (uint32_t i = 0; i < sorted.size (); i++)
+    {
+      const Entry &entry = *sorted[i];
+      os << "EventProfile " << std::fixed << std::setprecision (1)
+         << std::setw (5) << (total > 0 ? 100.0 * entry.cycles / total : 0.0) << "%"
+         << std::setw (14) << entry.count
+         << std::setw (14) << std::setprecision (0) << (double) entry.cycles / entry.count
+         << std::setw (12) << std::setprecision (2) << (double) entry.allocations / entry.count
+         << "  " << GetName (entry) << std::endl;
+    }
+  os.flags (flags);
+  os.precision (precision);
+  for (uint32_t i = 0; i < g_samples.size (); i++)
+    {
+      os << "EventProfile pending " << g_samples[i].time.GetSeconds ()
+         << " " << g_samples[i].pending << std::endl;
+    }
+}
+
+void
+EventProfiler::Reset (void)
+{
+  NS_LOG_FUNCTION_NOARGS ();
+  g_entries.clear ();
+  g_labelIds.clear ();
+  g_samples.clear ();
+  g_events = 0;
+  g_sampleEvery = 1024;
+  g_pendingSum = 0;
+  g_pendingMax = 0;
+  // label 0 collects the events made without a label
+  Entry unlabelled;
+  unlabelled.type = 0;
+  unlabelled.code = 0;
+  unlabelled.count = unlabelled.cycles = unlabelled.allocations = 0;
+  g_entries.push_back (unlabelled);
+}
+
+} // namespace ns3
@@ -0,0 +1,140 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+
+#ifndef EVENT_PROFILER_H
+#define EVENT_PROFILER_H
+
+#include <stdint.h>
+#include <cstring>
+#include <ostream>
+#include <typeinfo>
+#include "event-impl.h"
+#include "type-traits.h"
+
+namespace ns3 {
+
+/**
+ * \ingroup simulator
+ *
+ * \brief Wall-clock profile of the simulation events, by callback.
+ *
+ * Off unless the "EventProfile" GlobalValue is true when the simulator
+ * implementation is created or Simulator::Run is called, e.g. with
+ * --EventProfile=1 on the command line or NS_GLOBAL_VALUE=EventProfile=1;
+ * events scheduled before then are reported as unlabelled.  Once enabled, MakeEvent labels
+ * every event with its callback (the member function or function pointer,
+ * a virtual member resolved on the object it is scheduled on) and
+ * DefaultSimulatorImpl runs each event through Invoke, which accounts its
+ * invocations, cycles (TSC where available, nanoseconds otherwise) and the
+ * events and packets allocated while it ran, and samples the number of
+ * pending events.  Simulator::Destroy prints the callbacks sorted by
+ * cycles, named through the dynamic symbol table when they are exported.
+ * Functions the compiler folded into one are reported under one name.
+ *
+ * When disabled, labelling costs a test of a static flag per event and a
+ * counter increment per event or packet created.
+ */
+class EventProfiler
+{
+public:
+  static bool IsEnabled (void);
+  static void Enable (bool enable);
+  /** Enable the profiler if the "EventProfile" GlobalValue is true. */
+  static void EnableFromGlobalValue (void);
+
+  /** Label event with a call of mem_ptr on obj. */
+  template <typename MEM, typename T>
+  static void Label (EventImpl *event, MEM mem_ptr, T *obj);
+  /** Label event with a call of f. */
+  template <typename F>
+  static void Label (EventImpl *event, F f);
+
+  /** Invoke event, accounting it to its label; pending events in queue. */
+  static void Invoke (EventImpl *event, uint32_t pending);
+  /** Count an object allocated by the running event. */
+  static void NoteAllocation (void);
+
+  static void Report (std::ostream &os);
+  static void Reset (void);
+
+private:
+  static uint32_t GetLabel (const std::type_info &type, const void *raw, uint32_t size, const void *code);
+  template <typename C, typename MEM>
+  static const void * GetCode (MEM mem_ptr, C *obj);
+
+  static bool m_enabled;
+  static uint64_t m_allocations;
+};
+
+} // namespace ns3
+
+/********************************************************************
+   Implementation of templates defined above
+ ********************************************************************/
+
+namespace ns3 {
+
+inline bool
+EventProfiler::IsEnabled (void)
+{
+  return m_enabled;
+}
+
+inline void
+EventProfiler::NoteAllocation (void)
+{
+  m_allocations++;
+}
+
+template <typename C, typename MEM>
+const void *
+EventProfiler::GetCode (MEM mem_ptr, C *obj)
+{
+#if (defined (__x86_64__) || defined (__i386__)) && defined (__GNUC__)
+  // Itanium C++ ABI: the function address, or one plus the offset of the
+  // function in the vtable of the object adjusted by adj
+  struct Itanium
+  {
+    uintptr_t ptr;
+    ptrdiff_t adj;
+  } pmf;
+  if (sizeof (mem_ptr) != sizeof (pmf))
+    {
+      return 0;
+    }
+  std::memcpy (&pmf, &mem_ptr, sizeof (pmf));
+  if ((pmf.ptr & 1) == 0)
+    {
+      return reinterpret_cast<const void *> (pmf.ptr);
+    }
+  const char *self = reinterpret_cast<const char *> (obj) + pmf.adj;
+  const char *vtable = *reinterpret_cast<const char * const *> (self);
+  return *reinterpret_cast<const void * const *> (vtable + pmf.ptr - 1);
+#else
+  return 0;
+#endif
+}
+
+template <typename MEM, typename T>
+void
+EventProfiler::Label (EventImpl *event, MEM mem_ptr, T *obj)
+{
+  typedef typename TypeTraits<MEM>::PointerToMemberTraits::ObjectType C;
+  const void *code = GetCode<const C> (mem_ptr, obj);
+  event->SetProfileLabel (GetLabel (typeid (MEM), &mem_ptr, sizeof (mem_ptr), code));
+}
+
+template <typename F>
+void
+EventProfiler::Label (EventImpl *event, F f)
+{
+  const void *code = 0;
+  if (sizeof (f) == sizeof (code))
+    {
+      std::memcpy (&code, &f, sizeof (code));
+    }
+  event->SetProfileLabel (GetLabel (typeid (F), &f, sizeof (f), code));
+}
+
+} // namespace ns3
+
+#endif /* EVENT_PROFILER_H */
@@ -29,6 +29,10 @@ protected:
 private:
     F m_function;
   } *ev = new EventFunctionImpl0 (f);
+  if (EventProfiler::IsEnabled ())
+    {
+      EventProfiler::Label (ev, f);
+    }
   return ev;
 }
 
@@ -58,6 +58,7 @@ EventImpl * MakeEvent (void (*f)(U1,U2,U3,U4,U5), T1 a1, T2 a2, T3 a3, T4 a4, T5
 
 #include "event-impl.h"
 #include "type-traits.h"
+#include "event-profiler.h"
 
 namespace ns3 {
 
@@ -96,6 +97,10 @@ private:
     OBJ m_obj;
     MEM m_function;
   } *ev = new EventMemberImpl0 (obj, mem_ptr);
+  if (EventProfiler::IsEnabled ())
+    {
+      EventProfiler::Label (ev, mem_ptr, &EventMemberImplObjTraits<OBJ>::GetReference (obj));
+    }
   return ev;
 }
 
@@ -127,6 +132,10 @@ private:
     MEM m_function;
     typename TypeTraits<T1>::ReferencedType m_a1;
   } *ev = new EventMemberImpl1 (obj, mem_ptr, a1);
+  if (EventProfiler::IsEnabled ())
+    {
+      EventProfiler::Label (ev, mem_ptr, &EventMemberImplObjTraits<OBJ>::GetReference (obj));
+    }
   return ev;
 }
 
@@ -159,6 +168,10 @@ private:
     typename TypeTraits<T1>::ReferencedType m_a1;
     typename TypeTraits<T2>::ReferencedType m_a2;
   } *ev = new EventMemberImpl2 (obj, mem_ptr, a1, a2);
+  if (EventProfiler::IsEnabled ())
+    {
+      EventProfiler::Label (ev, mem_ptr, &EventMemberImplObjTraits<OBJ>::GetReference (obj));
+    }
   return ev;
 }
 
@@ -193,6 +206,10 @@ private:
     typename TypeTraits<T2>::ReferencedType m_a2;
     typename TypeTraits<T3>::ReferencedType m_a3;
   } *ev = new EventMemberImpl3 (obj, mem_ptr, a1, a2, a3);
+  if (EventProfiler::IsEnabled ())
+    {
+      EventProfiler::Label (ev, mem_ptr, &EventMemberImplObjTraits<OBJ>::GetReference (obj));
+    }
   return ev;
 }
 
@@ -229,6 +246,10 @@ private:
     typename TypeTraits<T3>::ReferencedType m_a3;
     typename TypeTraits<T4>::ReferencedType m_a4;
   } *ev = new EventMemberImpl4 (obj, mem_ptr, a1, a2, a3, a4);
+  if (EventProfiler::IsEnabled ())
+    {
+      EventProfiler::Label (ev, mem_ptr, &EventMemberImplObjTraits<OBJ>::GetReference (obj));
+    }
   return ev;
 }
 
@@ -268,6 +289,10 @@ private:
     typename TypeTraits<T4>::ReferencedType m_a4;
     typename TypeTraits<T5>::ReferencedType m_a5;
   } *ev = new EventMemberImpl5 (obj, mem_ptr, a1, a2, a3, a4, a5);
+  if (EventProfiler::IsEnabled ())
+    {
+      EventProfiler::Label (ev, mem_ptr, &EventMemberImplObjTraits<OBJ>::GetReference (obj));
+    }
   return ev;
 }
 
@@ -297,6 +322,10 @@ private:
     F m_function;
     typename TypeTraits<T1>::ReferencedType m_a1;
   } *ev = new EventFunctionImpl1 (f, a1);
+  if (EventProfiler::IsEnabled ())
+    {
+      EventProfiler::Label (ev, f);
+    }
   return ev;
 }
 
@@ -328,6 +357,10 @@ private:
     typename TypeTraits<T1>::ReferencedType m_a1;
     typename TypeTraits<T2>::ReferencedType m_a2;
   } *ev = new EventFunctionImpl2 (f, a1, a2);
+  if (EventProfiler::IsEnabled ())
+    {
+      EventProfiler::Label (ev, f);
+    }
   return ev;
 }
 
@@ -362,6 +395,10 @@ private:
     typename TypeTraits<T2>::ReferencedType m_a2;
     typename TypeTraits<T3>::ReferencedType m_a3;
   } *ev = new EventFunctionImpl3 (f, a1, a2, a3);
+  if (EventProfiler::IsEnabled ())
+    {
+      EventProfiler::Label (ev, f);
+    }
   return ev;
 }
 
@@ -398,6 +435,10 @@ private:
     typename TypeTraits<T3>::ReferencedType m_a3;
     typename TypeTraits<T4>::ReferencedType m_a4;
   } *ev = new EventFunctionImpl4 (f, a1, a2, a3, a4);
+  if (EventProfiler::IsEnabled ())
+    {
+      EventProfiler::Label (ev, f);
+    }
   return ev;
 }
 
@@ -436,6 +477,10 @@ private:
     typename TypeTraits<T4>::ReferencedType m_a4;
     typename TypeTraits<T5>::ReferencedType m_a5;
   } *ev = new EventFunctionImpl5 (f, a1, a2, a3, a4, a5);
+  if (EventProfiler::IsEnabled ())
+    {
+      EventProfiler::Label (ev, f);
+    }
   return ev;
 }
 
@@ -126,6 +126,7 @@ private:
     enum { IsPointerToMember = 1};                //!< Pointer to member value
     enum { nArgs = 0};                            //!< Number of arguments
     typedef U ReturnType;                         //!< Return type
+    typedef V ObjectType;                         //!< Class type
   };
   template <typename U, typename V> 
   struct PtrToMemberTraits <U (V::*) (void) const>//!< Pointer to const member type traits
@@ -133,6 +134,7 @@ private:
     enum { IsPointerToMember = 1};		  //!< Pointer to member value	    
     enum { nArgs = 0};				  //!< Number of arguments	    
     typedef U ReturnType;			  //!< Return type		    
+    typedef V ObjectType;                         //!< Class type
   };
   template <typename U, typename V,typename W1> 
   struct PtrToMemberTraits <U (V::*) (W1)>        //!< Pointer to member type traits
@@ -140,6 +142,7 @@ private:
     enum { IsPointerToMember = 1};		  //!< Pointer to member value	    
     enum { nArgs = 1};				  //!< Number of arguments	    
     typedef U ReturnType;			  //!< Return type		    
+    typedef V ObjectType;                         //!< Class type
     typedef W1 Arg1Type;                          //!< First argument type
   };
   template <typename U, typename V,typename W1> 
@@ -148,6 +151,7 @@ private:
     enum { IsPointerToMember = 1};		  //!< Pointer to member value	    	  
     enum { nArgs = 1};				  //!< Number of arguments	    	  
     typedef U ReturnType;			  //!< Return type		    	  
+    typedef V ObjectType;                         //!< Class type
     typedef W1 Arg1Type;                          //!< First argument type
   };
   template <typename U, typename V,typename W1, typename W2> 
@@ -156,6 +160,7 @@ private:
     enum { IsPointerToMember = 1};		  //!< Pointer to member value	    
     enum { nArgs = 2};				  //!< Number of arguments	    
     typedef U ReturnType;			  //!< Return type		    
+    typedef V ObjectType;                         //!< Class type
     typedef W1 Arg1Type;			  //!< First argument type	    
     typedef W2 Arg2Type;			  //!< Second argument type	    
   };
@@ -165,6 +170,7 @@ private:
     enum { IsPointerToMember = 1};		     //!< Pointer to member value	    	  
     enum { nArgs = 2};				     //!< Number of arguments	    	  
     typedef U ReturnType;			     //!< Return type		    	  
+    typedef V ObjectType;                         //!< Class type
     typedef W1 Arg1Type;			     //!< First argument type		  
     typedef W2 Arg2Type;			     //!< Second argument type		  
   };
@@ -176,6 +182,7 @@ private:
     enum { IsPointerToMember = 1};		  //!< Pointer to member value	    
     enum { nArgs = 3};				  //!< Number of arguments	    
     typedef U ReturnType;			  //!< Return type		    
+    typedef V ObjectType;                         //!< Class type
     typedef W1 Arg1Type;			  //!< First argument type	    
     typedef W2 Arg2Type;			  //!< Second argument type	    
     typedef W3 Arg3Type;			  //!< Third argument type	    
@@ -188,6 +195,7 @@ private:
     enum { IsPointerToMember = 1};			//!< Pointer to member value	     
     enum { nArgs = 3};					//!< Number of arguments	    	     
     typedef U ReturnType;				//!< Return type		    	     
+    typedef V ObjectType;                         //!< Class type
     typedef W1 Arg1Type;				//!< First argument type		     
     typedef W2 Arg2Type;				//!< Second argument type		     
     typedef W3 Arg3Type;				//!< Third argument type		     
@@ -200,6 +208,7 @@ private:
     enum { IsPointerToMember = 1};		     //!< Pointer to member value	    
     enum { nArgs = 4};				     //!< Number of arguments	    
     typedef U ReturnType;			     //!< Return type		    
+    typedef V ObjectType;                         //!< Class type
     typedef W1 Arg1Type;			     //!< First argument type	    
     typedef W2 Arg2Type;			     //!< Second argument type	    
     typedef W3 Arg3Type;			     //!< Third argument type	    
@@ -213,6 +222,7 @@ private:
     enum { IsPointerToMember = 1};			   //!< Pointer to member value	     	
     enum { nArgs = 4};					   //!< Number of arguments	    	
     typedef U ReturnType;				   //!< Return type		    	
+    typedef V ObjectType;                         //!< Class type
     typedef W1 Arg1Type;				   //!< First argument type		
     typedef W2 Arg2Type;				   //!< Second argument type		
     typedef W3 Arg3Type;				   //!< Third argument type		
@@ -227,6 +237,7 @@ private:
     enum { IsPointerToMember = 1};			//!< Pointer to member value      
     enum { nArgs = 5};					//!< Number of arguments	       
     typedef U ReturnType;				//!< Return type		       
+    typedef V ObjectType;                         //!< Class type
     typedef W1 Arg1Type;				//!< First argument type	       
     typedef W2 Arg2Type;				//!< Second argument type	       
     typedef W3 Arg3Type;				//!< Third argument type	       
@@ -242,6 +253,7 @@ private:
     enum { IsPointerToMember = 1};			      //!< Pointer to member value	     	   
     enum { nArgs = 5};					      //!< Number of arguments	    	   
     typedef U ReturnType;				      //!< Return type		    	   
+    typedef V ObjectType;                         //!< Class type
     typedef W1 Arg1Type;				      //!< First argument type		   
     typedef W2 Arg2Type;				      //!< Second argument type		   
     typedef W3 Arg3Type;				      //!< Third argument type		   
@@ -257,6 +269,7 @@ private:
     enum { IsPointerToMember = 1};			   //!< Pointer to member value      
     enum { nArgs = 6};					   //!< Number of arguments	  
     typedef U ReturnType;				   //!< Return type		  
+    typedef V ObjectType;                         //!< Class type
     typedef W1 Arg1Type;				   //!< First argument type	  
     typedef W2 Arg2Type;				   //!< Second argument type	  
     typedef W3 Arg3Type;				   //!< Third argument type	  
@@ -273,6 +286,7 @@ private:
     enum { IsPointerToMember = 1};				 //!< Pointer to member value	      
     enum { nArgs = 6};						 //!< Number of arguments	    	      
     typedef U ReturnType;					 //!< Return type		    	      
+    typedef V ObjectType;                         //!< Class type
     typedef W1 Arg1Type;					 //!< First argument type		      
     typedef W2 Arg2Type;					 //!< Second argument type		      
     typedef W3 Arg3Type;					 //!< Third argument type		      
@@ -0,0 +1,143 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+
+#include <sstream>
+#include <string>
+#include "ns3/test.h"
+#include "ns3/simulator.h"
+#include "ns3/nstime.h"
+#include "ns3/event-profiler.h"
+
+using namespace ns3;
+
+// the callbacks differ, or the compiler may fold them into one function
+class EventProfilerTestTarget
+{
+public:
+  EventProfilerTestTarget () : m_ticks (0), m_tocks (0), m_baseTocks (0) {}
+  virtual ~EventProfilerTestTarget () {}
+  void Tick (void);
+  virtual void Tock (void);
+  void Relay (void);
+  uint32_t m_ticks;
+  uint32_t m_tocks;
+  uint32_t m_baseTocks;
+};
+
+class EventProfilerTestDerived : public EventProfilerTestTarget
+{
+public:
+  virtual void Tock (void);
+};
+
+void
+EventProfilerTestTarget::Tick (void)
+{
+  m_ticks++;
+}
+
+void
+EventProfilerTestTarget::Tock (void)
+{
+  m_baseTocks++;
+}
+
+void
+EventProfilerTestTarget::Relay (void)
+{
+  Simulator::Schedule (Seconds (1), &EventProfilerTestTarget::Tick, this);
+}
+
+void
+EventProfilerTestDerived::Tock (void)
+{
+  m_tocks++;
+}
+
+class EventProfilerTest : public TestCase
+{
+public:
+  EventProfilerTest ();
+private:
+  virtual void DoRun (void);
+  std::string FindLine (const std::string &report, const std::string &callback);
+};
+
+EventProfilerTest::EventProfilerTest ()
+  : TestCase ("Events are accounted to their callback, virtual members resolved")
+{
+}
+
+std::string
+EventProfilerTest::FindLine (const std::string &report, const std::string &callback)
+{
+  std::istringstream iss (report);
+  std::string line;
+  while (std::getline (iss, line))
+    {
+      if (line.find (callback) != std::string::npos)
+        {
+          return line;
+        }
+    }
+  return "";
+}
+
+void
+EventProfilerTest::DoRun (void)
+{
+  EventProfiler::Enable (true);
+  EventProfilerTestDerived derived;
+  EventProfilerTestTarget *target = &derived;
+  for (uint32_t i = 0; i < 3; i++)
+    {
+      Simulator::Schedule (Seconds (i), &EventProfilerTestTarget::Tick, target);
+    }
+  for (uint32_t i = 0; i < 2; i++)
+    {
+      Simulator::Schedule (Seconds (i), &EventProfilerTestTarget::Tock, target);
+    }
+  Simulator::Schedule (Seconds (5), &EventProfilerTestTarget::Relay, target);
+  Simulator::Run ();
+
+  std::ostringstream oss;
+  EventProfiler::Report (oss);
+  EventProfiler::Enable (false);
+  Simulator::Destroy ();
+  std::string report = oss.str ();
+  NS_TEST_ASSERT_MSG_EQ (derived.m_ticks + derived.m_tocks, 6, "events run");
+
+  NS_TEST_ASSERT_MSG_NE (report.find ("EventProfile events 7 "), std::string::npos,
+                         "all events accounted in\n" << report);
+  std::string tick = FindLine (report, "EventProfilerTestTarget::Tick");
+  std::istringstream tickFields (tick);
+  std::string tag, share;
+  uint64_t calls = 0;
+  tickFields >> tag >> share >> calls;
+  NS_TEST_ASSERT_MSG_EQ (calls, 4, "calls of Tick in\n" << report);
+
+  std::string tock = FindLine (report, "EventProfilerTestDerived::Tock");
+  std::istringstream tockFields (tock);
+  calls = 0;
+  tockFields >> tag >> share >> calls;
+  NS_TEST_ASSERT_MSG_EQ (calls, 2, "virtual Tock resolved to the override in\n" << report);
+  NS_TEST_ASSERT_MSG_EQ (FindLine (report, "EventProfilerTestTarget::Tock"), "",
+                         "base Tock never called in\n" << report);
+
+  std::string relay = FindLine (report, "EventProfilerTestTarget::Relay");
+  std::istringstream relayFields (relay);
+  double cyclesPerCall = 0;
+  double allocations = 0;
+  relayFields >> tag >> share >> calls >> cyclesPerCall >> allocations;
+  NS_TEST_ASSERT_MSG_EQ (calls, 1, "calls of Relay in\n" << report);
+  NS_TEST_ASSERT_MSG_EQ (allocations, 1, "event allocated by Relay in\n" << report);
+}
+
+static class EventProfilerTestSuite : public TestSuite
+{
+public:
+  EventProfilerTestSuite ()
+    : TestSuite ("event-profiler", UNIT)
+  {
+    AddTestCase (new EventProfilerTest (), TestCase::QUICK);
+  }
+} g_eventProfilerTestSuite;
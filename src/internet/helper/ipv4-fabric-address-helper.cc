@@ -0,0 +1,162 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+
+#include "ns3/log.h"
+#include "ns3/abort.h"
+#include "ns3/ipv4.h"
+#include "ns3/ipv4-global-routing.h"
+#include "ipv4-address-helper.h"
+#include "ipv4-routing-helper.h"
+#include "ipv4-fabric-address-helper.h"
+
+NS_LOG_COMPONENT_DEFINE ("Ipv4FabricAddressHelper");
+
+namespace ns3 {
+
+// every link is a /30
+static const uint32_t LINK_BITS = 2;
+
+Ipv4FabricAddressHelper::Ipv4FabricAddressHelper ()
+{
+  NS_LOG_FUNCTION (this);
+  SetBase ("10.0.0.0", "255.0.0.0");
+}
+
+Ipv4FabricAddressHelper::Ipv4FabricAddressHelper (Ipv4Address network, Ipv4Mask mask)
+{
+  NS_LOG_FUNCTION (this << network << mask);
+  SetBase (network, mask);
+}
+
+void
+Ipv4FabricAddressHelper::SetBase (Ipv4Address network, Ipv4Mask mask)
+{
+  NS_LOG_FUNCTION (this << network << mask);
+  m_network = network.Get () & mask.Get ();
+  m_hostBits = 32 - mask.GetPrefixLength ();
+  NS_ABORT_MSG_IF (m_hostBits < LINK_BITS + 1, "Ipv4FabricAddressHelper::SetBase(): " << mask << " leaves no room for links");
+  m_nFabricLinks = 0;
+  SetTopology (1, 1, 1);
+}
+
+uint32_t
+Ipv4FabricAddressHelper::FieldBits (uint32_t n)
+{
+  uint32_t bits = 0;
+  while (bits < 32 && (uint64_t (1) << bits) < n)
+    {
+      bits++;
+    }
+  return bits;
+}
+
+void
+Ipv4FabricAddressHelper::SetTopology (uint32_t nPods, uint32_t nLeavesPerPod, uint32_t nHostsPerLeaf)
+{
+  NS_LOG_FUNCTION (this << nPods << nLeavesPerPod << nHostsPerLeaf);
+  m_nPods = nPods;
+  m_nLeavesPerPod = nLeavesPerPod;
+  m_nHostsPerLeaf = nHostsPerLeaf;
+  m_leafShift = LINK_BITS + FieldBits (nHostsPerLeaf);
+  m_podShift = m_leafShift + FieldBits (nLeavesPerPod);
+  // the top bit below the base mask selects the fabric half
+  NS_ABORT_MSG_IF (m_podShift + FieldBits (nPods) > m_hostBits - 1,
+                   "Ipv4FabricAddressHelper::SetTopology(): " << nPods << " pods of " << nLeavesPerPod
+                   << " leaves of " << nHostsPerLeaf << " hosts do not fit in a /" << 32 - m_hostBits);
+}
+
+Ipv4InterfaceContainer
+Ipv4FabricAddressHelper::AssignLink (const NetDeviceContainer &c, uint32_t network)
+{
+  Ipv4AddressHelper ipv4;
+  ipv4.SetBase (Ipv4Address (network), "255.255.255.252");
+  return ipv4.Assign (c);
+}
+
+Ipv4InterfaceContainer
+Ipv4FabricAddressHelper::AssignHostLink (const NetDeviceContainer &c, uint32_t pod,
+                                         uint32_t leaf, uint32_t host)
+{
+  NS_LOG_FUNCTION (this << pod << leaf << host);
+  NS_ABORT_MSG_UNLESS (pod < m_nPods && leaf < m_nLeavesPerPod && host < m_nHostsPerLeaf,
+                       "Ipv4FabricAddressHelper::AssignHostLink(): host " << pod << "/" << leaf << "/" << host
+                       << " outside the topology");
+  return AssignLink (c, GetLeafNetwork (pod, leaf).Get () | (host << LINK_BITS));
+}
+
+Ipv4InterfaceContainer
+Ipv4FabricAddressHelper::AssignFabricLink (const NetDeviceContainer &c)
+{
+  NS_LOG_FUNCTION (this << m_nFabricLinks);
+  NS_ABORT_MSG_IF (FieldBits (m_nFabricLinks + 1) > m_hostBits - 1 - LINK_BITS,
+                   "Ipv4FabricAddressHelper::AssignFabricLink(): out of fabric link prefixes");
+  uint32_t network = m_network | (1u << (m_hostBits - 1)) | (m_nFabricLinks << LINK_BITS);
+  m_nFabricLinks++;
+  return AssignLink (c, network);
+}
+
+Ipv4Address
+Ipv4FabricAddressHelper::GetLeafNetwork (uint32_t pod, uint32_t leaf) const
+{
+  return Ipv4Address (GetPodNetwork (pod).Get () | (leaf << m_leafShift));
+}
+
+Ipv4Mask
+Ipv4FabricAddressHelper::GetLeafMask (void) const
+{
+  return Ipv4Mask (~((1u << m_leafShift) - 1));
+}
+
+Ipv4Address
+Ipv4FabricAddressHelper::GetPodNetwork (uint32_t pod) const
+{
+  return Ipv4Address (m_network | (pod << m_podShift));
+}
+
+Ipv4Mask
+Ipv4FabricAddressHelper::GetPodMask (void) const
+{
+  return Ipv4Mask (~((1u << m_podShift) - 1));
+}
+
+Ipv4Address
+Ipv4FabricAddressHelper::GetHostLinksNetwork (void) const
+{
+  return Ipv4Address (m_network);
+}
+
+Ipv4Mask
+Ipv4FabricAddressHelper::GetHostLinksMask (void) const
+{
+  return Ipv4Mask (~((1u << (m_hostBits - 1)) - 1));
+}
+
+uint32_t
+Ipv4FabricAddressHelper::AggregateRoutes (Ptr<Node> node) const
+{
+  NS_LOG_FUNCTION (this << node->GetId ());
+  Ptr<Ipv4> ipv4 = node->GetObject<Ipv4> ();
+  NS_ASSERT_MSG (ipv4, "Ipv4FabricAddressHelper::AggregateRoutes(): node without Ipv4");
+  Ptr<Ipv4GlobalRouting> routing = Ipv4RoutingHelper::GetRouting<Ipv4GlobalRouting> (ipv4->GetRoutingProtocol ());
+  if (routing == 0)
+    {
+      return 0;
+    }
+  // leaves first, so that a pod prefix can fold the leaf prefixes under it
+  uint32_t removed = routing->AggregateNetworkRoutes (GetLeafMask ());
+  removed += routing->AggregateNetworkRoutes (GetPodMask ());
+  NS_LOG_LOGIC ("node " << node->GetId () << " dropped " << removed << " routes, " << routing->GetNRoutes () << " left");
+  return removed;
+}
+
+uint32_t
+Ipv4FabricAddressHelper::AggregateRoutes (const NodeContainer &c) const
+{
+  uint32_t removed = 0;
+  for (NodeContainer::Iterator i = c.Begin (); i != c.End (); ++i)
+    {
+      removed += AggregateRoutes (*i);
+    }
+  return removed;
+}
+
+} // namespace ns3
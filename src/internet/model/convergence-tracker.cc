@@ -0,0 +1,215 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+
+#include <cmath>
+#include "ns3/log.h"
+#include "ns3/double.h"
+#include "ns3/uinteger.h"
+#include "convergence-tracker.h"
+
+NS_LOG_COMPONENT_DEFINE ("ConvergenceTracker");
+
+namespace ns3 {
+
+NS_OBJECT_ENSURE_REGISTERED (ConvergenceTracker);
+
+TypeId
+ConvergenceTracker::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::ConvergenceTracker")
+    .SetParent<Object> ()
+    .AddConstructor<ConvergenceTracker> ()
+    .AddAttribute ("Tolerance",
+                   "Relative error below which a flow counts as converged",
+                   DoubleValue (0.1),
+                   MakeDoubleAccessor (&ConvergenceTracker::m_tolerance),
+                   MakeDoubleChecker<double> (0.0))
+    .AddAttribute ("Fraction",
+                   "Fraction of the flows that must be within tolerance",
+                   DoubleValue (0.95),
+                   MakeDoubleAccessor (&ConvergenceTracker::m_fraction),
+                   MakeDoubleChecker<double> (0.0, 1.0))
+    .AddAttribute ("Window",
+                   "Number of consecutive ticks the condition must hold",
+                   UintegerValue (250),
+                   MakeUintegerAccessor (&ConvergenceTracker::m_window),
+                   MakeUintegerChecker<uint32_t> ())
+  ;
+  return tid;
+}
+
+ConvergenceTracker::ConvergenceTracker ()
+  : m_within (0),
+    m_consecutive (0),
+    m_tolerance (0.1),
+    m_fraction (0.95),
+    m_window (250)
+{
+  NS_LOG_FUNCTION (this);
+}
+
+ConvergenceTracker::~ConvergenceTracker ()
+{
+  NS_LOG_FUNCTION (this);
+}
+
+bool
+ConvergenceTracker::IsWithin (double measured, double ideal) const
+{
+  if (ideal <= 0.0 || measured < 0.0)
+    {
+      return false;
+    }
+  return std::fabs (ideal - measured) / ideal < m_tolerance;
+}
+
+void
+ConvergenceTracker::Refresh (FlowState &flow)
+{
+  bool within = IsWithin (flow.measured, flow.ideal);
+  if (within != flow.within)
+    {
+      if (within)
+        {
+          m_within++;
+        }
+      else
+        {
+          m_within--;
+        }
+      flow.within = within;
+    }
+}
+
+void
+ConvergenceTracker::AddFlow (uint32_t fid, double ideal)
+{
+  NS_LOG_FUNCTION (this << fid << ideal);
+  RemoveFlow (fid);
+  FlowState flow;
+  flow.measured = -1;
+  flow.ideal = ideal;
+  flow.within = false;
+  m_flows[fid] = flow;
+}
+
+void
+ConvergenceTracker::RemoveFlow (uint32_t fid)
+{
+  std::map<uint32_t, FlowState>::iterator it = m_flows.find (fid);
+  if (it == m_flows.end ())
+    {
+      return;
+    }
+  NS_LOG_FUNCTION (this << fid);
+  if (it->second.within)
+    {
+      m_within--;
+    }
+  m_flows.erase (it);
+}
+
+void
+ConvergenceTracker::SetIdealRate (uint32_t fid, double ideal)
+{
+  std::map<uint32_t, FlowState>::iterator it = m_flows.find (fid);
+  if (it == m_flows.end ())
+    {
+      return;
+    }
+  it->second.ideal = ideal;
+  Refresh (it->second);
+}
+
+void
+ConvergenceTracker::UpdateRate (uint32_t fid, double measured)
+{
+  std::map<uint32_t, FlowState>::iterator it = m_flows.find (fid);
+  if (it == m_flows.end ())
+    {
+      return;
+    }
+  it->second.measured = measured;
+  Refresh (it->second);
+}
+
+bool
+ConvergenceTracker::Tick (void)
+{
+  if (!m_flows.empty () && m_within >= m_fraction * m_flows.size ())
+    {
+      m_consecutive++;
+    }
+  else
+    {
+      m_consecutive = 0;
+    }
+  if (m_consecutive > m_window)
+    {
+      NS_LOG_LOGIC ("converged, " << m_within << " of " << m_flows.size () << " flows within tolerance");
+      m_consecutive = 0;
+      if (!m_converged.IsNull ())
+        {
+          m_converged ();
+        }
+      return true;
+    }
+  return false;
+}
+
+void
+ConvergenceTracker::Reset (void)
+{
+  m_consecutive = 0;
+}
+
+void
+ConvergenceTracker::SetConvergedCallback (Callback<void> cb)
+{
+  m_converged = cb;
+}
+
+uint32_t
+ConvergenceTracker::GetNFlows (void) const
+{
+  return m_flows.size ();
+}
+
+uint32_t
+ConvergenceTracker::GetNWithinTolerance (void) const
+{
+  return m_within;
+}
+
+uint32_t
+ConvergenceTracker::GetConsecutive (void) const
+{
+  return m_consecutive;
+}
+
+double
+ConvergenceTracker::GetMeasuredRate (uint32_t fid) const
+{
+  std::map<uint32_t, FlowState>::const_iterator it = m_flows.find (fid);
+  return (it == m_flows.end ()) ? -1 : it->second.measured;
+}
+
+double
+ConvergenceTracker::GetIdealRate (uint32_t fid) const
+{
+  std::map<uint32_t, FlowState>::const_iterator it = m_flows.find (fid);
+  return (it == m_flows.end ()) ? 0 : it->second.ideal;
+}
+
+std::vector<uint32_t>
+ConvergenceTracker::GetFlowIds (void) const
+{
+  std::vector<uint32_t> fids;
+  fids.reserve (m_flows.size ());
+  for (std::map<uint32_t, FlowState>::const_iterator it = m_flows.begin (); it != m_flows.end (); ++it)
+    {
+      fids.push_back (it->first);
+    }
+  return fids;
+}
+
+} // namespace ns3
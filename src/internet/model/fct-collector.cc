@@ -0,0 +1,313 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+
+#include "fct-collector.h"
+#include "ns3/tracker.h"
+#include "ns3/log.h"
+#include "ns3/simulator.h"
+#include "ns3/string.h"
+#include "ns3/uinteger.h"
+#include "ns3/trace-source-accessor.h"
+#include <algorithm>
+#include <cstdlib>
+#include <sstream>
+
+NS_LOG_COMPONENT_DEFINE ("FctCollector");
+
+namespace ns3 {
+
+static std::vector<double>
+ParseEdges (const std::string &edges)
+{
+  std::vector<double> result;
+  std::istringstream iss (edges);
+  std::string edge;
+  while (std::getline (iss, edge, ','))
+    {
+      if (!edge.empty ())
+        {
+          result.push_back (std::atof (edge.c_str ()));
+        }
+    }
+  std::sort (result.begin (), result.end ());
+  return result;
+}
+
+FctStats::FctStats (const std::vector<double> &edges, uint32_t subBucketBits)
+  : m_edges (edges),
+    m_fct (edges.size () + 1, LogLinearHistogram (subBucketBits)),
+    m_slowdown (edges.size () + 1, LogLinearHistogram (subBucketBits))
+{
+}
+
+void
+FctStats::Record (double bytes, uint64_t fct, double slowdown)
+{
+  uint32_t bucket = GetBucket (bytes);
+  m_fct[bucket].Record (fct);
+  m_slowdown[bucket].Record ((uint64_t) (std::max (slowdown, 0.0) * 1000.0 + 0.5));
+}
+
+void
+FctStats::Merge (const FctStats &o)
+{
+  NS_ASSERT (o.m_edges == m_edges);
+  for (uint32_t i = 0; i < m_fct.size (); i++)
+    {
+      m_fct[i].Merge (o.m_fct[i]);
+      m_slowdown[i].Merge (o.m_slowdown[i]);
+    }
+}
+
+void
+FctStats::Reset (void)
+{
+  for (uint32_t i = 0; i < m_fct.size (); i++)
+    {
+      m_fct[i].Reset ();
+      m_slowdown[i].Reset ();
+    }
+}
+
+const std::vector<double> &
+FctStats::GetEdges (void) const
+{
+  return m_edges;
+}
+
+uint32_t
+FctStats::GetBucket (double bytes) const
+{
+  return std::lower_bound (m_edges.begin (), m_edges.end (), bytes) - m_edges.begin ();
+}
+
+uint64_t
+FctStats::GetCount (void) const
+{
+  uint64_t count = 0;
+  for (uint32_t i = 0; i < m_fct.size (); i++)
+    {
+      count += m_fct[i].GetCount ();
+    }
+  return count;
+}
+
+const LogLinearHistogram &
+FctStats::GetFct (uint32_t bucket) const
+{
+  return m_fct[bucket];
+}
+
+const LogLinearHistogram &
+FctStats::GetSlowdown (uint32_t bucket) const
+{
+  return m_slowdown[bucket];
+}
+
+void
+FctStats::Print (std::ostream &os, const std::string &prefix) const
+{
+  for (uint32_t i = 0; i < m_fct.size (); i++)
+    {
+      const LogLinearHistogram &fct = m_fct[i];
+      const LogLinearHistogram &slowdown = m_slowdown[i];
+      if (fct.GetCount () == 0)
+        {
+          continue;
+        }
+      os << prefix << " bytes " << (i > 0 ? m_edges[i - 1] : 0.0) << " ";
+      if (i < m_edges.size ())
+        {
+          os << m_edges[i];
+        }
+      else
+        {
+          os << "inf";
+        }
+      os << " count " << fct.GetCount ()
+         << " fct_ns mean " << fct.GetMean () << " p50 " << fct.GetQuantile (0.5)
+         << " p99 " << fct.GetQuantile (0.99) << " p999 " << fct.GetQuantile (0.999)
+         << " slowdown mean " << slowdown.GetMean () / 1000.0
+         << " p50 " << slowdown.GetQuantile (0.5) / 1000.0
+         << " p99 " << slowdown.GetQuantile (0.99) / 1000.0
+         << " p999 " << slowdown.GetQuantile (0.999) / 1000.0 << std::endl;
+    }
+}
+
+NS_OBJECT_ENSURE_REGISTERED (FctCollector);
+
+TypeId
+FctCollector::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::FctCollector")
+    .SetParent<Object> ()
+    .AddConstructor<FctCollector> ()
+    .AddAttribute ("LineRate",
+                   "Rate of the ideal transfer of a flow",
+                   DataRateValue (DataRate ("10Gbps")),
+                   MakeDataRateAccessor (&FctCollector::m_lineRate),
+                   MakeDataRateChecker ())
+    .AddAttribute ("BaseRtt",
+                   "Round trip time added to the ideal transfer of a flow",
+                   TimeValue (MicroSeconds (0)),
+                   MakeTimeAccessor (&FctCollector::m_baseRtt),
+                   MakeTimeChecker ())
+    .AddAttribute ("SizeBuckets",
+                   "Comma separated upper edges in bytes of the flow size buckets",
+                   StringValue ("10000,100000,1000000,10000000"),
+                   MakeStringAccessor (&FctCollector::SetSizeBuckets,
+                                       &FctCollector::GetSizeBuckets),
+                   MakeStringChecker ())
+    .AddAttribute ("Precision",
+                   "Linear sub-buckets per power of two of the histograms, as a power of two",
+                   UintegerValue (6),
+                   MakeUintegerAccessor (&FctCollector::SetPrecision,
+                                         &FctCollector::GetPrecision),
+                   MakeUintegerChecker<uint32_t> (1, 16))
+    .AddAttribute ("Window",
+                   "Trace the flows finished in every window this long, 0 for no windows",
+                   TimeValue (Seconds (0)),
+                   MakeTimeAccessor (&FctCollector::m_window),
+                   MakeTimeChecker ())
+    .AddTraceSource ("Window",
+                     "Statistics of the flows finished in the window that just ended",
+                     MakeTraceSourceAccessor (&FctCollector::m_windowTrace))
+  ;
+  return tid;
+}
+
+FctCollector::FctCollector ()
+  : m_edges (ParseEdges ("10000,100000,1000000,10000000")),
+    m_subBucketBits (6),
+    m_total (m_edges, m_subBucketBits),
+    m_current (m_edges, m_subBucketBits)
+{
+  NS_LOG_FUNCTION (this);
+}
+
+FctCollector::~FctCollector ()
+{
+  NS_LOG_FUNCTION (this);
+}
+
+void
+FctCollector::DoDispose (void)
+{
+  Simulator::Cancel (m_windowEvent);
+  m_open.clear ();
+  Object::DoDispose ();
+}
+
+void
+FctCollector::SetSizeBuckets (std::string edges)
+{
+  m_edges = ParseEdges (edges);
+  m_total = FctStats (m_edges, m_subBucketBits);
+  m_current = FctStats (m_edges, m_subBucketBits);
+}
+
+std::string
+FctCollector::GetSizeBuckets (void) const
+{
+  std::ostringstream oss;
+  for (uint32_t i = 0; i < m_edges.size (); i++)
+    {
+      oss << (i > 0 ? "," : "") << m_edges[i];
+    }
+  return oss.str ();
+}
+
+void
+FctCollector::SetPrecision (uint32_t subBucketBits)
+{
+  m_subBucketBits = subBucketBits;
+  m_total = FctStats (m_edges, m_subBucketBits);
+  m_current = FctStats (m_edges, m_subBucketBits);
+}
+
+uint32_t
+FctCollector::GetPrecision (void) const
+{
+  return m_subBucketBits;
+}
+
+void
+FctCollector::FlowStarted (uint32_t fid, double bytes)
+{
+  NS_LOG_FUNCTION (this << fid << bytes);
+  if (m_window > Seconds (0) && !m_windowEvent.IsRunning ())
+    {
+      m_windowEvent = Simulator::Schedule (m_window, &FctCollector::EndWindow, this);
+    }
+  OpenFlow flow;
+  flow.start = Simulator::Now ();
+  flow.bytes = bytes;
+  m_open[fid] = flow;
+}
+
+void
+FctCollector::FlowFinished (uint32_t fid)
+{
+  NS_LOG_FUNCTION (this << fid);
+  sgi::hash_map<uint32_t, OpenFlow>::iterator it = m_open.find (fid);
+  if (it == m_open.end ())
+    {
+      // never started, or already finished through another trace
+      return;
+    }
+  Time fct = Simulator::Now () - it->second.start;
+  double ideal = m_baseRtt.GetSeconds () + it->second.bytes * 8.0 / m_lineRate.GetBitRate ();
+  double slowdown = ideal > 0.0 ? fct.GetSeconds () / ideal : 0.0;
+  m_current.Record (it->second.bytes, fct.GetNanoSeconds (), slowdown);
+  m_open.erase (it);
+}
+
+void
+FctCollector::TrackerStarted (const FlowData &fd)
+{
+  FlowStarted (fd.flow_id, fd.flow_size);
+}
+
+void
+FctCollector::Track (Ptr<Tracker> tracker)
+{
+  tracker->TraceConnectWithoutContext ("FlowStart", MakeCallback (&FctCollector::TrackerStarted, this));
+  tracker->TraceConnectWithoutContext ("FlowStop", MakeCallback (&FctCollector::FlowFinished, this));
+}
+
+void
+FctCollector::EndWindow (void)
+{
+  m_windowTrace (m_current);
+  m_total.Merge (m_current);
+  m_current.Reset ();
+  m_windowEvent = Simulator::Schedule (m_window, &FctCollector::EndWindow, this);
+}
+
+FctStats
+FctCollector::GetStats (void) const
+{
+  FctStats stats = m_total;
+  stats.Merge (m_current);
+  return stats;
+}
+
+const FctStats &
+FctCollector::GetWindowStats (void) const
+{
+  return m_current;
+}
+
+uint32_t
+FctCollector::GetNOpen (void) const
+{
+  return m_open.size ();
+}
+
+void
+FctCollector::Print (std::ostream &os) const
+{
+  GetStats ().Print (os, "FCT");
+  os << "FCT open " << GetNOpen () << std::endl;
+}
+
+} // namespace ns3
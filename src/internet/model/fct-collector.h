@@ -0,0 +1,128 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Flow completion time statistics gathered while the simulation runs,
+ * instead of from the flow_start / flow_stop lines after it.
+ */
+
+#ifndef FCT_COLLECTOR_H
+#define FCT_COLLECTOR_H
+
+#include <ostream>
+#include <string>
+#include <vector>
+#include "ns3/object.h"
+#include "ns3/nstime.h"
+#include "ns3/data-rate.h"
+#include "ns3/event-id.h"
+#include "ns3/traced-callback.h"
+#include "ns3/sgi-hashmap.h"
+#include "queue-histograms.h"
+
+class FlowData;
+class Tracker;
+
+namespace ns3 {
+
+/**
+ * \ingroup internet
+ *
+ * \brief FCT and slowdown histograms, by flow size bucket.
+ *
+ * Bucket i holds the flows of at most GetEdges ()[i] bytes and more than
+ * the previous edge; the last bucket holds the flows above every edge.
+ * Histograms with the same edges and precision merge, e.g. across runs.
+ */
+class FctStats
+{
+public:
+  FctStats (const std::vector<double> &edges, uint32_t subBucketBits);
+
+  /** fct in ns, slowdown as the ratio of fct to the ideal fct */
+  void Record (double bytes, uint64_t fct, double slowdown);
+  void Merge (const FctStats &o);
+  void Reset (void);
+
+  const std::vector<double> &GetEdges (void) const;
+  uint32_t GetBucket (double bytes) const;
+  uint64_t GetCount (void) const;
+  const LogLinearHistogram &GetFct (uint32_t bucket) const;
+  /** slowdown in thousandths */
+  const LogLinearHistogram &GetSlowdown (uint32_t bucket) const;
+
+  /** One line per bucket with flows: its size range, the count and the
+      mean, median, p99 and p99.9 of the fct (ns) and slowdown. */
+  void Print (std::ostream &os, const std::string &prefix) const;
+
+private:
+  std::vector<double> m_edges;
+  std::vector<LogLinearHistogram> m_fct;
+  std::vector<LogLinearHistogram> m_slowdown;
+};
+
+/**
+ * \ingroup internet
+ *
+ * \brief Streaming flow completion time and slowdown statistics.
+ *
+ * A flow is timed from FlowStarted to FlowFinished, which match the
+ * Tracker FlowStart and FlowStop and the PacketSink Finished traces (see
+ * Track).  Its slowdown is its fct over the ideal fct, size / LineRate +
+ * BaseRtt.  Completed flows are recorded in the histograms of the current
+ * window; every Window the Window trace gets them and they are folded into
+ * the totals GetStats returns.  Flows that never finish are counted by
+ * GetNOpen, not recorded.
+ */
+class FctCollector : public Object
+{
+public:
+  static TypeId GetTypeId (void);
+
+  FctCollector ();
+  virtual ~FctCollector ();
+
+  void FlowStarted (uint32_t fid, double bytes);
+  void FlowFinished (uint32_t fid);
+  /** Time the flows registered with tracker. */
+  void Track (Ptr<Tracker> tracker);
+
+  /** Flows finished since the start of the run, the current window included. */
+  FctStats GetStats (void) const;
+  /** Flows finished in the current window. */
+  const FctStats &GetWindowStats (void) const;
+  uint32_t GetNOpen (void) const;
+
+  /** The totals, then the number of flows still open. */
+  void Print (std::ostream &os) const;
+
+protected:
+  virtual void DoDispose (void);
+
+private:
+  struct OpenFlow
+  {
+    Time start;
+    double bytes;
+  };
+
+  void SetSizeBuckets (std::string edges);
+  std::string GetSizeBuckets (void) const;
+  void SetPrecision (uint32_t subBucketBits);
+  uint32_t GetPrecision (void) const;
+  void TrackerStarted (const FlowData &fd);
+  void EndWindow (void);
+
+  DataRate m_lineRate;
+  Time m_baseRtt;
+  Time m_window;
+  std::vector<double> m_edges;
+  uint32_t m_subBucketBits;
+  FctStats m_total;
+  FctStats m_current;
+  sgi::hash_map<uint32_t, OpenFlow> m_open;
+  EventId m_windowEvent;
+  TracedCallback<const FctStats &> m_windowTrace;
+};
+
+} // namespace ns3
+
+#endif /* FCT_COLLECTOR_H */
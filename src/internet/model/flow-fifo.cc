@@ -0,0 +1,170 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+
+#include "flow-fifo.h"
+#include "ns3/assert.h"
+
+namespace ns3 {
+
+const uint32_t FlowFifoTable::NONE;
+
+FlowFifoTable::FlowFifoTable ()
+  : m_free (NONE),
+    m_packets (0),
+    m_bytes (0)
+{
+}
+
+uint32_t
+FlowFifoTable::Lookup (uint32_t fid)
+{
+  if (fid < m_handles.size () && m_handles[fid] != NONE)
+    {
+      return m_handles[fid];
+    }
+  if (fid >= m_handles.size ())
+    {
+      m_handles.resize (fid + 1, NONE);
+    }
+  uint32_t handle = m_flows.size ();
+  Flow flow;
+  flow.fid = fid;
+  flow.head = NONE;
+  flow.tail = NONE;
+  flow.packets = 0;
+  flow.bytes = 0;
+  flow.start = 0.0;
+  flow.finish = 0.0;
+  flow.weight = 0.0;
+  flow.weighted = false;
+  m_flows.push_back (flow);
+  m_handles[fid] = handle;
+
+  // flows arrive roughly in the order of their ids, so this is an append
+  std::vector<uint32_t>::iterator it = m_ordered.end ();
+  while (it != m_ordered.begin () && m_flows[*(it - 1)].fid > fid)
+    {
+      --it;
+    }
+  m_ordered.insert (it, handle);
+  return handle;
+}
+
+uint32_t
+FlowFifoTable::Find (uint32_t fid) const
+{
+  if (fid < m_handles.size ())
+    {
+      return m_handles[fid];
+    }
+  return NONE;
+}
+
+FlowFifoTable::Flow &
+FlowFifoTable::Get (uint32_t handle)
+{
+  return m_flows[handle];
+}
+
+const FlowFifoTable::Flow &
+FlowFifoTable::Get (uint32_t handle) const
+{
+  return m_flows[handle];
+}
+
+uint32_t
+FlowFifoTable::GetNFlows (void) const
+{
+  return m_ordered.size ();
+}
+
+uint32_t
+FlowFifoTable::GetOrdered (uint32_t i) const
+{
+  return m_ordered[i];
+}
+
+void
+FlowFifoTable::Push (uint32_t handle, Ptr<Packet> p)
+{
+  uint32_t node = m_free;
+  if (node == NONE)
+    {
+      node = m_nodes.size ();
+      m_nodes.push_back (Node ());
+    }
+  else
+    {
+      m_free = m_nodes[node].next;
+    }
+  m_nodes[node].packet = p;
+  m_nodes[node].next = NONE;
+
+  Flow &flow = m_flows[handle];
+  if (flow.tail == NONE)
+    {
+      flow.head = node;
+    }
+  else
+    {
+      m_nodes[flow.tail].next = node;
+    }
+  flow.tail = node;
+  flow.packets++;
+  flow.bytes += p->GetSize ();
+  m_packets++;
+  m_bytes += p->GetSize ();
+}
+
+Ptr<Packet>
+FlowFifoTable::Pop (uint32_t handle)
+{
+  Flow &flow = m_flows[handle];
+  NS_ASSERT_MSG (flow.head != NONE, "pop from the empty FIFO of flow " << flow.fid);
+  uint32_t node = flow.head;
+  Ptr<Packet> p = m_nodes[node].packet;
+  flow.head = m_nodes[node].next;
+  if (flow.head == NONE)
+    {
+      flow.tail = NONE;
+    }
+  m_nodes[node].packet = 0;
+  m_nodes[node].next = m_free;
+  m_free = node;
+
+  flow.packets--;
+  flow.bytes -= p->GetSize ();
+  m_packets--;
+  m_bytes -= p->GetSize ();
+  return p;
+}
+
+Ptr<Packet>
+FlowFifoTable::Front (uint32_t handle) const
+{
+  const Flow &flow = m_flows[handle];
+  if (flow.head == NONE)
+    {
+      return 0;
+    }
+  return m_nodes[flow.head].packet;
+}
+
+uint32_t
+FlowFifoTable::GetNPackets (void) const
+{
+  return m_packets;
+}
+
+uint32_t
+FlowFifoTable::GetNBytes (void) const
+{
+  return m_bytes;
+}
+
+uint32_t
+FlowFifoTable::GetPoolSize (void) const
+{
+  return m_nodes.size ();
+}
+
+} // namespace ns3
@@ -0,0 +1,92 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Per-flow packet FIFOs of the fair queueing disciplines (W2FQ and the
+ * W2FQ half of hybridQ).  The state of a flow -- its FIFO, its counters,
+ * its start and finish tags and its weight -- is one record in a dense
+ * vector, and the FIFOs are singly linked through nodes taken from a pool
+ * owned by the table, so queueing a packet allocates nothing once the pool
+ * has grown to the peak occupancy.
+ */
+
+#ifndef FLOW_FIFO_H
+#define FLOW_FIFO_H
+
+#include <stdint.h>
+#include <vector>
+#include "ns3/packet.h"
+#include "ns3/ptr.h"
+
+namespace ns3 {
+
+/**
+ * \ingroup internet
+ *
+ * \brief Packet FIFOs and fair queueing state of the flows crossing a queue.
+ *
+ * Flows are known by their flow id and addressed by a handle, the index
+ * of their record.  A flow gets its record the first time it is looked up
+ * and keeps it for the life of the table, as the maps it replaces kept
+ * their keys.  Handles stay valid while flows are added; references to a
+ * record do not.
+ */
+class FlowFifoTable
+{
+public:
+  static const uint32_t NONE = 0xffffffff;
+
+  struct Flow
+  {
+    uint32_t fid;
+    uint32_t head;          //!< first node of the FIFO, NONE when empty
+    uint32_t tail;          //!< last node of the FIFO, NONE when empty
+    uint32_t packets;
+    uint32_t bytes;
+    double start;           //!< start tag of the head packet
+    double finish;          //!< finish tag of the head packet
+    double weight;          //!< weight of the last packet that (re)set the tags
+    bool weighted;          //!< whether weight was ever set
+  };
+
+  FlowFifoTable ();
+
+  /** Handle of fid, adding an empty flow if fid is new. */
+  uint32_t Lookup (uint32_t fid);
+  /** Handle of fid, NONE if fid was never looked up. */
+  uint32_t Find (uint32_t fid) const;
+  Flow &Get (uint32_t handle);
+  const Flow &Get (uint32_t handle) const;
+
+  /** Number of flows, and the handle of the i-th flow in the order of their ids. */
+  uint32_t GetNFlows (void) const;
+  uint32_t GetOrdered (uint32_t i) const;
+
+  void Push (uint32_t handle, Ptr<Packet> p);
+  /** Unlink and return the head of a non-empty FIFO. */
+  Ptr<Packet> Pop (uint32_t handle);
+  Ptr<Packet> Front (uint32_t handle) const;
+
+  /** Totals over all flows. */
+  uint32_t GetNPackets (void) const;
+  uint32_t GetNBytes (void) const;
+  /** Nodes in the pool, in use or free. */
+  uint32_t GetPoolSize (void) const;
+
+private:
+  struct Node
+  {
+    Ptr<Packet> packet;
+    uint32_t next;          //!< next node of the FIFO or of the free list
+  };
+
+  std::vector<Flow> m_flows;
+  std::vector<uint32_t> m_handles;   //!< handle by flow id
+  std::vector<uint32_t> m_ordered;   //!< handles sorted by flow id
+  std::vector<Node> m_nodes;
+  uint32_t m_free;                   //!< head of the free list
+  uint32_t m_packets;
+  uint32_t m_bytes;
+};
+
+} // namespace ns3
+
+#endif /* FLOW_FIFO_H */
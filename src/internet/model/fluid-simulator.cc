@@ -0,0 +1,513 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+
+#include <cmath>
+#include <queue>
+#include <functional>
+#include "ns3/log.h"
+#include "ns3/enum.h"
+#include "ns3/boolean.h"
+#include "ns3/pointer.h"
+#include "ns3/simulator.h"
+#include "ns3/net-device.h"
+#include "ns3/data-rate.h"
+#include "ns3/trace-source-accessor.h"
+#include "prio-queue.h"
+#include "fluid-simulator.h"
+
+NS_LOG_COMPONENT_DEFINE ("FluidSimulator");
+
+namespace ns3 {
+
+NS_OBJECT_ENSURE_REGISTERED (FluidSimulator);
+
+static const double NO_RESIDUE = 1e300;
+// smallest rate a flow asks for, in Mbps, so every flow keeps a weight
+static const double MIN_RATE = 1e-6;
+
+TypeId
+FluidSimulator::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::FluidSimulator")
+    .SetParent<NumSolver> ()
+    .AddConstructor<FluidSimulator> ()
+    .AddAttribute ("TimeStep",
+                   "Interval at which rates are recomputed and handed to the queues; "
+                   "keep it a fraction of the queues' PriceUpdateTime",
+                   TimeValue (MicroSeconds (20)),
+                   MakeTimeAccessor (&FluidSimulator::m_step),
+                   MakeTimeChecker ())
+    .AddAttribute ("Sharing",
+                   "How a link shares its capacity among its flows",
+                   EnumValue (WEIGHTED_FAIR),
+                   MakeEnumAccessor (&FluidSimulator::m_sharing),
+                   MakeEnumChecker (WEIGHTED_FAIR, "WeightedFair",
+                                    FIFO, "Fifo"))
+    .AddAttribute ("Hybrid",
+                   "Share the links with packet-level flows: take the packet "
+                   "traffic of the transmit queues into account and reserve "
+                   "the fluid rates on them",
+                   BooleanValue (false),
+                   MakeBooleanAccessor (&FluidSimulator::m_hybrid),
+                   MakeBooleanChecker ())
+    .AddAttribute ("DemandWindow",
+                   "How long a packet flow counts in the demand of a link after "
+                   "its last packet, in hybrid runs",
+                   TimeValue (MilliSeconds (1)),
+                   MakeTimeAccessor (&FluidSimulator::m_demandWindow),
+                   MakeTimeChecker ())
+    .AddTraceSource ("Rate",
+                     "The rate of a flow in Mbps after a step",
+                     MakeTraceSourceAccessor (&FluidSimulator::m_rateTrace))
+    .AddTraceSource ("FlowCompleted",
+                     "A flow with a size has sent all of it and left",
+                     MakeTraceSourceAccessor (&FluidSimulator::m_completedTrace))
+  ;
+  return tid;
+}
+
+FluidSimulator::FluidSimulator ()
+  : m_step (MicroSeconds (20)),
+    m_sharing (WEIGHTED_FAIR),
+    m_hybrid (false),
+    m_demandWindow (MilliSeconds (1)),
+    m_nSteps (0)
+{
+  NS_LOG_FUNCTION (this);
+}
+
+FluidSimulator::~FluidSimulator ()
+{
+  NS_LOG_FUNCTION (this);
+}
+
+void
+FluidSimulator::DoDispose (void)
+{
+  NS_LOG_FUNCTION (this);
+  m_stepEvent.Cancel ();
+  ReleaseLinks ();
+  m_fluidLinks.clear ();
+  NumSolver::DoDispose ();
+}
+
+void
+FluidSimulator::SyncLinks (void)
+{
+  FluidLink link;
+  link.queue = 0;
+  link.txQueue = 0;
+  link.received = 0;
+  link.packets = 0.0;
+  link.backlog = 0.0;
+  link.offered = 0.0;
+  link.served = 0.0;
+  link.residue = NO_RESIDUE;
+  link.remaining = 0.0;
+  link.weights = 0.0;
+  link.active = 0;
+  m_fluidLinks.resize (m_links.size (), link);
+}
+
+uint32_t
+FluidSimulator::GetLinkId (Ptr<NetDevice> dev)
+{
+  uint32_t n = GetNLinks ();
+  uint32_t id = NumSolver::GetLinkId (dev);
+  if (id >= n)
+    {
+      SyncLinks ();
+      PointerValue queue;
+      if (dev->GetAttributeFailSafe ("TxQueue", queue))
+        {
+          m_fluidLinks[id].queue = DynamicCast<PrioQueue> (queue.Get<Object> ());
+          m_fluidLinks[id].txQueue = DynamicCast<Queue> (queue.Get<Object> ());
+        }
+    }
+  return id;
+}
+
+uint32_t
+FluidSimulator::AddLink (Ptr<PrioQueue> queue)
+{
+  DataRateValue rate;
+  queue->GetAttribute ("DataRate", rate);
+  uint32_t id = NumSolver::AddLink (rate.Get ().GetBitRate ());
+  SyncLinks ();
+  m_fluidLinks[id].queue = queue;
+  m_fluidLinks[id].txQueue = queue;
+  return id;
+}
+
+void
+FluidSimulator::AddFlow (uint32_t fid, const std::vector<uint32_t> &links, double size, double weight)
+{
+  NumSolver::AddFlow (fid, links, size, weight);
+  FluidFlow flow;
+  flow.remaining = size;
+  flow.price = 0.0;
+  flow.weight = 0.0;
+  flow.rate = 0.0;
+  flow.frozen = false;
+  m_fluidFlows.push_back (flow);
+  if (!m_stepEvent.IsRunning ())
+    {
+      m_stepEvent = Simulator::Schedule (m_step, &FluidSimulator::Step, this);
+    }
+}
+
+void
+FluidSimulator::RemoveFlow (uint32_t fid)
+{
+  std::map<uint32_t, uint32_t>::iterator it = m_flowIndex.find (fid);
+  if (it == m_flowIndex.end ())
+    {
+      return;
+    }
+  // NumSolver moves the last flow into the hole, so do the same
+  uint32_t index = it->second;
+  NumSolver::RemoveFlow (fid);
+  m_fluidFlows[index] = m_fluidFlows.back ();
+  m_fluidFlows.pop_back ();
+}
+
+double
+FluidSimulator::GetFluidRate (uint32_t fid) const
+{
+  std::map<uint32_t, uint32_t>::const_iterator it = m_flowIndex.find (fid);
+  if (it == m_flowIndex.end ())
+    {
+      return 0.0;
+    }
+  return m_fluidFlows[it->second].rate * 1000000.0;
+}
+
+double
+FluidSimulator::GetBacklog (uint32_t link) const
+{
+  return link < m_fluidLinks.size () ? m_fluidLinks[link].backlog : 0.0;
+}
+
+uint64_t
+FluidSimulator::GetNSteps (void) const
+{
+  return m_nSteps;
+}
+
+void
+FluidSimulator::MeasurePackets (double dt)
+{
+  for (uint32_t l = 0; l < m_links.size (); l++)
+    {
+      FluidLink &link = m_fluidLinks[l];
+      link.packets = 0.0;
+      bool queued = false;
+      if (m_hybrid && link.txQueue != 0)
+        {
+          // the counter restarts when the queue statistics are reset; the
+          // packets still queued ask to be served within the step as well
+          uint32_t received = link.txQueue->GetTotalReceivedBytes ();
+          uint32_t bytes = received >= link.received ? received - link.received : received;
+          link.received = received;
+          link.packets = 8.0 * (bytes + link.txQueue->GetNBytes ()) / (1000000.0 * dt);
+          queued = link.txQueue->GetNBytes () > 0;
+        }
+      if (m_hybrid && m_sharing == WEIGHTED_FAIR && link.queue != 0)
+        {
+          if (!link.queue->m_trackPacketDemand)
+            {
+              link.queue->TrackPacketDemand (true);
+            }
+          // packets held back here may take all their hosts ask for; when
+          // none wait, they are limited elsewhere and need no more than
+          // they bring.  The arrivals of window limited senders follow what
+          // they were served, so they alone would starve them.
+          double demand = link.queue->GetPacketDemand (m_demandWindow);
+          if (demand > 0.0)
+            {
+              link.packets = queued ? std::max (link.packets, demand) : std::min (link.packets, demand);
+            }
+        }
+    }
+}
+
+void
+FluidSimulator::ReleaseLinks (void)
+{
+  for (uint32_t l = 0; l < m_fluidLinks.size (); l++)
+    {
+      if (m_hybrid && m_fluidLinks[l].txQueue != 0)
+        {
+          m_fluidLinks[l].txQueue->SetFluidRate (0.0);
+        }
+      if (m_hybrid && m_fluidLinks[l].queue != 0)
+        {
+          m_fluidLinks[l].queue->TrackPacketDemand (false);
+        }
+    }
+}
+
+double
+FluidSimulator::MarginalUtility (const FlowState &flow, double rate)
+{
+  // as Ipv4L3Protocol::updateMarginalUtility
+  if (m_method == 2)
+    {
+      return m_flowutil.getFCTUtilDerivative (flow.fid, rate);
+    }
+  if (m_method == 3)
+    {
+      return m_flowutil.getAlpha1UtilByFlowID (flow.fid, rate);
+    }
+  return m_flowutil.getPrioByFlowID (flow.fid, rate);
+}
+
+void
+FluidSimulator::ShareWeightedFair (void)
+{
+  // water filling: the link with the smallest capacity per unit of weight
+  // is saturated first and freezes its flows at that share.  Freezing can
+  // only raise the share of the other links, so stale heap entries are
+  // simply pushed back with their new share.  In hybrid runs the packets
+  // of a link take part as one more flow, weighted by their demand, and no
+  // flow gets more than it asks for.
+  typedef std::pair<double, uint32_t> Share;
+  std::priority_queue<Share, std::vector<Share>, std::greater<Share> > heap;
+  for (uint32_t l = 0; l < m_links.size (); l++)
+    {
+      FluidLink &link = m_fluidLinks[l];
+      link.remaining = m_links[l].capacity;
+      link.weights = link.packets;
+      link.active = link.packets > 0.0 ? 1 : 0;
+    }
+  for (uint32_t i = 0; i < m_flows.size (); i++)
+    {
+      FluidFlow &flow = m_fluidFlows[i];
+      flow.frozen = m_flows[i].links.empty ();
+      flow.rate = flow.frozen ? flow.weight : 0.0;
+      for (uint32_t k = 0; k < m_flows[i].links.size (); k++)
+        {
+          FluidLink &link = m_fluidLinks[m_flows[i].links[k]];
+          link.weights += flow.weight;
+          link.active++;
+        }
+    }
+  for (uint32_t l = 0; l < m_links.size (); l++)
+    {
+      if (m_fluidLinks[l].active > 0)
+        {
+          heap.push (Share (m_fluidLinks[l].remaining / m_fluidLinks[l].weights, l));
+        }
+    }
+  while (!heap.empty ())
+    {
+      Share top = heap.top ();
+      heap.pop ();
+      FluidLink &link = m_fluidLinks[top.second];
+      if (link.active == 0)
+        {
+          continue;
+        }
+      double share = link.weights > 0.0 ? std::max (link.remaining, 0.0) / link.weights : 0.0;
+      if (share > top.first)
+        {
+          heap.push (Share (share, top.second));
+          continue;
+        }
+      if (m_hybrid)
+        {
+          share = std::min (share, 1.0);
+        }
+      const std::vector<uint32_t> &flows = m_links[top.second].flows;
+      for (uint32_t j = 0; j < flows.size (); j++)
+        {
+          FluidFlow &flow = m_fluidFlows[flows[j]];
+          if (flow.frozen)
+            {
+              continue;
+            }
+          flow.frozen = true;
+          flow.rate = flow.weight * share;
+          const std::vector<uint32_t> &path = m_flows[flows[j]].links;
+          for (uint32_t k = 0; k < path.size (); k++)
+            {
+              FluidLink &other = m_fluidLinks[path[k]];
+              other.remaining -= flow.rate;
+              other.weights -= flow.weight;
+              other.active--;
+            }
+        }
+      if (link.packets > 0.0 && link.active > 0)
+        {
+          link.remaining -= link.packets * share;
+          link.weights -= link.packets;
+          link.active--;
+        }
+    }
+  for (uint32_t l = 0; l < m_links.size (); l++)
+    {
+      m_fluidLinks[l].offered = 0.0;
+    }
+  for (uint32_t i = 0; i < m_flows.size (); i++)
+    {
+      for (uint32_t k = 0; k < m_flows[i].links.size (); k++)
+        {
+          m_fluidLinks[m_flows[i].links[k]].offered += m_fluidFlows[i].rate;
+        }
+    }
+  for (uint32_t l = 0; l < m_links.size (); l++)
+    {
+      m_fluidLinks[l].served = m_fluidLinks[l].offered;
+    }
+}
+
+void
+FluidSimulator::ShareFifo (double dt)
+{
+  for (uint32_t l = 0; l < m_links.size (); l++)
+    {
+      m_fluidLinks[l].offered = 0.0;
+    }
+  for (uint32_t i = 0; i < m_flows.size (); i++)
+    {
+      for (uint32_t k = 0; k < m_flows[i].links.size (); k++)
+        {
+          m_fluidLinks[m_flows[i].links[k]].offered += m_fluidFlows[i].weight;
+        }
+    }
+  // bytes per Mbps over one step
+  double bytes = dt * 1000000.0 / 8.0;
+  for (uint32_t l = 0; l < m_links.size (); l++)
+    {
+      FluidLink &link = m_fluidLinks[l];
+      // packets and fluid share the link in proportion to what they offer
+      double capacity = m_links[l].capacity;
+      double total = link.offered + link.packets;
+      if (link.packets > 0.0)
+        {
+          capacity = std::max (capacity - link.packets, total > 0.0 ? capacity * link.offered / total : 0.0);
+        }
+      link.served = std::min (capacity, link.offered + link.backlog / bytes);
+      link.backlog += (link.offered - link.served) * bytes;
+      link.backlog = std::max (link.backlog, 0.0);
+      if (link.queue != 0 && link.queue->GetMode () == Queue::QUEUE_MODE_BYTES)
+        {
+          link.backlog = std::min (link.backlog, (double) link.queue->GetMaxBytes ());
+        }
+    }
+  for (uint32_t i = 0; i < m_flows.size (); i++)
+    {
+      FluidFlow &flow = m_fluidFlows[i];
+      double scale = 1.0;
+      for (uint32_t k = 0; k < m_flows[i].links.size (); k++)
+        {
+          const FluidLink &link = m_fluidLinks[m_flows[i].links[k]];
+          if (link.offered > link.served)
+            {
+              scale = std::min (scale, link.served / link.offered);
+            }
+        }
+      flow.rate = flow.weight * scale;
+    }
+}
+
+void
+FluidSimulator::Step (void)
+{
+  NS_LOG_FUNCTION (this << m_flows.size ());
+  m_nSteps++;
+  SyncLinks ();
+  m_flowutil.SetFCTAlpha (m_fctAlpha);
+  double dt = m_step.GetSeconds ();
+  MeasurePackets (dt);
+
+  // the rates the hosts ask for at the current path prices
+  for (uint32_t i = 0; i < m_flows.size (); i++)
+    {
+      FluidFlow &flow = m_fluidFlows[i];
+      flow.price = 0.0;
+      for (uint32_t k = 0; k < m_flows[i].links.size (); k++)
+        {
+          Ptr<PrioQueue> queue = m_fluidLinks[m_flows[i].links[k]].queue;
+          if (queue != 0)
+            {
+              flow.price += queue->getCurrentPrice ();
+            }
+        }
+      flow.weight = std::max (RateAtPrice (m_flows[i], flow.price), MIN_RATE);
+    }
+
+  if (m_sharing == FIFO)
+    {
+      ShareFifo (dt);
+    }
+  else
+    {
+      ShareWeightedFair ();
+    }
+
+  // residues as the hosts stamp them, see Ipv4L3Protocol::AddPrioHeader
+  for (uint32_t l = 0; l < m_links.size (); l++)
+    {
+      m_fluidLinks[l].residue = NO_RESIDUE;
+    }
+  for (uint32_t i = 0; i < m_flows.size (); i++)
+    {
+      const FlowState &state = m_flows[i];
+      FluidFlow &flow = m_fluidFlows[i];
+      if (flow.rate <= 0.0 || state.links.empty ())
+        {
+          continue;
+        }
+      double residue = (MarginalUtility (state, flow.rate) - flow.price) / state.links.size ();
+      for (uint32_t k = 0; k < state.links.size (); k++)
+        {
+          FluidLink &link = m_fluidLinks[state.links[k]];
+          link.residue = std::min (link.residue, residue);
+        }
+    }
+  double bytes = dt * 1000000.0 / 8.0;
+  for (uint32_t l = 0; l < m_links.size (); l++)
+    {
+      FluidLink &link = m_fluidLinks[l];
+      if (link.queue != 0)
+        {
+          link.queue->AccountFluid (link.offered * bytes, link.served * bytes, link.backlog, link.residue);
+        }
+      if (m_hybrid && link.txQueue != 0)
+        {
+          link.txQueue->SetFluidRate (link.served * 1000000.0);
+        }
+    }
+
+  std::vector<uint32_t> completed;
+  for (uint32_t i = 0; i < m_flows.size (); i++)
+    {
+      FluidFlow &flow = m_fluidFlows[i];
+      m_rateTrace (m_flows[i].fid, flow.rate);
+      if (flow.remaining > 0.0)
+        {
+          flow.remaining -= flow.rate * bytes;
+          if (flow.remaining <= 0.0)
+            {
+              completed.push_back (m_flows[i].fid);
+            }
+        }
+    }
+  for (uint32_t j = 0; j < completed.size (); j++)
+    {
+      NS_LOG_LOGIC ("flow " << completed[j] << " completed");
+      RemoveFlow (completed[j]);
+      m_completedTrace (completed[j]);
+    }
+
+  if (!m_flows.empty ())
+    {
+      m_stepEvent = Simulator::Schedule (m_step, &FluidSimulator::Step, this);
+    }
+  else
+    {
+      ReleaseLinks ();
+    }
+}
+
+} // namespace ns3
@@ -0,0 +1,151 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Flow-level (fluid) model of the fabric, for parameter exploration at a
+ * fraction of the cost of a packet-level run.
+ *
+ * Flows are routed exactly as by NumSolver, over the live routing tables,
+ * and ask for the rate FlowUtil gives at their path price, as the hosts do
+ * in Ipv4L3Protocol.  No packets are sent: every time step the engine
+ * shares the link capacities among the flows and hands the resulting byte
+ * counts, backlog and residues to the PrioQueue of each link, so the
+ * prices still come from the queues' own updateLinkPrice laws and
+ * parameters, on the queues' own update events.
+ */
+
+#ifndef FLUID_SIMULATOR_H
+#define FLUID_SIMULATOR_H
+
+#include <vector>
+#include "ns3/nstime.h"
+#include "ns3/event-id.h"
+#include "ns3/traced-callback.h"
+#include "num-solver.h"
+
+namespace ns3 {
+
+class Queue;
+class PrioQueue;
+
+/**
+ * \ingroup internet
+ *
+ * \brief Fixed-step fluid simulation of the NUMFabric rate and price dynamics.
+ *
+ * Each TimeStep, every flow sums the current prices of the queues on its
+ * path and asks for the rate FlowUtil gives at that price.  The link
+ * capacities are then shared in one of two ways:
+ *
+ * - WeightedFair: weighted max-min fair rates, with the requested rates as
+ *   weights, as the weighted fair queueing of the xFabric queues gives
+ *   window limited senders.  Links never build a backlog.
+ * - Fifo: the flows send at the requested rate; a link serving more than
+ *   its capacity builds a backlog (capped at the queue's MaxBytes) and
+ *   scales the rates of its flows down to what it serves.
+ *
+ * The arrived and departed bytes, the backlog and the smallest residue
+ * (U'(x) - q) / hops of the flows crossing a link are then passed to its
+ * PrioQueue through PrioQueue::AccountFluid.  Links without a PrioQueue
+ * are never priced.  Finite flows leave once they have sent their size
+ * in bytes.
+ *
+ * In Hybrid mode the fluid flows share the links with packet-level
+ * flows.  With WeightedFair sharing, the packets of a link compete with its
+ * fluid flows as one more flow, weighted by the rates their hosts asked for
+ * (PrioQueue::GetPacketDemand, over DemandWindow) while packets wait in the
+ * transmit queue, and by no more than the rate it received over the last
+ * step plus its backlog otherwise.  With Fifo sharing, packets and fluid are
+ * served in proportion to what each offers.  The fluid flows never take
+ * more than they ask for, and the rate they get is reserved on the queue
+ * with Queue::SetFluidRate, so the device serves the packets at what is
+ * left.
+ * The queues thus price the sum of both, and packets see the queueing the
+ * fluid load causes.  A packet served at the leftover rate advances a
+ * weighted fair virtual time by as much as it would among the fluid flows,
+ * so the virtual times need no fluid term.
+ *
+ * The Rate trace reports the rate of every flow after each step in Mbps,
+ * the unit of the Ipv4L3Protocol MeasurementRate trace it stands in for.
+ */
+class FluidSimulator : public NumSolver
+{
+public:
+  enum Sharing
+  {
+    WEIGHTED_FAIR,
+    FIFO
+  };
+
+  static TypeId GetTypeId (void);
+
+  FluidSimulator ();
+  virtual ~FluidSimulator ();
+
+  using NumSolver::AddFlow;
+  using NumSolver::AddLink;
+
+  virtual void AddFlow (uint32_t fid, const std::vector<uint32_t> &links, double size, double weight);
+  virtual void RemoveFlow (uint32_t fid);
+  /** Link id of dev, priced by the PrioQueue of dev if it has one. */
+  virtual uint32_t GetLinkId (Ptr<NetDevice> dev);
+  /** Register a link priced by queue, at the DataRate of the queue. */
+  uint32_t AddLink (Ptr<PrioQueue> queue);
+
+  /** Rate of fid over the last step in bits per second, 0 for unknown flows. */
+  double GetFluidRate (uint32_t fid) const;
+  /** Fluid backlog of link in bytes. */
+  double GetBacklog (uint32_t link) const;
+  uint64_t GetNSteps (void) const;
+
+protected:
+  virtual void DoDispose (void);
+
+private:
+  struct FluidLink
+  {
+    Ptr<PrioQueue> queue;
+    Ptr<Queue> txQueue; //!< transmit queue, for hybrid runs
+    uint32_t received;  //!< bytes txQueue had received at the last step
+    double packets;     //!< packet rate to serve over the next step, Mbps
+    double backlog;     //!< bytes
+    double offered;     //!< Mbps
+    double served;      //!< Mbps
+    double residue;     //!< smallest residue of the flows of the link
+    double remaining;   //!< capacity left while water filling, Mbps
+    double weights;     //!< weight of the flows not yet frozen
+    uint32_t active;    //!< number of flows not yet frozen
+  };
+
+  struct FluidFlow
+  {
+    double remaining;   //!< bytes, 0 for flows without a size
+    double price;       //!< path price
+    double weight;      //!< requested rate, Mbps
+    double rate;        //!< Mbps
+    bool frozen;
+  };
+
+  void SyncLinks (void);
+  void MeasurePackets (double dt);
+  void ReleaseLinks (void);
+  void Step (void);
+  void ShareWeightedFair (void);
+  void ShareFifo (double dt);
+  double MarginalUtility (const FlowState &flow, double rate);
+
+  std::vector<FluidLink> m_fluidLinks;    //!< indexed like m_links
+  std::vector<FluidFlow> m_fluidFlows;    //!< indexed like m_flows
+
+  Time m_step;
+  Sharing m_sharing;
+  bool m_hybrid;
+  Time m_demandWindow;
+  EventId m_stepEvent;
+  uint64_t m_nSteps;
+
+  TracedCallback<uint32_t, double> m_rateTrace;
+  TracedCallback<uint32_t> m_completedTrace;
+};
+
+} // namespace ns3
+
+#endif /* FLUID_SIMULATOR_H */
@@ -0,0 +1,152 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+
+#include "host-flow-context.h"
+#include "ipv4-l3-protocol.h"
+
+namespace ns3 {
+
+HostFlowContext::HostFlowContext (Ipv4L3Protocol *ipv4, const std::string &flowkey)
+  : m_ipv4 (ipv4),
+    m_flowkey (flowkey),
+    m_fid (0),
+    m_priceValid (0),
+    m_numHops (0),
+    m_instantRate (0),
+    m_longTermRate (0),
+    m_shortTermRate (0),
+    m_measurementRate (0),
+    m_groupId (0),
+    m_groupRate (0.0)
+{
+}
+
+const std::string &
+HostFlowContext::GetFlowKey (void) const
+{
+  return m_flowkey;
+}
+
+uint32_t *
+HostFlowContext::FindFlowId (void)
+{
+  if (m_fid == 0)
+    {
+      Ipv4L3Protocol::FlowId_::iterator it = m_ipv4->flowids.find (m_flowkey);
+      if (it != m_ipv4->flowids.end ())
+        {
+          m_fid = &it->second;
+        }
+    }
+  return m_fid;
+}
+
+uint32_t
+HostFlowContext::GetFlowId (void)
+{
+  uint32_t *fid = FindFlowId ();
+  return fid != 0 ? *fid : 0;
+}
+
+double
+HostFlowContext::GetFlowIdealRate (void)
+{
+  return m_ipv4->flow_idealrate[GetFlowId ()];
+}
+
+void
+HostFlowContext::SetPriceValid (void)
+{
+  if (m_priceValid == 0)
+    {
+      m_priceValid = &m_ipv4->price_valid[m_flowkey];
+    }
+  *m_priceValid = true;
+}
+
+void
+HostFlowContext::SetNumHops (uint32_t hops)
+{
+  if (m_numHops == 0)
+    {
+      m_numHops = &m_ipv4->num_hops[m_flowkey];
+    }
+  *m_numHops = hops;
+}
+
+void
+HostFlowContext::UpdateAverages (double interArrival, double pktsize)
+{
+  m_ipv4->updateAverages (*this, interArrival, pktsize);
+}
+
+double
+HostFlowContext::GetShortTermRate (void)
+{
+  return m_ipv4->GetShortTermRate (*this);
+}
+
+Ptr<SubflowGroup>
+HostFlowContext::GetSubflowGroup (void) const
+{
+  return m_group;
+}
+
+SubflowGroup::SubflowGroup ()
+  : m_aggregate (0.0),
+    m_updates (0)
+{
+}
+
+double
+SubflowGroup::GetAggregateRate (void) const
+{
+  return m_aggregate;
+}
+
+uint32_t
+SubflowGroup::GetSize (void) const
+{
+  return m_members.size ();
+}
+
+void
+SubflowGroup::Add (HostFlowContext *flow, double rate)
+{
+  m_members[flow->m_flowkey] = flow;
+  flow->m_group = this;
+  flow->m_groupRate = rate;
+  Resum ();
+}
+
+void
+SubflowGroup::Remove (HostFlowContext *flow)
+{
+  m_members.erase (flow->m_flowkey);
+  flow->m_group = 0;
+  Resum ();
+}
+
+void
+SubflowGroup::Update (HostFlowContext *flow, double rate)
+{
+  m_aggregate += rate - flow->m_groupRate;
+  flow->m_groupRate = rate;
+  if (++m_updates >= ResumInterval)
+    {
+      Resum ();
+    }
+}
+
+void
+SubflowGroup::Resum (void)
+{
+  m_aggregate = 0.0;
+  for (std::map<std::string, HostFlowContext *>::const_iterator it = m_members.begin ();
+       it != m_members.end (); ++it)
+    {
+      m_aggregate += it->second->m_groupRate;
+    }
+  m_updates = 0;
+}
+
+} // namespace ns3
@@ -0,0 +1,116 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Per-connection handle on the host state of a flow, so that the ACK path
+ * of TcpNewReno reaches it without building the flow key or searching the
+ * per-flow maps of Ipv4L3Protocol.
+ */
+
+#ifndef HOST_FLOW_CONTEXT_H
+#define HOST_FLOW_CONTEXT_H
+
+#include <stdint.h>
+#include <map>
+#include <string>
+#include "ns3/simple-ref-count.h"
+#include "ns3/ptr.h"
+#include "rate-estimator.h"
+
+namespace ns3 {
+
+class Ipv4L3Protocol;
+class HostFlowContext;
+
+/**
+ * \ingroup internet
+ *
+ * \brief The subflows of one multipath connection and the sum of their
+ * short term rates.
+ *
+ * Every member contributes its short term rate, or -1 before its first
+ * sample, as Ipv4L3Protocol::GetRate reads it.  The sum is kept up to date
+ * as the members' rates change and is recomputed from the members, in flow
+ * key order, every ResumInterval updates and whenever a member joins or
+ * leaves, so that rounding does not accumulate.
+ */
+class SubflowGroup : public SimpleRefCount<SubflowGroup>
+{
+public:
+  enum { ResumInterval = 1024 };
+
+  SubflowGroup ();
+
+  double GetAggregateRate (void) const;
+  uint32_t GetSize (void) const;
+
+private:
+  friend class Ipv4L3Protocol;
+
+  void Add (HostFlowContext *flow, double rate);
+  void Remove (HostFlowContext *flow);
+  void Update (HostFlowContext *flow, double rate);
+  void Resum (void);
+
+  std::map<std::string, HostFlowContext *> m_members;
+  double m_aggregate;
+  uint32_t m_updates;
+};
+
+/**
+ * \ingroup internet
+ *
+ * \brief The entries of one flow in the per-flow maps of Ipv4L3Protocol.
+ *
+ * Ipv4L3Protocol::GetFlowContext hands out one context per flow key; a TCP
+ * socket binds it when it connects or is accepted.  The context keeps
+ * pointers to the flow's entries in the IP layer maps: std::map never
+ * moves its elements and the IP layer never erases these entries, except
+ * the flow id, which removeFlow unbinds.  An entry the IP layer has not
+ * created yet is looked up once, when first needed, so the maps read the
+ * same as with the string keyed calls.
+ */
+class HostFlowContext : public SimpleRefCount<HostFlowContext>
+{
+public:
+  HostFlowContext (Ipv4L3Protocol *ipv4, const std::string &flowkey);
+
+  /** local address:peer address:peer port */
+  const std::string &GetFlowKey (void) const;
+  /** 0 for a flow never registered with Ipv4L3Protocol::setFlow */
+  uint32_t GetFlowId (void);
+  double GetFlowIdealRate (void);
+
+  void SetPriceValid (void);
+  void SetNumHops (uint32_t hops);
+  /** Ipv4L3Protocol::updateAverages of this flow */
+  void UpdateAverages (double interArrival, double pktsize);
+  /** Mbps, -1 before the first rate sample */
+  double GetShortTermRate (void);
+  /** the group this flow counts in while it is registered, 0 if none */
+  Ptr<SubflowGroup> GetSubflowGroup (void) const;
+
+private:
+  friend class Ipv4L3Protocol;
+  friend class SubflowGroup;
+
+  /** the flow id entry, 0 if there is none */
+  uint32_t *FindFlowId (void);
+
+  Ipv4L3Protocol *m_ipv4;
+  std::string m_flowkey;
+  uint32_t *m_fid;
+  bool *m_priceValid;
+  uint32_t *m_numHops;
+  double *m_instantRate;
+  EwmaRate *m_longTermRate;
+  EwmaRate *m_shortTermRate;
+  EwmaRate *m_measurementRate;
+  /* Ipv4L3Protocol::SetSubflowGroup, 0 by default */
+  uint32_t m_groupId;
+  Ptr<SubflowGroup> m_group;
+  /* the rate this flow last added to m_group */
+  double m_groupRate;
+};
+
+} // namespace ns3
+
+#endif /* HOST_FLOW_CONTEXT_H */
@@ -15,6 +15,7 @@
 #include "ns3/data-rate.h"
 #include "ns3/boolean.h"
 #include "tcp-header.h"
+#include "flow-fifo.h"
 
 //#include "ns3/traced-callback.h"
 
@@ -79,8 +80,6 @@ private:
   virtual bool DoEnqueue (Ptr<Packet> p);
   virtual Ptr<Packet> DoDequeue (void);
 
-  bool enqueue(Ptr<Packet> p, uint32_t flowid);
-  bool removeW2FQ(Ptr<Packet> p, int32_t flowid);
   bool removeFifo(Ptr<Packet> p);
   uint32_t turn;
 
@@ -89,21 +88,14 @@ private:
   uint32_t m_fifosize;
   uint32_t m_fifobytesInQueue;
 
-  std::map<uint32_t, std::queue<Ptr <Packet> > >m_packets; //!< the packets in the queue
-  std::map<uint32_t, uint32_t> m_size;
+  FlowFifoTable m_flows;              //!< the packets and the fair queueing state of the known flows
   std::map<std::string, uint32_t> flow_ids;
   std::map<uint32_t, double> flow_weights;
   uint32_t m_maxPackets;              //!< max packets in the queue
   uint32_t m_maxBytes;                //!< max bytes in the queue
-  std::map<uint32_t, uint32_t> m_bytesInQueue;            //!< actual bytes in the queue
   DataRate m_bps;
   QueueMode m_mode;                   //!< queue mode (packets or bytes limited)
   double current_virtualtime;
-  std::map<uint32_t, double> local_flow_weights;
-
-  
-  std::map<uint32_t, double> start_time;
-  std::map<uint32_t, double> finish_time;
 
   double current_slope;
   double CalcSlope(void);
@@ -114,8 +106,9 @@ private:
   
   double getWFQweight(Ptr<Packet> p);
   bool QueueEmpty(void);
-  void resetFlows(uint32_t fid, Ptr<Packet> p);
-  void re_resetFlows(uint32_t fid, Ptr<Packet> p);
+  void resetFlows(uint32_t handle, Ptr<Packet> p);
+  void re_resetFlows(uint32_t handle, Ptr<Packet> p);
+  void UpdateVirtualTime(double min_starttime);
   
   TcpHeader GetTCPHeader(Ptr<Packet> p);
   Ptr<const Packet> DoPeek (void) const;
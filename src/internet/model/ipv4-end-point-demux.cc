@@ -26,8 +26,33 @@ namespace ns3 {
 
 NS_LOG_COMPONENT_DEFINE ("Ipv4EndPointDemux");
 
+Ipv4EndPointDemux::EndPointKey::EndPointKey (Ipv4Address localAddress, uint16_t localPort,
+                                              Ipv4Address peerAddress, uint16_t peerPort)
+  : localAddress (localAddress.Get ()),
+    peerAddress (peerAddress.Get ()),
+    localPort (localPort),
+    peerPort (peerPort)
+{
+}
+
+bool
+Ipv4EndPointDemux::EndPointKey::operator== (const EndPointKey &other) const
+{
+  return localAddress == other.localAddress && peerAddress == other.peerAddress &&
+         localPort == other.localPort && peerPort == other.peerPort;
+}
+
+size_t
+Ipv4EndPointDemux::EndPointKeyHash::operator() (const EndPointKey &key) const
+{
+  uint32_t h = key.localAddress;
+  h = h * 31 + key.peerAddress;
+  h = h * 31 + ((uint32_t (key.localPort) << 16) | key.peerPort);
+  return h ^ (h >> 16);
+}
+
 Ipv4EndPointDemux::Ipv4EndPointDemux ()
-  : m_ephemeral (49152), m_portLast (65535), m_portFirst (49152)
+  : m_ephemeral (49152), m_portLast (65535), m_portFirst (49152), m_nEndPoints (0)
 {
   NS_LOG_FUNCTION (this);
 }
@@ -35,36 +60,73 @@ Ipv4EndPointDemux::Ipv4EndPointDemux ()
 Ipv4EndPointDemux::~Ipv4EndPointDemux ()
 {
   NS_LOG_FUNCTION (this);
-  for (EndPointsI i = m_endPoints.begin (); i != m_endPoints.end (); i++) 
+  for (PortTable::iterator p = m_ports.begin (); p != m_ports.end (); p++)
     {
-      Ipv4EndPoint *endPoint = *i;
-      delete endPoint;
+      for (EndPointsI i = p->second.begin (); i != p->second.end (); i++) 
+        {
+          Ipv4EndPoint *endPoint = *i;
+          endPoint->m_demux = 0;
+          delete endPoint;
+        }
+    }
+  m_ports.clear ();
+  m_tuples.clear ();
+}
+
+void
+Ipv4EndPointDemux::Insert (Ipv4EndPoint *endPoint)
+{
+  m_ports[endPoint->GetLocalPort ()].push_back (endPoint);
+  Index (endPoint);
+  endPoint->m_demux = this;
+  m_nEndPoints++;
+  NS_LOG_DEBUG ("Now have >>" << m_nEndPoints << "<< endpoints.");
+}
+
+void
+Ipv4EndPointDemux::Index (Ipv4EndPoint *endPoint)
+{
+  EndPointKey key (endPoint->GetLocalAddress (), endPoint->GetLocalPort (),
+                   endPoint->GetPeerAddress (), endPoint->GetPeerPort ());
+  m_tuples[key].push_back (endPoint);
+}
+
+void
+Ipv4EndPointDemux::Unindex (Ipv4EndPoint *endPoint)
+{
+  EndPointKey key (endPoint->GetLocalAddress (), endPoint->GetLocalPort (),
+                   endPoint->GetPeerAddress (), endPoint->GetPeerPort ());
+  TupleTable::iterator t = m_tuples.find (key);
+  if (t == m_tuples.end ())
+    {
+      return;
+    }
+  t->second.remove (endPoint);
+  if (t->second.empty ())
+    {
+      m_tuples.erase (t);
     }
-  m_endPoints.clear ();
 }
 
 bool
 Ipv4EndPointDemux::LookupPortLocal (uint16_t port)
 {
   NS_LOG_FUNCTION (this << port);
-  for (EndPointsI i = m_endPoints.begin (); i != m_endPoints.end (); i++) 
-    {
-      if ((*i)->GetLocalPort  () == port) 
-        {
-          return true;
-        }
-    }
-  return false;
+  return m_ports.find (port) != m_ports.end ();
 }
 
 bool
 Ipv4EndPointDemux::LookupLocal (Ipv4Address addr, uint16_t port)
 {
   NS_LOG_FUNCTION (this << addr << port);
-  for (EndPointsI i = m_endPoints.begin (); i != m_endPoints.end (); i++) 
+  PortTable::iterator p = m_ports.find (port);
+  if (p == m_ports.end ())
     {
-      if ((*i)->GetLocalPort () == port &&
-          (*i)->GetLocalAddress () == addr) 
+      return false;
+    }
+  for (EndPointsI i = p->second.begin (); i != p->second.end (); i++) 
+    {
+      if ((*i)->GetLocalAddress () == addr) 
         {
           return true;
         }
@@ -83,8 +145,7 @@ Ipv4EndPointDemux::Allocate (void)
       return 0;
     }
   Ipv4EndPoint *endPoint = new Ipv4EndPoint (Ipv4Address::GetAny (), port);
-  m_endPoints.push_back (endPoint);
-  NS_LOG_DEBUG ("Now have >>" << m_endPoints.size () << "<< endpoints.");
+  Insert (endPoint);
   return endPoint;
 }
 
@@ -99,8 +160,7 @@ Ipv4EndPointDemux::Allocate (Ipv4Address address)
       return 0;
     }
   Ipv4EndPoint *endPoint = new Ipv4EndPoint (address, port);
-  m_endPoints.push_back (endPoint);
-  NS_LOG_DEBUG ("Now have >>" << m_endPoints.size () << "<< endpoints.");
+  Insert (endPoint);
   return endPoint;
 }
 
@@ -122,8 +182,7 @@ Ipv4EndPointDemux::Allocate (Ipv4Address address, uint16_t port)
       return 0;
     }
   Ipv4EndPoint *endPoint = new Ipv4EndPoint (address, port);
-  m_endPoints.push_back (endPoint);
-  NS_LOG_DEBUG ("Now have >>" << m_endPoints.size () << "<< endpoints.");
+  Insert (endPoint);
   return endPoint;
 }
 
@@ -132,23 +191,15 @@ Ipv4EndPointDemux::Allocate (Ipv4Address localAddress, uint16_t localPort,
                              Ipv4Address peerAddress, uint16_t peerPort)
 {
   NS_LOG_FUNCTION (this << localAddress << localPort << peerAddress << peerPort);
-  for (EndPointsI i = m_endPoints.begin (); i != m_endPoints.end (); i++) 
+  if (m_tuples.find (EndPointKey (localAddress, localPort, peerAddress, peerPort)) != m_tuples.end ())
     {
-      if ((*i)->GetLocalPort () == localPort &&
-          (*i)->GetLocalAddress () == localAddress &&
-          (*i)->GetPeerPort () == peerPort &&
-          (*i)->GetPeerAddress () == peerAddress) 
-        {
-          NS_LOG_WARN ("No way we can allocate this end-point.");
-          /* no way we can allocate this end-point. */
-          return 0;
-        }
+      NS_LOG_WARN ("No way we can allocate this end-point.");
+      /* no way we can allocate this end-point. */
+      return 0;
     }
   Ipv4EndPoint *endPoint = new Ipv4EndPoint (localAddress, localPort);
   endPoint->SetPeer (peerAddress, peerPort);
-  m_endPoints.push_back (endPoint);
-
-  NS_LOG_DEBUG ("Now have >>" << m_endPoints.size () << "<< endpoints.");
+  Insert (endPoint);
 
   return endPoint;
 }
@@ -157,12 +208,24 @@ void
 Ipv4EndPointDemux::DeAllocate (Ipv4EndPoint *endPoint)
 {
   NS_LOG_FUNCTION (this << endPoint);
-  for (EndPointsI i = m_endPoints.begin (); i != m_endPoints.end (); i++) 
+  PortTable::iterator p = m_ports.find (endPoint->GetLocalPort ());
+  if (p == m_ports.end ())
+    {
+      return;
+    }
+  for (EndPointsI i = p->second.begin (); i != p->second.end (); i++) 
     {
       if (*i == endPoint)
         {
+          Unindex (endPoint);
+          p->second.erase (i);
+          if (p->second.empty ())
+            {
+              m_ports.erase (p);
+            }
+          m_nEndPoints--;
+          endPoint->m_demux = 0;
           delete endPoint;
-          m_endPoints.erase (i);
           break;
         }
     }
@@ -177,10 +240,9 @@ Ipv4EndPointDemux::GetAllEndPoints (void)
   NS_LOG_FUNCTION (this);
   EndPoints ret;
 
-  for (EndPointsI i = m_endPoints.begin (); i != m_endPoints.end (); i++)
+  for (PortTable::iterator p = m_ports.begin (); p != m_ports.end (); p++)
     {
-      Ipv4EndPoint* endP = *i;
-      ret.push_back (endP);
+      ret.insert (ret.end (), p->second.begin (), p->second.end ());
     }
   return ret;
 }
@@ -190,6 +252,10 @@ Ipv4EndPointDemux::GetAllEndPoints (void)
  * If we have an exact match, we return it.
  * Otherwise, if we find a generic match, we return it.
  * Otherwise, we return 0.
+ *
+ * A single unicast exact match comes straight from the four-tuple index;
+ * everything else is decided by the rules below over the endpoints of the
+ * destination port only.
  */
 Ipv4EndPointDemux::EndPoints
 Ipv4EndPointDemux::Lookup (Ipv4Address daddr, uint16_t dport, 
@@ -204,21 +270,47 @@ Ipv4EndPointDemux::Lookup (Ipv4Address daddr, uint16_t dport,
   EndPoints retval4; // Exact match on all 4
 
   NS_LOG_DEBUG ("Looking up endpoint for destination address " << daddr);
-  for (EndPointsI i = m_endPoints.begin (); i != m_endPoints.end (); i++) 
+  bool subnetDirected = false;
+  Ipv4Address incomingInterfaceAddr = daddr;  // may be a broadcast
+  for (uint32_t i = 0; i < incomingInterface->GetNAddresses (); i++)
+    {
+      Ipv4InterfaceAddress addr = incomingInterface->GetAddress (i);
+      if (addr.GetLocal ().CombineMask (addr.GetMask ()) == daddr.CombineMask (addr.GetMask ()) &&
+          daddr.IsSubnetDirectedBroadcast (addr.GetMask ()))
+        {
+          subnetDirected = true;
+          incomingInterfaceAddr = addr.GetLocal ();
+        }
+    }
+  bool isBroadcast = (daddr.IsBroadcast () || subnetDirected == true);
+  NS_LOG_DEBUG ("dest addr " << daddr << " broadcast? " << isBroadcast);
+
+  if (!isBroadcast)
+    {
+      TupleTable::iterator t = m_tuples.find (EndPointKey (daddr, dport, saddr, sport));
+      if (t != m_tuples.end () && t->second.size () == 1)
+        {
+          Ipv4EndPoint* endP = t->second.front ();
+          if (!endP->GetBoundNetDevice () ||
+              endP->GetBoundNetDevice () == incomingInterface->GetDevice ())
+            {
+              return t->second;
+            }
+        }
+    }
+
+  PortTable::iterator p = m_ports.find (dport);
+  if (p == m_ports.end ())
+    {
+      return retval1;
+    }
+  for (EndPointsI i = p->second.begin (); i != p->second.end (); i++) 
     {
       Ipv4EndPoint* endP = *i;
       NS_LOG_DEBUG ("Looking at endpoint dport=" << endP->GetLocalPort ()
                                                  << " daddr=" << endP->GetLocalAddress ()
                                                  << " sport=" << endP->GetPeerPort ()
                                                  << " saddr=" << endP->GetPeerAddress ());
-      if (endP->GetLocalPort () != dport) 
-        {
-          NS_LOG_LOGIC ("Skipping endpoint " << &endP
-                                             << " because endpoint dport "
-                                             << endP->GetLocalPort ()
-                                             << " does not match packet dport " << dport);
-          continue;
-        }
       if (endP->GetBoundNetDevice ())
         {
           if (endP->GetBoundNetDevice () != incomingInterface->GetDevice ())
@@ -230,20 +322,6 @@ Ipv4EndPointDemux::Lookup (Ipv4Address daddr, uint16_t dport,
               continue;
             }
         }
-      bool subnetDirected = false;
-      Ipv4Address incomingInterfaceAddr = daddr;  // may be a broadcast
-      for (uint32_t i = 0; i < incomingInterface->GetNAddresses (); i++)
-        {
-          Ipv4InterfaceAddress addr = incomingInterface->GetAddress (i);
-          if (addr.GetLocal ().CombineMask (addr.GetMask ()) == daddr.CombineMask (addr.GetMask ()) &&
-              daddr.IsSubnetDirectedBroadcast (addr.GetMask ()))
-            {
-              subnetDirected = true;
-              incomingInterfaceAddr = addr.GetLocal ();
-            }
-        }
-      bool isBroadcast = (daddr.IsBroadcast () || subnetDirected == true);
-      NS_LOG_DEBUG ("dest addr " << daddr << " broadcast? " << isBroadcast);
       bool localAddressMatchesWildCard = 
         endP->GetLocalAddress () == Ipv4Address::GetAny ();
       bool localAddressMatchesExact = endP->GetLocalAddress () == daddr;
@@ -315,16 +393,24 @@ Ipv4EndPointDemux::SimpleLookup (Ipv4Address daddr,
 {
   NS_LOG_FUNCTION (this << daddr << dport << saddr << sport);
 
+  TupleTable::iterator t = m_tuples.find (EndPointKey (daddr, dport, saddr, sport));
+  if (t != m_tuples.end () && t->second.size () == 1)
+    {
+      /* this is an exact match. */
+      return t->second.front ();
+    }
+
   // this code is a copy/paste version of an old BSD ip stack lookup
   // function.
   uint32_t genericity = 3;
   Ipv4EndPoint *generic = 0;
-  for (EndPointsI i = m_endPoints.begin (); i != m_endPoints.end (); i++) 
+  PortTable::iterator p = m_ports.find (dport);
+  if (p == m_ports.end ())
+    {
+      return 0;
+    }
+  for (EndPointsI i = p->second.begin (); i != p->second.end (); i++) 
     {
-      if ((*i)->GetLocalPort () != dport) 
-        {
-          continue;
-        }
       if ((*i)->GetLocalAddress () == daddr &&
           (*i)->GetPeerPort () == sport &&
           (*i)->GetPeerAddress () == saddr) 
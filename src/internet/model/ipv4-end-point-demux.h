@@ -24,6 +24,7 @@
 #include <stdint.h>
 #include <list>
 #include "ns3/ipv4-address.h"
+#include "ns3/sgi-hashmap.h"
 #include "ipv4-interface.h"
 
 namespace ns3 {
@@ -34,13 +35,18 @@ class Ipv4EndPoint;
  * \brief Demultiplexes packets to various transport layer endpoints
  *
  * This class serves as a lookup table to match partial or full information
- * about a four-tuple to an ns3::Ipv4EndPoint.  It internally contains a list
- * of endpoints, and has APIs to add and find endpoints in this demux.  This
- * code is shared in common to TCP and UDP protocols in ns3.  This demux
- * sits between ns3's layer four and the socket layer
+ * about a four-tuple to an ns3::Ipv4EndPoint.  It internally indexes the
+ * endpoints by local port, and by their full four-tuple so that the exact
+ * match of a received segment is found without scanning the endpoints of a
+ * busy port.  Endpoints notify the demux when their local address or peer
+ * change so the four-tuple index stays current.  It has APIs to add and
+ * find endpoints in this demux.  This code is shared in common to TCP and
+ * UDP protocols in ns3.  This demux sits between ns3's layer four and the
+ * socket layer
  */
 
 class Ipv4EndPointDemux {
+  friend class Ipv4EndPoint;
 public:
   /**
    * \brief Container of the IPv4 endpoints.
@@ -153,6 +159,60 @@ public:
 
 private:
 
+  /**
+   * \brief Four-tuple of an end point, local side first.
+   */
+  struct EndPointKey
+  {
+    EndPointKey (Ipv4Address localAddress, uint16_t localPort,
+                 Ipv4Address peerAddress, uint16_t peerPort);
+    bool operator== (const EndPointKey &other) const;
+    uint32_t localAddress;
+    uint32_t peerAddress;
+    uint16_t localPort;
+    uint16_t peerPort;
+  };
+
+  /**
+   * \brief Hash of an EndPointKey.
+   */
+  struct EndPointKeyHash
+  {
+    size_t operator() (const EndPointKey &key) const;
+  };
+
+  /**
+   * \brief Endpoints by local port, in allocation order.
+   */
+  typedef sgi::hash_map<uint16_t, EndPoints> PortTable;
+
+  /**
+   * \brief Endpoints by their current four-tuple.
+   */
+  typedef sgi::hash_map<EndPointKey, EndPoints, EndPointKeyHash> TupleTable;
+
+  /**
+   * \brief Add a new end point to both indexes.
+   * \param endPoint the end point
+   */
+  void Insert (Ipv4EndPoint *endPoint);
+
+  /**
+   * \brief Add an end point to the four-tuple index.
+   *
+   * Also called by Ipv4EndPoint after its local address or peer changed.
+   * \param endPoint the end point
+   */
+  void Index (Ipv4EndPoint *endPoint);
+
+  /**
+   * \brief Remove an end point from the four-tuple index.
+   *
+   * Also called by Ipv4EndPoint before its local address or peer change.
+   * \param endPoint the end point
+   */
+  void Unindex (Ipv4EndPoint *endPoint);
+
   /**
    * \brief Allocate an ephemeral port.
    * \returns the ephemeral port
@@ -175,9 +235,19 @@ private:
   uint16_t m_portFirst;
 
   /**
-   * \brief A list of IPv4 end points.
+   * \brief The number of end points.
+   */
+  uint32_t m_nEndPoints;
+
+  /**
+   * \brief IPv4 end points by local port.
+   */
+  PortTable m_ports;
+
+  /**
+   * \brief IPv4 end points by four-tuple.
    */
-  EndPoints m_endPoints;
+  TupleTable m_tuples;
 };
 
 } // namespace ns3
@@ -32,6 +32,7 @@ namespace ns3 {
 
 class Header;
 class Packet;
+class Ipv4EndPointDemux;
 
 /**
  * \brief A representation of an internet endpoint/connection
@@ -45,6 +46,7 @@ class Packet;
  */
 
 class Ipv4EndPoint {
+  friend class Ipv4EndPointDemux;
 public:
   /**
    * \brief Constructor.
@@ -215,6 +217,11 @@ private:
    */
   Ptr<NetDevice> m_boundnetdevice;
 
+  /**
+   * \brief The demux indexing this EndPoint by its four-tuple (if any).
+   */
+  Ipv4EndPointDemux *m_demux;
+
   /**
    * \brief The RX callback.
    */
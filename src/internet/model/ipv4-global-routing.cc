@@ -17,6 +17,7 @@
 //
 
 #include <vector>
+#include <map>
 #include <iomanip>
 #include "ns3/names.h"
 #include "ns3/log.h"
@@ -462,6 +463,103 @@ Ipv4GlobalRouting::RemoveRoute (uint32_t index)
   NS_ASSERT (false);
 }
 
+namespace {
+
+// next hops (interface, gateway) of one destination network, in table order
+typedef std::vector<std::pair<uint32_t, uint32_t> > NextHops;
+
+// the destination networks (address, mask) under one covering prefix
+struct AggregateGroup
+{
+  AggregateGroup () : mergeable (false) {}
+  std::map<std::pair<uint32_t, uint32_t>, NextHops> networks;
+  bool mergeable;
+};
+
+} // anonymous namespace
+
+uint32_t
+Ipv4GlobalRouting::AggregateNetworkRoutes (Ipv4Mask mask)
+{
+  NS_LOG_FUNCTION (this << mask);
+  typedef AggregateGroup Group;
+  typedef std::map<uint32_t, Group> Groups;
+
+  uint16_t length = mask.GetPrefixLength ();
+  Groups groups;
+  std::vector<Ipv4RoutingTableEntry *> covering;
+  for (NetworkRoutesCI j = m_networkRoutes.begin (); j != m_networkRoutes.end (); j++)
+    {
+      Ipv4Mask routeMask = (*j)->GetDestNetworkMask ();
+      if (routeMask.GetPrefixLength () < length)
+        {
+          covering.push_back (*j);
+          continue;
+        }
+      uint32_t network = (*j)->GetDestNetwork ().Get ();
+      Group &group = groups[mask.Get () & network];
+      group.networks[std::make_pair (network, routeMask.Get ())].push_back (
+        std::make_pair ((*j)->GetInterface (), (*j)->GetGateway ().Get ()));
+    }
+
+  for (Groups::iterator g = groups.begin (); g != groups.end (); g++)
+    {
+      Group &group = g->second;
+      if (group.networks.size () < 2)
+        {
+          continue;
+        }
+      const NextHops &first = group.networks.begin ()->second;
+      group.mergeable = true;
+      for (std::map<std::pair<uint32_t, uint32_t>, NextHops>::const_iterator n = group.networks.begin ();
+           n != group.networks.end () && group.mergeable; n++)
+        {
+          group.mergeable = (n->second == first);
+        }
+      for (uint32_t c = 0; c < covering.size () && group.mergeable; c++)
+        {
+          group.mergeable = !covering[c]->GetDestNetworkMask ().IsMatch (Ipv4Address (g->first),
+                                                                         covering[c]->GetDestNetwork ());
+        }
+    }
+
+  uint32_t before = m_networkRoutes.size ();
+  NetworkRoutes routes;
+  std::map<uint32_t, bool> emitted;
+  for (NetworkRoutesI j = m_networkRoutes.begin (); j != m_networkRoutes.end (); j++)
+    {
+      if ((*j)->GetDestNetworkMask ().GetPrefixLength () < length)
+        {
+          routes.push_back (*j);
+          continue;
+        }
+      uint32_t prefix = mask.Get () & (*j)->GetDestNetwork ().Get ();
+      Group &group = groups[prefix];
+      if (!group.mergeable)
+        {
+          routes.push_back (*j);
+          continue;
+        }
+      if (!emitted[prefix])
+        {
+          const NextHops &hops = group.networks.begin ()->second;
+          for (uint32_t h = 0; h < hops.size (); h++)
+            {
+              Ipv4RoutingTableEntry *route = new Ipv4RoutingTableEntry ();
+              *route = Ipv4RoutingTableEntry::CreateNetworkRouteTo (Ipv4Address (prefix), mask,
+                                                                    Ipv4Address (hops[h].second),
+                                                                    hops[h].first);
+              routes.push_back (route);
+            }
+          emitted[prefix] = true;
+          NS_LOG_LOGIC ("Aggregated " << group.networks.size () << " networks into " << Ipv4Address (prefix) << mask);
+        }
+      delete *j;
+    }
+  m_networkRoutes.swap (routes);
+  return before - m_networkRoutes.size ();
+}
+
 int64_t
 Ipv4GlobalRouting::AssignStreams (int64_t stream)
 {
@@ -216,6 +216,25 @@ public:
    */
   void RemoveRoute (uint32_t i);
 
+  /**
+   * \brief Replace network routes by routes to a covering prefix.
+   *
+   * The network routes are grouped by the prefix \p mask selects from their
+   * destination.  A group is replaced by routes to that prefix when it holds
+   * more than one destination network and every destination is reached over
+   * the same next hops, listed in the same order.  The aggregate routes take
+   * the place of the first route of the group, so lookups, including the
+   * flow ECMP choice, return the same next hop for every address the
+   * replaced routes matched.  Groups that a route with a shorter mask also
+   * covers are left alone.
+   *
+   * Routes recomputed by global routing later are not aggregated again.
+   *
+   * \param mask the mask of the covering prefixes, e.g. one prefix per leaf
+   * \returns the number of routes removed from the table
+   */
+  uint32_t AggregateNetworkRoutes (Ipv4Mask mask);
+
   /**
    * Assign a fixed random variable stream number to the random variables
    * used by this model.  Return the number of streams (possibly zero) that
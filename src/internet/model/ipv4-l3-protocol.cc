@@ -101,6 +101,12 @@ Ipv4L3Protocol::GetTypeId (void)
                    UintegerValue (1),
                    MakeUintegerAccessor (&Ipv4L3Protocol::m_method),
                    MakeUintegerChecker<uint8_t> ())
+    .AddAttribute ("FastRateDecay",
+                   "Evaluate the decay of the per-flow rate EWMAs from a table instead of exp (relative error below 2e-6).",
+                   BooleanValue (false),
+                   MakeBooleanAccessor (&Ipv4L3Protocol::SetFastRateDecay,
+                                        &Ipv4L3Protocol::GetFastRateDecay),
+                   MakeBooleanChecker ())
     .AddAttribute ("DefaultTtl", "The TTL value set by default on all outgoing packets generated on this node.",
                    UintegerValue (64),
                    MakeUintegerAccessor (&Ipv4L3Protocol::m_defaultTtl),
@@ -127,6 +133,8 @@ Ipv4L3Protocol::GetTypeId (void)
                      MakeTraceSourceAccessor (&Ipv4L3Protocol::m_unicastForwardTrace))
     .AddTraceSource ("LocalDeliver", "An IPv4 packet was received by/for this node, and it is being forward up the stack",
                      MakeTraceSourceAccessor (&Ipv4L3Protocol::m_localDeliverTrace))
+    .AddTraceSource ("MeasurementRate", "The measured rate of a flow sourced at this node was updated",
+                     MakeTraceSourceAccessor (&Ipv4L3Protocol::m_measurementRateTrace))
 
   ;
   return tid;
@@ -172,6 +180,7 @@ double Ipv4L3Protocol::SetFlowRtt(double rtt, std::string fkey)
 {
 	flow_rtt[fkey] = rtt;
 	//std::cout<<" RTTUPDATE Node "<<m_node->GetId()<<" flow "<<fkey<<" time "<<Simulator::Now().GetSeconds()<<" rtt "<<rtt<<std::endl;
+	return rtt;
 }
 
 
@@ -244,6 +253,11 @@ Ipv4L3Protocol::Ipv4L3Protocol()
     
   long_ewma_const = 50000;
   short_ewma_const = 10000; // KANTHI - TEST - REMOVE
+  measurement_ewma_const = short_ewma_const;
+  m_fastRateDecay = false;
+  m_longDecay = RateDecay(long_ewma_const);
+  m_shortDecay = RateDecay(short_ewma_const);
+  m_measurementDecay = RateDecay(measurement_ewma_const);
   next_deadline = 0.0;
   last_deadline = 0.0;
   
@@ -365,17 +379,33 @@ void Ipv4L3Protocol::setmeasurement_ewma_const(double kvalue)
 {
 //  std::cout<<"Setting long_ewma_const to "<<kvalue<<std::endl;
   measurement_ewma_const = kvalue;
+  m_measurementDecay = RateDecay(kvalue, m_fastRateDecay);
 }
 void Ipv4L3Protocol::setlong_ewma_const(double kvalue)
 {
 //  std::cout<<"Setting long_ewma_const to "<<kvalue<<std::endl;
   long_ewma_const = kvalue;
+  m_longDecay = RateDecay(kvalue, m_fastRateDecay);
 }
 
 void Ipv4L3Protocol::setshort_ewma_const(double kvalue)
 {
 //  std::cout<<"Setting short_ewma_const to "<<kvalue<<std::endl;
   short_ewma_const = kvalue;
+  m_shortDecay = RateDecay(kvalue, m_fastRateDecay);
+}
+
+void Ipv4L3Protocol::SetFastRateDecay(bool fast)
+{
+  m_fastRateDecay = fast;
+  m_longDecay = RateDecay(long_ewma_const, fast);
+  m_shortDecay = RateDecay(short_ewma_const, fast);
+  m_measurementDecay = RateDecay(measurement_ewma_const, fast);
+}
+
+bool Ipv4L3Protocol::GetFastRateDecay(void) const
+{
+  return m_fastRateDecay;
 }
 
 void Ipv4L3Protocol::setLineRate(double d)
@@ -540,6 +570,8 @@ Ipv4L3Protocol::DoDispose (void)
 
   m_fragments.clear ();
   m_fragmentsTimers.clear ();
+  m_flowContexts.clear ();
+  m_subflowGroups.clear ();
 
   Object::DoDispose ();
 }
@@ -1156,6 +1188,18 @@ double Ipv4L3Protocol::GetShortTermRate(std::string fkey)
   return GetRate(fkey, SHORTER);
 }
 
+double Ipv4L3Protocol::GetShortTermRate(HostFlowContext &flow)
+{
+  if(flow.m_shortTermRate == 0) {
+    FlowRate_::iterator it = short_term_ewma_rate.find(flow.m_flowkey);
+    if(it == short_term_ewma_rate.end()) {
+      return -1;
+    }
+    flow.m_shortTermRate = &it->second;
+  }
+  return flow.m_shortTermRate->rate;
+}
+
 double Ipv4L3Protocol::GetMeasurementRate(std::string fkey)
 {
   return GetRate(fkey, MEASUREMENT);
@@ -1167,19 +1211,19 @@ double Ipv4L3Protocol::GetRate(std::string fkey, Term term)
     if (long_term_ewma_rate.find(fkey) == long_term_ewma_rate.end()) {
       return -1;
     }
-    return long_term_ewma_rate[fkey];
+    return long_term_ewma_rate[fkey].rate;
   }
   if(term == SHORTER) {
     if (short_term_ewma_rate.find(fkey) == short_term_ewma_rate.end()) {
       return -1;
     }
-    return short_term_ewma_rate[fkey];
+    return short_term_ewma_rate[fkey].rate;
   }
   if(term == MEASUREMENT) {
     if (measurement_rate.find(fkey) == measurement_rate.end()) {
       return -1;
     }
-    return measurement_rate[fkey];
+    return measurement_rate[fkey].rate;
   }
   return -1;
     
@@ -1187,12 +1231,14 @@ double Ipv4L3Protocol::GetRate(std::string fkey, Term term)
 
 double Ipv4L3Protocol::GetCSFQRate(std::string fkey)
 {
-  return long_term_ewma_rate[fkey];
+  return long_term_ewma_rate[fkey].rate;
 }
 
 double Ipv4L3Protocol::GetShortRate(std::string fkey)
 {
-  return short_term_ewma_rate[fkey];
+  // no entry is created, so GetRate still tells unsampled flows apart
+  FlowRate_::iterator it = short_term_ewma_rate.find(fkey);
+  return it != short_term_ewma_rate.end() ? it->second.rate : 0.0;
 }
 double Ipv4L3Protocol::GetStoreDestRate(std::string fkey)
 {
@@ -1322,14 +1368,8 @@ void Ipv4L3Protocol::updateMarginalUtility(std::string fkey, double cur_rate1)
 
   double cur_rate = 0.0;
   if(m_mptcp) {
-    std::map<std::string, uint32_t>::iterator it;
-    for (it=flowids.begin(); it!=flowids.end(); ++it) {
-       //if(it->second != 0 && it->second != fid) {
-       if(it->second != 0) {
-     //     std::cout<<" Marginal utility adding subflow "<<it->first<<" with id "<<it->second<<" on node "<<m_node->GetId()<<" my id "<<fid<<" my rate "<<cur_rate1<<" adding "<<GetRate(it->first, SHORTER)<<" my key "<<fkey<<std::endl;
-         cur_rate += GetRate(it->first, SHORTER);
-       }
-    }
+    // summed short term rate of the subflows of this connection
+    cur_rate = GetSubflowRate(*GetFlowContext(fkey));
   } else {
     cur_rate = cur_rate1;
   }
@@ -1382,13 +1422,18 @@ bool Ipv4L3Protocol::isDestination(std::string node)
 
 void Ipv4L3Protocol::removeFromDropList(uint32_t id)
 {
-  drop_list[id] = 0;
+  if(id < drop_list.size()) {
+    drop_list[id] = 0;
+  }
 }
   
 
 void Ipv4L3Protocol::addToDropList(uint32_t id)
 {
   NS_LOG_LOGIC(Simulator::Now().GetSeconds()<<" nodeid "<<m_node->GetId()<<" added flow "<<id<<" to drop list");
+  if(id >= drop_list.size()) {
+    drop_list.resize(id + 1, 0);
+  }
   drop_list[id] = 1;
 }
 
@@ -1470,24 +1515,15 @@ double Ipv4L3Protocol::getVirtualPktLength(Ptr<Packet> packet, Ipv4Header &ipHea
 	if(m_mptcp) {
        /* sum up rates of all other subflows */
        /* this flow's id */
-      uint32_t own_id = flowids[flowkey];
-      double subflow_sum = 0.0;
-      std::map<std::string, uint32_t>::iterator it;
-      for (it=flowids.begin(); it!=flowids.end(); ++it) {
- //        if(own_id == it->second || it->second == 0) {
-         if(it->second == 0) {
-           continue;
-         }
-     //   std::cout<<" Target rate adding subflow "<<it->first<<" with id "<<it->second<<" on node "<<m_node->GetId()<<" my id "<<own_id<<std::endl;
-        subflow_sum += GetRate(it->first, SHORTER);
-       }
+      HostFlowContext &flow = *GetFlowContext(flowkey);
+      double subflow_sum = GetSubflowRate(flow);
 
        // subtract this from target rate
      //  double final_rate = target_rate - subflow_sum;
       // target_rate -= subflow_sum;
       double final_rate = target_rate;
        if(subflow_sum > 0.0)
-         final_rate = GetRate(flowkey, SHORTER) * (target_rate / subflow_sum);
+         final_rate = GetShortTermRate(flow) * (target_rate / subflow_sum);
 //       std::cout<<" target_rate_debug node "<<m_node->GetId()<<" "<<Simulator::Now().GetSeconds     ()<<" flow "<<own_id<<" target_rate "<<target_rate<<" final_rate "<<final_rate<<" subflow_sum      "<<subflow_sum<<std::endl;
        target_rate = final_rate;
      }
@@ -1562,78 +1598,132 @@ double Ipv4L3Protocol::get_wfq_weight(Ptr<Packet> packet, Ipv4Header &ipHeader)
 //   return ((packet->GetSize()+30.0)*8.0) / fweight;
 }
 
+Ptr<HostFlowContext> Ipv4L3Protocol::GetFlowContext(const std::string &flowkey)
+{
+  Ptr<HostFlowContext> &flow = m_flowContexts[flowkey];
+  if(flow == 0) {
+    flow = Create<HostFlowContext> (this, flowkey);
+  }
+  return flow;
+}
+
+Ptr<SubflowGroup> Ipv4L3Protocol::GetSubflowGroup(uint32_t group)
+{
+  Ptr<SubflowGroup> &g = m_subflowGroups[group];
+  if(g == 0) {
+    g = Create<SubflowGroup> ();
+  }
+  return g;
+}
+
+void Ipv4L3Protocol::SetSubflowGroup(const std::string &flowkey, uint32_t group)
+{
+  HostFlowContext &flow = *GetFlowContext(flowkey);
+  flow.m_groupId = group;
+  if(flow.m_group != 0) {
+    flow.m_group->Remove(&flow);
+    GetSubflowGroup(group)->Add(&flow, GetShortTermRate(flow));
+  }
+}
+
+void Ipv4L3Protocol::UpdateSubflowMembership(HostFlowContext &flow, uint32_t fid)
+{
+  if(fid != 0 && flow.m_group == 0) {
+    GetSubflowGroup(flow.m_groupId)->Add(&flow, GetShortTermRate(flow));
+  } else if(fid == 0 && flow.m_group != 0) {
+    flow.m_group->Remove(&flow);
+  }
+}
+
+double Ipv4L3Protocol::GetSubflowRate(HostFlowContext &flow)
+{
+  if(flow.m_group != 0) {
+    return flow.m_group->GetAggregateRate();
+  }
+  // an unregistered flow reads the group it would join
+  return GetSubflowGroup(flow.m_groupId)->GetAggregateRate();
+}
+
 void Ipv4L3Protocol::updateAverages(std::string flowkey, double inter_arrival, double pktsize)
+{
+  updateAverages(*GetFlowContext(flowkey), inter_arrival, pktsize);
+}
+
+void Ipv4L3Protocol::updateAverages(HostFlowContext &flow, double inter_arrival, double pktsize)
 {
 
   double pkt_rate = 10000.0;
   if(inter_arrival == -1) {  //invalid
-//    std::cout<<Simulator::Now().GetSeconds()<<" invalid inter-arrival - returning node "<<m_node->GetId()<<std::endl;
- /*   long_term_ewma_rate[flowkey] = line_rate/1000000.0;
-    short_term_ewma_rate[flowkey] = line_rate/1000000.0;
-    measurement_rate[flowkey] = line_rate/1000000.0; */
     return;
   }
-//    std::cout<<Simulator::Now().GetSeconds()<<" updating average node "<<m_node->GetId()<<" flowkey "<<flowkey<<" inter_arrival "<<inter_arrival<<std::endl;
-
-/*  if(inter_arrival == 0.0) {
-//    std::cout<<Simulator::Now().GetSeconds()<<" invalid inter-arrival - returning node "<<m_node->GetId()<<" flowkey "<<flowkey<<std::endl;
-   inter_arrival = 0.0000000001; //shouldn't happen - fixing something I don't understand
-   return;
-  }
-*/
 
   // else calculate instant rate
   if(inter_arrival > 0.000000000001) { // bug fix - verify later
     pkt_rate = (pktsize * 1.0 * 8.0) / (inter_arrival * 1.0e-9 * 1.0e+6);
   }
-  instant_rate_store[flowkey] = pkt_rate;
+  if(flow.m_instantRate == 0) {
+    flow.m_instantRate = &instant_rate_store[flow.m_flowkey];
+  }
+  *flow.m_instantRate = pkt_rate;
 
   // first time we got a rate feedback
-
-  // print all long_term_ewma entries here
-
-  if (long_term_ewma_rate.find(flowkey) == long_term_ewma_rate.end() || long_term_ewma_rate[flowkey] == 0.0) { // first time
-//    std::cout<<Simulator::Now().GetSeconds()<<" node "<<m_node->GetId()<<" first ewma update for flow "<<flowkey<<" with pkt rate "<<pkt_rate<<std::endl;
-    long_term_ewma_rate[flowkey] = pkt_rate;
-    short_term_ewma_rate[flowkey] = pkt_rate;
-    measurement_rate[flowkey] = pkt_rate;
-    return;
+  if(flow.m_longTermRate == 0) {
+    FlowRate_::iterator it = long_term_ewma_rate.find(flow.m_flowkey);
+    if(it != long_term_ewma_rate.end()) {
+      flow.m_longTermRate = &it->second;
+    }
   }
-    
-
-  if(inter_arrival > 8000000) { // for a flow that was inactive for along time - 8 ms
-//    std::cout<<Simulator::Now().GetSeconds()<<" node "<<m_node->GetId()<<" first ewma update for flow "<<flowkey<<" with pkt rate "<<pkt_rate<<" inter_arrival "<<inter_arrival<<std::endl;
-    long_term_ewma_rate[flowkey] = pkt_rate;
-    short_term_ewma_rate[flowkey] = pkt_rate;
-    measurement_rate[flowkey] = pkt_rate;
+  bool first = flow.m_longTermRate == 0 || flow.m_longTermRate->rate == 0.0;
+  if(flow.m_longTermRate == 0) {
+    flow.m_longTermRate = &long_term_ewma_rate[flow.m_flowkey];
+  }
+  if(flow.m_shortTermRate == 0) {
+    flow.m_shortTermRate = &short_term_ewma_rate[flow.m_flowkey];
+  }
+  if(flow.m_measurementRate == 0) {
+    flow.m_measurementRate = &measurement_rate[flow.m_flowkey];
+  }
+  EwmaRate &long_rate = *flow.m_longTermRate;
+  EwmaRate &short_rate = *flow.m_shortTermRate;
+  EwmaRate &measured_rate = *flow.m_measurementRate;
+
+  // or a flow that was inactive for along time - 8 ms
+  if(first || inter_arrival > 8000000) {
+    long_rate.Reset(pkt_rate);
+    short_rate.Reset(pkt_rate);
+    measured_rate.Reset(pkt_rate);
+    if(flow.m_group != 0) {
+      flow.m_group->Update(&flow, short_rate.rate);
+    }
+    NotifyMeasurementRate(flow);
     return;
   }
 
-  /* if(m_node->GetId() == 2 || m_node->GetId() == 3) {
-    std::cout<<"instant_rate "<<Simulator::Now().GetSeconds()<<" "<<flowids[flowkey]<<" "<<pkt_rate<<std::endl;
-  } */
-//  if(flowids[flowkey] == 8)
-//  std::cout<<"ratesample "<<pkt_rate<<" node "<<m_node->GetId()<<" flow "<<flowids[flowkey]<<" time "<<Simulator::Now().GetSeconds()<<" inter_arrival "<<inter_arrival<<" pktsize "<<pktsize<<std::endl;
-
-//  std::cout<<Simulator::Now().GetSeconds()<<" ewma update for flow "<<flowkey<<" with pkt rate "<<pkt_rate<<" current ewma "<<long_term_ewma_rate[flowkey]<<" short term "<<short_term_ewma_rate[flowkey]<<std::endl;
-  double epower = exp((-1.0*inter_arrival)/long_ewma_const);
-  double first_term = (1.0 - epower)*pkt_rate;
-  double second_term = epower * long_term_ewma_rate[flowkey];
-  double new_rate = first_term + second_term;
-  long_term_ewma_rate[flowkey] = new_rate;
-
-
+  // ACKs of the same timestep keep the whole weight and skip the exp
+  long_rate.Update(pkt_rate, m_longDecay.Get(inter_arrival));
   // calculate short term ewma
-  //
-  epower = exp((-1.0*inter_arrival)/short_ewma_const);
-  first_term = (1.0 - epower)*pkt_rate;
-  second_term = epower * short_term_ewma_rate[flowkey];
-  short_term_ewma_rate[flowkey] = first_term + second_term;
+  short_rate.Update(pkt_rate, m_shortDecay.Get(inter_arrival));
+  measured_rate.Update(pkt_rate, m_measurementDecay.Get(inter_arrival));
+  if(flow.m_group != 0) {
+    flow.m_group->Update(&flow, short_rate.rate);
+  }
+  NotifyMeasurementRate(flow);
+}
+
+void Ipv4L3Protocol::NotifyMeasurementRate(const std::string &flowkey)
+{
+  FlowId_::iterator it = flowids.find(flowkey);
+  if(it != flowids.end()) {
+    m_measurementRateTrace(it->second, measurement_rate[flowkey].rate);
+  }
+}
 
-  epower = exp((-1.0*inter_arrival)/measurement_ewma_const);
-  first_term = (1.0 - epower)*pkt_rate;
-  second_term = epower * measurement_rate[flowkey];
-  measurement_rate[flowkey] = first_term + second_term;
+void Ipv4L3Protocol::NotifyMeasurementRate(HostFlowContext &flow)
+{
+  uint32_t *fid = flow.FindFlowId();
+  if(fid != 0) {
+    m_measurementRateTrace(*fid, flow.m_measurementRate->rate);
+  }
 }
 
 
@@ -1804,6 +1894,11 @@ void Ipv4L3Protocol::removeFlow(uint32_t fid)
   for (it=flowids.begin(); it!=flowids.end(); ++it) {
 	if(it->second == fid) {
 		std::cout<<"removing flowid "<<fid<<" with key "<<it->first<<" from node "<<m_node->GetId()<<std::endl;
+	        std::map<std::string, Ptr<HostFlowContext> >::iterator flow = m_flowContexts.find(it->first);
+	        if(flow != m_flowContexts.end()) {
+	          flow->second->m_fid = 0;
+	          UpdateSubflowMembership(*flow->second, 0);
+	        }
 	        flowids.erase(it);
 		return;
 	}
@@ -1827,6 +1922,7 @@ void Ipv4L3Protocol::setFlow(std::string flow, uint32_t flowid, double fsize, ui
     //std::cout<<" Ipv4L3Protocol::SetFlow "<<m_node->GetId()<<" flowid "<<flowid<<" flow "<<flow<<" size "<<fsize<<" weight "<<weight<<std::endl;
 
     flowids[flow] = flowid;
+    UpdateSubflowMembership(*GetFlowContext(flow), flowid);
     price_valid[flow] = false;
     fsizes_copy[flowid] = fsize;
     fweights_copy[flowid] = weight;
@@ -1859,6 +1955,7 @@ Ipv4L3Protocol::setFlows(std::map<std::string, uint32_t> flowid_set)
   {
 //    NS_LOG_LOGIC(Simulator::Now().GetSeconds()<< " Node "<<m_node->GetId()<<" Set flow key "<<it->first<<" flow id "<<it->second);
     flowids[it->first] = it->second;
+    UpdateSubflowMembership(*GetFlowContext(it->first), it->second);
     last_residue[it->first] = 0.0;
     total_samples[it->first] = 0;
     current_residue[it->first] = 0.0;
@@ -1899,7 +1996,7 @@ Ipv4L3Protocol::SendRealOut (Ptr<Ipv4Route> route,
    uint32_t fid = flowids[flowkey];
 
    NS_LOG_LOGIC("SendRealOut" <<this << route << packet << &ipHeader);
-   if (route == 0 || (fid != 0 && (drop_list.find(fid) != drop_list.end()) && drop_list[fid]==1))
+   if (route == 0 || (fid != 0 && fid < drop_list.size() && drop_list[fid]))
     {
 //      std::cout<<" DROPPING AT IP "<<Simulator::Now().GetSeconds()<<" "<<m_node->GetId()<<std::endl;
       NS_LOG_WARN ("No route to host.  Drop.");
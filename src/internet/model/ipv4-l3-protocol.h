@@ -35,6 +35,8 @@
 #include "ns3/nstime.h"
 #include "ns3/simulator.h"
 #include "ns3/flow_utils.h"
+#include "host-flow-context.h"
+#include "rate-estimator.h"
 #include<cstring>
 #include<iostream>
 #include<sstream>
@@ -131,7 +133,8 @@ public:
   double stop_time;
   void addToDropList(uint32_t id);
   void removeFromDropList(uint32_t id);
-  std::map<uint32_t, uint32_t> drop_list;
+  /* indexed by flow id, non-zero for the flows whose packets are dropped */
+  std::vector<uint8_t> drop_list;
 
   double long_ewma_const, short_ewma_const, measurement_ewma_const;
   std::map<std::string, EventId> m_sendEvent;
@@ -145,11 +148,26 @@ public:
   void setlong_ewma_const(double kvalue);
   void setshort_ewma_const(double kvalue);
   void setmeasurement_ewma_const(double kvalue);
+  void SetFastRateDecay(bool fast);
+  bool GetFastRateDecay(void) const;
   void setLineRate(double d);
   void setMPTCP(bool b);
 
   void setKay(double kvalue);
   void updateAverages(std::string flowkey, double inter_arrival, double pktsize);
+  void updateAverages(HostFlowContext &flow, double inter_arrival, double pktsize);
+  void NotifyMeasurementRate(const std::string &flowkey);
+  void NotifyMeasurementRate(HostFlowContext &flow);
+  /** The handle on the per-flow state of flowkey, created on first use. */
+  Ptr<HostFlowContext> GetFlowContext(const std::string &flowkey);
+  /* With MPTCP, the marginal utility and the rate split of a subflow read
+     the summed short term rate of its group.  A connection puts each of
+     its subflows in its own group; flows that set none share group 0,
+     which then holds every registered flow of the host.  A flow counts
+     in its group while it has a non-zero flow id. */
+  void SetSubflowGroup(const std::string &flowkey, uint32_t group);
+  Ptr<SubflowGroup> GetSubflowGroup(uint32_t group);
+  double GetSubflowRate(HostFlowContext &flow);
   
   double GetStoreRate(std::string fkey);
   double GetStoreDestRate(std::string fkey);
@@ -226,6 +244,7 @@ public:
 
   double GetRate(std::string, Term t);
   double GetShortTermRate(std::string);
+  double GetShortTermRate(HostFlowContext &flow);
 
   
   void setCurrentNetwPrice(double cnp_sample, std::string fkey);
@@ -588,10 +607,18 @@ private:
   std::map<std::string, int> total_samples;
 
   std::map<std::string, double> last_arrival;
-  std::map<std::string, double> long_term_ewma_rate;
-  std::map<std::string, double> short_term_ewma_rate;
+  typedef std::map<std::string, EwmaRate> FlowRate_;
+  FlowRate_ long_term_ewma_rate;
+  FlowRate_ short_term_ewma_rate;
   std::map<std::string, double>instant_rate_store;
-  std::map<std::string, double> measurement_rate;
+  FlowRate_ measurement_rate;
+  bool m_fastRateDecay;
+  RateDecay m_longDecay;
+  RateDecay m_shortDecay;
+  RateDecay m_measurementDecay;
+  std::map<std::string, Ptr<HostFlowContext> > m_flowContexts;
+  std::map<uint32_t, Ptr<SubflowGroup> > m_subflowGroups;
+  void UpdateSubflowMembership(HostFlowContext &flow, uint32_t fid);
 
 
   double QUERY_TIME;
@@ -621,6 +648,8 @@ private:
   // <ip-header, payload, reason, ifindex> (ifindex not valid if reason is DROP_NO_ROUTE)
   /// Trace of dropped packets
   TracedCallback<const Ipv4Header &, Ptr<const Packet>, DropReason, Ptr<Ipv4>, uint32_t> m_dropTrace;
+  /// Trace of measured flow rates <flow id, rate in Mbps>
+  TracedCallback<uint32_t, double> m_measurementRateTrace;
 
   Ptr<Ipv4RoutingProtocol> m_routingProtocol; //!< Routing protocol associated with the stack
 
@@ -0,0 +1,524 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+
+#include <cmath>
+#include "ns3/log.h"
+#include "ns3/double.h"
+#include "ns3/uinteger.h"
+#include "ns3/node.h"
+#include "ns3/packet.h"
+#include "ns3/channel.h"
+#include "ns3/net-device.h"
+#include "ns3/data-rate.h"
+#include "ns3/socket.h"
+#include "ns3/ipv4.h"
+#include "ns3/ipv4-route.h"
+#include "ns3/ipv4-header.h"
+#include "ns3/ipv4-routing-protocol.h"
+#include "tcp-header.h"
+#include "num-solver.h"
+
+NS_LOG_COMPONENT_DEFINE ("NumSolver");
+
+namespace ns3 {
+
+NS_OBJECT_ENSURE_REGISTERED (NumSolver);
+
+// largest change of a price in one Newton step, in log scale
+static const double MAX_LOG_STEP = 10.0;
+// prices are seeded with this value when a link first becomes congested
+static const double SEED_PRICE = 1.0;
+static const uint32_t MAX_LINK_ITERATIONS = 100;
+
+TypeId
+NumSolver::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::NumSolver")
+    .SetParent<Object> ()
+    .AddConstructor<NumSolver> ()
+    .AddAttribute ("UtilFunction",
+                   "Utility of the flows, same encoding as ns3::Ipv4L3Protocol::UtilFunction "
+                   "(1 weighted log, 2 FCT utility, 3 alpha-fair)",
+                   UintegerValue (1),
+                   MakeUintegerAccessor (&NumSolver::m_method),
+                   MakeUintegerChecker<uint32_t> (1, 3))
+    .AddAttribute ("fct_alpha",
+                   "alpha of the FCT and alpha-fair utilities",
+                   DoubleValue (1.0),
+                   MakeDoubleAccessor (&NumSolver::m_fctAlpha),
+                   MakeDoubleChecker<double> (0.0))
+    .AddAttribute ("Tolerance",
+                   "Relative violation of link capacities at which the solution is accepted",
+                   DoubleValue (1e-4),
+                   MakeDoubleAccessor (&NumSolver::m_tolerance),
+                   MakeDoubleChecker<double> (0.0))
+    .AddAttribute ("Damping",
+                   "Fraction of the Newton step applied to a link price",
+                   DoubleValue (1.0),
+                   MakeDoubleAccessor (&NumSolver::m_damping),
+                   MakeDoubleChecker<double> (0.0, 1.0))
+    .AddAttribute ("MaxIterations",
+                   "Maximum number of sweeps over the links per solve",
+                   UintegerValue (500),
+                   MakeUintegerAccessor (&NumSolver::m_maxIterations),
+                   MakeUintegerChecker<uint32_t> (1))
+    .AddAttribute ("MaxHops",
+                   "Path length after which path tracing gives up (routing loop)",
+                   UintegerValue (64),
+                   MakeUintegerAccessor (&NumSolver::m_maxHops),
+                   MakeUintegerChecker<uint32_t> (1))
+  ;
+  return tid;
+}
+
+NumSolver::NumSolver ()
+  : m_method (1),
+    m_fctAlpha (1.0),
+    m_tolerance (1e-4),
+    m_damping (1.0),
+    m_maxIterations (500),
+    m_maxHops (64),
+    m_dirty (false),
+    m_lastIterations (0)
+{
+  NS_LOG_FUNCTION (this);
+}
+
+NumSolver::~NumSolver ()
+{
+  NS_LOG_FUNCTION (this);
+}
+
+uint32_t
+NumSolver::AddLink (double capacity)
+{
+  NS_ASSERT (capacity > 0);
+  LinkState link;
+  link.capacity = capacity / 1000000.0;
+  link.price = 0.0;
+  link.load = 0.0;
+  m_links.push_back (link);
+  return m_links.size () - 1;
+}
+
+uint32_t
+NumSolver::GetLinkId (Ptr<NetDevice> dev)
+{
+  std::map<Ptr<NetDevice>, uint32_t>::iterator it = m_deviceLinks.find (dev);
+  if (it != m_deviceLinks.end ())
+    {
+      return it->second;
+    }
+  DataRateValue rate;
+  uint32_t id;
+  if (dev->GetAttributeFailSafe ("DataRate", rate) && rate.Get ().GetBitRate () > 0)
+    {
+      id = AddLink (rate.Get ().GetBitRate ());
+    }
+  else
+    {
+      // devices without a rate (loopback, ideal channels) never constrain
+      id = AddLink (1e18);
+    }
+  m_deviceLinks[dev] = id;
+  return id;
+}
+
+uint32_t
+NumSolver::GetNLinks (void) const
+{
+  return m_links.size ();
+}
+
+void
+NumSolver::AddFlow (uint32_t fid, Ptr<Node> src, Ipv4Address srcAddr, Ipv4Address dstAddr,
+                    uint16_t srcPort, uint16_t dstPort, double size, double weight)
+{
+  NS_LOG_FUNCTION (this << fid << src->GetId () << srcAddr << dstAddr << srcPort << dstPort);
+
+  // the same headers the flow's packets carry, so flow ECMP hashes them alike
+  Ptr<Packet> p = Create<Packet> ();
+  TcpHeader tcph;
+  tcph.SetSourcePort (srcPort);
+  tcph.SetDestinationPort (dstPort);
+  p->AddHeader (tcph);
+  Ipv4Header iph;
+  iph.SetSource (srcAddr);
+  iph.SetDestination (dstAddr);
+  iph.SetProtocol (6);
+
+  std::vector<uint32_t> links;
+  Ptr<Node> node = src;
+  uint32_t hops = 0;
+  while (true)
+    {
+      Ptr<Ipv4> ipv4 = node->GetObject<Ipv4> ();
+      if (ipv4 == 0 || ipv4->GetInterfaceForAddress (dstAddr) >= 0)
+        {
+          break;
+        }
+      if (++hops > m_maxHops)
+        {
+          NS_LOG_WARN ("flow " << fid << " exceeds " << m_maxHops << " hops, path truncated");
+          break;
+        }
+      Socket::SocketErrno err;
+      Ptr<Ipv4Route> route = ipv4->GetRoutingProtocol ()->RouteOutput (p, iph, 0, err);
+      if (route == 0)
+        {
+          NS_LOG_WARN ("no route for flow " << fid << " at node " << node->GetId ());
+          break;
+        }
+      Ptr<NetDevice> dev = route->GetOutputDevice ();
+      links.push_back (GetLinkId (dev));
+
+      Ipv4Address nextHop = route->GetGateway ();
+      if (nextHop.IsEqual (Ipv4Address ("0.0.0.0")))
+        {
+          nextHop = dstAddr;
+        }
+      Ptr<Channel> channel = dev->GetChannel ();
+      Ptr<Node> next = 0;
+      for (uint32_t i = 0; channel != 0 && i < channel->GetNDevices (); i++)
+        {
+          Ptr<NetDevice> peer = channel->GetDevice (i);
+          if (peer == dev)
+            {
+              continue;
+            }
+          Ptr<Ipv4> peerIpv4 = peer->GetNode ()->GetObject<Ipv4> ();
+          if (peerIpv4 != 0 && peerIpv4->GetInterfaceForAddress (nextHop) >= 0)
+            {
+              next = peer->GetNode ();
+              break;
+            }
+          if (channel->GetNDevices () == 2)
+            {
+              next = peer->GetNode ();
+            }
+        }
+      if (next == 0)
+        {
+          NS_LOG_WARN ("cannot find next hop " << nextHop << " of flow " << fid);
+          break;
+        }
+      node = next;
+    }
+  AddFlow (fid, links, size, weight);
+}
+
+void
+NumSolver::AddFlow (uint32_t fid, const std::vector<uint32_t> &links, double size, double weight)
+{
+  NS_LOG_FUNCTION (this << fid << links.size () << size << weight);
+  if (HasFlow (fid))
+    {
+      RemoveFlow (fid);
+    }
+  FlowState flow;
+  flow.fid = fid;
+  flow.links = links;
+  flow.bottleneck = 1e18;
+  flow.price = 0.0;
+  flow.rate = 0.0;
+  uint32_t index = m_flows.size ();
+  for (uint32_t k = 0; k < links.size (); k++)
+    {
+      NS_ASSERT (links[k] < m_links.size ());
+      LinkState &link = m_links[links[k]];
+      link.flows.push_back (index);
+      flow.bottleneck = std::min (flow.bottleneck, link.capacity);
+      flow.price += link.price;
+    }
+  m_flows.push_back (flow);
+  m_flowIndex[fid] = index;
+  m_flowutil.SetFlow ("", fid, size, weight);
+  m_dirty = true;
+}
+
+void
+NumSolver::RemoveFlow (uint32_t fid)
+{
+  NS_LOG_FUNCTION (this << fid);
+  std::map<uint32_t, uint32_t>::iterator it = m_flowIndex.find (fid);
+  if (it == m_flowIndex.end ())
+    {
+      return;
+    }
+  uint32_t index = it->second;
+  uint32_t last = m_flows.size () - 1;
+  m_flowIndex.erase (it);
+
+  // drop index from the links of the removed flow
+  for (uint32_t k = 0; k < m_flows[index].links.size (); k++)
+    {
+      std::vector<uint32_t> &flows = m_links[m_flows[index].links[k]].flows;
+      for (uint32_t j = 0; j < flows.size (); j++)
+        {
+          if (flows[j] == index)
+            {
+              flows[j] = flows.back ();
+              flows.pop_back ();
+              break;
+            }
+        }
+      if (flows.empty ())
+        {
+          m_links[m_flows[index].links[k]].price = 0.0;
+        }
+    }
+  // move the last flow into the hole and renumber it on its links
+  if (index != last)
+    {
+      m_flows[index] = m_flows[last];
+      m_flowIndex[m_flows[index].fid] = index;
+      for (uint32_t k = 0; k < m_flows[index].links.size (); k++)
+        {
+          std::vector<uint32_t> &flows = m_links[m_flows[index].links[k]].flows;
+          for (uint32_t j = 0; j < flows.size (); j++)
+            {
+              if (flows[j] == last)
+                {
+                  flows[j] = index;
+                  break;
+                }
+            }
+        }
+    }
+  m_flows.pop_back ();
+  m_flowutil.flow_weights.erase (fid);
+  m_flowutil.flow_sizes.erase (fid);
+  m_dirty = true;
+}
+
+bool
+NumSolver::HasFlow (uint32_t fid) const
+{
+  return m_flowIndex.find (fid) != m_flowIndex.end ();
+}
+
+uint32_t
+NumSolver::GetNFlows (void) const
+{
+  return m_flows.size ();
+}
+
+double
+NumSolver::RateFromPrice (const FlowState &flow)
+{
+  return RateAtPrice (flow, flow.price);
+}
+
+double
+NumSolver::RateAtPrice (const FlowState &flow, double q)
+{
+  if (q <= 0.0)
+    {
+      return flow.bottleneck;
+    }
+  double rate;
+  if (m_method == 2)
+    {
+      rate = m_flowutil.getFCTUtilDerivativeInverse (flow.fid, q);
+    }
+  else if (m_method == 3)
+    {
+      rate = m_flowutil.getAlpha1InverseByFlowId (flow.fid, q);
+    }
+  else
+    {
+      rate = m_flowutil.getUtilInverseByFlowId (flow.fid, q);
+    }
+  return std::min (rate, flow.bottleneck);
+}
+
+void
+NumSolver::UpdateRates (void)
+{
+  for (uint32_t l = 0; l < m_links.size (); l++)
+    {
+      m_links[l].load = 0.0;
+    }
+  for (uint32_t i = 0; i < m_flows.size (); i++)
+    {
+      FlowState &flow = m_flows[i];
+      flow.price = 0.0;
+      for (uint32_t k = 0; k < flow.links.size (); k++)
+        {
+          flow.price += m_links[flow.links[k]].price;
+        }
+      flow.rate = RateFromPrice (flow);
+      for (uint32_t k = 0; k < flow.links.size (); k++)
+        {
+          m_links[flow.links[k]].load += flow.rate;
+        }
+    }
+}
+
+bool
+NumSolver::Converged (void) const
+{
+  for (uint32_t l = 0; l < m_links.size (); l++)
+    {
+      const LinkState &link = m_links[l];
+      double excess = (link.load - link.capacity) / link.capacity;
+      if (excess > m_tolerance || (link.price > 0.0 && excess < -m_tolerance))
+        {
+          return false;
+        }
+    }
+  return true;
+}
+
+void
+NumSolver::Solve (void)
+{
+  if (!m_dirty)
+    {
+      return;
+    }
+  NS_LOG_FUNCTION (this << m_flows.size ());
+  m_flowutil.SetFCTAlpha (m_fctAlpha);
+  // rate elasticity -d ln x / d ln q, constant for the utilities of FlowUtil
+  double elasticity = (m_method == 1) ? 1.0 : 1.0 / m_fctAlpha;
+
+  UpdateRates ();
+  uint32_t iter = 0;
+  while (iter < m_maxIterations && !Converged ())
+    {
+      iter++;
+      // Gauss-Seidel sweep: each link price is moved to the root of
+      // load(p) = capacity with the other prices held fixed, and the rates
+      // of the flows crossing the link are refreshed right away
+      for (uint32_t l = 0; l < m_links.size (); l++)
+        {
+          LinkState &link = m_links[l];
+          if (link.flows.empty ())
+            {
+              continue;
+            }
+          double old = link.price;
+          double p = old;
+          // load with a zero price on this link
+          double free = 0.0;
+          for (uint32_t j = 0; j < link.flows.size (); j++)
+            {
+              FlowState &flow = m_flows[link.flows[j]];
+              flow.price -= old;
+              if (flow.price < 0.0)
+                {
+                  flow.price = 0.0;
+                }
+              free += RateFromPrice (flow);
+            }
+          if (free <= link.capacity * (1 + m_tolerance / 10))
+            {
+              p = 0.0;
+            }
+          else
+            {
+              double lo = 0.0, hi = 0.0;
+              if (p <= 0.0)
+                {
+                  p = SEED_PRICE;
+                }
+              for (uint32_t k = 0; k < MAX_LINK_ITERATIONS; k++)
+                {
+                  double load = 0.0, slope = 0.0;
+                  for (uint32_t j = 0; j < link.flows.size (); j++)
+                    {
+                      FlowState &flow = m_flows[link.flows[j]];
+                      double base = flow.price;
+                      flow.price = base + p;
+                      double x = RateFromPrice (flow);
+                      flow.price = base;
+                      load += x;
+                      if (x < flow.bottleneck)
+                        {
+                          slope += x * elasticity * p / (base + p);
+                        }
+                    }
+                  if (std::fabs (load - link.capacity) <= link.capacity * m_tolerance / 10)
+                    {
+                      break;
+                    }
+                  if (load > link.capacity)
+                    {
+                      lo = p;
+                    }
+                  else
+                    {
+                      hi = p;
+                    }
+                  double next;
+                  if (slope > 0.0)
+                    {
+                      double step = std::log (load / link.capacity) / (slope / load);
+                      step = std::max (-MAX_LOG_STEP, std::min (MAX_LOG_STEP, step));
+                      next = p * std::exp (step);
+                    }
+                  else
+                    {
+                      next = (load > link.capacity) ? p * 2 : p / 2;
+                    }
+                  // safeguard with the bracket found so far
+                  if ((hi > 0.0 && next >= hi) || next <= lo)
+                    {
+                      next = (hi > 0.0 && lo > 0.0) ? std::sqrt (lo * hi) : (hi > 0.0 ? hi / 2 : lo * 2);
+                    }
+                  p = next;
+                }
+              p = old + m_damping * (p - old);
+            }
+          link.price = p;
+          // refresh the flows of this link and the loads of their paths
+          for (uint32_t j = 0; j < link.flows.size (); j++)
+            {
+              FlowState &flow = m_flows[link.flows[j]];
+              flow.price += p;
+              double x = RateFromPrice (flow);
+              for (uint32_t k = 0; k < flow.links.size (); k++)
+                {
+                  m_links[flow.links[k]].load += x - flow.rate;
+                }
+              flow.rate = x;
+            }
+        }
+      // recompute from scratch so incremental updates do not drift
+      UpdateRates ();
+    }
+  if (iter == m_maxIterations)
+    {
+      NS_LOG_WARN ("NUM solver did not converge in " << iter << " sweeps");
+    }
+  NS_LOG_LOGIC ("solved " << m_flows.size () << " flows on " << m_links.size () << " links in " << iter << " sweeps");
+  m_lastIterations = iter;
+  m_dirty = false;
+}
+
+double
+NumSolver::GetRate (uint32_t fid)
+{
+  std::map<uint32_t, uint32_t>::iterator it = m_flowIndex.find (fid);
+  if (it == m_flowIndex.end ())
+    {
+      return 0.0;
+    }
+  Solve ();
+  return m_flows[it->second].rate * 1000000.0;
+}
+
+double
+NumSolver::GetLinkPrice (uint32_t link)
+{
+  NS_ASSERT (link < m_links.size ());
+  Solve ();
+  return m_links[link].price;
+}
+
+uint32_t
+NumSolver::GetLastIterations (void) const
+{
+  return m_lastIterations;
+}
+
+} // namespace ns3
@@ -0,0 +1,131 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * In-simulator oracle for the network utility maximization (NUM) problem
+ *
+ *   maximize   sum_i U_i(x_i)
+ *   subject to sum_{i uses l} x_i <= c_l   for every link l
+ *
+ * solved over the flows that are currently active in the simulation.  Flow
+ * paths are read from the live routing tables of the nodes (so ECMP choices
+ * made by Ipv4GlobalRouting are honoured) and the per-flow rate as a function
+ * of path price, U_i'^{-1}(q), is taken from FlowUtil exactly as the hosts
+ * compute it in Ipv4L3Protocol.  This replaces the offline mp_solver runs that
+ * used to produce the opt_rates files.
+ */
+
+#ifndef NUM_SOLVER_H
+#define NUM_SOLVER_H
+
+#include <map>
+#include <vector>
+#include "ns3/object.h"
+#include "ns3/ptr.h"
+#include "ns3/ipv4-address.h"
+#include "ns3/flow_utils.h"
+
+namespace ns3 {
+
+class Node;
+class NetDevice;
+
+/**
+ * \ingroup internet
+ *
+ * \brief Computes NUM-optimal rates for the set of active flows.
+ *
+ * The solver keeps a sparse link/flow incidence (each flow holds the list of
+ * links on its path, each link the list of flows crossing it) and the dual
+ * prices of all links.  Solve () does Gauss-Seidel sweeps over the links of
+ * the dual, moving each price to the root of load = capacity with a
+ * safeguarded Newton iteration in log-price space: for the utilities
+ * supported by FlowUtil the rate is a power of the path price, so the step
+ * only needs the rate elasticity of the flows crossing the link.  Prices are
+ * kept across flow arrivals and departures so every re-solve is warm-started
+ * from the previous optimum, and only a few sweeps are needed per event.
+ *
+ * Rates are exchanged in bits per second.
+ */
+class NumSolver : public Object
+{
+public:
+  static TypeId GetTypeId (void);
+
+  NumSolver ();
+  virtual ~NumSolver ();
+
+  /**
+   * Add a flow and trace its path through the routing tables, starting at
+   * node src.  The ports are used so that flow-level ECMP picks the same
+   * path as the packets of the flow.
+   */
+  void AddFlow (uint32_t fid, Ptr<Node> src, Ipv4Address srcAddr, Ipv4Address dstAddr,
+                uint16_t srcPort, uint16_t dstPort, double size, double weight);
+  /**
+   * Add a flow over an explicit list of links (as returned by GetLinkId).
+   */
+  virtual void AddFlow (uint32_t fid, const std::vector<uint32_t> &links, double size, double weight);
+  virtual void RemoveFlow (uint32_t fid);
+  bool HasFlow (uint32_t fid) const;
+  uint32_t GetNFlows (void) const;
+
+  /** Register a link with the given capacity in bits per second. */
+  uint32_t AddLink (double capacity);
+  /** Link id of the transmit side of dev, created on first use. */
+  virtual uint32_t GetLinkId (Ptr<NetDevice> dev);
+  uint32_t GetNLinks (void) const;
+
+  /** Re-solve if the flow set changed since the last solve. */
+  void Solve (void);
+  /** Optimal rate of fid in bits per second, 0 for unknown flows. */
+  double GetRate (uint32_t fid);
+  double GetLinkPrice (uint32_t link);
+  /** Number of iterations used by the last call that actually solved. */
+  uint32_t GetLastIterations (void) const;
+
+protected:
+  struct LinkState
+  {
+    double capacity;             //!< in Mbps, the unit FlowUtil rates are in
+    double price;
+    double load;
+    std::vector<uint32_t> flows; //!< dense indices into m_flows
+  };
+
+  struct FlowState
+  {
+    uint32_t fid;
+    std::vector<uint32_t> links;
+    double bottleneck;           //!< smallest capacity on the path, Mbps
+    double price;                //!< path price q_i
+    double rate;                 //!< Mbps
+  };
+
+  double RateFromPrice (const FlowState &flow);
+  /** Rate of flow in Mbps at path price q, capped by its bottleneck. */
+  double RateAtPrice (const FlowState &flow, double q);
+
+  std::vector<LinkState> m_links;
+  std::vector<FlowState> m_flows;
+  std::map<uint32_t, uint32_t> m_flowIndex;       //!< flow id -> index in m_flows
+
+  FlowUtil m_flowutil;
+  uint32_t m_method;      //!< same encoding as Ipv4L3Protocol::UtilFunction
+  double m_fctAlpha;
+
+private:
+  void UpdateRates (void);
+  bool Converged (void) const;
+
+  std::map<Ptr<NetDevice>, uint32_t> m_deviceLinks;
+  double m_tolerance;
+  double m_damping;
+  uint32_t m_maxIterations;
+  uint32_t m_maxHops;
+
+  bool m_dirty;
+  uint32_t m_lastIterations;
+};
+
+} // namespace ns3
+
+#endif /* NUM_SOLVER_H */
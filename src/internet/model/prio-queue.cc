@@ -9,6 +9,9 @@
 #include "ns3/simulator.h"
 #include "ns3/random-variable-stream.h"
 #include "ns3/double.h"
+#include "ns3/trace-source-accessor.h"
+#include <algorithm>
+#include <string>
 
 
 NS_LOG_COMPONENT_DEFINE ("PrioQueue");
@@ -220,6 +223,12 @@ TypeId PrioQueue::GetTypeId (void)
                    TimeValue(Seconds(0.005)),
                    MakeTimeAccessor (&PrioQueue::m_guardTime),
                    MakeTimeChecker())
+    .AddAttribute ("DepartureRateTau",
+                   "Time constant of the departure rate EWMA read by getCurrentDepartureRate; 0 turns it off",
+                   TimeValue(Seconds(0)),
+                   MakeTimeAccessor (&PrioQueue::SetDepartureRateTau,
+                                     &PrioQueue::GetDepartureRateTau),
+                   MakeTimeChecker())
     .AddAttribute ("xfabric_beta",
                    "Value of beta for xfabric",
                    DoubleValue(0.5),
@@ -236,11 +245,29 @@ TypeId PrioQueue::GetTypeId (void)
                    DoubleValue(1.0),
                    MakeDoubleAccessor (&PrioQueue::fct_alpha),
                    MakeDoubleChecker <double>())
+    .AddAttribute ("Histograms",
+                   "Keep histograms of the sojourn time and occupancy of the queue",
+                   BooleanValue (false),
+                   MakeBooleanAccessor (&PrioQueue::m_histogramsEnabled),
+                   MakeBooleanChecker ())
+    .AddAttribute ("HistogramEpoch",
+                   "Trace and restart the histograms this often, 0 only on DumpHistograms",
+                   TimeValue (Seconds (0)),
+                   MakeTimeAccessor (&PrioQueue::m_histogramEpoch),
+                   MakeTimeChecker ())
+    .AddTraceSource ("Histograms",
+                     "Sojourn time and occupancy histograms of the queue, by link id",
+                     MakeTraceSourceAccessor (&PrioQueue::m_histogramTrace))
 	
 ;
   return tid;
 }
 
+std::map<std::string, uint32_t> PrioQueue::s_flowSlots;
+std::vector<uint8_t> PrioQueue::s_flowStopped;
+std::vector<std::vector<PrioQueue *> > PrioQueue::s_flowQueues;
+uint32_t PrioQueue::s_liveQueues = 0;
+
 PrioQueue::PrioQueue () :
   Queue (),
   m_packets (),
@@ -248,6 +275,7 @@ PrioQueue::PrioQueue () :
   m_pFabric(1)
 {
   NS_LOG_FUNCTION (this);
+  s_liveQueues++;
   nodeid = 1000;
   eps = 0.00001;
   running_min_prio = latest_min_prio = MAX_DOUBLE;
@@ -257,6 +285,14 @@ PrioQueue::PrioQueue () :
   control_virtualtime = 0.0;
   updated_virtual_time = 0.0;
   current_price = 0.0;
+  incoming_bytes = outgoing_bytes = 0.0;
+  current_util = last_link_rate = 0.0;
+  update_minimum = true;
+  m_fluidBacklog = 0.0;
+  m_trackPacketDemand = false;
+  m_histogramsEnabled = false;
+  virtualtime_updated = 0;
+  current_slope = last_virtualtime = last_virtualtime_time = 0.0;
   previous_departure = 1.0 * 1.0e+9; // in ns
   //want to make sure that previous departure is start of simulation
   averaged_ratio = 0;
@@ -286,27 +322,74 @@ PrioQueue::PrioQueue () :
   NS_LOG_LOGIC(" link data rate "<<m_bps<<" ecn_delaythreshold "<<ecn_delaythreshold);
 }
 
+uint32_t
+PrioQueue::GetFlowSlot (const std::string &flowkey)
+{
+  std::map<std::string, uint32_t>::iterator it = s_flowSlots.lower_bound (flowkey);
+  if (it != s_flowSlots.end () && it->first == flowkey)
+    {
+      return it->second;
+    }
+  uint32_t slot = s_flowStopped.size ();
+  s_flowSlots.insert (it, std::make_pair (flowkey, slot));
+  s_flowStopped.push_back (0);
+  s_flowQueues.push_back (std::vector<PrioQueue *> ());
+  return slot;
+}
+
 void
-PrioQueue::dropFlowPackets(std::string arg_flowkey)
+PrioQueue::PurgeFlow (const std::string &flowkey)
 {
+  uint32_t slot = GetFlowSlot (flowkey);
+  s_flowStopped[slot] = 1;
+  std::vector<PrioQueue *> queues;
+  queues.swap (s_flowQueues[slot]);
+  for (uint32_t i = 0; i < queues.size (); i++)
+    {
+      queues[i]->m_carriedFlows.erase (slot);
+      queues[i]->PurgeChain (slot);
+    }
+}
 
-   drop_list[arg_flowkey] = 1;
+void
+PrioQueue::dropFlowPackets(std::string arg_flowkey)
+{
+  uint32_t slot = GetFlowSlot (arg_flowkey);
+  s_flowStopped[slot] = 1;
+  PurgeChain (slot);
+}
 
-   typedef std::list<Ptr<Packet> >::iterator PacketQueueI;
-   PacketQueueI pp = m_packets.begin();
-
-   while(pp != m_packets.end()) {
-
-        std::string flowkey = GetFlowKey(*pp);
-        if(flowkey == arg_flowkey) {
- //           std::cout<<Simulator::Now().GetSeconds()<<" Q "<<linkid_string<<" erasing packet of flow "<<flowkey<<std::endl;
-            m_bytesInQueue -= (*pp)->GetSize();
-            pp = m_packets.erase(pp);
-        } else {
-//            std::cout<<Simulator::Now().GetSeconds()<<" Q "<<linkid_string<<" NOTerasing packet of flow "<<flowkey<<std::endl;
-            ++pp;
+PrioQueue::QueuedPackets::iterator
+PrioQueue::FindQueued (PacketQueueI position)
+{
+  std::pair<QueuedPackets::iterator, QueuedPackets::iterator> range = m_queued.equal_range (PeekPointer (*position));
+  for (QueuedPackets::iterator it = range.first; it != range.second; ++it)
+    {
+      if (it->second.position == position)
+        {
+          return it;
         }
     }
+  return m_queued.end ();
+}
+
+void
+PrioQueue::PurgeChain (uint32_t flow)
+{
+  std::map<uint32_t, FlowChain>::iterator chain = m_flowChains.find (flow);
+  if (chain == m_flowChains.end ())
+    {
+      return;
+    }
+  for (FlowChain::iterator pp = chain->second.begin (); pp != chain->second.end (); ++pp)
+    {
+      m_bytesInQueue -= (**pp)->GetSize ();
+      m_size--;
+      pkt_arrival.erase ((**pp)->GetUid ());
+      m_queued.erase (FindQueued (*pp));
+      m_packets.erase (*pp);
+    }
+  m_flowChains.erase (chain);
 }
         
 
@@ -401,7 +484,38 @@ PrioQueue::getCurrentPrice(void)
 double
 PrioQueue::getCurrentDepartureRate(void)
 {
-  return departure_rate;
+  return departure_rate.rate;
+}
+
+void
+PrioQueue::SetDepartureRateTau (Time tau)
+{
+  m_departureRateTau = tau;
+  if(tau.IsStrictlyPositive()) {
+    m_departureDecay = RateDecay(tau.GetNanoSeconds(), true);
+  }
+}
+
+Time
+PrioQueue::GetDepartureRateTau (void) const
+{
+  return m_departureRateTau;
+}
+
+void
+PrioQueue::UpdateDepartureRate (uint32_t pktsize)
+{
+  double pkt_departure = Simulator::Now().GetNanoSeconds();
+  double pkt_interdeparture = pkt_departure - previous_departure;
+  previous_departure = pkt_departure;
+
+  // back to back departures count as the line rate
+  if(pkt_interdeparture <= 0.0) {
+    departure_rate.Reset(m_bps.GetBitRate()/1000000.0);
+    return;
+  }
+  double pkt_rate = (pktsize * 1.0 * 8.0) / (pkt_interdeparture * 1.0e-9 * 1.0e+6); // should be in Mbps
+  departure_rate.Update(pkt_rate, m_departureDecay.Get(pkt_interdeparture));
 }
 
 double
@@ -439,9 +553,12 @@ PrioQueue::updateAvgRtt(double rtt)
 void
 PrioQueue::updateLinkPrice(void)
 {
+  UpdatePriceWith<RuntimePrice> ();
+}
 
-  if(alpha_fair_rcp) {  /* IF THE SWITCH IS IMPLEMENTING ALPHA_FAIR_RCP */
-	
+void
+PrioQueue::UpdateRcpPrice(void)
+{
 	if(switch_fsr == -1.0) {
 		//first time ; set the fair share to link rate
 		switch_fsr = m_bps.GetBitRate()/1000000.0;  // Mbps
@@ -471,18 +588,12 @@ PrioQueue::updateLinkPrice(void)
 	
 	switch_fsr = fair_share_rate;
     current_price = pow(switch_fsr, -1.0*fct_alpha);
+}
 
-//  std::cout<<"alpha_fair_rcp: "<<Simulator::Now().GetSeconds()<<" link "<<linkid_string<<" avg_rtt "<<avg_rtt<<" switch_fsr "<<switch_fsr<<" rate_difference "<<rate_difference<<" instant_queue_size "<<instant_queue_size<<" rate term "<<m_rcp_alpha*(rate_difference)<<" queue term "<<m_rcp_beta*(instant_queue_size*8.0/(1000000.0*avg_rtt))<<" last_link_rate "<<last_link_rate<<" priceupdatetime "<<m_updatePriceTime.GetSeconds()<<" ratio "<<ratio<<" current_price "<<current_price<<" rcp_alpha "<<m_rcp_alpha<<" rcp_beta "<<m_rcp_beta<<" capacity "<<capacity<<" priceupdatetime "<<m_updatePriceTime.GetSeconds()<<" fct_alpha "<<fct_alpha<<std::endl; 
-  	m_updateEvent = Simulator::Schedule(m_updatePriceTime, &ns3::PrioQueue::updateLinkPrice, this);
-	return;
-  }  /* END ALPHA_FAIR_RCP */
-	
-     
-
-  if(!xfabric_price)   /* IF IT IS DGD */
-  {
-
-    double current_queue = m_bytesInQueue; //GetCurSize();
+void
+PrioQueue::UpdateDgdPrice(void)
+{
+    double current_queue = m_bytesInQueue + m_fluidBacklog; //GetCurSize();
     double rate_term = getRateDifference(m_updatePriceTime);
     double queue_term = current_queue - m_target_queue;
     
@@ -491,16 +602,11 @@ PrioQueue::updateLinkPrice(void)
     // cap it to positive value
     current_price = std::max(current_price, 0.0);
     current_price = std::min(current_price, 1.0);
+}
 
-//    std::cout<<" Queue "<<linkid_string<<" current_price "<<current_price<<" "<<Simulator::Now().GetSeconds()<<" rate_term "<<rate_term<<" queue_term "<<queue_term<<" after multi qterm "<<m_alpha*queue_term<<" rterm "<<m_gamma* rate_term<<" gamma "<<m_gamma<<" alpha "<<m_alpha<<" datarate "<<m_bps.GetBitRate() / 1000000.0<<" target_queue "<<m_target_queue<<std::endl;
-
-
-//    if(m_is_switch) {
-      //NS_LOG_UNCOND(Simulator::Now().GetSeconds()<< " current price "<<current_price<<" node "<<nodeid<<" price_raise "<<price_hike<<" queue_term "<< (m_alpha *(current_queue - m_target_queue))<<" rate_term "<<price_hike<<" current_queue "<<current_queue<<" target_queue "<<m_target_queue);
- //   } 
-//    std::cout<<Simulator::Now().GetSeconds()<<" NOXFABRIC Queue_id "<<linkid_string<<" price "<<current_price<<" price_hike "<<price_hike<<" m_gamma "<<m_gamma<<" m_alpha "<<m_alpha<<std::endl;
-  } else {  /* IF ITS NUMFABRIC */
-//    std::cout<<"ERROR !!"<<std::endl;
+void
+PrioQueue::UpdateNumFabricPrice(void)
+{
     if(running_min_prio != MAX_DOUBLE) {
       latest_min_prio = running_min_prio;
     } else {
@@ -548,14 +654,9 @@ PrioQueue::updateLinkPrice(void)
    }
   
     NS_LOG_LOGIC(Simulator::Now().GetSeconds()<<" XFABRIC nodeid "<<nodeid<<" price "<<current_price<<" min_price_inc "<<min_price_inc<<" new_price "<<new_price<<" rate_increase "<<rate_increase);
-//   std::cout<<Simulator::Now().GetSeconds()<<" Queue_id "<<GetLinkIDString()<<" old_price "<<old_price<<" lastest_min_prio "<<latest_min_prio<<" rate_increase "<<incr<<" new_price "<<new_price<<" current_price "<<current_price<<" current_virtualtime "<<current_virtualtime<<" m_numfabric_eta "<<m_numfabric_eta<<" latest_min_prio "<<latest_min_prio<<" hcompensate "<<host_compensate<<std::endl;
    // when you update the price - set a timer to not update the minimum for an interval
    update_minimum = false;
    Simulator::Schedule(m_guardTime, &ns3::PrioQueue::enableUpdates, this); // don't update min residue for m_guardTime
-  }
-
-  m_updateEvent = Simulator::Schedule(m_updatePriceTime, &ns3::PrioQueue::updateLinkPrice, this);
- 
 }
 
 void
@@ -568,6 +669,18 @@ PrioQueue::~PrioQueue ()
 {
 //  NS_LOG_FUNCTION (this);
   update_minimum = true;
+  for (std::set<uint32_t>::iterator it = m_carriedFlows.begin (); it != m_carriedFlows.end (); ++it)
+    {
+      std::vector<PrioQueue *> &queues = s_flowQueues[*it];
+      queues.erase (std::find (queues.begin (), queues.end (), this));
+    }
+  // the flow ids and stopped flows belong to one simulation
+  if (--s_liveQueues == 0)
+    {
+      s_flowSlots.clear ();
+      s_flowStopped.clear ();
+      s_flowQueues.clear ();
+    }
 }
 
 void PrioQueue::SetNodeID(uint32_t node_id)
@@ -656,7 +769,7 @@ PrioQueue::GetCurSize(void)
   
    //NS_LOG_UNCOND(Simulator::Now().GetSeconds()<<" totalpktscounter "<<total_pkts<<" nodeid "<<nodeid);  
 
-  return m_bytesInQueue;
+  return m_bytesInQueue + (uint32_t) m_fluidBacklog;
 }
 
 uint32_t
@@ -673,13 +786,22 @@ PrioQueue::GetMode (void)
 }
 
 /***** Functions that will implement a queue using a std::list *****/
-bool PrioQueue::enqueue(Ptr<Packet> p)
+bool PrioQueue::enqueue(Ptr<Packet> p, uint32_t flow)
 {
   /* We assume all checks are done by the time
      the packet is here 
    */
   NS_LOG_FUNCTION (this << p);
   m_packets.push_back(p);
+  FlowChain &chain = m_flowChains[flow];
+  QueuedPacket queued;
+  queued.flow = flow;
+  queued.position = --m_packets.end ();
+  queued.link = chain.insert (chain.end (), queued.position);
+  m_queued.insert (std::make_pair (PeekPointer (p), queued));
+  if (m_carriedFlows.insert (flow).second) {
+    s_flowQueues[flow].push_back (this);
+  }
   m_size++;
   m_bytesInQueue += p->GetSize();
 
@@ -690,20 +812,23 @@ bool
 PrioQueue::remove(Ptr<Packet> p)
 {
   NS_LOG_FUNCTION(this << p);
-  typedef std::list<Ptr<Packet> >::iterator PacketQueueI;
-  PacketQueueI it = m_packets.begin();
-  
-  for(; it != m_packets.end(); it++) 
-  {
-    if(*it == p)
-    {
-      m_packets.erase(it);
-      m_size--;
-      m_bytesInQueue -= p->GetSize();
-      return true;
-    }
+  QueuedPackets::iterator queued = m_queued.lower_bound(PeekPointer(p));
+  if(queued == m_queued.end() || queued->first != PeekPointer(p)) {
+    return false;
   }
-  return false;
+  std::map<uint32_t, FlowChain>::iterator chain = m_flowChains.find(queued->second.flow);
+  chain->second.erase(queued->second.link);
+  if(chain->second.empty()) {
+    m_flowChains.erase(chain);
+  }
+  m_packets.erase(queued->second.position);
+  m_queued.erase(queued);
+  m_size--;
+  m_bytesInQueue -= p->GetSize();
+  if(m_histogramsEnabled) {
+    pkt_arrival.erase(p->GetUid());
+  }
+  return true;
 
 }
   
@@ -993,8 +1118,249 @@ PrioQueue::sort_by_priority(std::map<std::string, double> prios)
 
 
 
+/***** Queue disciplines *****/
+
+/*
+ * A discipline is a price controller, a scheduling order and an ECN
+ * marking policy.  Each policy is a set of static hooks called from the
+ * EnqueueWith/DequeueWith/UpdatePriceWith skeletons; with the policies
+ * fixed at compile time the hooks inline and the untaken algorithms
+ * leave no branches behind.
+ */
+
+/* price controllers: Update () runs every PriceUpdateTime */
+struct PrioQueue::NumFabricPrice
+{
+  static const char *Name (void) { return "NumFabric"; }
+  static void OnEnqueue (PrioQueue &q, double residue, bool control_packet)
+  {
+    if (residue < q.running_min_prio && !control_packet && q.update_minimum)
+      {
+        q.running_min_prio = residue;
+      }
+  }
+  static void Update (PrioQueue &q) { q.UpdateNumFabricPrice (); }
+  static bool MarksEcn (const PrioQueue &q) { return false; }
+};
+
+struct PrioQueue::DgdPrice
+{
+  static const char *Name (void) { return "Dgd"; }
+  static void OnEnqueue (PrioQueue &q, double residue, bool control_packet) {}
+  static void Update (PrioQueue &q) { q.UpdateDgdPrice (); }
+  static bool MarksEcn (const PrioQueue &q) { return true; }
+};
+
+struct PrioQueue::RcpPrice
+{
+  static const char *Name (void) { return "Rcp"; }
+  static void OnEnqueue (PrioQueue &q, double residue, bool control_packet) { q.updateAvgRtt (residue); }
+  static void Update (PrioQueue &q) { q.UpdateRcpPrice (); }
+  static bool MarksEcn (const PrioQueue &q) { return false; }
+};
+
+struct PrioQueue::RuntimePrice
+{
+  static void OnEnqueue (PrioQueue &q, double residue, bool control_packet)
+  {
+    NumFabricPrice::OnEnqueue (q, residue, control_packet);
+    if (q.alpha_fair_rcp)
+      {
+        RcpPrice::OnEnqueue (q, residue, control_packet);
+      }
+  }
+  static void Update (PrioQueue &q)
+  {
+    if (q.alpha_fair_rcp)
+      {
+        RcpPrice::Update (q);
+      }
+    else if (!q.xfabric_price)
+      {
+        DgdPrice::Update (q);
+      }
+    else
+      {
+        NumFabricPrice::Update (q);
+      }
+  }
+  static bool MarksEcn (const PrioQueue &q) { return !q.alpha_fair_rcp && !q.xfabric_price; }
+};
+
+/* scheduling orders: Select () picks the packet to dequeue, Victim () the
+   packet to mark */
+struct PrioQueue::FifoOrder
+{
+  static const char *Name (void) { return "Fifo"; }
+  static void OnEnqueue (PrioQueue &q, Ptr<Packet> p, const std::string &flowkey,
+                         bool control_packet, double wfq_weight) {}
+  static Ptr<Packet> Select (PrioQueue &q, double &deadline) { return q.m_packets.front (); }
+  static Ptr<Packet> Victim (PrioQueue &q, Ptr<Packet> p, double wfq_weight) { return p; }
+};
+
+struct PrioQueue::TagWfqOrder
+{
+  static const char *Name (void) { return "TagWfq"; }
+  static void OnEnqueue (PrioQueue &q, Ptr<Packet> p, const std::string &flowkey,
+                         bool control_packet, double wfq_weight)
+  {
+    q.TagPacket (p, flowkey, control_packet, wfq_weight);
+  }
+  static Ptr<Packet> Select (PrioQueue &q, double &deadline)
+  {
+    Ptr<Packet> p = q.get_lowest_tag_packet ();
+    if (!p)
+      {
+        NS_LOG_LOGIC ("could not get packet with " << q.linkid_string);
+      }
+    MyTag t1;
+    p->RemovePacketTag (t1);
+    deadline = t1.GetValue ();
+    return p;
+  }
+  static Ptr<Packet> Victim (PrioQueue &q, Ptr<Packet> p, double wfq_weight) { return p; }
+};
+
+struct PrioQueue::PFabricOrder
+{
+  static const char *Name (void) { return "PFabric"; }
+  static void OnEnqueue (PrioQueue &q, Ptr<Packet> p, const std::string &flowkey,
+                         bool control_packet, double wfq_weight) {}
+  static Ptr<Packet> Select (PrioQueue &q, double &deadline) { return q.GetLowestWeightPacket (); }
+  static Ptr<Packet> Victim (PrioQueue &q, Ptr<Packet> p, double wfq_weight)
+  {
+    return q.GetHighestWeightPacket (p, wfq_weight);
+  }
+};
+
+struct PrioQueue::RuntimeOrder
+{
+  static void OnEnqueue (PrioQueue &q, Ptr<Packet> p, const std::string &flowkey,
+                         bool control_packet, double wfq_weight)
+  {
+    if (q.m_pkt_tagged && !q.m_pfabricdequeue)
+      {
+        TagWfqOrder::OnEnqueue (q, p, flowkey, control_packet, wfq_weight);
+      }
+  }
+  static Ptr<Packet> Select (PrioQueue &q, double &deadline)
+  {
+    if (q.m_pfabricdequeue)
+      {
+        return PFabricOrder::Select (q, deadline);
+      }
+    else if (q.m_pkt_tagged)
+      {
+        return TagWfqOrder::Select (q, deadline);
+      }
+    return FifoOrder::Select (q, deadline);
+  }
+  static Ptr<Packet> Victim (PrioQueue &q, Ptr<Packet> p, double wfq_weight)
+  {
+    if (q.m_pfabricdequeue)
+      {
+        return PFabricOrder::Victim (q, p, wfq_weight);
+      }
+    return p;
+  }
+};
+
+/* marking: whether to ECN mark past ECNThreshBytes */
+struct PrioQueue::NoMark
+{
+  static const char *Name (void) { return "No"; }
+  template <class Price>
+  static bool Enabled (const PrioQueue &q) { return false; }
+};
+
+struct PrioQueue::EcnMark
+{
+  static const char *Name (void) { return "Ecn"; }
+  template <class Price>
+  static bool Enabled (const PrioQueue &q) { return true; }
+};
+
+/* ns3::PrioQueue marks when its price controller is DGD */
+struct PrioQueue::RuntimeMark
+{
+  template <class Price>
+  static bool Enabled (const PrioQueue &q) { return Price::MarksEcn (q); }
+};
+
+void
+PrioQueue::TagPacket (Ptr<Packet> p, const std::string &flowkey, bool control_packet, double wfq_weight)
+{
+    MyTag tag;
+    double deadline = get_stored_deadline(flowkey);
+    
+    
+    if(deadline == -1 || control_packet) {
+      if(control_packet) {
+        tag.SetValue(control_virtualtime * 1.0, Simulator::Now().GetNanoSeconds());
+      } else {
+        tag.SetValue(current_virtualtime * 1.0, Simulator::Now().GetNanoSeconds());
+      }
+    } else {
+      double new_start_time= std::max(current_virtualtime*1.0, deadline);
+      tag.SetValue(new_start_time, Simulator::Now().GetNanoSeconds());
+    }
+    p->AddPacketTag(tag);
+    // insert the new deadline now
+    set_stored_deadline(flowkey, tag.GetValue()+ wfq_weight); //there is no need to divide 8/16
+}
+
+Ptr<Packet>
+PrioQueue::GetHighestWeightPacket (Ptr<Packet> p, double wfq_weight)
+{
+  typedef std::list<Ptr<Packet> >::iterator PacketQueueI;
+
+  for (PacketQueueI pp = m_packets.begin (); pp != m_packets.end (); pp++)
+  {
+    PrioHeader pheader = GetPrioHeader (*(pp));
+    PriHeader phdata = pheader.GetData();
+    double cur_wfq_weight = phdata.wfq_weight;
+    if(cur_wfq_weight > wfq_weight) {
+      wfq_weight = cur_wfq_weight;
+      p = *pp;
+    }
+  }
+  return p;
+}
+
+Ptr<Packet>
+PrioQueue::GetLowestWeightPacket (void)
+{
+    typedef std::list<Ptr<Packet> >::iterator PacketQueueI;
+    double highest_wfq_weight_;
+    PacketQueueI pItr = m_packets.begin();
+    PrioHeader pheader;
+
+	  if (*pItr != NULL) 
+    {
+      pheader = GetPrioHeader(*pItr);
+		  highest_wfq_weight_ = (pheader.GetData()).wfq_weight;
+    }
+	  else
+    { //should not occur !!
+		  return 0;
+    }
+
+    for (PacketQueueI pp = m_packets.begin (); pp != m_packets.end (); pp++)
+    {
+      pheader = GetPrioHeader(*pp);
+      double  cur_wfq_weight = (pheader.GetData()).wfq_weight;
+       //deque from the head
+       if (cur_wfq_weight < highest_wfq_weight_) {
+	 pItr = pp;
+	highest_wfq_weight_ = cur_wfq_weight;
+       }
+    }
+    return *pItr;
+}
+
+template <class Price, class Order, class Mark>
 bool 
-PrioQueue::DoEnqueue (Ptr<Packet> p)
+PrioQueue::EnqueueWith (Ptr<Packet> p)
 {
   NS_LOG_FUNCTION (this << p);
 
@@ -1010,10 +1376,10 @@ PrioQueue::DoEnqueue (Ptr<Packet> p)
   
   Ptr<Packet> min_pp = p;
 
-
-  if(drop_list.find(GetFlowKey(min_pp)) != drop_list.end()) {
+  std::string flowkey = GetFlowKey(min_pp);
+  uint32_t flow = GetFlowSlot(flowkey);
+  if(s_flowStopped[flow]) {
     // drop this packet
-//    std::cout<<Simulator::Now().GetSeconds()<<" Dropiing pkt from flow "<<GetFlowKey(min_pp)<<" at q "<<linkid_string<<std::endl;
     Drop (p);
     return false;
   }
@@ -1025,63 +1391,37 @@ PrioQueue::DoEnqueue (Ptr<Packet> p)
 
   bool control_packet = false;
 
-// std::cout<<GetLinkIDString()<<" pkt from flow "<<GetFlowKey(min_pp)<<std::endl;
- 
   uint32_t header_size_total = tcph.GetSerializedSize() + pheader.GetSerializedSize() + h1.GetSerializedSize() + ppp.GetSerializedSize();
   if((min_pp->GetSize() - header_size_total) == 0) {
     control_packet = true;
   }
 
+  Price::OnEnqueue (*this, p_residue, control_packet);
+  Order::OnEnqueue (*this, p, flowkey, control_packet, min_wfq_weight);
 
-
-//  std::cout<<Simulator::Now().GetSeconds()<<" link "<<GetLinkIDString()<<" residue "<<p_residue<<" weight "<<min_wfq_weight<<" from flow "<<GetFlowKey(min_pp)<<std::endl;
-   if(p_residue < running_min_prio && !control_packet && update_minimum) {
-     running_min_prio = p_residue;
-   }
-
-   if(alpha_fair_rcp) {
-		updateAvgRtt(p_residue); 
-	}
-
-  if(m_pkt_tagged && !m_pfabricdequeue) {
-    MyTag tag;
-    std::string flowkey = GetFlowKey(min_pp);
-    double deadline = get_stored_deadline(flowkey);
-    
-    
-    if(deadline == -1 || control_packet) {
-      if(control_packet) {
-        tag.SetValue(control_virtualtime * 1.0, Simulator::Now().GetNanoSeconds());
-      } else {
-        tag.SetValue(current_virtualtime * 1.0, Simulator::Now().GetNanoSeconds());
-      }
-    } else {
-      double new_start_time= std::max(current_virtualtime*1.0, deadline);
-      tag.SetValue(new_start_time, Simulator::Now().GetNanoSeconds());
-//      pkt_tag[pkt_uid] = new_start_time;   //  + min_wfq_weight;
+  if(m_trackPacketDemand && !control_packet) {
+    // the host stamps (segment + 46) bytes over the target rate, in ns;
+    // flows that stamp no virtual length are elastic and ask for the link
+    double demand = m_bps.GetBitRate() / 1000000.0;
+    if(min_wfq_weight > 0.0) {
+      uint32_t segment = min_pp->GetSize() - pheader.GetSerializedSize() - h1.GetSerializedSize() - ppp.GetSerializedSize();
+      demand = (segment + 46) * 8.0 * 1000.0 / min_wfq_weight;
     }
-    p->AddPacketTag(tag);
-    // insert the new deadline now
-//   std::cout<<Simulator::Now().GetSeconds()<<" nodeid "<<linkid_string<<" pkt_flow "<<flowkey<<" storing deadline = "<< tag.GetValue()+ min_wfq_weight<<" tagged packet with "<<tag.GetValue()<<" pktid "<<p->GetUid()<<std::endl;
-    set_stored_deadline(flowkey, tag.GetValue()+ min_wfq_weight); //there is no need to divide 8/16
+    m_packetDemand[flowkey] = std::make_pair(demand, Simulator::Now());
   }
 
-  /* Also store time of arrival for each packet */
-  //pkt_arrival[pkt_uid] = Simulator::Now().GetNanoSeconds();
   incoming_bytes += min_pp->GetSize(); 
-  //if(linkid_string == "23_129_23")
-  //std::cout<<Simulator::Now().GetSeconds()<<" pkt arrival of size "<<min_pp->GetSize()<<" linkid_string "<<linkid_string<<" flow "<<GetFlowKey(min_pp)<<std::endl;
-    
 
-  // Now, enqueue    
-//  Ptr<UniformRandomVariable> uv = CreateObject<UniformRandomVariable> ();
-//  double rand_num = uv->GetValue(0.0, 1.0);
+  if(m_histogramsEnabled) {
+    if(m_histogramEpoch > Seconds(0) && !m_histogramEvent.IsRunning()) {
+      m_histogramEvent = Simulator::Schedule(m_histogramEpoch, &PrioQueue::HistogramEpoch, this);
+    }
+    m_histograms.RecordOccupancy(GetNBytes(), control_packet);
+    pkt_arrival[min_pp->GetUid()] = Simulator::Now().GetNanoSeconds();
+  }
 
-  enqueue(min_pp);
+  enqueue(min_pp, flow);
   
-  // dummy call for getting debug output
-//  GetCurSize();
-
   /* First check if the queue size exceeded */
   if ((m_mode == QUEUE_MODE_BYTES && (m_bytesInQueue >= m_maxBytes)) ||
         (m_mode == QUEUE_MODE_PACKETS && m_packets.size() >= m_maxPackets))
@@ -1097,20 +1437,17 @@ PrioQueue::DoEnqueue (Ptr<Packet> p)
         {
              
               typedef std::list<Ptr<Packet> >::iterator PacketQueueI;
-              //NS_LOG_UNCOND("Current queue .. "); 
               for (PacketQueueI pp = m_packets.begin (); pp != m_packets.end (); pp++)
               {
                 Ipv4Header h = GetIPHeader(*(pp));
                 PrioHeader pheader = GetPrioHeader(*(pp));
                 
-                // NS_LOG_UNCOND("DoEnqueue : source "<<h.GetSource()<<" dest : "<<h.GetDestination()<<" priority "<<pheader.GetData());
                 PriHeader phdata = pheader.GetData();
                 if(phdata.wfq_weight > min_wfq_weight) {
                   min_wfq_weight = phdata.wfq_weight;
                   min_pp = *pp;
                   min_source = h.GetSource();
                   min_dest = h.GetDestination();
-                  //NS_LOG_UNCOND("DoEnqueue : min_source "<<min_source<<" min_dest : "<<min_dest<<" priority "<<min_pp);
                 }
               }
 
@@ -1121,39 +1458,11 @@ PrioQueue::DoEnqueue (Ptr<Packet> p)
         } // if pfabric == 1 
     } /* if queue is going to be full */
 
-  else if (!alpha_fair_rcp && !xfabric_price && ((m_mode == QUEUE_MODE_BYTES && (m_bytesInQueue >= m_ECNThreshBytes)) ||
+  else if (Mark::template Enabled<Price> (*this) && ((m_mode == QUEUE_MODE_BYTES && (m_bytesInQueue >= m_ECNThreshBytes)) ||
         (m_mode == QUEUE_MODE_PACKETS && m_packets.size() >= m_ECNThreshPackets))) 
     {
-          // NS_LOG_UNCOND("Queue size greater than ECNThreshold. Marking packet");
           // Find the lowest priority packet and mark it with ECN marking 
-          //
-          
-          if(m_pfabricdequeue) { 
-            typedef std::list<Ptr<Packet> >::iterator PacketQueueI;
-        
-            for (PacketQueueI pp = m_packets.begin (); pp != m_packets.end (); pp++)
-            {
-              Ipv4Header h = GetIPHeader (*(pp));
-              PrioHeader pheader = GetPrioHeader (*(pp));
-              PriHeader phdata = pheader.GetData();
-              double cur_wfq_weight = phdata.wfq_weight;
-              if(cur_wfq_weight > min_wfq_weight) {
-                min_wfq_weight = cur_wfq_weight;
-                min_pp = *pp;
-              }
-            }
-          } 
-                 /*else if(m_pkt_tagged && !m_pfabricdequeue && !delay_mark) { 
-            // determine the packet id with the highest tag 
-            struct tag_elem elem = get_highest_tagid(); //get the lowest deadline pkt and remove it
-            uint64_t highest_tag_id = elem.pktid;
-            //highest_deadline = elem.deadline;
-            min_pp = get_packet_with_id(highest_tag_id);
-            if(!min_pp) {
-              NS_LOG_UNCOND("could not get packet with id "<<highest_tag_id);
-            }
-            NS_LOG_LOGIC("marking pkt at enqueue");
-          }*/ 
+          min_pp = Order::Victim (*this, min_pp, min_wfq_weight);
           
         // Now add ECN bit to the IP header of the min packet 
           
@@ -1164,7 +1473,6 @@ PrioQueue::DoEnqueue (Ptr<Packet> p)
         double rand_num = uv->GetValue(0.0, 1.0);
 
         if(min_pp && rand_num > 0.5)
-        //if(min_pp)
         {
           min_pp->RemoveHeader(ppp);
           min_pp->RemoveHeader(pheader);
@@ -1175,8 +1483,6 @@ PrioQueue::DoEnqueue (Ptr<Packet> p)
           min_pp->AddHeader(min_ipheader);
           min_pp->AddHeader(pheader);
           min_pp->AddHeader(ppp);
-//          std::cout<<Simulator::Now().GetSeconds()<<" "<<GetLinkIDString()<<" marking pkt from flow "<<GetFlowKey(min_pp)<<"Queue size "<<m_bytesInQueue<<std::endl;
-          
         } 
           
     } 
@@ -1184,6 +1490,79 @@ PrioQueue::DoEnqueue (Ptr<Packet> p)
   return true;
 }
 
+void
+PrioQueue::AccountFluid (double arrived, double departed, double backlog, double residue)
+{
+  // as DequeueWith, departures only count outside the guard time
+  incoming_bytes += arrived;
+  if (update_minimum)
+    {
+      outgoing_bytes += departed;
+    }
+  m_fluidBacklog = backlog;
+  NumFabricPrice::OnEnqueue (*this, residue, false);
+}
+
+void
+PrioQueue::TrackPacketDemand (bool track)
+{
+  m_trackPacketDemand = track;
+  m_packetDemand.clear ();
+}
+
+double
+PrioQueue::GetPacketDemand (Time window)
+{
+  double demand = 0.0;
+  Time since = Simulator::Now () - window;
+  std::map<std::string, std::pair<double, Time> >::iterator it = m_packetDemand.begin ();
+  while (it != m_packetDemand.end ())
+    {
+      if (it->second.second < since)
+        {
+          m_packetDemand.erase (it++);
+          continue;
+        }
+      demand += it->second.first;
+      ++it;
+    }
+  return demand;
+}
+
+void
+PrioQueue::DumpHistograms (void)
+{
+  m_histogramTrace (linkid_string, m_histograms);
+  m_histograms.Reset ();
+}
+
+const QueueHistograms &
+PrioQueue::GetHistograms (void) const
+{
+  return m_histograms;
+}
+
+void
+PrioQueue::HistogramEpoch (void)
+{
+  DumpHistograms ();
+  m_histogramEvent = Simulator::Schedule (m_histogramEpoch, &PrioQueue::HistogramEpoch, this);
+}
+
+template <class Price>
+void
+PrioQueue::UpdatePriceWith (void)
+{
+  Price::Update (*this);
+  m_updateEvent = Simulator::Schedule(m_updatePriceTime, &ns3::PrioQueue::updateLinkPrice, this);
+}
+
+bool 
+PrioQueue::DoEnqueue (Ptr<Packet> p)
+{
+  return EnqueueWith<RuntimePrice, RuntimeOrder, RuntimeMark> (p);
+}
+
 int
 PrioQueue::getflowid_temp(std::string fkey)
 {
@@ -1199,8 +1578,9 @@ PrioQueue::getflowid_temp(std::string fkey)
   return 0;
 }
 
+template <class Order>
 Ptr<Packet>
-PrioQueue::DoDequeue (void)
+PrioQueue::DequeueWith (void)
 {
   NS_LOG_FUNCTION (this);
 
@@ -1210,114 +1590,26 @@ PrioQueue::DoDequeue (void)
       return 0;
   }
 
-  /* Toss a coin - 50% of the do regular dequeue and 50% do priority dequeue */
-//  Ptr<UniformRandomVariable> uv = CreateObject<UniformRandomVariable> ();
-//  double rand_num = uv->GetValue(0.0, 1.0);
   Ptr<Packet> p = m_packets.front ();
 
   if(update_minimum) {
      outgoing_bytes += p->GetSize(); 
   }
-/*
-  short_ewma_const = 10000; //10us - make is same as ipv4 short const - TBD
-
-  double pkt_departure = Simulator::Now().GetNanoSeconds();
-  double pkt_interdeparture = pkt_departure - previous_departure;
-  previous_departure = pkt_departure;
-  double pkt_rate = (p->GetSize() * 1.0 * 8.0) / (pkt_interdeparture * 1.0e-9 * 1.0e+6); // should be in Mbps
-
-
-  // update rate
-  if(pkt_interdeparture == 0.0) {
-      departure_rate = m_bps.GetBitRate()/1000000.0;
-  } else {
-
-      double epower = exp((-1.0*pkt_interdeparture)/short_ewma_const);
-      double first_term = (1.0 - epower)*pkt_rate;
-
-      double second_term = epower * departure_rate;
-      departure_rate = first_term + second_term;
-   }
-
-*/
-//  std::cout<<"QRATE linkid "<<linkid_string<<" "<<pkt_departure<<" "<<pkt_interdeparture<<" "<<pkt_rate<<std::endl;
 
   double lowest_deadline = 0.0;
-  double pkt_wait_duration = 0.0;
-
-  if(m_pfabricdequeue) { 
-
-    typedef std::list<Ptr<Packet> >::iterator PacketQueueI;
-    double highest_wfq_weight_;
-    PacketQueueI pItr = m_packets.begin();
-    Ipv4Header h;
-    PrioHeader pheader;
-    Ipv4Address highSource, highDest;
-
-    if (m_packets.empty ())
+  p = Order::Select (*this, lowest_deadline);
+  if (p == 0)
     {
-      NS_LOG_LOGIC ("Queue empty");
       return 0;
     }
 
-	  if (*pItr != NULL) 
-    {
-//      NS_LOG_UNCOND("Dequeued packet with id "<<(*pItr)->GetUid()<<" size "<<(*pItr)->GetSize());
-      pheader = GetPrioHeader(*pItr);
-      h = GetIPHeader(*pItr);
-
-		  highest_wfq_weight_ = (pheader.GetData()).wfq_weight;
-      highSource = h.GetSource();
-      highDest = h.GetDestination();
-    }
-	  else
-    { //should not occur !!
-      //NS_LOG_UNCOND("DoDequeue: p is NULL");
-		  return 0;
-    }
-
-    for (PacketQueueI pp = m_packets.begin (); pp != m_packets.end (); pp++)
-    {
-      pheader = GetPrioHeader(*pp);
-      h = GetIPHeader(*pp);
-      double  cur_wfq_weight = (pheader.GetData()).wfq_weight;
-       //deque from the head
-       if (cur_wfq_weight < highest_wfq_weight_) {
-	 pItr = pp;
-	highest_wfq_weight_ = cur_wfq_weight;
-        highSource = h.GetSource();
-        highDest = h.GetDestination();
-       }
-    }
-    //if(nodeid == 0) {
-//    NS_LOG_LOGIC(Simulator::Now().GetSeconds()<<" node "<<nodeid<<" prio "<<highest_prio_<<" flowkey "<<GetFlowKey(p)<<"linkid "<<linkid<<" DEQUEUED ");
-    //}
-  
-    p = (*pItr);
-  } 
-  else if (m_pkt_tagged)
-  {
-    p = get_lowest_tag_packet();
-    if(!p) {
-      NS_LOG_LOGIC("could not get packet with "<<linkid_string);
-    }
-    MyTag t1;
-    p->RemovePacketTag(t1);
-    lowest_deadline = t1.GetValue();
-
-  //  double pkt_depart = Simulator::Now().GetNanoSeconds();
-  //  pkt_wait_duration = pkt_depart - t1.GetArrival();
-
-//    std::cout<<"pkt_tagged_dequeue "<<std::endl;
-
-    //NS_LOG_LOGIC("packetdeadline "<<Simulator::Now().GetSeconds()<<" "<<lowest_deadline<<" removed at node "<<nodeid<<" "<<GetFlowKey(p));
-
-    //NS_LOG_LOGIC("virtualtime at switch "<<nodeid<<" "<<Simulator::Now().GetSeconds()<<" "<<current_virtualtime);  
-    
-  } else {
-//    std::cout<<" plain dequeue "<<std::endl;
-  }
- 
+   Time sojourn = Seconds(0);
+   if(m_histogramsEnabled) {
+     std::map<uint64_t, double>::iterator arrival = pkt_arrival.find(p->GetUid());
+     if(arrival != pkt_arrival.end()) {
+       sojourn = Simulator::Now() - NanoSeconds(arrival->second);
+     }
+   }
 
    // debug 
    Ptr<Packet> ret_packet = p;
@@ -1329,6 +1621,9 @@ PrioQueue::DoDequeue (void)
    /* At Dequeue, update the network price field of the packet with the current link price */
 
   uint32_t pktsize  = ret_packet->GetSize();
+  if(m_departureRateTau.IsStrictlyPositive()) {
+    UpdateDepartureRate(pktsize);
+  }
    PppHeader temp_ppp;
    PrioHeader temp_pheader;
    Ipv4Header  temp_ip_header;
@@ -1346,6 +1641,9 @@ PrioQueue::DoDequeue (void)
    if((pktsize - header_size_total) == 0) {
     control_packet = true;
    }
+   if(m_histogramsEnabled) {
+     m_histograms.RecordSojourn(sojourn, control_packet);
+   }
 
     // increment virtual time
     if(!control_packet) {
@@ -1386,13 +1684,15 @@ PrioQueue::DoDequeue (void)
    ret_packet->AddHeader(temp_pheader);
    ret_packet->AddHeader(temp_ppp);
 
-   if(linkid_string == "23_129_23") {
-     //std::cout<<Simulator::Now().GetSeconds()<<"instant_queue_size "<<GetCurSize()<<std::endl;
-   }
-
    return ret_packet;
 }
 
+Ptr<Packet>
+PrioQueue::DoDequeue (void)
+{
+  return DequeueWith<RuntimeOrder> ();
+}
+
 void
 PrioQueue::SetVPkts(uint32_t vpkts)
 {
@@ -1429,6 +1729,70 @@ PrioQueue::DoPeek (void) const
   return p;
 }
 
+/*
+ * A PrioQueue with its discipline fixed at compile time.
+ */
+template <class Price, class Order, class Mark>
+class PrioQueueDiscipline : public PrioQueue
+{
+public:
+  static TypeId GetTypeId (void);
+
+  virtual void updateLinkPrice (void)
+  {
+    UpdatePriceWith<Price> ();
+  }
+
+private:
+  virtual bool DoEnqueue (Ptr<Packet> p)
+  {
+    return EnqueueWith<Price, Order, Mark> (p);
+  }
+  virtual Ptr<Packet> DoDequeue (void)
+  {
+    return DequeueWith<Order> ();
+  }
+};
+
+template <class Price, class Order, class Mark>
+TypeId
+PrioQueueDiscipline<Price, Order, Mark>::GetTypeId (void)
+{
+  static std::string name = std::string ("ns3::PrioQueue<") + Price::Name () + ","
+    + Order::Name () + "," + Mark::Name () + ">";
+  static TypeId tid = TypeId (name.c_str ())
+    .SetParent<PrioQueue> ()
+    .AddConstructor<PrioQueueDiscipline<Price, Order, Mark> > ()
+  ;
+  return tid;
+}
+
+#define PRIO_QUEUE_DISCIPLINE(price, order, mark)                       \
+  typedef PrioQueueDiscipline<PrioQueue::price ## Price,                \
+                              PrioQueue::order ## Order,                \
+                              PrioQueue::mark ## Mark>                  \
+    PrioQueue ## price ## order ## mark;                                \
+  NS_OBJECT_ENSURE_REGISTERED (PrioQueue ## price ## order ## mark)
+
+PRIO_QUEUE_DISCIPLINE (NumFabric, Fifo, No);
+PRIO_QUEUE_DISCIPLINE (NumFabric, Fifo, Ecn);
+PRIO_QUEUE_DISCIPLINE (NumFabric, TagWfq, No);
+PRIO_QUEUE_DISCIPLINE (NumFabric, TagWfq, Ecn);
+PRIO_QUEUE_DISCIPLINE (NumFabric, PFabric, No);
+PRIO_QUEUE_DISCIPLINE (NumFabric, PFabric, Ecn);
+PRIO_QUEUE_DISCIPLINE (Dgd, Fifo, No);
+PRIO_QUEUE_DISCIPLINE (Dgd, Fifo, Ecn);
+PRIO_QUEUE_DISCIPLINE (Dgd, TagWfq, No);
+PRIO_QUEUE_DISCIPLINE (Dgd, TagWfq, Ecn);
+PRIO_QUEUE_DISCIPLINE (Dgd, PFabric, No);
+PRIO_QUEUE_DISCIPLINE (Dgd, PFabric, Ecn);
+PRIO_QUEUE_DISCIPLINE (Rcp, Fifo, No);
+PRIO_QUEUE_DISCIPLINE (Rcp, Fifo, Ecn);
+PRIO_QUEUE_DISCIPLINE (Rcp, TagWfq, No);
+PRIO_QUEUE_DISCIPLINE (Rcp, TagWfq, Ecn);
+PRIO_QUEUE_DISCIPLINE (Rcp, PFabric, No);
+PRIO_QUEUE_DISCIPLINE (Rcp, PFabric, Ecn);
+
 } // namespace ns3
 
 
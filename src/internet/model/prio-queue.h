@@ -5,6 +5,8 @@
 #define PRIO_QUEUE_H
 
 #include <queue>
+#include <set>
+#include <vector>
 #include "ns3/packet.h"
 #include "ns3/object.h"
 #include "ns3/queue.h"
@@ -17,8 +19,11 @@
 #include "tcp-header.h"
 #include "ns3/tag.h"
 #include "ns3/event-id.h"
+#include "ns3/nstime.h"
+#include "ns3/traced-callback.h"
+#include "queue-histograms.h"
+#include "rate-estimator.h"
 
-//#include "ns3/traced-callback.h"
 
 //#include <tr1/unordered_map>
 //#include <tr1/functional>
@@ -68,15 +73,43 @@ class MyTag : public Tag
  
 
 
+/*
+ * ns3::PrioQueue picks its price controller, scheduling order and ECN
+ * marking from attributes, per packet.  The same disciplines are also
+ * registered with the choice made at compile time, one TypeId per
+ * combination: ns3::PrioQueue<Price,Order,Mark> with Price one of
+ * NumFabric, Dgd or Rcp, Order one of Fifo, TagWfq or PFabric and Mark
+ * one of No or Ecn, e.g. ns3::PrioQueue<NumFabric,TagWfq,No>.  They take
+ * the attributes of ns3::PrioQueue but ignore xfabric_price,
+ * alpha_fair_rcp, m_pkt_tag and m_pfabricdequeue.
+ */
 class PrioQueue : public Queue {
 public:
 
+  /* policies the disciplines are composed of, see prio-queue.cc */
+  struct NumFabricPrice;
+  struct DgdPrice;
+  struct RcpPrice;
+  struct FifoOrder;
+  struct TagWfqOrder;
+  struct PFabricOrder;
+  struct NoMark;
+  struct EcnMark;
+
   static TypeId GetTypeId (void);
   PrioQueue ();
   virtual ~PrioQueue ();
 
+  /* Stopped flows.  Every flow key seen by a PrioQueue gets a dense id in
+     a table shared by all queues, holding whether the flow was stopped and
+     which queues have carried it; each queue chains the packets it holds
+     per flow.  PurgeFlow stops a flow: it visits only the queues that
+     carried it and there only the flow's own packets, and from then on
+     every PrioQueue drops the flow's packets on arrival.
+     dropFlowPackets does the same for this queue only, after marking the
+     flow stopped everywhere. */
+  static void PurgeFlow (const std::string &flowkey);
   void dropFlowPackets(std::string);
-  std::map<std::string, uint32_t> drop_list;
     
   double averaged_ratio;
   double g; 
@@ -99,6 +132,9 @@ public:
   Time m_updateMinPrioTime;
   Time m_updatePriceTime;
   Time m_guardTime;
+  Time m_departureRateTau;
+  RateDecay m_departureDecay;
+  void UpdateDepartureRate (uint32_t pktsize);
   double xfabric_beta;
   double latest_avg_prio, running_avg_prio;
   double fct_alpha;
@@ -110,8 +146,12 @@ public:
   double incoming_bytes;
   double outgoing_bytes;
 
-  double departure_rate;
+  /* departure rate in Mbps, an EWMA over DepartureRateTau updated at every
+     dequeue; it stays 0 while DepartureRateTau is 0 */
+  EwmaRate departure_rate;
   double previous_departure;
+  void SetDepartureRateTau (Time tau);
+  Time GetDepartureRateTau (void) const;
    
   uint32_t getFlowID(Ptr<Packet> p);
   int getflowid_temp(std::string);
@@ -166,7 +206,26 @@ public:
   double current_price;
 
 
-  void updateLinkPrice(void);
+  virtual void updateLinkPrice(void);
+  /* fluid traffic, see ns3::FluidSimulator: the bytes that arrived and
+     left since the last call, the fluid backlog in bytes and the smallest
+     residue of the fluid flows, counted as if packets had carried them */
+  void AccountFluid (double arrived, double departed, double backlog, double residue);
+  double m_fluidBacklog;
+  /* packet flows sharing the link with fluid traffic: once tracking is on,
+     the rate each data packet's wfq_weight stands for (the link rate when
+     it has none) is kept per flow, and GetPacketDemand sums it over the
+     flows seen within window, in Mbps */
+  void TrackPacketDemand (bool track);
+  double GetPacketDemand (Time window);
+  bool m_trackPacketDemand;
+  std::map<std::string, std::pair<double, Time> > m_packetDemand;
+  /* with the Histograms attribute, the sojourn time of every dequeued
+     packet and the bytes of packets already queued at every arrival are
+     kept in log-linear histograms; the Histograms trace gets them, and they
+     restart, every HistogramEpoch and on DumpHistograms */
+  void DumpHistograms (void);
+  const QueueHistograms &GetHistograms (void) const;
   double getRateDifference(Time t);
   double getRateDifferenceNormalized(Time t);
 
@@ -195,13 +254,57 @@ public:
   TcpHeader GetTCPHeader(Ptr<Packet> p);
   Ptr<Packet> get_lowest_tag_packet();
 
+protected:
+  template <class Price, class Order, class Mark>
+  bool EnqueueWith (Ptr<Packet> p);
+  template <class Order>
+  Ptr<Packet> DequeueWith (void);
+  template <class Price>
+  void UpdatePriceWith (void);
+
 private:
+  /* the policies of ns3::PrioQueue, which follow the attributes */
+  struct RuntimePrice;
+  struct RuntimeOrder;
+  struct RuntimeMark;
+
   virtual bool DoEnqueue (Ptr<Packet> p);
   virtual Ptr<Packet> DoDequeue (void);
   virtual Ptr<const Packet> DoPeek (void) const;
 
-  bool enqueue(Ptr<Packet> p);
+  bool enqueue(Ptr<Packet> p, uint32_t flow);
   bool remove(Ptr<Packet> p);
+  void PurgeChain (uint32_t flow);
+
+  /* copies of a packet share its uid, so queued packets are found by
+     pointer, the same packet queued twice in arrival order */
+  typedef std::list<Ptr<Packet> >::iterator PacketQueueI;
+  typedef std::list<PacketQueueI> FlowChain;
+  struct QueuedPacket
+  {
+    uint32_t flow;
+    PacketQueueI position;
+    FlowChain::iterator link;
+  };
+  typedef std::multimap<const Packet *, QueuedPacket> QueuedPackets;
+  QueuedPackets::iterator FindQueued (PacketQueueI position);
+  QueuedPackets m_queued;                        //!< every queued packet
+  std::map<uint32_t, FlowChain> m_flowChains;    //!< packets queued per flow
+  std::set<uint32_t> m_carriedFlows;             //!< flows registered as carried here
+
+  static uint32_t GetFlowSlot (const std::string &flowkey);
+  static std::map<std::string, uint32_t> s_flowSlots;
+  static std::vector<uint8_t> s_flowStopped;
+  static std::vector<std::vector<PrioQueue *> > s_flowQueues;
+  static uint32_t s_liveQueues;
+
+  void UpdateRcpPrice (void);
+  void UpdateDgdPrice (void);
+  void UpdateNumFabricPrice (void);
+  void TagPacket (Ptr<Packet> p, const std::string &flowkey, bool control_packet, double wfq_weight);
+  Ptr<Packet> GetLowestWeightPacket (void);
+  Ptr<Packet> GetHighestWeightPacket (Ptr<Packet> p, double wfq_weight);
+  void HistogramEpoch (void);
 
   std::list<Ptr<Packet> > m_packets; //!< the packets in the queue
   uint32_t m_maxPackets;              //!< max packets in the queue
@@ -223,6 +326,12 @@ private:
   uint64_t  current_virtualtime;
   uint64_t  control_virtualtime;
 
+  bool m_histogramsEnabled;
+  Time m_histogramEpoch;
+  EventId m_histogramEvent;
+  QueueHistograms m_histograms;
+  TracedCallback<std::string, const QueueHistograms &> m_histogramTrace;
+
 //  unsigned int sq_limit_;
 //  unordered_map<size_t, int> sq_counts_;
 //  std::queue<size_t> sq_queue_;
@@ -0,0 +1,214 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+
+#include "queue-histograms.h"
+#include "ns3/assert.h"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace ns3 {
+
+LogLinearHistogram::LogLinearHistogram (uint32_t subBucketBits)
+  : m_subBucketBits (subBucketBits)
+{
+  NS_ASSERT (subBucketBits >= 1 && subBucketBits <= 16);
+  // 2^s exact buckets, then 2^s per power of two from 2^s to 2^63
+  m_counts.resize ((65 - subBucketBits) << subBucketBits, 0);
+  Reset ();
+}
+
+uint32_t
+LogLinearHistogram::GetBucket (uint64_t value) const
+{
+  uint64_t subBuckets = 1ULL << m_subBucketBits;
+  if (value < subBuckets)
+    {
+      return value;
+    }
+  uint32_t shift = 63 - __builtin_clzll (value) - m_subBucketBits;
+  return ((shift + 1) << m_subBucketBits) + ((value >> shift) - subBuckets);
+}
+
+void
+LogLinearHistogram::Record (uint64_t value)
+{
+  m_counts[GetBucket (value)]++;
+  m_count++;
+  m_sum += value;
+  m_min = std::min (m_min, value);
+  m_max = std::max (m_max, value);
+}
+
+void
+LogLinearHistogram::Merge (const LogLinearHistogram &o)
+{
+  NS_ASSERT (o.m_subBucketBits == m_subBucketBits);
+  for (uint32_t i = 0; i < m_counts.size (); i++)
+    {
+      m_counts[i] += o.m_counts[i];
+    }
+  m_count += o.m_count;
+  m_sum += o.m_sum;
+  m_min = std::min (m_min, o.m_min);
+  m_max = std::max (m_max, o.m_max);
+}
+
+void
+LogLinearHistogram::Reset (void)
+{
+  std::fill (m_counts.begin (), m_counts.end (), 0);
+  m_count = 0;
+  m_min = std::numeric_limits<uint64_t>::max ();
+  m_max = 0;
+  m_sum = 0.0;
+}
+
+uint64_t
+LogLinearHistogram::GetCount (void) const
+{
+  return m_count;
+}
+
+uint64_t
+LogLinearHistogram::GetMin (void) const
+{
+  return m_count > 0 ? m_min : 0;
+}
+
+uint64_t
+LogLinearHistogram::GetMax (void) const
+{
+  return m_max;
+}
+
+double
+LogLinearHistogram::GetMean (void) const
+{
+  return m_count > 0 ? m_sum / m_count : 0.0;
+}
+
+uint64_t
+LogLinearHistogram::GetQuantile (double q) const
+{
+  if (m_count == 0)
+    {
+      return 0;
+    }
+  uint64_t rank = std::max<uint64_t> (1, (uint64_t) std::ceil (q * m_count));
+  uint64_t seen = 0;
+  for (uint32_t i = 0; i < m_counts.size (); i++)
+    {
+      seen += m_counts[i];
+      if (seen >= rank)
+        {
+          return std::min (GetBucketHigh (i), m_max);
+        }
+    }
+  return m_max;
+}
+
+uint32_t
+LogLinearHistogram::GetNBuckets (void) const
+{
+  return m_counts.size ();
+}
+
+uint64_t
+LogLinearHistogram::GetBucketCount (uint32_t bucket) const
+{
+  return m_counts[bucket];
+}
+
+uint64_t
+LogLinearHistogram::GetBucketLow (uint32_t bucket) const
+{
+  uint32_t subBuckets = 1 << m_subBucketBits;
+  if (bucket < subBuckets)
+    {
+      return bucket;
+    }
+  uint32_t shift = (bucket >> m_subBucketBits) - 1;
+  return (uint64_t) (subBuckets + bucket % subBuckets) << shift;
+}
+
+uint64_t
+LogLinearHistogram::GetBucketHigh (uint32_t bucket) const
+{
+  uint32_t subBuckets = 1 << m_subBucketBits;
+  if (bucket < subBuckets)
+    {
+      return bucket;
+    }
+  uint32_t shift = (bucket >> m_subBucketBits) - 1;
+  return GetBucketLow (bucket) + ((1ULL << shift) - 1);
+}
+
+void
+LogLinearHistogram::Print (std::ostream &os) const
+{
+  os << "count " << m_count << " mean " << GetMean ()
+     << " p50 " << GetQuantile (0.5) << " p90 " << GetQuantile (0.9)
+     << " p99 " << GetQuantile (0.99) << " p999 " << GetQuantile (0.999)
+     << " max " << GetMax ();
+}
+
+void
+QueueHistograms::RecordSojourn (Time sojourn, bool control)
+{
+  uint64_t ns = std::max<int64_t> (0, sojourn.GetNanoSeconds ());
+  if (control)
+    {
+      m_sojournControl.Record (ns);
+    }
+  else
+    {
+      m_sojournData.Record (ns);
+    }
+}
+
+void
+QueueHistograms::RecordOccupancy (uint32_t bytes, bool control)
+{
+  if (control)
+    {
+      m_occupancyControl.Record (bytes);
+    }
+  else
+    {
+      m_occupancyData.Record (bytes);
+    }
+}
+
+void
+QueueHistograms::Merge (const QueueHistograms &o)
+{
+  m_sojournData.Merge (o.m_sojournData);
+  m_sojournControl.Merge (o.m_sojournControl);
+  m_occupancyData.Merge (o.m_occupancyData);
+  m_occupancyControl.Merge (o.m_occupancyControl);
+}
+
+void
+QueueHistograms::Reset (void)
+{
+  m_sojournData.Reset ();
+  m_sojournControl.Reset ();
+  m_occupancyData.Reset ();
+  m_occupancyControl.Reset ();
+}
+
+void
+QueueHistograms::Print (std::ostream &os, const std::string &prefix) const
+{
+  os << prefix << " sojourn_ns data ";
+  m_sojournData.Print (os);
+  os << std::endl << prefix << " sojourn_ns control ";
+  m_sojournControl.Print (os);
+  os << std::endl << prefix << " occupancy_bytes data ";
+  m_occupancyData.Print (os);
+  os << std::endl << prefix << " occupancy_bytes control ";
+  m_occupancyControl.Print (os);
+  os << std::endl;
+}
+
+} // namespace ns3
@@ -0,0 +1,92 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Streaming histograms of the sojourn time and occupancy of the xFabric
+ * queues, cheap enough to keep on every link of a large run.
+ */
+
+#ifndef QUEUE_HISTOGRAMS_H
+#define QUEUE_HISTOGRAMS_H
+
+#include <stdint.h>
+#include <ostream>
+#include <string>
+#include <vector>
+#include "ns3/nstime.h"
+
+namespace ns3 {
+
+/**
+ * \ingroup internet
+ *
+ * \brief Log-linear (HDR style) histogram of non-negative integers.
+ *
+ * Values below 2^SubBucketBits get a bucket each; above, every power of
+ * two is split into 2^SubBucketBits linear buckets, so a bucket is never
+ * wider than 2^-SubBucketBits of the values it holds.  The buckets are
+ * allocated once, for the whole 64-bit range, and Record is a few shifts
+ * and an increment.  Histograms of the same SubBucketBits can be merged.
+ */
+class LogLinearHistogram
+{
+public:
+  LogLinearHistogram (uint32_t subBucketBits = 4);
+
+  void Record (uint64_t value);
+  void Merge (const LogLinearHistogram &o);
+  void Reset (void);
+
+  uint64_t GetCount (void) const;
+  uint64_t GetMin (void) const;
+  uint64_t GetMax (void) const;
+  double GetMean (void) const;
+  /** Highest value of the bucket holding quantile q, at most the maximum. */
+  uint64_t GetQuantile (double q) const;
+
+  uint32_t GetNBuckets (void) const;
+  uint64_t GetBucketCount (uint32_t bucket) const;
+  /** Smallest value counted in bucket. */
+  uint64_t GetBucketLow (uint32_t bucket) const;
+  /** Largest value counted in bucket. */
+  uint64_t GetBucketHigh (uint32_t bucket) const;
+
+  /** count, mean, p50, p90, p99, p99.9 and max on one line. */
+  void Print (std::ostream &os) const;
+
+private:
+  uint32_t GetBucket (uint64_t value) const;
+
+  uint32_t m_subBucketBits;
+  std::vector<uint64_t> m_counts;
+  uint64_t m_count;
+  uint64_t m_min;
+  uint64_t m_max;
+  double m_sum;
+};
+
+/**
+ * \ingroup internet
+ *
+ * \brief Sojourn time (ns) and occupancy at enqueue (bytes) of a queue,
+ * data and control packets apart.
+ */
+class QueueHistograms
+{
+public:
+  void RecordSojourn (Time sojourn, bool control);
+  /** bytes already queued when a packet is enqueued */
+  void RecordOccupancy (uint32_t bytes, bool control);
+  void Merge (const QueueHistograms &o);
+  void Reset (void);
+
+  /** One line per histogram, each starting with prefix and its name. */
+  void Print (std::ostream &os, const std::string &prefix) const;
+
+  LogLinearHistogram m_sojournData;
+  LogLinearHistogram m_sojournControl;
+  LogLinearHistogram m_occupancyData;
+  LogLinearHistogram m_occupancyControl;
+};
+
+} // namespace ns3
+
+#endif /* QUEUE_HISTOGRAMS_H */
@@ -0,0 +1,192 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+
+#include "rate-estimator.h"
+#include <cmath>
+#include <vector>
+
+namespace ns3 {
+
+namespace {
+
+const double DECAY_STEPS = 256.0;
+const double DECAY_RANGE = 32.0;
+
+// exp (-i / DECAY_STEPS) for i up to DECAY_RANGE * DECAY_STEPS, one past
+// the end so that interpolation never reads beyond the table
+const std::vector<double> &
+DecayTable (void)
+{
+  static std::vector<double> table;
+  if (table.empty ())
+    {
+      uint32_t n = (uint32_t) (DECAY_RANGE * DECAY_STEPS) + 2;
+      table.resize (n);
+      for (uint32_t i = 0; i < n; i++)
+        {
+          table[i] = std::exp (-(i / DECAY_STEPS));
+        }
+    }
+  return table;
+}
+
+} // anonymous namespace
+
+RateDecay::RateDecay ()
+  : m_tau (1.0),
+    m_invTau (1.0),
+    m_fast (false)
+{
+}
+
+RateDecay::RateDecay (double tau, bool fast)
+  : m_tau (tau),
+    m_invTau (1.0 / tau),
+    m_fast (fast)
+{
+  if (fast)
+    {
+      DecayTable ();
+    }
+}
+
+double
+RateDecay::Get (double dt) const
+{
+  if (dt == 0.0)
+    {
+      return 1.0;
+    }
+  if (!m_fast)
+    {
+      return std::exp ((-1.0 * dt) / m_tau);
+    }
+  double x = dt * m_invTau * DECAY_STEPS;
+  if (x >= DECAY_RANGE * DECAY_STEPS)
+    {
+      return 0.0;
+    }
+  if (x < 0.0)
+    {
+      return std::exp ((-1.0 * dt) / m_tau);
+    }
+  const std::vector<double> &table = DecayTable ();
+  uint32_t i = (uint32_t) x;
+  double frac = x - i;
+  return table[i] + frac * (table[i + 1] - table[i]);
+}
+
+double
+RateDecay::GetTimeConstant (void) const
+{
+  return m_tau;
+}
+
+bool
+RateDecay::IsFast (void) const
+{
+  return m_fast;
+}
+
+EwmaRate::EwmaRate ()
+  : rate (0.0)
+{
+}
+
+void
+EwmaRate::Update (double sample, double decay)
+{
+  double first_term = (1.0 - decay) * sample;
+  double second_term = decay * rate;
+  rate = first_term + second_term;
+}
+
+void
+EwmaRate::Reset (double sample)
+{
+  rate = sample;
+}
+
+WindowRate::WindowRate ()
+  : bucketStart (-1.0),
+    head (0)
+{
+  for (uint32_t i = 0; i < Buckets; i++)
+    {
+      bytes[i] = 0.0;
+    }
+}
+
+void
+WindowRate::Advance (double now, double window)
+{
+  double width = window / Buckets;
+  if (bucketStart < 0.0)
+    {
+      bucketStart = now;
+      return;
+    }
+  double steps = std::floor ((now - bucketStart) / width);
+  if (steps <= 0.0)
+    {
+      return;
+    }
+  if (steps >= Buckets)
+    {
+      for (uint32_t i = 0; i < Buckets; i++)
+        {
+          bytes[i] = 0.0;
+        }
+    }
+  else
+    {
+      for (uint32_t i = 0; i < (uint32_t) steps; i++)
+        {
+          head = (head + 1) % Buckets;
+          bytes[head] = 0.0;
+        }
+    }
+  bucketStart += steps * width;
+}
+
+void
+WindowRate::Add (double b, double now, double window)
+{
+  Advance (now, window);
+  bytes[head] += b;
+}
+
+double
+WindowRate::GetRate (double now, double window)
+{
+  Advance (now, window);
+  double sum = 0.0;
+  for (uint32_t i = 0; i < Buckets; i++)
+    {
+      sum += bytes[i];
+    }
+  // bytes per ns to Mbps
+  return sum * 8000.0 / window;
+}
+
+KalmanRate::KalmanRate ()
+  : rate (0.0),
+    variance (-1.0)
+{
+}
+
+void
+KalmanRate::Update (double sample, double dt, double processNoise, double measurementNoise)
+{
+  if (variance < 0.0)
+    {
+      rate = sample;
+      variance = measurementNoise;
+      return;
+    }
+  variance += processNoise * dt;
+  double gain = variance / (variance + measurementNoise);
+  rate += gain * (sample - rate);
+  variance *= 1.0 - gain;
+}
+
+} // namespace ns3
@@ -0,0 +1,108 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Rate estimators shared by the hosts (per-flow ACK rates) and the switch
+ * queues (departure rates): a time-decayed EWMA, a sliding-window byte
+ * counter and a scalar Kalman filter.  Each keeps its state in a small
+ * struct, so a per-flow table holds them by value.
+ */
+
+#ifndef RATE_ESTIMATOR_H
+#define RATE_ESTIMATOR_H
+
+#include <stdint.h>
+
+namespace ns3 {
+
+/**
+ * \ingroup internet
+ *
+ * \brief exp (-dt / tau), the weight an EWMA keeps after dt.
+ *
+ * Exact by default.  Fast decays interpolate linearly in a table of
+ * exp (-x) with 256 points per unit of x, which bounds the relative error
+ * by 2e-6 and costs two loads and a multiply-add; beyond x = 32 the weight
+ * is 0.  A dt of 0 always keeps the whole weight, so samples arriving in
+ * the same timestep are folded without evaluating the exponential.
+ */
+class RateDecay
+{
+public:
+  RateDecay ();
+  /** tau and dt share their unit, ns for the xFabric estimators */
+  RateDecay (double tau, bool fast = false);
+
+  double Get (double dt) const;
+  double GetTimeConstant (void) const;
+  bool IsFast (void) const;
+
+private:
+  double m_tau;
+  double m_invTau;
+  bool m_fast;
+};
+
+/**
+ * \ingroup internet
+ *
+ * \brief Exponentially weighted average of rate samples.
+ */
+struct EwmaRate
+{
+  EwmaRate ();
+
+  /** Fold sample in, keeping decay of the previous rate. */
+  void Update (double sample, double decay);
+  /** Restart from sample, e.g. for the first sample or after a long idle time. */
+  void Reset (double sample);
+
+  double rate;
+};
+
+/**
+ * \ingroup internet
+ *
+ * \brief Bytes counted over the last Window, in Buckets sub-windows.
+ *
+ * The rate lags by at most one sub-window.  Times are in ns and rates in
+ * Mbps, as for the EWMA samples.
+ */
+struct WindowRate
+{
+  enum { Buckets = 8 };
+
+  WindowRate ();
+
+  void Add (double bytes, double now, double window);
+  double GetRate (double now, double window);
+
+  double bytes[Buckets];
+  double bucketStart;
+  uint32_t head;
+
+private:
+  void Advance (double now, double window);
+};
+
+/**
+ * \ingroup internet
+ *
+ * \brief Scalar Kalman filter of a rate that drifts as a random walk.
+ *
+ * The variance of the rate grows by processNoise per ns between samples,
+ * and a sample is off by measurementNoise (variance); the gain weighs the
+ * two, so noisy samples move a settled estimate little and a sample after
+ * a long gap moves it much.
+ */
+struct KalmanRate
+{
+  KalmanRate ();
+
+  void Update (double sample, double dt, double processNoise, double measurementNoise);
+
+  double rate;
+  double variance;
+};
+
+} // namespace ns3
+
+#endif /* RATE_ESTIMATOR_H */
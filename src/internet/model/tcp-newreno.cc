@@ -205,15 +205,12 @@ TcpNewReno::NewAck (const SequenceNumber32& seq)
     }
   else
     {
-        std::stringstream ss;
-        ss<<m_endPoint->GetLocalAddress()<<":"<<m_endPoint->GetPeerAddress()<<":"<<m_endPoint->GetPeerPort();
-        std::string flowkey = ss.str();
 //        std::cout<<" adjusting window -- dctcp xfabric "<<m_xfabric<<" strawman "<<m_strawmancc<<std::endl; 
         // Congestion avoidance mode, increase by (segSize*segSize)/cwnd. (RFC2581, sec.3.1)
         // To increase cwnd for one segSize per RTT, it should be (ackBytes*segSize)/cwnd
         double adder = static_cast<double> (m_segmentSize * m_segmentSize) / m_cWnd.Get ();
         adder = std::max (1.0, adder);
-      //  std::cout<<"adding to cwnd "<<adder<<" flow "<<flowkey<<std::endl;
+      //  std::cout<<"adding to cwnd "<<adder<<" flow "<<m_flowContext->GetFlowKey()<<std::endl;
         m_cWnd += static_cast<uint32_t> (adder);
     }
   } else if(m_dctcp && ecn_is_one) {
@@ -223,33 +220,21 @@ TcpNewReno::NewAck (const SequenceNumber32& seq)
 }
 
 uint32_t 
-TcpNewReno::getFlowId(std::string flowkey)
+TcpNewReno::getFlowId(void)
 {
-  uint32_t fid = 0;
-  Ptr<Ipv4L3Protocol> ipv4 = StaticCast<Ipv4L3Protocol > (m_node->GetObject<Ipv4> ());
-  if((ipv4->flowids).find(flowkey) != (ipv4->flowids).end()) {
-    fid = ipv4->flowids[flowkey];
+  if(m_flowContext == 0) {
+    BindFlowContext();
   }
-   
-//  std::map<std::string, uint32_t>::iterator it;
-//  for (it=ipv4->flowids.begin(); it!=ipv4->flowids.end(); ++it) {
-//    NS_LOG_LOGIC(it->first<<" "<<it->second);
-//  }
- 
-//  NS_LOG_LOGIC(" flowkey "<<flowkey<<" fid "<<fid); 
-  return fid;
+  return m_flowContext->GetFlowId();
 }
 
 double
-TcpNewReno::getFlowIdealRate(std::string flowkey)
+TcpNewReno::getFlowIdealRate(void)
 {
-  uint32_t fid = 0;
-  Ptr<Ipv4L3Protocol> ipv4 = StaticCast<Ipv4L3Protocol > (m_node->GetObject<Ipv4> ());
-  if((ipv4->flowids).find(flowkey) != (ipv4->flowids).end()) {
-    fid = ipv4->flowids[flowkey];
+  if(m_flowContext == 0) {
+    BindFlowContext();
   }
-  double rate = ipv4->flow_idealrate[fid]; 
-  return rate;
+  return m_flowContext->GetFlowIdealRate();
 }
 
 void
@@ -300,19 +285,21 @@ void
 TcpNewReno::processRate(const TcpHeader &tcpHeader)
 {
 
-  std::stringstream ss;
-  ss<<m_endPoint->GetLocalAddress()<<":"<<m_endPoint->GetPeerAddress()<<":"<<m_endPoint->GetPeerPort();
-  std::string flowkey = ss.str();
-  //std::cout<<" ack recvd for flow "<<flowkey<<" seq number "<<tcpHeader.GetAckNumber()<<" ack number "<<tcpHeader.GetSequenceNumber()<<std::endl;
+  // bound at connect or accept, unless the endpoint was set up some other way
+  if(m_flowContext == 0) {
+    if(m_endPoint == 0) {
+      return; // IPv6, the IP layer keeps no per-flow state
+    }
+    BindFlowContext();
+  }
+  HostFlowContext &flow = *m_flowContext;
+  //std::cout<<" ack recvd for flow "<<flow.GetFlowKey()<<" seq number "<<tcpHeader.GetAckNumber()<<" ack number "<<tcpHeader.GetSequenceNumber()<<std::endl;
   // if we are here, we have got an ACK - so we can say that the price is valid 
   double inter_arrival = tcpHeader.GetRate();
   uint32_t bytes_acked = getBytesAcked(tcpHeader);
-  // get the ipv4 object 
-  Ptr<Ipv4L3Protocol> ipv4 = StaticCast<Ipv4L3Protocol > (m_node->GetObject<Ipv4> ());
-  ipv4->setPriceValid(flowkey);
+  flow.SetPriceValid();
 
-  ipv4->setNumHops(flowkey, tcpHeader.GetHopCount());
-  uint32_t fid = ipv4->flowids[flowkey];
+  flow.SetNumHops(tcpHeader.GetHopCount());
 
 /*  if(fid == 8) {
   std::cout<<Simulator::Now().GetSeconds()<<" processRate flow "<<flowkey<<" node "<<m_node->GetId()<<" d0+dt "<<d0+m_dt<<" m_cWnd "<<m_cWnd<<" inter_arrival "<<inter_arrival<<" "<<Simulator::Now().GetNanoSeconds()<<" bytes_acked "<<bytes_acked<<" rtt "<<lastRtt_copy.GetNanoSeconds()<<" new cwnd "<<unquantized_window<<" using dt "<<m_dt<<std::endl; 
@@ -320,7 +307,7 @@ TcpNewReno::processRate(const TcpHeader &tcpHeader)
 
   if(m_strawmancc || m_dctcp) { // we want to update rates in case of both strawman and dctcp
 //    std::cout<<"either true.. strawman"<<m_strawmancc<<" dctcp "<<m_dctcp<<" xfabric "<<m_xfabric<<" node "<<m_node->GetId()<<std::endl;
-    ipv4->updateAverages(flowkey, inter_arrival, getBytesAcked(tcpHeader));
+    flow.UpdateAverages(inter_arrival, bytes_acked);
     return;
   }
 
@@ -353,7 +340,7 @@ TcpNewReno::processRate(const TcpHeader &tcpHeader)
     {
       //unquantized_window = 10*1000000000.0/8.0 * (dt+d0);
       unquantized_window = 10*1000000000.0/8.0 * (m_dt+0.000045);
-      ipv4->updateAverages(flowkey, inter_arrival, getBytesAcked(tcpHeader));
+      flow.UpdateAverages(inter_arrival, bytes_acked);
     } 
     //else if(scheme2 || scheme3) 
     else 
@@ -384,8 +371,8 @@ TcpNewReno::processRate(const TcpHeader &tcpHeader)
         if(scheme2 || scheme3) {
 
           // send the inter-arrival to update averages 
-          ipv4->updateAverages(flowkey, inter_arrival, getBytesAcked(tcpHeader));
-          double Rsmall = ipv4->GetShortTermRate(flowkey);
+          flow.UpdateAverages(inter_arrival, bytes_acked);
+          double Rsmall = flow.GetShortTermRate();
           // Now get the short term average for setting window 
           target_cwnd = Rsmall * (1000000.0/8.0) * (d0+m_dt); 
 
@@ -403,10 +390,9 @@ TcpNewReno::processRate(const TcpHeader &tcpHeader)
         }
         else 
         {
-          Ptr<Ipv4L3Protocol> ipv4 = StaticCast<Ipv4L3Protocol > (m_node->GetObject<Ipv4> ());
-          ipv4->updateAverages(flowkey, inter_arrival, getBytesAcked(tcpHeader));
+          flow.UpdateAverages(inter_arrival, bytes_acked);
           /* Now get the short term average for setting window */
-          double estimated_rate = ipv4->GetShortTermRate(flowkey);
+          double estimated_rate = flow.GetShortTermRate();
           if(estimated_rate < 0.0) {
             estimated_rate = 0.0;
 //            return;
@@ -469,10 +455,6 @@ TcpNewReno::ProcessECN(const TcpHeader &tcpHeader)
   NS_LOG_FUNCTION (this << tcpHeader);
   SequenceNumber32 ack_num = tcpHeader.GetAckNumber();
 
-  std::stringstream ss;
-  ss<<m_endPoint->GetLocalAddress()<<":"<<m_endPoint->GetPeerAddress()<<":"<<m_endPoint->GetPeerPort();
-  std::string flowkey = ss.str();
-
   /* update the last ack recvd variable */
   int32_t num_bytes_acked = ack_num.GetValue() - highest_ack_recvd.GetValue();
   NS_LOG_INFO("DCTCP_DEBUG "<<highest_ack_recvd.GetValue()<<" ack_num "<<ack_num.GetValue());
@@ -494,7 +476,7 @@ TcpNewReno::ProcessECN(const TcpHeader &tcpHeader)
        dctcp_alpha = (1.0 - beta)*dctcp_alpha + beta* new_alpha;
        total_bytes_acked = 0;
        bytes_with_ecn = 0; 
-       //std::cout<<Simulator::Now().GetSeconds()<<" node "<<m_node->GetId()<<" DCTCP_DEBUG new_alpha "<<new_alpha<<" DCTCP_ALPHA "<<dctcp_alpha<<" "<<flowkey<<" fid "<<getFlowId(flowkey)<<" ECN "<<tcpHeader.GetECN()<<" ssthresh "<<m_ssThresh<<" initcwnd "<<m_initialCWnd<<" lastoutstanding "<<last_outstanding_num<<" ack_num "<<ack_num<<" hightxmark "<<m_highTxMark<<std::endl;
+       //std::cout<<Simulator::Now().GetSeconds()<<" node "<<m_node->GetId()<<" DCTCP_DEBUG new_alpha "<<new_alpha<<" DCTCP_ALPHA "<<dctcp_alpha<<" "<<m_flowContext->GetFlowKey()<<" fid "<<getFlowId()<<" ECN "<<tcpHeader.GetECN()<<" ssthresh "<<m_ssThresh<<" initcwnd "<<m_initialCWnd<<" lastoutstanding "<<last_outstanding_num<<" ack_num "<<ack_num<<" hightxmark "<<m_highTxMark<<std::endl;
        last_outstanding_num = m_highTxMark;
      } 
    }
@@ -523,10 +505,10 @@ TcpNewReno::ProcessECN(const TcpHeader &tcpHeader)
           ecn_highest = m_highTxMark;
           //bytes_with_ecn = 0.0;
           //total_bytes_acked = 0.0;
-          //std::cout<<Simulator::Now().GetMicroSeconds()<<" m_dctcp -- processing ECN ack_num "<<ack_num<<" ecn_highest now "<<ecn_highest<<" "<<flowkey<<std::endl;
+          //std::cout<<Simulator::Now().GetMicroSeconds()<<" m_dctcp -- processing ECN ack_num "<<ack_num<<" ecn_highest now "<<ecn_highest<<" "<<m_flowContext->GetFlowKey()<<std::endl;
         
       } else {
-          //std::cout<<Simulator::Now().GetMicroSeconds()<<" m_dctcp -- not processing ECN ack_num "<<ack_num<<" ecn_highest "<<ecn_highest<<" "<<flowkey<<std::endl;
+          //std::cout<<Simulator::Now().GetMicroSeconds()<<" m_dctcp -- not processing ECN ack_num "<<ack_num<<" ecn_highest "<<ecn_highest<<" "<<m_flowContext->GetFlowKey()<<std::endl;
 //      NS_LOG_INFO("Notreacting "<<Simulator::Now().GetSeconds());
         // no reaction 
       }
@@ -75,8 +75,8 @@ protected:
   virtual void resetCW(double);
   virtual void ProcessECN(const TcpHeader &tcpheader);
   virtual void processRate(const TcpHeader &tcpheader);
-  uint32_t getFlowId(std::string fkey);
-  double getFlowIdealRate(std::string fkey);
+  uint32_t getFlowId(void);
+  double getFlowIdealRate(void);
   SequenceNumber32 ecn_highest;
   SequenceNumber32 last_outstanding_num;
   double d0, m_dt;
@@ -418,6 +418,7 @@ TcpSocketBase::Connect (const Address & address)
         { // Route to destination does not exist
           return -1;
         }
+      BindFlowContext ();
     }
   else if (Inet6SocketAddress::IsMatchingType (address)  && m_endPoint == 0)
     {
@@ -1876,6 +1877,15 @@ TcpSocketBase::SetupEndpoint ()
   return 0;
 }
 
+void
+TcpSocketBase::BindFlowContext (void)
+{
+  NS_LOG_FUNCTION (this);
+  std::stringstream ss;
+  ss << m_endPoint->GetLocalAddress () << ":" << m_endPoint->GetPeerAddress () << ":" << m_endPoint->GetPeerPort ();
+  m_flowContext = StaticCast<Ipv4L3Protocol> (m_node->GetObject<Ipv4> ())->GetFlowContext (ss.str ());
+}
+
 int
 TcpSocketBase::SetupEndpoint6 ()
 {
@@ -1921,6 +1931,7 @@ TcpSocketBase::CompleteFork (Ptr<Packet> p, const TcpHeader& h,
                                     InetSocketAddress::ConvertFrom (fromAddress).GetIpv4 (),
                                     InetSocketAddress::ConvertFrom (fromAddress).GetPort ());
       m_endPoint6 = 0;
+      BindFlowContext ();
     }
   else if (Inet6SocketAddress::IsMatchingType (toAddress))
     {
@@ -37,6 +37,7 @@
 #include "tcp-rx-buffer.h"
 #include "rtt-estimator.h"
 #include "flow_utils.h"
+#include "host-flow-context.h"
 
 namespace ns3 {
 
@@ -203,6 +204,13 @@ protected:
    */
   int SetupEndpoint6 (void);
 
+  /**
+   * \brief Bind m_flowContext to the IP layer state of the IPv4 endpoint.
+   * Called once the endpoint has its local and peer address, on connect
+   * and accept.
+   */
+  void BindFlowContext (void);
+
   /**
    * \brief Complete a connection by forking the socket
    *
@@ -653,6 +661,7 @@ protected:
   // Connections to other layers of TCP/IP
 //  Ipv4EndPoint*       m_endPoint;   //!< the IPv4 endpoint made public 12/21 Kanthi:
   Ipv6EndPoint*       m_endPoint6;  //!< the IPv6 endpoint
+  Ptr<HostFlowContext> m_flowContext; //!< per-flow state of the IPv4 endpoint in Ipv4L3Protocol
   Ptr<Node>           m_node;       //!< the associated node
   Ptr<TcpL4Protocol>  m_tcp;        //!< the associated TCP L4 protocol
   Callback<void, Ipv4Address,uint8_t,uint8_t,uint8_t,uint32_t> m_icmpCallback;  //!< ICMP callback
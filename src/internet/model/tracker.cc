@@ -3,10 +3,23 @@
 #define FLOW_START 1
 #define FLOW_STOP 2
 
+NS_OBJECT_ENSURE_REGISTERED (Tracker);
+
 FlowData::FlowData(uint32_t fid)
 {
   flow_id = fid;
+  flow_size = 0.0;
+  source_node = 0;
+  dest_node = 0;
+  flow_weight = 1.0;
+  flow_tcp = 0;
+  flow_known = 0;
+  flow_start = 0.0;
+  flow_rem_size = 0.0;
+  flow_deadline = 0.0;
+  flow_deadline_delta = 0.0;
   flow_running = true; //check if this is useful
+  flow_deadline_bound = false;
 }
 FlowData::FlowData(uint32_t source, int32_t dest, double fstart, double
 fsize, uint32_t flw_id, double fweight, uint32_t tcp, uint32_t known,
@@ -30,124 +43,176 @@ double flw_rem_size, double flw_deadline, double flw_deadline_delta, bool deadli
 //  std::cout<<"DEBUG PARAMS FlowData "<<source<<" "<<dest<<" "<<flow_start<<" "<<flow_size<<" "<<flow_id<<" "<<flow_weight<<" "<<flow_tcp<<" "<<flow_known<<" "<<flow_rem_size<<std::endl;
 }
 
+Tracker::Entry::Entry(const FlowData &fd)
+  : data(fd)
+{
+}
+
+TypeId Tracker::GetTypeId(void)
+{
+  static TypeId tid = TypeId ("Tracker")
+    .SetParent<Object> ()
+    .AddConstructor<Tracker> ()
+    .AddTraceSource ("FlowDump",
+                     "One tracked flow, fired for every flow by dataDump",
+                     MakeTraceSourceAccessor (&Tracker::m_dumpTrace))
+    .AddTraceSource ("FlowStart",
+                     "A flow started, as registered with registerEvent",
+                     MakeTraceSourceAccessor (&Tracker::m_startTrace))
+    .AddTraceSource ("FlowStop",
+                     "A flow stopped, as registered with registerEvent; passes the flow id",
+                     MakeTraceSourceAccessor (&Tracker::m_stopTrace))
+  ;
+  return tid;
+}
+
+Tracker::Tracker()
+  : scheduler_func(0)
+{
+}
+
+Tracker::~Tracker()
+{
+}
+
+void Tracker::DoDispose(void)
+{
+  for(FlowTable::iterator it = m_flows.begin(); it != m_flows.end(); ++it) {
+    delete it->second;
+  }
+  m_flows.clear();
+  m_deadlineOrder.clear();
+  m_sizeOrder.clear();
+  Object::DoDispose();
+}
 
 void Tracker::registered_callback(uint32_t fid)
 {
-  scheduler_func(fid);
+  if(scheduler_func) {
+    scheduler_func(fid);
+  }
 }
 
 void Tracker::register_callback(void (*functocall)(uint32_t))
 {
   scheduler_func = functocall;
-} 
-   
+}
+
+void Tracker::AddFlow(const FlowData &fd)
+{
+  // a restarted flow id replaces the old entry
+  RemoveFlow(fd.flow_id);
+  Entry *entry = new Entry(fd);
+  if(fd.flow_deadline_bound) {
+    entry->order = m_deadlineOrder.insert(std::make_pair(fd.flow_deadline, &entry->data));
+  } else {
+    entry->order = m_sizeOrder.insert(std::make_pair(fd.flow_rem_size, &entry->data));
+  }
+  m_flows[fd.flow_id] = entry;
+}
+
+bool Tracker::RemoveFlow(uint32_t fid)
+{
+  FlowTable::iterator it = m_flows.find(fid);
+  if(it == m_flows.end()) {
+    return false;
+  }
+  Entry *entry = it->second;
+  if(entry->data.flow_deadline_bound) {
+    m_deadlineOrder.erase(entry->order);
+  } else {
+    m_sizeOrder.erase(entry->order);
+  }
+  m_flows.erase(it);
+  delete entry;
+  return true;
+}
 
 void Tracker::registerEvent(uint32_t eventtype, FlowData fd)
 {
-    
   if(eventtype == FLOW_START) {
-//    std::cout<<"FLOW_START event "<<std::endl;
     // a new flow started - add it to set of flows
-    if(fd.flow_deadline_bound) {
-      deadline_flows_set.push_back(fd);
-    } else {
-       flows_set.push_back(fd);
-    }
-    dataDump();
+    AddFlow(fd);
+    m_startTrace(fd);
   } else {
-    //flows_set is a list..search for the right fid to remove
-    bool flow_erased = false;
- //   std::cout<<"FLOW_STOP event fid "<<fd.flow_id<<std::endl;
-    std::list<FlowData>::iterator itr;
-    itr = flows_set.begin();  
-    for(; itr != flows_set.end(); itr++) 
-    {
-      if(itr->flow_id == fd.flow_id) {
-        flows_set.erase(itr);
-        flow_erased = true;
-        break;
-      }
-    }
-
-    if(flow_erased == false) {
-      // didn't yet erase this flow.. look in the deadline bound flows 
-      itr = deadline_flows_set.begin();  
-      for(; itr != deadline_flows_set.end(); itr++) 
-      {
-        if(itr->flow_id == fd.flow_id) {
-          deadline_flows_set.erase(itr);
-          flow_erased = true;
-          break;
-        }
-      }
-    }  
-
-    if(flow_erased == false) {
+    if(!RemoveFlow(fd.flow_id)) {
 //      std::cout<<" ERROR ! FLOW TO BE ERASED NOT FOUND "<<std::endl;
     }
-    // 
-    registered_callback(fd.flow_id);  
-    
+    m_stopTrace(fd.flow_id);
+    registered_callback(fd.flow_id);
   }
 }
 
 void Tracker::dataDump(void)
 {
-    std::cout<<"flow_set dump "<<std::endl;
-    std::list<FlowData>::iterator itr;
-    itr = flows_set.begin();  
-    for(; itr != flows_set.end(); itr++) 
-    {
-      std::cout<<"fid "<<itr->flow_id<<" src "<<itr->source_node<<" dst "<<itr->dest_node<<" size "<<itr->flow_size<< " rem_size " << itr->flow_rem_size << " deadline " << itr->flow_deadline << " deadline_duration " << itr->flow_deadline_delta << " flow_start " << itr->flow_start << std::endl;
-    }
-
-    std::cout<<" DEADLINE BOUND FLOWS "<<std::endl;
-    itr = deadline_flows_set.begin();  
-    for(; itr != deadline_flows_set.end(); itr++) 
-    {
-      std::cout<<"fid "<<itr->flow_id<<" src "<<itr->source_node<<" dst "<<itr->dest_node<<" size "<<itr->flow_size<< " rem_size " << itr->flow_rem_size << " deadline " << itr->flow_deadline << " deadline_duration " << itr->flow_deadline_delta << " flow_start " << itr->flow_start << std::endl;
-    }
+  FlowOrder::const_iterator itr;
+  for(itr = m_sizeOrder.begin(); itr != m_sizeOrder.end(); itr++) {
+    m_dumpTrace(*itr->second);
+  }
+  for(itr = m_deadlineOrder.begin(); itr != m_deadlineOrder.end(); itr++) {
+    m_dumpTrace(*itr->second);
+  }
 }
 
 void Tracker::UpdateFlowRemainingSize(FlowData fd, double transmitted_size, uint32_t passed_in_flowID)
 {
-
-  /*
-  fd.flow_rem_size = double(fd.flow_size) - double(transmitted_size);
- 
-  if(fd. flow_rem_size <= 0.0){
-      fd.flow_rem_size = 0.0;
+  FlowTable::iterator it = m_flows.find(fd.flow_id);
+  if(it == m_flows.end()) {
+    return;
+  }
+  Entry *entry = it->second;
+  entry->data.flow_rem_size = double(entry->data.flow_size) - double(transmitted_size);
+  if(entry->data.flow_rem_size <= 0.0) {
+    entry->data.flow_rem_size = 0.0;
+  }
+  if(!entry->data.flow_deadline_bound) {
+    // re-key the flow in the SRPT order
+    m_sizeOrder.erase(entry->order);
+    entry->order = m_sizeOrder.insert(std::make_pair(entry->data.flow_rem_size, &entry->data));
   }
+}
 
-  std::cout<<"SC update flow rem size "<< fd.flow_rem_size << " transmitted size " << transmitted_size << " flow size " << fd.flow_size << " flow id " << fd.flow_id << " passed_in_flowID " << passed_in_flowID << std::endl; 
- */
+FlowData *Tracker::GetFlow(uint32_t fid)
+{
+  FlowTable::iterator it = m_flows.find(fid);
+  if(it == m_flows.end()) {
+    return 0;
+  }
+  return &it->second->data;
+}
 
- // dataDump();
- 
- std::list<FlowData>::iterator itr;
- itr = flows_set.begin();
- for(; itr != flows_set.end(); itr++)
- {
+FlowData *Tracker::GetEarliestDeadlineFlow(void)
+{
+  if(m_deadlineOrder.empty()) {
+    return 0;
+  }
+  return m_deadlineOrder.begin()->second;
+}
 
-      if(itr->flow_id == fd.flow_id) {
+FlowData *Tracker::GetShortestRemainingFlow(void)
+{
+  if(m_sizeOrder.empty()) {
+    return 0;
+  }
+  return m_sizeOrder.begin()->second;
+}
 
-        itr->flow_rem_size = double(itr->flow_size) - double(transmitted_size);
-     
-        if(itr->flow_rem_size <= 0.0){
-          itr->flow_rem_size = 0.0;
-        }
+uint32_t Tracker::GetNFlows(void) const
+{
+  return m_sizeOrder.size();
+}
 
-        // std::cout<<"SC update flow rem size "<< itr->flow_rem_size << " transmitted size " << transmitted_size << " flow size " << itr->flow_size << " flow id " << itr->flow_id << " passed_in_flowID " << passed_in_flowID << std::endl; 
-      }
-    
-    // std::cout<<"SC UPDATE SIZE fid "<<itr->flow_id<<" src "<<itr->source_node<<" dst "<<itr->dest_node<<" size "<<itr->flow_size<<std::endl;
- }
- 
- //dataDump(); 
+uint32_t Tracker::GetNDeadlineFlows(void) const
+{
+  return m_deadlineOrder.size();
+}
 
+const Tracker::FlowOrder &Tracker::GetDeadlineOrder(void) const
+{
+  return m_deadlineOrder;
 }
-   
 
-Tracker::Tracker()
+const Tracker::FlowOrder &Tracker::GetRemainingSizeOrder(void) const
 {
-}  
+  return m_sizeOrder;
+}
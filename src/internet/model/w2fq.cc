@@ -9,6 +9,8 @@
 #include "ns3/simulator.h"
 #include "ns3/random-variable-stream.h"
 #include "ns3/double.h"
+#include "ns3/boolean.h"
+#include "ns3/trace-source-accessor.h"
 #include <limits>
 
 NS_LOG_COMPONENT_DEFINE ("W2FQ");
@@ -19,7 +21,6 @@ static double MAXDOUBLE=1.79e+100;
 //static double PKTSIZE=1500*8.0;
 
 namespace ns3 {
-typedef std::map<uint32_t, std::queue<Ptr <Packet> > >::iterator pktq_iter; //!< the packets in the queue
 
 NS_OBJECT_ENSURE_REGISTERED (W2FQ);
 
@@ -55,6 +56,19 @@ TypeId W2FQ::GetTypeId (void)
                    UintegerValue (1),
                    MakeUintegerAccessor (&W2FQ::vpackets),
                    MakeUintegerChecker<uint32_t> ())
+    .AddAttribute ("Histograms",
+                   "Keep histograms of the sojourn time and occupancy of the queue",
+                   BooleanValue (false),
+                   MakeBooleanAccessor (&W2FQ::m_histogramsEnabled),
+                   MakeBooleanChecker ())
+    .AddAttribute ("HistogramEpoch",
+                   "Trace and restart the histograms this often, 0 only on DumpHistograms",
+                   TimeValue (Seconds (0)),
+                   MakeTimeAccessor (&W2FQ::m_histogramEpoch),
+                   MakeTimeChecker ())
+    .AddTraceSource ("Histograms",
+                     "Sojourn time and occupancy histograms of the queue, by link id",
+                     MakeTraceSourceAccessor (&W2FQ::m_histogramTrace))
 
 ;
   return tid;
@@ -69,6 +83,7 @@ W2FQ::W2FQ ()
   last_virtualtime_time = 0.0;
   last_virtualtime = 0.0;
   virtualtime_updated = 0;
+  m_histogramsEnabled = false;
 }
 
 W2FQ::~W2FQ ()
@@ -108,20 +123,17 @@ W2FQ::SetMode (W2FQ::QueueMode mode)
 
 uint32_t W2FQ::GetCurCount(uint32_t fid)
 {
-
-  return m_size[fid];
+  uint32_t handle = m_flows.Find(fid);
+  if(handle == FlowFifoTable::NONE) {
+    return 0;
+  }
+  return m_flows.Get(handle).packets;
 }
 
 
 uint32_t W2FQ::GetCurSize(uint32_t fid_dummy)
 {
-  uint32_t tot_bytes = 0;
-  for(std::map<uint32_t, uint32_t>::iterator it = m_bytesInQueue.begin(); it!=m_bytesInQueue.end(); ++it) {
-    uint32_t fid = it->first;
-//    std::cout<<"QOCCU "<<linkid_string<<" "<<Simulator::Now().GetSeconds()<<" "<<fid<<" "<<m_bytesInQueue[fid]<<std::endl;
-    tot_bytes += m_bytesInQueue[fid];
-  }
-  return tot_bytes;
+  return m_flows.GetNBytes();
 }
 
 uint32_t W2FQ::GetMaxBytes(void)
@@ -136,35 +148,6 @@ W2FQ::GetMode (void)
   return m_mode;
 }
 
-/***** Functions that will implement a queue using a std::list *****/
-bool W2FQ::enqueue(Ptr<Packet> p, uint32_t flowid)
-{
-  /* We assume all checks are done by the time
-     the packet is here 
-   */
-
-//  if(linkid_string == "0_0_1") {
-//    std::cout<<"E queuenumber "<<linkid_string<<" "<<Simulator::Now().GetNanoSeconds()<<" flow "<<flowid<<" pkts "<<m_size[flowid]<<std::endl;
-//  }
-  (m_packets[flowid]).push(p);
-  m_size[flowid] += 1;
-  m_bytesInQueue[flowid] += p->GetSize(); // TBD : headers?
-  return true;
-}
-
-bool 
-W2FQ::remove(Ptr<Packet> p, int32_t flowid)
-{
-  NS_LOG_FUNCTION(this << p);
-  m_packets[flowid].pop();
-  m_size[flowid]-= 1;
-  m_bytesInQueue[flowid] -= p->GetSize();
-//  if(linkid_string == "0_0_1") {
-//    std::cout<<"D queuenumber "<<linkid_string<<" "<<Simulator::Now().GetNanoSeconds()<<" flow "<<flowid<<" pkts "<<m_size[flowid]<<std::endl;
-//  }
-  return true;
-}
-  
 /*** private functions ****/ 
 TcpHeader
 W2FQ::GetTCPHeader(Ptr<Packet> p)
@@ -273,87 +256,48 @@ W2FQ::setFlowID(std::string flowkey, uint32_t fid, double fweight, uint32_t know
 
 
 void
-W2FQ::re_resetFlows(uint32_t flowid, Ptr<Packet> p)
-{
-     //double fw = flow_weights[flowid];
-     //if(fw < 1.0) {
-     // fw = 1000.0;
-     //}
-     double fw = getWFQweight(p);
-     double pkt_wfq_weight = p->GetSize()*8.0/fw;
-     local_flow_weights[flowid] = fw;
-    
-    start_time[flowid] = current_virtualtime;
-    finish_time[flowid] = start_time[flowid] + pkt_wfq_weight;
- 
- 
-    double min_starttime = start_time[flowid]; 
-    /* update virtual time */
-    pktq_iter it;
-    for (it = m_packets.begin(); it != m_packets.end(); ++it) {
-      uint32_t fid = it->first;
-    /*  if(linkid_string == "0_0_1") {
-        std::cout<<"start_time flowid "<<fid<<" "<<start_time[fid]<<" "<<Simulator::Now().GetSeconds()<<std::endl;
-        std::cout<<"finish_time flowid "<<fid<<" "<<finish_time[fid]<<" "<<Simulator::Now().GetSeconds()<<std::endl;
-      } */
-  
-      if(((m_packets[fid].size()) > 0) && (start_time[fid] < min_starttime)) {
-        min_starttime = start_time[fid];
-      }
-    }
+W2FQ::re_resetFlows(uint32_t handle, Ptr<Packet> p)
+{
+  double fw = getWFQweight(p);
+  double pkt_wfq_weight = p->GetSize()*8.0/fw;
+  FlowFifoTable::Flow &flow = m_flows.Get(handle);
+  flow.weight = fw;
+  flow.weighted = true;
 
+  flow.start = current_virtualtime;
+  flow.finish = flow.start + pkt_wfq_weight;
 
-    current_virtualtime = std::max(min_starttime, current_virtualtime);
-//      if(linkid_string == "0_0_1") 
-//    std::cout<<"re_resetFlows: flowid "<<flowid<<" start_time "<<start_time[flowid]<<" pkt_wfq_weight "<<pkt_wfq_weight<<" finish_time "<<finish_time[flowid]<<" vtime "<<current_virtualtime<<" min_starttime "<<min_starttime<<" VTIMEUPDATE "<<linkid_string<<std::endl;
-  return;
+  UpdateVirtualTime(flow.start);
 }
+
 void
-W2FQ::resetFlows(uint32_t flowid, Ptr<Packet> p)
-{
-   /*  double fw = flow_weights[flowid];
-     if(fw < 1.0) {
-      fw = 1000.0;
-     }
-    */
-    double fw = getWFQweight(p);
-    double pkt_wfq_weight = p->GetSize()*8.0/fw;
-     //double pkt_wfq_weight = PKTSIZE/fw;
-     local_flow_weights[flowid] = fw;
-     
-//      if(linkid_string == "0_0_1") 
-//     std::cout<<"before: flowid "<<flowid<<" start_time "<<start_time[flowid]<<" pkt_wfq_weight "<<pkt_wfq_weight<<" finish_time "<<finish_time[flowid]<<" vtime "<<current_virtualtime<<" "<<linkid_string<<" "<<Simulator::Now().GetSeconds()<<std::endl;
-     start_time[flowid] = std::max(current_virtualtime, finish_time[flowid]);
-     finish_time[flowid] = start_time[flowid] + pkt_wfq_weight;
-//      if(linkid_string == "0_0_1") 
-//     std::cout<<"after:flowid "<<flowid<<" start_time "<<start_time[flowid]<<" pkt_wfq_weight "<<pkt_wfq_weight<<" finish_time "<<finish_time[flowid]<<" vtime "<<current_virtualtime<<" "<<linkid_string<<std::endl;
- 
-    //uint32_t min_starttime = MAXUINT; 
-    double min_starttime = start_time[flowid]; 
-    /* update virtual time */
-    pktq_iter it;
-    for (it = m_packets.begin(); it != m_packets.end(); ++it) {
-      uint32_t fid = it->first;
-     /* if(linkid_string == "0_0_1") {
-        std::cout<<"start_time flowid "<<fid<<" "<<start_time[fid]<<" "<<Simulator::Now().GetSeconds()<<std::endl;
-        std::cout<<"finish_time flowid "<<fid<<" "<<finish_time[fid]<<" "<<Simulator::Now().GetSeconds()<<std::endl;
-      } */
-  
-      if(((m_packets[fid].size()) > 0) && (start_time[fid] < min_starttime)) {
-        min_starttime = start_time[fid];
-      }
-    }
+W2FQ::resetFlows(uint32_t handle, Ptr<Packet> p)
+{
+  double fw = getWFQweight(p);
+  double pkt_wfq_weight = p->GetSize()*8.0/fw;
+  FlowFifoTable::Flow &flow = m_flows.Get(handle);
+  flow.weight = fw;
+  flow.weighted = true;
+
+  flow.start = std::max(current_virtualtime, flow.finish);
+  flow.finish = flow.start + pkt_wfq_weight;
 
-    current_virtualtime = std::max(min_starttime, current_virtualtime);
-   /*   if(linkid_string == "0_0_1") {
-      std::cout.precision(15);
-      std::cout<<"VIRTUALTIMETRACK ENQUEUE "<<Simulator::Now().GetNanoSeconds()<<" "<<std::fixed<<old_virtualtime<<" "<<std::fixed<<current_virtualtime<<std::endl;
-      } 
-//      if(linkid_string == "0_0_1") 
-    std::cout<<"resetFlows: flowid "<<flowid<<" start_time "<<start_time[flowid]<<" pkt_wfq_weight "<<pkt_wfq_weight<<" finish_time "<<finish_time[flowid]<<" vtime "<<current_virtualtime<<" min_starttime "<<min_starttime<<" VTIMEUPDATE "<<linkid_string<<" fw "<<fw<<std::endl; */
-  return;
+  UpdateVirtualTime(flow.start);
+}
+
+/* the virtual time catches up with the earliest start of a backlogged flow,
+   if that is before min_starttime */
+void
+W2FQ::UpdateVirtualTime(double min_starttime)
+{
+  for (uint32_t handle = 0; handle < m_flows.GetNFlows(); handle++) {
+    const FlowFifoTable::Flow &flow = m_flows.Get(handle);
+    if((flow.packets > 0) && (flow.start < min_starttime)) {
+      min_starttime = flow.start;
+    }
+  }
+  current_virtualtime = std::max(min_starttime, current_virtualtime);
 }
-  
 
 bool 
 W2FQ::DoEnqueue (Ptr<Packet> p)
@@ -361,30 +305,36 @@ W2FQ::DoEnqueue (Ptr<Packet> p)
   NS_LOG_FUNCTION (this << p);
 
   uint32_t flowid = getFlowID(p);
+  uint32_t handle = m_flows.Lookup(flowid);
 
   /* First check if the queue size exceeded */
-  if ((m_mode == QUEUE_MODE_BYTES && (m_bytesInQueue[flowid] >= m_maxBytes)) ||
-        (m_mode == QUEUE_MODE_PACKETS && m_packets[flowid].size() >= m_maxPackets))
+  if ((m_mode == QUEUE_MODE_BYTES && (m_flows.Get(handle).bytes >= m_maxBytes)) ||
+        (m_mode == QUEUE_MODE_PACKETS && m_flows.Get(handle).packets >= m_maxPackets))
     {
             NS_LOG_UNCOND ("Queue full (packet would exceed max bytes) -- dropping pkt");
-            remove(p, flowid);
+            // the flow also loses the packet at its head
+            m_flows.Pop(handle);
             Drop (p);
             return false;
     }
  
-   if(m_packets[flowid].size() <= 0) { 
-    resetFlows(flowid, p);
-   }
+  if(m_flows.Get(handle).packets <= 0) { 
+    resetFlows(handle, p);
+  }
 
-   if((local_flow_weights.find(flowid) != local_flow_weights.end()) && (getWFQweight(p) != local_flow_weights[flowid])) {
-      re_resetFlows(flowid, p);
+  if(m_flows.Get(handle).weighted && (getWFQweight(p) != m_flows.Get(handle).weight)) {
+    re_resetFlows(handle, p);
+  }
+
+  if(m_histogramsEnabled) {
+    if(m_histogramEpoch > Seconds(0) && !m_histogramEvent.IsRunning()) {
+      m_histogramEvent = Simulator::Schedule(m_histogramEpoch, &W2FQ::HistogramEpoch, this);
+    }
+    m_histograms.RecordOccupancy(GetNBytes(), IsControlPacket(p));
   }
 
   pkt_arrival[p->GetUid()] = Simulator::Now().GetNanoSeconds();
-  enqueue(p, flowid); 
- // if(linkid_string == "0_0_1") {
- //   std::cout<<"enqueued packet with flowid "<<flowid<<" current_virtualtime "<<current_virtualtime<<" pakcte starttime "<<start_time[flowid]<<" finish time "<<finish_time[flowid]<<" "<<linkid_string<<" pkt size "<<p->GetSize()<<std::endl;
-  //} 
+  m_flows.Push(handle, p);
   return true;
   
 }
@@ -392,16 +342,7 @@ W2FQ::DoEnqueue (Ptr<Packet> p)
 bool
 W2FQ::QueueEmpty(void) 
 {
-  std::map<uint32_t, std::queue < Ptr <Packet> > >::iterator it;
-  it = m_packets.begin();
-  while(it != m_packets.end()) {
-    uint32_t fid = it->first;
-    if(m_packets[fid].size() > 0) {
-      return false;
-    }
-    ++it;
-  }
-  return true;
+  return m_flows.GetNPackets() == 0;
 } 
 
 Ptr<Packet>
@@ -411,121 +352,114 @@ W2FQ::DoDequeue (void)
 
   if (QueueEmpty())
   {
-    //  std::cout<<"Queue empty"<<std::endl;
       return 0;
   }
 
-  //uint32_t min_finishtime = MAXUINT;
+  /* the eligible flow with the smallest finish time, the smallest flow id on ties */
   double min_finishtime = MAXDOUBLE;
-  pktq_iter it;
-  int32_t flow = -1;
-  for (it=m_packets.begin(); it != m_packets.end(); ++it)
+  uint32_t served = FlowFifoTable::NONE;
+  for (uint32_t i = 0; i < m_flows.GetNFlows(); i++)
   {
-    uint32_t fid = it->first;
-     //if(linkid_string == "0_0_1") {
-//      std::cout<<"DoDequeue flow "<<fid<<" has "<<m_packets[fid].size()<<" packets: st "<<start_time[fid]<<" ft "<<finish_time[fid]<<" minfinish "<<min_finishtime<<" virtual time "<<current_virtualtime<<" "<<linkid_string<<std::endl;
-     // }
-    if((m_packets[fid].size() > 0) && (start_time[fid] <= current_virtualtime)) {
-      if(finish_time[fid] < min_finishtime) {
-        flow = fid;
-        min_finishtime = finish_time[fid];
+    uint32_t handle = m_flows.GetOrdered(i);
+    const FlowFifoTable::Flow &flow = m_flows.Get(handle);
+    if((flow.packets > 0) && (flow.start <= current_virtualtime)) {
+      if(flow.finish < min_finishtime) {
+        served = handle;
+        min_finishtime = flow.finish;
       }
     }
   }
 
-  if(flow == -1 || min_finishtime == MAXDOUBLE) {
+  if(served == FlowFifoTable::NONE || min_finishtime == MAXDOUBLE) {
     return 0;
   }
 
-  Ptr<Packet> pkt = m_packets[flow].front();
-  remove(pkt, flow);
+  Ptr<Packet> pkt = m_flows.Pop(served);
+
+  std::map<uint32_t, uint64_t>::iterator arrival = pkt_arrival.find(pkt->GetUid());
+  if(arrival != pkt_arrival.end()) {
+    if(m_histogramsEnabled) {
+      m_histograms.RecordSojourn(Simulator::Now() - NanoSeconds(arrival->second), IsControlPacket(pkt));
+    }
+    pkt_arrival.erase(arrival);
+  }
 
-  /* TBD : any other updates ? */
-  
   /* Set the start and finish times of the remaining packets in the queue */
-  //double pkt_wfq_weight = getWFQweight(pkt);
-  if(m_packets[flow].size() > 0) {
-     double pktSize = (m_packets[flow].front())->GetSize() * 8.0;
-
-/*     double fw = flow_weights[flow];
-     if(fw < 1.0) {
-      fw = 1000.0;
-     }
-*/
+  FlowFifoTable::Flow &flow = m_flows.Get(served);
+  if(flow.packets > 0) {
+    double pktSize = m_flows.Front(served)->GetSize() * 8.0;
     double fw = getWFQweight(pkt);
     double pkt_wfq_weight = pktSize/fw;
-    start_time[flow] = finish_time[flow];
-    finish_time[flow] = start_time[flow] + pkt_wfq_weight; 
-//    std::cout<<"updated starttime finishtime "<<start_time[flow]<<" "<<finish_time[flow]<<" "<<linkid_string<<" weight "<<pkt_wfq_weight<<" flow "<<flow<<" "<<pktSize<<" "<<fw<<std::endl;
+    flow.start = flow.finish;
+    flow.finish = flow.start + pkt_wfq_weight; 
   }
 
-  /* update the virtual clock */
-  double minS = start_time[flow];
+  /* update the virtual clock, summing the weights in flow id order */
+  double minS = flow.start;
   bool minSreset = false;
   double W = 0.00000001; 
-/*  std::map<uint32_t, double>::iterator it1;
-  for(it1=local_flow_weights.begin(); it1 != local_flow_weights.end(); ++it1)
-  {
-    uint32_t fid = it1->first;
-    double fweight = it1->second;
-    W += fweight;
-    if(m_packets[fid].size() > 0 && !minSreset) {
-      minSreset = true;
-      minS = start_time[fid];
-    }
-    if(m_packets[fid].size() > 0 && start_time[fid] < minS) {
-      minS = start_time[fid];
-    }
-  }
- */ 
-  for (it=m_packets.begin(); it != m_packets.end(); ++it)
+  for (uint32_t i = 0; i < m_flows.GetNFlows(); i++)
   {
-    uint32_t fid = it->first;
-    double fweight = local_flow_weights[fid];
-/*    if(fweight < 1.0) {
-      fweight = 1000.0;
-    }
-*/
-    W += fweight;
-    if(m_packets[fid].size() > 0 && !minSreset) {
+    const FlowFifoTable::Flow &other = m_flows.Get(m_flows.GetOrdered(i));
+    W += other.weight;
+    if(other.packets > 0 && !minSreset) {
       minSreset = true;
-      minS = start_time[fid];
+      minS = other.start;
     }
-    if(m_packets[fid].size() > 0 && start_time[fid] < minS) {
-      minS = start_time[fid];
+    if(other.packets > 0 && other.start < minS) {
+      minS = other.start;
     }
   } 
-/*  if(minSreset == false) {
-    minS = 0.0;
-    std::cout<<"minSRESET is false "<<linkid_string<<std::endl;
-  }
-*/  
-  //if(linkid_string == "0_0_1") {
-//    std::cout<<"determined minstartime "<<minS<<" second term "<< (1.0*current_virtualtime + (double)(pkt->GetSize()*8.0/W))<<" "<<linkid_string<<" W = "<<W<<std::endl;
-  //}
   current_virtualtime = std::max(minS*1.0, (1.0*current_virtualtime + (double)(pkt->GetSize()*8.0/W)));
-    /*  if(linkid_string == "0_0_1") {
-      std::cout.precision(15);
-      std::cout<<"VIRTUALTIMETRACK DEQUEUE "<<Simulator::Now().GetNanoSeconds()<<" "<<std::fixed<<old_virtualtime<<" "<<std::fixed<<current_virtualtime<<std::endl;
-      }*/
-//  current_virtualtime = std::max(minS*1.0, (1.0*current_virtualtime + PKTSIZE/W));
-  //double wait_duration = Simulator::Now().GetNanoSeconds() - pkt_arrival[pkt->GetUid()];
-//  if(linkid_string == "0_0_1") {
-//    std::cout<<"QWAIT "<<linkid_string<<" "<<Simulator::Now().GetSeconds()<<" "<<flow<<" spent "<<wait_duration<<" in queue "<<linkid_string<<std::endl;
-//    std::cout<<"DEQUEUE "<<linkid_string<<" "<<Simulator::Now().GetMicroSeconds()<<" "<<flow<<" pkt size "<<pkt->GetSize()<<std::endl;
     
-    virtualtime_updated += 1;
-    if(virtualtime_updated >= vpackets) {
-     virtualtime_updated = 0;
-     current_slope = CalcSlope();
-  //   std::cout<<"SLOPEINFO "<<linkid_string<<" "<<Simulator::Now().GetMicroSeconds()<<" "<<current_slope<<std::endl;
-    } 
+  virtualtime_updated += 1;
+  if(virtualtime_updated >= vpackets) {
+    virtualtime_updated = 0;
+    current_slope = CalcSlope();
+  } 
   
-//    std::cout<<"End of dequeue: flow "<<flow<<" stime "<<start_time[flow]<<" ftime "<<finish_time[flow]<<" vtime "<<current_virtualtime<<" min_starttime "<<minS<<" "<<linkid_string<<" VTIMEUPDATE"<<std::endl;
-//  }
   return (pkt);
 }
 
+bool
+W2FQ::IsControlPacket(Ptr<Packet> p)
+{
+  PppHeader ppp;
+  PrioHeader pheader;
+  Ipv4Header h1;
+  TcpHeader tcph;
+  uint32_t size = p->GetSize();
+  p->RemoveHeader(ppp);
+  p->RemoveHeader(pheader);
+  p->RemoveHeader(h1);
+  p->PeekHeader(tcph);
+  p->AddHeader(h1);
+  p->AddHeader(pheader);
+  p->AddHeader(ppp);
+  uint32_t header_size_total = tcph.GetSerializedSize() + h1.GetSerializedSize() + pheader.GetSerializedSize() + ppp.GetSerializedSize();
+  return size == header_size_total;
+}
+
+void
+W2FQ::DumpHistograms (void)
+{
+  m_histogramTrace (linkid_string, m_histograms);
+  m_histograms.Reset ();
+}
+
+const QueueHistograms &
+W2FQ::GetHistograms (void) const
+{
+  return m_histograms;
+}
+
+void
+W2FQ::HistogramEpoch (void)
+{
+  DumpHistograms ();
+  m_histogramEvent = Simulator::Schedule (m_histogramEpoch, &W2FQ::HistogramEpoch, this);
+}
+
 void
 W2FQ::SetVPkts(uint32_t vpkts)
 {
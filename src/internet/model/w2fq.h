@@ -15,8 +15,11 @@
 #include "ns3/data-rate.h"
 #include "ns3/boolean.h"
 #include "tcp-header.h"
-
-//#include "ns3/traced-callback.h"
+#include "ns3/event-id.h"
+#include "ns3/nstime.h"
+#include "ns3/traced-callback.h"
+#include "queue-histograms.h"
+#include "flow-fifo.h"
 
 //#include <tr1/unordered_map>
 //#include <tr1/functional>
@@ -60,6 +63,10 @@ public:
   uint32_t getFlowID(Ptr<Packet> p);
 
   void SetVPkts(uint32_t);
+
+  /* sojourn time and occupancy histograms, as ns3::PrioQueue keeps them */
+  void DumpHistograms (void);
+  const QueueHistograms &GetHistograms (void) const;
   
 
 private:
@@ -67,24 +74,14 @@ private:
   virtual bool DoEnqueue (Ptr<Packet> p);
   virtual Ptr<Packet> DoDequeue (void);
 
-  bool enqueue(Ptr<Packet> p, uint32_t flowid);
-  bool remove(Ptr<Packet> p, int32_t flowid);
-
-  std::map<uint32_t, std::queue<Ptr <Packet> > >m_packets; //!< the packets in the queue
-  std::map<uint32_t, uint32_t> m_size;
+  FlowFifoTable m_flows;              //!< the packets and the fair queueing state of each flow
   std::map<std::string, uint32_t> flow_ids;
   std::map<uint32_t, double> flow_weights;
   uint32_t m_maxPackets;              //!< max packets in the queue
   uint32_t m_maxBytes;                //!< max bytes in the queue
-  std::map<uint32_t, uint32_t> m_bytesInQueue;            //!< actual bytes in the queue
   DataRate m_bps;
   QueueMode m_mode;                   //!< queue mode (packets or bytes limited)
   double current_virtualtime;
-  std::map<uint32_t, double> local_flow_weights;
-
-  
-  std::map<uint32_t, double> start_time;
-  std::map<uint32_t, double> finish_time;
 
   double current_slope;
   double CalcSlope(void);
@@ -95,11 +92,20 @@ private:
   
   double getWFQweight(Ptr<Packet> p);
   bool QueueEmpty(void);
-  void resetFlows(uint32_t fid, Ptr<Packet> p);
-  void re_resetFlows(uint32_t fid, Ptr<Packet> p);
+  void resetFlows(uint32_t handle, Ptr<Packet> p);
+  void re_resetFlows(uint32_t handle, Ptr<Packet> p);
+  void UpdateVirtualTime(double min_starttime);
   
   TcpHeader GetTCPHeader(Ptr<Packet> p);
   Ptr<const Packet> DoPeek (void) const;
+  bool IsControlPacket (Ptr<Packet> p);
+  void HistogramEpoch (void);
+
+  bool m_histogramsEnabled;
+  Time m_histogramEpoch;
+  EventId m_histogramEvent;
+  QueueHistograms m_histograms;
+  TracedCallback<std::string, const QueueHistograms &> m_histogramTrace;
   
 };
 
@@ -0,0 +1,88 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+
+#include "ns3/test.h"
+#include "ns3/uinteger.h"
+#include "ns3/convergence-tracker.h"
+
+using namespace ns3;
+
+class ConvergenceTrackerWindowTest : public TestCase
+{
+public:
+  ConvergenceTrackerWindowTest ();
+private:
+  virtual void DoRun (void);
+  void Converged (void);
+  uint32_t m_fired;
+};
+
+ConvergenceTrackerWindowTest::ConvergenceTrackerWindowTest ()
+  : TestCase ("Converged callback fires after the window"),
+    m_fired (0)
+{
+}
+
+void
+ConvergenceTrackerWindowTest::Converged (void)
+{
+  m_fired++;
+}
+
+void
+ConvergenceTrackerWindowTest::DoRun (void)
+{
+  Ptr<ConvergenceTracker> tracker = CreateObject<ConvergenceTracker> ();
+  tracker->SetAttribute ("Window", UintegerValue (3));
+  tracker->SetConvergedCallback (MakeCallback (&ConvergenceTrackerWindowTest::Converged, this));
+
+  NS_TEST_ASSERT_MSG_EQ (tracker->Tick (), false, "no flows is not converged");
+
+  for (uint32_t fid = 1; fid <= 20; fid++)
+    {
+      tracker->AddFlow (fid, 100.0);
+    }
+  // one flow off by more than 10% still leaves 95% within tolerance
+  for (uint32_t fid = 1; fid <= 20; fid++)
+    {
+      tracker->UpdateRate (fid, fid == 1 ? 50.0 : 95.0);
+    }
+  NS_TEST_ASSERT_MSG_EQ (tracker->GetNWithinTolerance (), 19, "wrong count");
+  tracker->Tick ();
+  tracker->Tick ();
+
+  // a second bad flow drops below 95% and restarts the window
+  tracker->UpdateRate (2, 200.0);
+  NS_TEST_ASSERT_MSG_EQ (tracker->GetNWithinTolerance (), 18, "wrong count");
+  tracker->Tick ();
+  NS_TEST_ASSERT_MSG_EQ (tracker->GetConsecutive (), 0, "window not reset");
+
+  // removing it and fixing the first one restores the condition
+  tracker->RemoveFlow (2);
+  NS_TEST_ASSERT_MSG_EQ (tracker->GetNFlows (), 19, "flow not removed");
+  tracker->UpdateRate (1, 105.0);
+  NS_TEST_ASSERT_MSG_EQ (tracker->GetNWithinTolerance (), 19, "wrong count");
+  for (uint32_t i = 0; i < 3; i++)
+    {
+      NS_TEST_ASSERT_MSG_EQ (tracker->Tick (), false, "converged too early");
+    }
+  NS_TEST_ASSERT_MSG_EQ (tracker->Tick (), true, "not converged");
+  NS_TEST_ASSERT_MSG_EQ (m_fired, 1, "callback not invoked");
+  NS_TEST_ASSERT_MSG_EQ (tracker->GetConsecutive (), 0, "window not restarted");
+
+  // a new ideal rate re-evaluates the flows
+  for (uint32_t fid = 1; fid <= 20; fid++)
+    {
+      tracker->SetIdealRate (fid, 200.0);
+    }
+  NS_TEST_ASSERT_MSG_EQ (tracker->GetNWithinTolerance (), 0, "ideal rate ignored");
+}
+
+static class ConvergenceTrackerTestSuite : public TestSuite
+{
+public:
+  ConvergenceTrackerTestSuite ()
+    : TestSuite ("convergence-tracker", UNIT)
+  {
+    AddTestCase (new ConvergenceTrackerWindowTest (), TestCase::QUICK);
+  }
+} g_convergenceTrackerTestSuite;
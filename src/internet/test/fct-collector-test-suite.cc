@@ -0,0 +1,124 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+
+#include "ns3/test.h"
+#include "ns3/simulator.h"
+#include "ns3/string.h"
+#include "ns3/nstime.h"
+#include "ns3/data-rate.h"
+#include "ns3/object-factory.h"
+#include "ns3/tracker.h"
+#include "ns3/fct-collector.h"
+
+using namespace ns3;
+
+class FctStatsBucketTest : public TestCase
+{
+public:
+  FctStatsBucketTest ();
+private:
+  virtual void DoRun (void);
+};
+
+FctStatsBucketTest::FctStatsBucketTest ()
+  : TestCase ("flows fall in the size bucket of the first edge not below them")
+{
+}
+
+void
+FctStatsBucketTest::DoRun (void)
+{
+  std::vector<double> edges;
+  edges.push_back (100);
+  edges.push_back (1000);
+  FctStats stats (edges, 4);
+  NS_TEST_ASSERT_MSG_EQ (stats.GetBucket (50), 0, "below the first edge");
+  NS_TEST_ASSERT_MSG_EQ (stats.GetBucket (100), 0, "on the first edge");
+  NS_TEST_ASSERT_MSG_EQ (stats.GetBucket (101), 1, "above the first edge");
+  NS_TEST_ASSERT_MSG_EQ (stats.GetBucket (1000), 1, "on the last edge");
+  NS_TEST_ASSERT_MSG_EQ (stats.GetBucket (5000), 2, "above every edge");
+
+  stats.Record (50, 1000, 2.0);
+  stats.Record (5000, 3000, 1.5);
+  FctStats other (edges, 4);
+  other.Record (500, 2000, 1.0);
+  stats.Merge (other);
+  NS_TEST_ASSERT_MSG_EQ (stats.GetCount (), 3, "merged count");
+  NS_TEST_ASSERT_MSG_EQ (stats.GetFct (1).GetMax (), 2000, "merged bucket");
+  NS_TEST_ASSERT_MSG_EQ (stats.GetSlowdown (2).GetMax (), 1500, "slowdown in thousandths");
+}
+
+class FctCollectorTest : public TestCase
+{
+public:
+  FctCollectorTest ();
+private:
+  virtual void DoRun (void);
+  void WindowEnded (const FctStats &stats);
+  std::vector<uint64_t> m_windowCounts;
+};
+
+FctCollectorTest::FctCollectorTest ()
+  : TestCase ("FctCollector times flows started directly or through a Tracker, by window")
+{
+}
+
+void
+FctCollectorTest::WindowEnded (const FctStats &stats)
+{
+  m_windowCounts.push_back (stats.GetCount ());
+}
+
+void
+FctCollectorTest::DoRun (void)
+{
+  ObjectFactory factory;
+  factory.SetTypeId ("ns3::FctCollector");
+  // one byte per microsecond
+  factory.Set ("LineRate", DataRateValue (DataRate ("8Mbps")));
+  factory.Set ("BaseRtt", TimeValue (MicroSeconds (10)));
+  factory.Set ("SizeBuckets", StringValue ("100,1000"));
+  factory.Set ("Window", TimeValue (MilliSeconds (1)));
+  Ptr<FctCollector> collector = factory.Create<FctCollector> ();
+  collector->TraceConnectWithoutContext ("Window", MakeCallback (&FctCollectorTest::WindowEnded, this));
+
+  Ptr<Tracker> tracker = CreateObject<Tracker> ();
+  collector->Track (tracker);
+
+  // ideal fct 90us + 10us, done in 500us
+  Simulator::Schedule (Seconds (0), &FctCollector::FlowStarted, collector, 1, 90.0);
+  Simulator::Schedule (MicroSeconds (500), &FctCollector::FlowFinished, collector, 1);
+  // a second stop of the same flow is not recorded again
+  Simulator::Schedule (MicroSeconds (600), &FctCollector::FlowFinished, collector, 1);
+  FlowData big (0, 1, 0.0002, 5000, 2, 1.0, 1, 1, 5000, 0, 0);
+  Simulator::Schedule (MicroSeconds (200), &Tracker::registerEvent, tracker, 1, big);
+  Simulator::Schedule (MicroSeconds (1500), &Tracker::registerEvent, tracker, 0, big);
+  Simulator::Schedule (MicroSeconds (1800), &FctCollector::FlowStarted, collector, 3, 500.0);
+  Simulator::Stop (MicroSeconds (2500));
+  Simulator::Run ();
+
+  NS_TEST_ASSERT_MSG_EQ (m_windowCounts.size (), 2, "two windows ended");
+  NS_TEST_ASSERT_MSG_EQ (m_windowCounts[0], 1, "first window");
+  NS_TEST_ASSERT_MSG_EQ (m_windowCounts[1], 1, "second window");
+
+  FctStats stats = collector->GetStats ();
+  NS_TEST_ASSERT_MSG_EQ (stats.GetCount (), 2, "finished flows");
+  NS_TEST_ASSERT_MSG_EQ (collector->GetNOpen (), 1, "flow 3 still open");
+  NS_TEST_ASSERT_MSG_EQ (stats.GetFct (0).GetMax (), 500000, "fct of flow 1 in ns");
+  NS_TEST_ASSERT_MSG_EQ_TOL (stats.GetSlowdown (0).GetQuantile (0.5), 5000, 5000 / 64.0, "slowdown of flow 1");
+  NS_TEST_ASSERT_MSG_EQ (stats.GetFct (2).GetMax (), 1300000, "fct of flow 2 through the tracker");
+  NS_TEST_ASSERT_MSG_EQ (collector->GetWindowStats ().GetCount (), 0, "nothing finished in the third window");
+
+  collector->Dispose ();
+  Simulator::Destroy ();
+}
+
+static class FctCollectorTestSuite : public TestSuite
+{
+public:
+  FctCollectorTestSuite ()
+    : TestSuite ("fct-collector", UNIT)
+  {
+    AddTestCase (new FctStatsBucketTest (), TestCase::QUICK);
+    AddTestCase (new FctCollectorTest (), TestCase::QUICK);
+  }
+} g_fctCollectorTestSuite;
@@ -0,0 +1,143 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+
+#include "ns3/test.h"
+#include "ns3/ipv4-header.h"
+#include "ns3/ppp-header.h"
+#include "ns3/prio-header.h"
+#include "ns3/tcp-header.h"
+#include "ns3/flow-fifo.h"
+#include "ns3/w2fq.h"
+
+using namespace ns3;
+
+class FlowFifoTableTest : public TestCase
+{
+public:
+  FlowFifoTableTest ();
+private:
+  virtual void DoRun (void);
+};
+
+FlowFifoTableTest::FlowFifoTableTest ()
+  : TestCase ("per-flow FIFOs keep their order and reuse their pooled nodes")
+{
+}
+
+void
+FlowFifoTableTest::DoRun (void)
+{
+  FlowFifoTable table;
+  NS_TEST_ASSERT_MSG_EQ (table.Find (5), FlowFifoTable::NONE, "unknown flow");
+  uint32_t five = table.Lookup (5);
+  uint32_t two = table.Lookup (2);
+  NS_TEST_ASSERT_MSG_EQ (table.Lookup (5), five, "one record per flow id");
+  NS_TEST_ASSERT_MSG_EQ (table.Find (2), two, "found after the lookup");
+  NS_TEST_ASSERT_MSG_EQ (table.GetNFlows (), 2, "two flows");
+  NS_TEST_ASSERT_MSG_EQ (table.GetOrdered (0), two, "flows in the order of their ids");
+  NS_TEST_ASSERT_MSG_EQ (table.GetOrdered (1), five, "flows in the order of their ids");
+
+  Ptr<Packet> p[5];
+  for (uint32_t i = 0; i < 5; i++)
+    {
+      p[i] = Create<Packet> (100 * (i + 1));
+      table.Push (i < 3 ? five : two, p[i]);
+    }
+  NS_TEST_ASSERT_MSG_EQ (table.Get (five).packets, 3, "packets of flow 5");
+  NS_TEST_ASSERT_MSG_EQ (table.Get (two).bytes, 900, "bytes of flow 2");
+  NS_TEST_ASSERT_MSG_EQ (table.GetNPackets (), 5, "packets of all flows");
+  NS_TEST_ASSERT_MSG_EQ (table.GetNBytes (), 1500, "bytes of all flows");
+  NS_TEST_ASSERT_MSG_EQ (table.Front (two), p[3], "head of flow 2");
+
+  NS_TEST_ASSERT_MSG_EQ (table.Pop (five), p[0], "first in, first out");
+  NS_TEST_ASSERT_MSG_EQ (table.Pop (five), p[1], "first in, first out");
+  table.Push (five, p[0]);
+  NS_TEST_ASSERT_MSG_EQ (table.Pop (five), p[2], "pushed behind the queued packet");
+  NS_TEST_ASSERT_MSG_EQ (table.Pop (five), p[0], "pushed behind the queued packet");
+  NS_TEST_ASSERT_MSG_EQ (table.Front (five), 0, "flow 5 drained");
+  NS_TEST_ASSERT_MSG_EQ (table.Get (five).bytes, 0, "no bytes left in flow 5");
+  NS_TEST_ASSERT_MSG_EQ (table.GetPoolSize (), 5, "freed nodes are reused");
+  for (uint32_t i = 0; i < 3; i++)
+    {
+      table.Push (five, p[i]);
+    }
+  NS_TEST_ASSERT_MSG_EQ (table.GetPoolSize (), 5, "no node allocated below the peak occupancy");
+  NS_TEST_ASSERT_MSG_EQ (table.Pop (two), p[3], "flow 2 untouched by flow 5");
+  NS_TEST_ASSERT_MSG_EQ (table.GetNPackets (), 4, "packets of all flows");
+  NS_TEST_ASSERT_MSG_EQ (table.GetNBytes (), 1100, "bytes of all flows");
+}
+
+static Ptr<Packet>
+MakeWeightedPacket (uint16_t port, double wfqWeight)
+{
+  Ptr<Packet> p = Create<Packet> (100);
+  TcpHeader tcp;
+  tcp.SetDestinationPort (port);
+  p->AddHeader (tcp);
+  Ipv4Header ip;
+  ip.SetSource (Ipv4Address ("10.0.0.1"));
+  ip.SetDestination (Ipv4Address ("10.0.0.2"));
+  p->AddHeader (ip);
+  PrioHeader prio;
+  prio.SetData (PriHeader (wfqWeight, 0.0, 0.0));
+  p->AddHeader (prio);
+  p->AddHeader (PppHeader ());
+  return p;
+}
+
+class W2fqWeightedServiceTest : public TestCase
+{
+public:
+  W2fqWeightedServiceTest ();
+private:
+  virtual void DoRun (void);
+};
+
+W2fqWeightedServiceTest::W2fqWeightedServiceTest ()
+  : TestCase ("W2FQ serves backlogged flows in proportion to their weights")
+{
+}
+
+void
+W2fqWeightedServiceTest::DoRun (void)
+{
+  Ptr<W2FQ> q = CreateObject<W2FQ> ();
+  q->setFlowID ("10.0.0.1:10.0.0.2:1", 1, 2.0, 1);
+  q->setFlowID ("10.0.0.1:10.0.0.2:2", 2, 1.0, 1);
+  for (uint32_t i = 0; i < 6; i++)
+    {
+      q->Enqueue (MakeWeightedPacket (1, 2.0));
+      q->Enqueue (MakeWeightedPacket (2, 1.0));
+    }
+  NS_TEST_ASSERT_MSG_EQ (q->GetCurCount (1), 6, "packets of flow 1");
+  NS_TEST_ASSERT_MSG_EQ (q->GetCurCount (3), 0, "unknown flows hold no packets");
+  uint32_t size = MakeWeightedPacket (1, 2.0)->GetSize ();
+  NS_TEST_ASSERT_MSG_EQ (q->GetCurSize (0), 12 * size, "bytes of all flows");
+
+  // virtual finish times S/2, S, 3S/2, 2S for flow 1 and S, 2S for flow 2
+  uint16_t expected[] = { 1, 2, 1, 1, 2, 1 };
+  for (uint32_t i = 0; i < 6; i++)
+    {
+      Ptr<Packet> p = q->Dequeue ();
+      NS_TEST_ASSERT_MSG_NE (p, 0, "backlogged queue");
+      NS_TEST_ASSERT_MSG_EQ (q->getFlowID (p), expected[i], "service order, packet " << i);
+    }
+  NS_TEST_ASSERT_MSG_EQ (q->GetCurCount (1), 2, "flow 1 served twice as often");
+  NS_TEST_ASSERT_MSG_EQ (q->GetCurCount (2), 4, "flow 2 served half as often");
+  for (uint32_t i = 0; i < 6; i++)
+    {
+      q->Dequeue ();
+    }
+  NS_TEST_ASSERT_MSG_EQ (q->Dequeue (), 0, "drained");
+  NS_TEST_ASSERT_MSG_EQ (q->GetCurSize (0), 0, "no bytes left");
+}
+
+static class FlowFifoTestSuite : public TestSuite
+{
+public:
+  FlowFifoTestSuite ()
+    : TestSuite ("flow-fifo", UNIT)
+  {
+    AddTestCase (new FlowFifoTableTest (), TestCase::QUICK);
+    AddTestCase (new W2fqWeightedServiceTest (), TestCase::QUICK);
+  }
+} g_flowFifoTestSuite;
@@ -0,0 +1,239 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+
+#include <vector>
+#include "ns3/test.h"
+#include "ns3/simulator.h"
+#include "ns3/enum.h"
+#include "ns3/nstime.h"
+#include "ns3/data-rate.h"
+#include "ns3/uinteger.h"
+#include "ns3/boolean.h"
+#include "ns3/object-factory.h"
+#include "ns3/ipv4-header.h"
+#include "ns3/ppp-header.h"
+#include "ns3/prio-header.h"
+#include "ns3/tcp-header.h"
+#include "ns3/prio-queue.h"
+#include "ns3/fluid-simulator.h"
+
+using namespace ns3;
+
+class FluidNumFabricTest : public TestCase
+{
+public:
+  FluidNumFabricTest ();
+private:
+  virtual void DoRun (void);
+  void Sample (void);
+  Ptr<FluidSimulator> m_fluid;
+  double m_rate1;
+  double m_rate2;
+};
+
+FluidNumFabricTest::FluidNumFabricTest ()
+  : TestCase ("NUMFabric prices drive weighted fair rates to the NUM optimum"),
+    m_rate1 (0.0),
+    m_rate2 (0.0)
+{
+}
+
+void
+FluidNumFabricTest::Sample (void)
+{
+  m_rate1 = m_fluid->GetFluidRate (1);
+  m_rate2 = m_fluid->GetFluidRate (2);
+}
+
+void
+FluidNumFabricTest::DoRun (void)
+{
+  ObjectFactory factory;
+  factory.SetTypeId ("ns3::PrioQueue<NumFabric,TagWfq,No>");
+  factory.Set ("DataRate", DataRateValue (DataRate ("1Gbps")));
+  factory.Set ("PriceUpdateTime", TimeValue (MicroSeconds (200)));
+  factory.Set ("guardTime", TimeValue (MicroSeconds (100)));
+  Ptr<PrioQueue> queue = factory.Create<PrioQueue> ();
+
+  m_fluid = CreateObject<FluidSimulator> ();
+  uint32_t link = m_fluid->AddLink (queue);
+  // log utilities weighted 1 and 3 share 1Gbps as 250 and 750Mbps
+  m_fluid->AddFlow (1, std::vector<uint32_t> (1, link), 0, 1.0);
+  m_fluid->AddFlow (2, std::vector<uint32_t> (1, link), 0, 3.0);
+
+  // the queue starts updating its price at 1s
+  Simulator::Schedule (Seconds (1.2), &FluidNumFabricTest::Sample, this);
+  Simulator::Stop (Seconds (1.2001));
+  Simulator::Run ();
+
+  NS_TEST_ASSERT_MSG_EQ_TOL (m_rate1, 250e6, 2.5e6, "light flow");
+  NS_TEST_ASSERT_MSG_EQ_TOL (m_rate2, 750e6, 7.5e6, "heavy flow");
+  NS_TEST_ASSERT_MSG_EQ_TOL (queue->getCurrentPrice (), 0.004, 0.0001, "price at the optimum");
+  NS_TEST_ASSERT_MSG_EQ_TOL (m_fluid->GetRate (1), 250e6, 1e3, "oracle on the same flows");
+  Simulator::Destroy ();
+}
+
+class FluidFifoTest : public TestCase
+{
+public:
+  FluidFifoTest ();
+private:
+  virtual void DoRun (void);
+  void Sample (void);
+  void Completed (uint32_t fid);
+  Ptr<FluidSimulator> m_fluid;
+  double m_rate;
+  double m_backlog;
+  std::vector<uint32_t> m_completed;
+  Time m_completedAt;
+};
+
+FluidFifoTest::FluidFifoTest ()
+  : TestCase ("FIFO sharing builds a backlog and finite flows complete"),
+    m_rate (0.0),
+    m_backlog (0.0)
+{
+}
+
+void
+FluidFifoTest::Sample (void)
+{
+  m_rate = m_fluid->GetFluidRate (1);
+  m_backlog = m_fluid->GetBacklog (0);
+}
+
+void
+FluidFifoTest::Completed (uint32_t fid)
+{
+  m_completed.push_back (fid);
+  m_completedAt = Simulator::Now ();
+}
+
+void
+FluidFifoTest::DoRun (void)
+{
+  m_fluid = CreateObject<FluidSimulator> ();
+  m_fluid->SetAttribute ("Sharing", EnumValue (FluidSimulator::FIFO));
+  m_fluid->TraceConnectWithoutContext ("FlowCompleted", MakeCallback (&FluidFifoTest::Completed, this));
+  // no queue, so no price: both flows send at 1Gbps into a 1Gbps link
+  uint32_t link = m_fluid->AddLink (1e9);
+  m_fluid->AddFlow (1, std::vector<uint32_t> (1, link), 1250000, 1.0);
+  m_fluid->AddFlow (2, std::vector<uint32_t> (1, link), 0, 1.0);
+
+  Simulator::Schedule (MilliSeconds (10), &FluidFifoTest::Sample, this);
+  Simulator::Stop (MilliSeconds (30));
+  Simulator::Run ();
+
+  NS_TEST_ASSERT_MSG_EQ_TOL (m_rate, 500e6, 1e3, "half the link each");
+  NS_TEST_ASSERT_MSG_EQ_TOL (m_backlog, 1250000, 2500, "10ms of 1Gbps excess");
+  NS_TEST_ASSERT_MSG_EQ (m_completed.size (), 1, "one flow completes");
+  NS_TEST_ASSERT_MSG_EQ (m_completed[0], 1, "the finite flow");
+  NS_TEST_ASSERT_MSG_EQ_TOL (m_completedAt.GetSeconds (), 0.02, 0.00002, "10Mbit at 500Mbps");
+  NS_TEST_ASSERT_MSG_EQ (m_fluid->GetNFlows (), 1, "completed flow removed");
+  NS_TEST_ASSERT_MSG_EQ_TOL (m_fluid->GetFluidRate (2), 1e9, 1e3, "remaining flow takes the link");
+  Simulator::Destroy ();
+}
+
+class FluidHybridTest : public TestCase
+{
+public:
+  FluidHybridTest ();
+private:
+  virtual void DoRun (void);
+  void SendPacket (void);
+  void Sample (void);
+  Ptr<FluidSimulator> m_fluid;
+  Ptr<PrioQueue> m_queue;
+  Time m_stopPackets;
+  std::vector<double> m_rates;
+  std::vector<double> m_reserved;
+};
+
+FluidHybridTest::FluidHybridTest ()
+  : TestCase ("hybrid fluid flows share a link with packets and reserve their rate")
+{
+}
+
+void
+FluidHybridTest::SendPacket (void)
+{
+  Ptr<Packet> p = Create<Packet> (100);
+  TcpHeader tcp;
+  tcp.SetDestinationPort (5000);
+  p->AddHeader (tcp);
+  // the host stamps the (segment + 46) byte virtual length at 500Mbps
+  double weight = (p->GetSize () + 46) * 8.0 * 1000.0 / 500.0;
+  Ipv4Header ip;
+  ip.SetSource (Ipv4Address ("10.0.0.1"));
+  ip.SetDestination (Ipv4Address ("10.0.0.2"));
+  p->AddHeader (ip);
+  PrioHeader prio;
+  prio.SetData (PriHeader (weight, 0.0, 0.0));
+  p->AddHeader (prio);
+  p->AddHeader (PppHeader ());
+  // one packet is kept waiting, as behind the fluid on a busy link
+  m_queue->Enqueue (p);
+  uint32_t waiting = Simulator::Now () < m_stopPackets ? 1 : 0;
+  while (m_queue->GetNPackets () > waiting)
+    {
+      m_queue->Dequeue ();
+    }
+  if (Simulator::Now () < m_stopPackets)
+    {
+      Simulator::Schedule (MicroSeconds (10), &FluidHybridTest::SendPacket, this);
+    }
+}
+
+void
+FluidHybridTest::Sample (void)
+{
+  m_rates.push_back (m_fluid->GetFluidRate (1));
+  m_reserved.push_back (m_queue->GetFluidRate ());
+}
+
+void
+FluidHybridTest::DoRun (void)
+{
+  ObjectFactory factory;
+  factory.SetTypeId ("ns3::PrioQueue");
+  factory.Set ("DataRate", DataRateValue (DataRate ("1Gbps")));
+  factory.Set ("MaxPackets", UintegerValue (100));
+  m_queue = factory.Create<PrioQueue> ();
+
+  m_fluid = CreateObject<FluidSimulator> ();
+  m_fluid->SetAttribute ("Hybrid", BooleanValue (true));
+  uint32_t link = m_fluid->AddLink (m_queue);
+  // unpriced until 1s, so the fluid flow asks for the whole link
+  m_fluid->AddFlow (1, std::vector<uint32_t> (1, link), 0, 1.0);
+
+  // packets every 10us, off the 20us steps, until 2ms; they count in the
+  // demand for the default 1ms after that
+  m_stopPackets = MilliSeconds (2);
+  Simulator::Schedule (MicroSeconds (5), &FluidHybridTest::SendPacket, this);
+  Simulator::Schedule (MilliSeconds (1), &FluidHybridTest::Sample, this);
+  Simulator::Schedule (MilliSeconds (4), &FluidHybridTest::Sample, this);
+  Simulator::Schedule (MilliSeconds (5), &FluidSimulator::RemoveFlow, m_fluid, 1);
+  Simulator::Schedule (MilliSeconds (6), &FluidHybridTest::Sample, this);
+  Simulator::Stop (MilliSeconds (6) + MicroSeconds (1));
+  Simulator::Run ();
+
+  // 1000 and 500Mbps asked for, shared in proportion
+  double shared = 1000.0 * 1000.0 / 1500.0;
+  NS_TEST_ASSERT_MSG_EQ_TOL (m_rates[0], shared * 1e6, 1e3, "packets take their share");
+  NS_TEST_ASSERT_MSG_EQ_TOL (m_reserved[0], shared * 1e6, 1e3, "fluid rate reserved on the queue");
+  NS_TEST_ASSERT_MSG_EQ_TOL (m_rates[1], 1e9, 1e3, "the whole link once the packets stop");
+  NS_TEST_ASSERT_MSG_EQ_TOL (m_reserved[1], 1e9, 1e3, "whole link reserved");
+  NS_TEST_ASSERT_MSG_EQ (m_reserved[2], 0.0, "reservation released with the last flow");
+  Simulator::Destroy ();
+}
+
+static class FluidSimulatorTestSuite : public TestSuite
+{
+public:
+  FluidSimulatorTestSuite ()
+    : TestSuite ("fluid-simulator", UNIT)
+  {
+    AddTestCase (new FluidNumFabricTest (), TestCase::QUICK);
+    AddTestCase (new FluidFifoTest (), TestCase::QUICK);
+    AddTestCase (new FluidHybridTest (), TestCase::QUICK);
+  }
+} g_fluidSimulatorTestSuite;
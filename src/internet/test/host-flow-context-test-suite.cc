@@ -0,0 +1,155 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+
+#include <cmath>
+#include "ns3/test.h"
+#include "ns3/node.h"
+#include "ns3/ipv4-l3-protocol.h"
+#include "ns3/host-flow-context.h"
+
+using namespace ns3;
+
+class HostFlowContextTest : public TestCase
+{
+public:
+  HostFlowContextTest ();
+private:
+  virtual void DoRun (void);
+  void Measured (uint32_t fid, double rate);
+  uint32_t m_measuredFid;
+  double m_measuredRate;
+};
+
+HostFlowContextTest::HostFlowContextTest ()
+  : TestCase ("a flow context reads and writes the per-flow state of the IP layer"),
+    m_measuredFid (0),
+    m_measuredRate (0.0)
+{
+}
+
+void
+HostFlowContextTest::Measured (uint32_t fid, double rate)
+{
+  m_measuredFid = fid;
+  m_measuredRate = rate;
+}
+
+void
+HostFlowContextTest::DoRun (void)
+{
+  std::string key = "10.0.0.1:10.0.0.2:80";
+  Ptr<Node> node = CreateObject<Node> ();
+  Ptr<Ipv4L3Protocol> ipv4 = CreateObject<Ipv4L3Protocol> ();
+  node->AggregateObject (ipv4);
+  ipv4->setlong_ewma_const (50000);
+  ipv4->setshort_ewma_const (10000);
+  ipv4->setmeasurement_ewma_const (20000);
+  ipv4->TraceConnectWithoutContext ("MeasurementRate", MakeCallback (&HostFlowContextTest::Measured, this));
+
+  Ptr<HostFlowContext> flow = ipv4->GetFlowContext (key);
+  NS_TEST_ASSERT_MSG_EQ (ipv4->GetFlowContext (key), flow, "one context per flow key");
+  NS_TEST_ASSERT_MSG_EQ (flow->GetFlowId (), 0, "flow not registered yet");
+  NS_TEST_ASSERT_MSG_EQ (flow->GetShortTermRate (), -1, "no rate before the first sample");
+
+  ipv4->setFlow (key, 7, 1000.0, 1);
+  NS_TEST_ASSERT_MSG_EQ (flow->GetFlowId (), 7, "registered flow id");
+  NS_TEST_ASSERT_MSG_EQ (ipv4->price_valid[key], false, "price not valid before an ACK");
+  flow->SetPriceValid ();
+  flow->SetNumHops (3);
+  NS_TEST_ASSERT_MSG_EQ (ipv4->price_valid[key], true, "price valid in the IP layer");
+  NS_TEST_ASSERT_MSG_EQ (ipv4->num_hops[key], 3, "hops in the IP layer");
+
+  // 1250 bytes in 1us is 10000Mbps, then 625 bytes in 1us
+  flow->UpdateAverages (1000, 1250);
+  NS_TEST_ASSERT_MSG_EQ_TOL (flow->GetShortTermRate (), 10000.0, 1e-9, "first sample sets the rate");
+  NS_TEST_ASSERT_MSG_EQ (m_measuredFid, 7, "measurement traced with the flow id");
+  ipv4->updateAverages (key, 1000, 625);
+  double e = std::exp (-1000.0 / 10000.0);
+  double expected = (1.0 - e) * 5000.0 + e * 10000.0;
+  NS_TEST_ASSERT_MSG_EQ_TOL (flow->GetShortTermRate (), expected, 1e-9, "string keyed update seen by the context");
+  NS_TEST_ASSERT_MSG_EQ_TOL (ipv4->GetShortTermRate (key), expected, 1e-9, "context update seen by the string keyed read");
+  e = std::exp (-1000.0 / 20000.0);
+  NS_TEST_ASSERT_MSG_EQ_TOL (m_measuredRate, (1.0 - e) * 5000.0 + e * 10000.0, 1e-9, "measurement rate traced");
+
+  ipv4->removeFlow (7);
+  NS_TEST_ASSERT_MSG_EQ (flow->GetFlowId (), 0, "removed flow unbound");
+  ipv4->setFlow (key, 9, 1000.0, 1);
+  NS_TEST_ASSERT_MSG_EQ (flow->GetFlowId (), 9, "flow id of the restarted flow");
+
+  node->Dispose ();
+}
+
+class SubflowGroupTest : public TestCase
+{
+public:
+  SubflowGroupTest ();
+private:
+  virtual void DoRun (void);
+};
+
+SubflowGroupTest::SubflowGroupTest ()
+  : TestCase ("subflow groups keep the summed short term rate of their registered flows")
+{
+}
+
+void
+SubflowGroupTest::DoRun (void)
+{
+  std::string a = "10.0.0.1:10.0.0.2:80";
+  std::string b = "10.0.1.1:10.0.0.2:80";
+  std::string c = "10.0.0.1:10.0.0.3:80";
+  Ptr<Node> node = CreateObject<Node> ();
+  Ptr<Ipv4L3Protocol> ipv4 = CreateObject<Ipv4L3Protocol> ();
+  node->AggregateObject (ipv4);
+  ipv4->setMPTCP (true);
+
+  ipv4->updateAverages (c, 1000, 125);
+  NS_TEST_ASSERT_MSG_EQ (ipv4->GetSubflowGroup (0)->GetSize (), 0, "unregistered flows are not counted");
+  ipv4->setFlow (a, 1, 1000.0, 1);
+  ipv4->setFlow (b, 2, 1000.0, 1);
+  ipv4->setFlow (c, 3, 1000.0, 1);
+  Ptr<SubflowGroup> host = ipv4->GetSubflowGroup (0);
+  NS_TEST_ASSERT_MSG_EQ (host->GetSize (), 3, "flows join group 0 by default");
+  // a and b have no sample yet and count -1 each, as GetRate reads them
+  NS_TEST_ASSERT_MSG_EQ_TOL (host->GetAggregateRate (), 1000.0 - 2.0, 1e-9, "unsampled flows");
+
+  ipv4->updateAverages (a, 1000, 1250);
+  ipv4->updateAverages (b, 1000, 625);
+  ipv4->updateAverages (a, 1000, 625);
+  double sum = ipv4->GetRate (a, Ipv4L3Protocol::SHORTER) + ipv4->GetRate (b, Ipv4L3Protocol::SHORTER)
+    + ipv4->GetRate (c, Ipv4L3Protocol::SHORTER);
+  NS_TEST_ASSERT_MSG_EQ_TOL (host->GetAggregateRate (), sum, 1e-9, "sum follows the updates");
+  NS_TEST_ASSERT_MSG_EQ_TOL (ipv4->GetSubflowRate (*ipv4->GetFlowContext (a)), sum, 1e-9, "rate read by a subflow");
+
+  // a and b are the subflows of one connection, c is another connection
+  ipv4->SetSubflowGroup (a, 1);
+  ipv4->SetSubflowGroup (b, 1);
+  NS_TEST_ASSERT_MSG_EQ (ipv4->GetFlowContext (a)->GetSubflowGroup (), ipv4->GetSubflowGroup (1), "moved to its connection");
+  NS_TEST_ASSERT_MSG_EQ_TOL (host->GetAggregateRate (), ipv4->GetRate (c, Ipv4L3Protocol::SHORTER), 1e-9, "left group 0");
+  NS_TEST_ASSERT_MSG_EQ_TOL (ipv4->GetSubflowGroup (1)->GetAggregateRate (),
+                             sum - ipv4->GetRate (c, Ipv4L3Protocol::SHORTER), 1e-9, "joined group 1");
+
+  ipv4->removeFlow (2);
+  NS_TEST_ASSERT_MSG_EQ (ipv4->GetSubflowGroup (1)->GetSize (), 1, "removed flows leave their group");
+  NS_TEST_ASSERT_MSG_EQ_TOL (ipv4->GetSubflowGroup (1)->GetAggregateRate (),
+                             ipv4->GetRate (a, Ipv4L3Protocol::SHORTER), 1e-9, "sum without the removed flow");
+
+  for (uint32_t i = 0; i < 3000; i++)
+    {
+      ipv4->updateAverages (a, 1000, 100 + i % 1400);
+    }
+  NS_TEST_ASSERT_MSG_EQ_TOL (ipv4->GetSubflowGroup (1)->GetAggregateRate (),
+                             ipv4->GetRate (a, Ipv4L3Protocol::SHORTER), 1e-9, "no drift over many updates");
+
+  node->Dispose ();
+}
+
+static class HostFlowContextTestSuite : public TestSuite
+{
+public:
+  HostFlowContextTestSuite ()
+    : TestSuite ("host-flow-context", UNIT)
+  {
+    AddTestCase (new HostFlowContextTest (), TestCase::QUICK);
+    AddTestCase (new SubflowGroupTest (), TestCase::QUICK);
+  }
+} g_hostFlowContextTestSuite;
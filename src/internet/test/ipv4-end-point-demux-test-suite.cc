@@ -0,0 +1,84 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+
+#include "ns3/test.h"
+#include "../src/internet/model/ipv4-end-point-demux.h"
+#include "../src/internet/model/ipv4-end-point.h"
+#include "ns3/ipv4-interface.h"
+
+using namespace ns3;
+
+class Ipv4EndPointDemuxPrecedenceTest : public TestCase
+{
+public:
+  Ipv4EndPointDemuxPrecedenceTest ();
+private:
+  virtual void DoRun (void);
+};
+
+Ipv4EndPointDemuxPrecedenceTest::Ipv4EndPointDemuxPrecedenceTest ()
+  : TestCase ("Most exact match wins, including after the peer changes")
+{
+}
+
+void
+Ipv4EndPointDemuxPrecedenceTest::DoRun (void)
+{
+  Ipv4EndPointDemux demux;
+  Ptr<Ipv4Interface> interface = CreateObject<Ipv4Interface> ();
+  Ipv4Address local ("10.0.0.1");
+  Ipv4Address peer ("10.0.0.2");
+  Ipv4Address other ("10.0.0.3");
+
+  Ipv4EndPoint *listen = demux.Allocate (80);
+  Ipv4EndPoint *bound = demux.Allocate (local, 80);
+  Ipv4EndPoint *connected = demux.Allocate (local, 80, peer, 1000);
+
+  NS_TEST_ASSERT_MSG_EQ (demux.Allocate (local, 80), 0, "duplicate local endpoint allocated");
+  NS_TEST_ASSERT_MSG_EQ (demux.Allocate (local, 80, peer, 1000), 0, "duplicate four-tuple allocated");
+  NS_TEST_ASSERT_MSG_EQ (demux.LookupPortLocal (80), true, "port 80 in use");
+  NS_TEST_ASSERT_MSG_EQ (demux.LookupPortLocal (81), false, "port 81 not in use");
+  NS_TEST_ASSERT_MSG_EQ (demux.LookupLocal (local, 80), true, "bound endpoint not found");
+
+  Ipv4EndPointDemux::EndPoints found = demux.Lookup (local, 80, peer, 1000, interface);
+  NS_TEST_ASSERT_MSG_EQ (found.size (), 1, "exact match");
+  NS_TEST_ASSERT_MSG_EQ (found.front (), connected, "exact match");
+  NS_TEST_ASSERT_MSG_EQ (demux.SimpleLookup (local, 80, peer, 1000), connected, "exact match");
+
+  // another peer falls back to the endpoint bound to the local address
+  found = demux.Lookup (local, 80, other, 2000, interface);
+  NS_TEST_ASSERT_MSG_EQ (found.size (), 1, "local address match");
+  NS_TEST_ASSERT_MSG_EQ (found.front (), bound, "local address match");
+
+  // and another local address to the wildcard listener
+  found = demux.Lookup (Ipv4Address ("10.0.1.1"), 80, other, 2000, interface);
+  NS_TEST_ASSERT_MSG_EQ (found.size (), 1, "local port match");
+  NS_TEST_ASSERT_MSG_EQ (found.front (), listen, "local port match");
+
+  // an endpoint connected after allocation is found by its new four-tuple
+  Ipv4EndPoint *client = demux.Allocate (local, 5000);
+  client->SetPeer (other, 2000);
+  found = demux.Lookup (local, 5000, other, 2000, interface);
+  NS_TEST_ASSERT_MSG_EQ (found.size (), 1, "re-keyed endpoint");
+  NS_TEST_ASSERT_MSG_EQ (found.front (), client, "re-keyed endpoint");
+  NS_TEST_ASSERT_MSG_EQ (demux.Allocate (local, 5000, other, 2000), 0, "re-keyed four-tuple allocated twice");
+
+  demux.DeAllocate (connected);
+  found = demux.Lookup (local, 80, peer, 1000, interface);
+  NS_TEST_ASSERT_MSG_EQ (found.front (), bound, "deallocated endpoint still found");
+  NS_TEST_ASSERT_MSG_EQ (demux.GetAllEndPoints ().size (), 3, "endpoint count");
+
+  demux.DeAllocate (listen);
+  demux.DeAllocate (bound);
+  NS_TEST_ASSERT_MSG_EQ (demux.LookupPortLocal (80), false, "port 80 released");
+  NS_TEST_ASSERT_MSG_EQ (demux.Lookup (local, 80, peer, 1000, interface).empty (), true, "no endpoint left");
+}
+
+static class Ipv4EndPointDemuxTestSuite : public TestSuite
+{
+public:
+  Ipv4EndPointDemuxTestSuite ()
+    : TestSuite ("ipv4-end-point-demux", UNIT)
+  {
+    AddTestCase (new Ipv4EndPointDemuxPrecedenceTest (), TestCase::QUICK);
+  }
+} g_ipv4EndPointDemuxTestSuite;
@@ -0,0 +1,133 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+
+#include "ns3/test.h"
+#include "ns3/simple-net-device.h"
+#include "ns3/simple-channel.h"
+#include "ns3/node-container.h"
+#include "ns3/internet-stack-helper.h"
+#include "ns3/ipv4-address-generator.h"
+#include "ns3/ipv4-global-routing.h"
+#include "ns3/ipv4-routing-table-entry.h"
+#include "ns3/ipv4-fabric-address-helper.h"
+
+using namespace ns3;
+
+class Ipv4FabricAddressLayoutTest : public TestCase
+{
+public:
+  Ipv4FabricAddressLayoutTest ();
+private:
+  virtual void DoRun (void);
+  NetDeviceContainer Link (NodeContainer &nodes);
+};
+
+Ipv4FabricAddressLayoutTest::Ipv4FabricAddressLayoutTest ()
+  : TestCase ("Host links are numbered pod | leaf | host, fabric links in the upper half")
+{
+}
+
+NetDeviceContainer
+Ipv4FabricAddressLayoutTest::Link (NodeContainer &nodes)
+{
+  Ptr<SimpleChannel> channel = CreateObject<SimpleChannel> ();
+  NetDeviceContainer devices;
+  for (uint32_t i = 0; i < 2; i++)
+    {
+      Ptr<SimpleNetDevice> device = CreateObject<SimpleNetDevice> ();
+      device->SetAddress (Mac48Address::Allocate ());
+      device->SetChannel (channel);
+      nodes.Get (i)->AddDevice (device);
+      devices.Add (device);
+    }
+  return devices;
+}
+
+void
+Ipv4FabricAddressLayoutTest::DoRun (void)
+{
+  NodeContainer nodes;
+  nodes.Create (2);
+  InternetStackHelper internet;
+  internet.Install (nodes);
+
+  // 2 pods of 3 leaves of 5 hosts: 3 host bits, 2 leaf bits, 1 pod bit
+  Ipv4FabricAddressHelper address;
+  address.SetTopology (2, 3, 5);
+  NS_TEST_ASSERT_MSG_EQ (address.GetLeafMask (), Ipv4Mask ("/27"), "leaf mask");
+  NS_TEST_ASSERT_MSG_EQ (address.GetPodMask (), Ipv4Mask ("/25"), "pod mask");
+  NS_TEST_ASSERT_MSG_EQ (address.GetLeafNetwork (1, 2), Ipv4Address ("10.0.0.192"), "leaf prefix");
+
+  Ipv4InterfaceContainer host = address.AssignHostLink (Link (nodes), 1, 2, 4);
+  NS_TEST_ASSERT_MSG_EQ (host.GetAddress (0), Ipv4Address ("10.0.0.209"), "host link address");
+  NS_TEST_ASSERT_MSG_EQ (host.GetAddress (1), Ipv4Address ("10.0.0.210"), "host link address");
+
+  address.AssignFabricLink (Link (nodes));
+  Ipv4InterfaceContainer fabric = address.AssignFabricLink (Link (nodes));
+  NS_TEST_ASSERT_MSG_EQ (fabric.GetAddress (0), Ipv4Address ("10.128.0.5"), "fabric link address");
+
+  Ipv4AddressGenerator::Reset ();
+}
+
+class Ipv4RouteAggregationTest : public TestCase
+{
+public:
+  Ipv4RouteAggregationTest ();
+private:
+  virtual void DoRun (void);
+};
+
+Ipv4RouteAggregationTest::Ipv4RouteAggregationTest ()
+  : TestCase ("Only networks with the same ordered next hops are folded")
+{
+}
+
+void
+Ipv4RouteAggregationTest::DoRun (void)
+{
+  Ptr<Ipv4GlobalRouting> routing = CreateObject<Ipv4GlobalRouting> ();
+  Ipv4Mask link ("/30");
+  Ipv4Address spine1 ("10.128.0.2");
+  Ipv4Address spine2 ("10.128.0.6");
+
+  // the hosts of one leaf, reached over both spines
+  routing->AddNetworkRouteTo ("10.0.0.192", link, spine1, 1);
+  routing->AddNetworkRouteTo ("10.0.0.192", link, spine2, 2);
+  routing->AddNetworkRouteTo ("10.0.0.196", link, spine1, 1);
+  routing->AddNetworkRouteTo ("10.0.0.196", link, spine2, 2);
+  // another leaf with a failed uplink for one of its hosts
+  routing->AddNetworkRouteTo ("10.0.0.160", link, spine1, 1);
+  routing->AddNetworkRouteTo ("10.0.0.164", link, spine1, 1);
+  routing->AddNetworkRouteTo ("10.0.0.164", link, spine2, 2);
+  routing->AddNetworkRouteTo ("10.128.0.8", link, spine1, 1);
+
+  NS_TEST_ASSERT_MSG_EQ (routing->AggregateNetworkRoutes ("/27"), 2, "routes removed");
+  NS_TEST_ASSERT_MSG_EQ (routing->GetNRoutes (), 6, "routes left");
+  // the aggregate keeps the position and next hop order of the first network
+  for (uint32_t i = 0; i < 2; i++)
+    {
+      Ipv4RoutingTableEntry *route = routing->GetRoute (i);
+      NS_TEST_ASSERT_MSG_EQ (route->GetDestNetwork (), Ipv4Address ("10.0.0.192"), "aggregate prefix");
+      NS_TEST_ASSERT_MSG_EQ (route->GetDestNetworkMask (), Ipv4Mask ("/27"), "aggregate mask");
+      NS_TEST_ASSERT_MSG_EQ (route->GetInterface (), i + 1, "aggregate interface");
+      NS_TEST_ASSERT_MSG_EQ (route->GetGateway (), (i == 0 ? spine1 : spine2), "aggregate next hop");
+    }
+  NS_TEST_ASSERT_MSG_EQ (routing->GetRoute (2)->GetDestNetwork (), Ipv4Address ("10.0.0.160"), "mixed next hops folded");
+
+  // a shorter route over the group keeps it apart
+  routing->AddNetworkRouteTo ("10.0.0.0", Ipv4Mask ("/24"), spine2, 2);
+  routing->AddNetworkRouteTo ("10.0.0.0", link, spine1, 1);
+  routing->AddNetworkRouteTo ("10.0.0.4", link, spine1, 1);
+  NS_TEST_ASSERT_MSG_EQ (routing->AggregateNetworkRoutes ("/27"), 0, "covered group folded");
+  routing->Dispose ();
+}
+
+static class Ipv4FabricAddressHelperTestSuite : public TestSuite
+{
+public:
+  Ipv4FabricAddressHelperTestSuite ()
+    : TestSuite ("ipv4-fabric-address-helper", UNIT)
+  {
+    AddTestCase (new Ipv4FabricAddressLayoutTest (), TestCase::QUICK);
+    AddTestCase (new Ipv4RouteAggregationTest (), TestCase::QUICK);
+  }
+} g_ipv4FabricAddressHelperTestSuite;
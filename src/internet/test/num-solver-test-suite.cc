@@ -0,0 +1,120 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+
+#include <cmath>
+#include <vector>
+#include "ns3/test.h"
+#include "ns3/double.h"
+#include "ns3/uinteger.h"
+#include "ns3/num-solver.h"
+
+using namespace ns3;
+
+// Parking lot: flow 0 crosses both links, flows 1 and 2 one link each
+static void
+BuildParkingLot (Ptr<NumSolver> solver)
+{
+  uint32_t a = solver->AddLink (10e6);
+  uint32_t b = solver->AddLink (10e6);
+  std::vector<uint32_t> path;
+  path.push_back (a);
+  path.push_back (b);
+  solver->AddFlow (0, path, 0, 1.0);
+  solver->AddFlow (1, std::vector<uint32_t> (1, a), 0, 1.0);
+  solver->AddFlow (2, std::vector<uint32_t> (1, b), 0, 1.0);
+}
+
+class NumSolverProportionalTest : public TestCase
+{
+public:
+  NumSolverProportionalTest ();
+private:
+  virtual void DoRun (void);
+};
+
+NumSolverProportionalTest::NumSolverProportionalTest ()
+  : TestCase ("Proportionally fair rates on a parking lot")
+{
+}
+
+void
+NumSolverProportionalTest::DoRun (void)
+{
+  Ptr<NumSolver> solver = CreateObject<NumSolver> ();
+  BuildParkingLot (solver);
+  NS_TEST_ASSERT_MSG_EQ_TOL (solver->GetRate (0), 10e6 / 3, 1e3, "long flow");
+  NS_TEST_ASSERT_MSG_EQ_TOL (solver->GetRate (1), 20e6 / 3, 1e3, "short flow");
+  NS_TEST_ASSERT_MSG_EQ_TOL (solver->GetRate (2), 20e6 / 3, 1e3, "short flow");
+}
+
+class NumSolverAlphaFairTest : public TestCase
+{
+public:
+  NumSolverAlphaFairTest ();
+private:
+  virtual void DoRun (void);
+};
+
+NumSolverAlphaFairTest::NumSolverAlphaFairTest ()
+  : TestCase ("Alpha-fair rates on a parking lot")
+{
+}
+
+void
+NumSolverAlphaFairTest::DoRun (void)
+{
+  Ptr<NumSolver> solver = CreateObject<NumSolver> ();
+  solver->SetAttribute ("UtilFunction", UintegerValue (3));
+  solver->SetAttribute ("fct_alpha", DoubleValue (2.0));
+  BuildParkingLot (solver);
+  // both links carry the same price p, x = q^(-1/2)
+  double shortRate = 10e6 / (1 + 1 / std::sqrt (2.0));
+  NS_TEST_ASSERT_MSG_EQ_TOL (solver->GetRate (1), shortRate, 1e3, "short flow");
+  NS_TEST_ASSERT_MSG_EQ_TOL (solver->GetRate (0), 10e6 - shortRate, 1e3, "long flow");
+}
+
+class NumSolverWarmStartTest : public TestCase
+{
+public:
+  NumSolverWarmStartTest ();
+private:
+  virtual void DoRun (void);
+};
+
+NumSolverWarmStartTest::NumSolverWarmStartTest ()
+  : TestCase ("Weighted rates across flow arrivals and departures")
+{
+}
+
+void
+NumSolverWarmStartTest::DoRun (void)
+{
+  Ptr<NumSolver> solver = CreateObject<NumSolver> ();
+  uint32_t l = solver->AddLink (8e6);
+  std::vector<uint32_t> path (1, l);
+  solver->AddFlow (1, path, 0, 1.0);
+  solver->AddFlow (2, path, 0, 3.0);
+  NS_TEST_ASSERT_MSG_EQ_TOL (solver->GetRate (1), 2e6, 1e3, "weight 1");
+  NS_TEST_ASSERT_MSG_EQ_TOL (solver->GetRate (2), 6e6, 1e3, "weight 3");
+
+  solver->RemoveFlow (2);
+  NS_TEST_ASSERT_MSG_EQ (solver->HasFlow (2), false, "flow not removed");
+  NS_TEST_ASSERT_MSG_EQ_TOL (solver->GetRate (1), 8e6, 1e3, "alone on the link");
+  NS_TEST_ASSERT_MSG_EQ (solver->GetRate (2), 0, "removed flow has a rate");
+
+  solver->AddFlow (2, path, 0, 3.0);
+  NS_TEST_ASSERT_MSG_EQ_TOL (solver->GetRate (2), 6e6, 1e3, "weight 3 after restart");
+  // the price of the link is kept, only a couple of sweeps are needed
+  NS_TEST_ASSERT_MSG_LT (solver->GetLastIterations (), 5, "re-solve not warm-started");
+}
+
+static class NumSolverTestSuite : public TestSuite
+{
+public:
+  NumSolverTestSuite ()
+    : TestSuite ("num-solver", UNIT)
+  {
+    AddTestCase (new NumSolverProportionalTest (), TestCase::QUICK);
+    AddTestCase (new NumSolverAlphaFairTest (), TestCase::QUICK);
+    AddTestCase (new NumSolverWarmStartTest (), TestCase::QUICK);
+  }
+} g_numSolverTestSuite;
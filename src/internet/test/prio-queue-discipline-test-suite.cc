@@ -0,0 +1,205 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+
+#include "ns3/test.h"
+#include "ns3/simulator.h"
+#include "ns3/boolean.h"
+#include "ns3/uinteger.h"
+#include "ns3/object-factory.h"
+#include "ns3/ipv4-header.h"
+#include "ns3/ppp-header.h"
+#include "ns3/prio-header.h"
+#include "ns3/tcp-header.h"
+#include "ns3/prio-queue.h"
+
+using namespace ns3;
+
+static Ptr<Packet>
+MakeFlowPacket (uint16_t port, double wfqWeight)
+{
+  Ptr<Packet> p = Create<Packet> (100);
+  TcpHeader tcp;
+  tcp.SetDestinationPort (port);
+  p->AddHeader (tcp);
+  Ipv4Header ip;
+  ip.SetSource (Ipv4Address ("10.0.0.1"));
+  ip.SetDestination (Ipv4Address ("10.0.0.2"));
+  p->AddHeader (ip);
+  PrioHeader prio;
+  prio.SetData (PriHeader (wfqWeight, 0.0, 0.0));
+  p->AddHeader (prio);
+  p->AddHeader (PppHeader ());
+  return p;
+}
+
+static Ptr<PrioQueue>
+MakeQueue (std::string type)
+{
+  ObjectFactory factory;
+  factory.SetTypeId (type);
+  factory.Set ("MaxPackets", UintegerValue (100));
+  return factory.Create<PrioQueue> ();
+}
+
+class PrioQueueDisciplineRegisteredTest : public TestCase
+{
+public:
+  PrioQueueDisciplineRegisteredTest ();
+private:
+  virtual void DoRun (void);
+};
+
+PrioQueueDisciplineRegisteredTest::PrioQueueDisciplineRegisteredTest ()
+  : TestCase ("every compiled discipline is a PrioQueue")
+{
+}
+
+void
+PrioQueueDisciplineRegisteredTest::DoRun (void)
+{
+  const char *prices[] = { "NumFabric", "Dgd", "Rcp" };
+  const char *orders[] = { "Fifo", "TagWfq", "PFabric" };
+  const char *marks[] = { "No", "Ecn" };
+  for (uint32_t i = 0; i < 3; i++)
+    {
+      for (uint32_t j = 0; j < 3; j++)
+        {
+          for (uint32_t k = 0; k < 2; k++)
+            {
+              std::string name = std::string ("ns3::PrioQueue<") + prices[i] + "," + orders[j] + "," + marks[k] + ">";
+              TypeId tid;
+              NS_TEST_ASSERT_MSG_EQ (TypeId::LookupByNameFailSafe (name, &tid), true, name << " registered");
+              NS_TEST_ASSERT_MSG_EQ ((MakeQueue (name) != 0), true, name << " creates a PrioQueue");
+            }
+        }
+    }
+  Simulator::Destroy ();
+}
+
+class PrioQueueDisciplineOrderTest : public TestCase
+{
+public:
+  PrioQueueDisciplineOrderTest ();
+private:
+  virtual void DoRun (void);
+  /* enqueue the packets, then return the uids in dequeue order */
+  std::vector<uint32_t> Drain (Ptr<PrioQueue> q, const std::vector<Ptr<Packet> > &packets);
+};
+
+PrioQueueDisciplineOrderTest::PrioQueueDisciplineOrderTest ()
+  : TestCase ("compiled disciplines dequeue like the attribute driven PrioQueue")
+{
+}
+
+std::vector<uint32_t>
+PrioQueueDisciplineOrderTest::Drain (Ptr<PrioQueue> q, const std::vector<Ptr<Packet> > &packets)
+{
+  std::vector<uint32_t> uids;
+  for (uint32_t i = 0; i < packets.size (); i++)
+    {
+      q->Enqueue (packets[i]->Copy ());
+    }
+  Ptr<Packet> p;
+  while ((p = q->Dequeue ()) != 0)
+    {
+      uids.push_back (p->GetUid ());
+    }
+  return uids;
+}
+
+void
+PrioQueueDisciplineOrderTest::DoRun (void)
+{
+  // flow 1 weighs ten times flow 2
+  std::vector<Ptr<Packet> > packets;
+  for (uint32_t i = 0; i < 3; i++)
+    {
+      packets.push_back (MakeFlowPacket (1, 10.0 + i));
+    }
+  for (uint32_t i = 0; i < 3; i++)
+    {
+      packets.push_back (MakeFlowPacket (2, 1.0));
+    }
+
+  Ptr<PrioQueue> runtime = MakeQueue ("ns3::PrioQueue");
+  std::vector<uint32_t> wfq = Drain (MakeQueue ("ns3::PrioQueue<NumFabric,TagWfq,No>"), packets);
+  NS_TEST_ASSERT_MSG_EQ (wfq.size (), 6, "every packet dequeued");
+  NS_TEST_ASSERT_MSG_EQ ((wfq == Drain (runtime, packets)), true, "tag order matches");
+  NS_TEST_ASSERT_MSG_EQ (wfq[1], packets[3]->GetUid (), "light flow overtakes");
+  NS_TEST_ASSERT_MSG_EQ (wfq[5], packets[2]->GetUid (), "heavy flow last");
+
+  runtime = MakeQueue ("ns3::PrioQueue");
+  runtime->SetAttribute ("m_pfabricdequeue", BooleanValue (true));
+  std::vector<uint32_t> pfabric = Drain (MakeQueue ("ns3::PrioQueue<Dgd,PFabric,No>"), packets);
+  NS_TEST_ASSERT_MSG_EQ ((pfabric == Drain (runtime, packets)), true, "pFabric order matches");
+  NS_TEST_ASSERT_MSG_EQ (pfabric[0], packets[3]->GetUid (), "lowest weight first");
+  NS_TEST_ASSERT_MSG_EQ (pfabric[5], packets[2]->GetUid (), "highest weight last");
+
+  runtime = MakeQueue ("ns3::PrioQueue");
+  runtime->SetAttribute ("m_pkt_tag", BooleanValue (false));
+  std::vector<uint32_t> fifo = Drain (MakeQueue ("ns3::PrioQueue<Rcp,Fifo,No>"), packets);
+  NS_TEST_ASSERT_MSG_EQ ((fifo == Drain (runtime, packets)), true, "fifo order matches");
+  NS_TEST_ASSERT_MSG_EQ (fifo[0], packets[0]->GetUid (), "arrival order");
+
+  Simulator::Destroy ();
+}
+
+class PrioQueuePurgeFlowTest : public TestCase
+{
+public:
+  PrioQueuePurgeFlowTest ();
+private:
+  virtual void DoRun (void);
+};
+
+PrioQueuePurgeFlowTest::PrioQueuePurgeFlowTest ()
+  : TestCase ("a stopped flow leaves the queues that carried it and is dropped everywhere")
+{
+}
+
+void
+PrioQueuePurgeFlowTest::DoRun (void)
+{
+  Ptr<PrioQueue> shared = MakeQueue ("ns3::PrioQueue");
+  Ptr<PrioQueue> own = MakeQueue ("ns3::PrioQueue");
+  Ptr<PrioQueue> other = MakeQueue ("ns3::PrioQueue");
+  std::vector<uint32_t> kept;
+  for (uint32_t i = 0; i < 3; i++)
+    {
+      shared->Enqueue (MakeFlowPacket (1, 1.0));
+      Ptr<Packet> p = MakeFlowPacket (2, 1.0);
+      kept.push_back (p->GetUid ());
+      shared->Enqueue (p);
+      own->Enqueue (MakeFlowPacket (1, 1.0));
+    }
+  other->Enqueue (MakeFlowPacket (2, 1.0));
+  NS_TEST_ASSERT_MSG_EQ (shared->GetCurCount (), 6, "both flows queued");
+
+  PrioQueue::PurgeFlow ("10.0.0.1:10.0.0.2:1");
+  NS_TEST_ASSERT_MSG_EQ (shared->GetCurCount (), 3, "only the stopped flow purged");
+  NS_TEST_ASSERT_MSG_EQ (shared->GetCurSize (), 3 * MakeFlowPacket (2, 1.0)->GetSize (), "bytes of the purged packets");
+  NS_TEST_ASSERT_MSG_EQ (own->GetCurCount (), 0, "flow purged from every queue it crossed");
+  NS_TEST_ASSERT_MSG_EQ (other->GetCurCount (), 1, "queue without the flow untouched");
+  NS_TEST_ASSERT_MSG_EQ (other->Enqueue (MakeFlowPacket (1, 1.0)), false, "stopped flow dropped at any queue");
+
+  for (uint32_t i = 0; i < kept.size (); i++)
+    {
+      Ptr<Packet> p = shared->Dequeue ();
+      NS_TEST_ASSERT_MSG_EQ ((p != 0), true, "remaining packet dequeued");
+      NS_TEST_ASSERT_MSG_EQ (p->GetUid (), kept[i], "remaining packets in order");
+    }
+  NS_TEST_ASSERT_MSG_EQ ((shared->Dequeue () == 0), true, "queue drained");
+
+  Simulator::Destroy ();
+}
+
+static class PrioQueueDisciplineTestSuite : public TestSuite
+{
+public:
+  PrioQueueDisciplineTestSuite ()
+    : TestSuite ("prio-queue-discipline", UNIT)
+  {
+    AddTestCase (new PrioQueueDisciplineRegisteredTest (), TestCase::QUICK);
+    AddTestCase (new PrioQueueDisciplineOrderTest (), TestCase::QUICK);
+    AddTestCase (new PrioQueuePurgeFlowTest (), TestCase::QUICK);
+  }
+} g_prioQueueDisciplineTestSuite;
@@ -0,0 +1,186 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+
+#include <cmath>
+#include "ns3/test.h"
+#include "ns3/simulator.h"
+#include "ns3/boolean.h"
+#include "ns3/uinteger.h"
+#include "ns3/object-factory.h"
+#include "ns3/ipv4-header.h"
+#include "ns3/ppp-header.h"
+#include "ns3/prio-header.h"
+#include "ns3/tcp-header.h"
+#include "ns3/prio-queue.h"
+#include "ns3/queue-histograms.h"
+
+using namespace ns3;
+
+class LogLinearHistogramTest : public TestCase
+{
+public:
+  LogLinearHistogramTest ();
+private:
+  virtual void DoRun (void);
+};
+
+LogLinearHistogramTest::LogLinearHistogramTest ()
+  : TestCase ("log-linear buckets tile the range and bound the quantile error")
+{
+}
+
+void
+LogLinearHistogramTest::DoRun (void)
+{
+  LogLinearHistogram h (4);
+  for (uint32_t i = 0; i + 1 < h.GetNBuckets (); i++)
+    {
+      NS_TEST_ASSERT_MSG_EQ (h.GetBucketHigh (i) + 1, h.GetBucketLow (i + 1), "bucket " << i << " adjoins the next");
+    }
+  NS_TEST_ASSERT_MSG_EQ (h.GetBucketHigh (h.GetNBuckets () - 1), ~0ULL, "the last bucket ends at 2^64 - 1");
+
+  uint64_t values[] = { 0, 15, 16, 17, 1000, 123456789, 1ULL << 40, (1ULL << 63) + 12345, ~0ULL };
+  for (uint32_t v = 0; v < sizeof (values) / sizeof (values[0]); v++)
+    {
+      h.Reset ();
+      h.Record (values[v]);
+      for (uint32_t i = 0; i < h.GetNBuckets (); i++)
+        {
+          if (h.GetBucketCount (i) > 0)
+            {
+              NS_TEST_ASSERT_MSG_EQ ((h.GetBucketLow (i) <= values[v] && values[v] <= h.GetBucketHigh (i)), true,
+                                     values[v] << " counted in its bucket");
+            }
+        }
+    }
+
+  // exact below 2^4
+  h.Reset ();
+  for (uint64_t v = 0; v < 16; v++)
+    {
+      h.Record (v);
+    }
+  NS_TEST_ASSERT_MSG_EQ (h.GetQuantile (0.5), 7, "median of 0..15");
+  NS_TEST_ASSERT_MSG_EQ (h.GetMax (), 15, "maximum");
+
+  LogLinearHistogram other (4);
+  for (uint64_t v = 1; v <= 100000; v++)
+    {
+      other.Record (v);
+    }
+  NS_TEST_ASSERT_MSG_EQ_TOL (other.GetQuantile (0.5), 50000, 50000 / 16.0, "median within a bucket");
+  NS_TEST_ASSERT_MSG_EQ_TOL (other.GetQuantile (0.99), 99000, 99000 / 16.0, "p99 within a bucket");
+  NS_TEST_ASSERT_MSG_EQ_TOL (other.GetMean (), 50000.5, 1e-6, "mean is exact");
+
+  h.Merge (other);
+  NS_TEST_ASSERT_MSG_EQ (h.GetCount (), 100016, "merged count");
+  NS_TEST_ASSERT_MSG_EQ (h.GetMin (), 0, "merged minimum");
+  NS_TEST_ASSERT_MSG_EQ (h.GetMax (), 100000, "merged maximum");
+}
+
+static Ptr<Packet>
+MakeHistogramPacket (uint32_t payload)
+{
+  Ptr<Packet> p = Create<Packet> (payload);
+  TcpHeader tcp;
+  tcp.SetDestinationPort (1);
+  p->AddHeader (tcp);
+  Ipv4Header ip;
+  ip.SetSource (Ipv4Address ("10.0.0.1"));
+  ip.SetDestination (Ipv4Address ("10.0.0.2"));
+  p->AddHeader (ip);
+  PrioHeader prio;
+  prio.SetData (PriHeader (1.0, 0.0, 0.0));
+  p->AddHeader (prio);
+  p->AddHeader (PppHeader ());
+  return p;
+}
+
+class PrioQueueHistogramTest : public TestCase
+{
+public:
+  PrioQueueHistogramTest ();
+private:
+  virtual void DoRun (void);
+  void Drain (void);
+  void Dumped (std::string link, const QueueHistograms &histograms);
+  Ptr<PrioQueue> m_queue;
+  std::string m_link;
+  uint64_t m_sojourns;
+  uint64_t m_sojournP99;
+};
+
+PrioQueueHistogramTest::PrioQueueHistogramTest ()
+  : TestCase ("PrioQueue histograms the sojourn time and occupancy of data and control packets"),
+    m_sojourns (0),
+    m_sojournP99 (0)
+{
+}
+
+void
+PrioQueueHistogramTest::Drain (void)
+{
+  while (m_queue->Dequeue () != 0)
+    {
+    }
+}
+
+void
+PrioQueueHistogramTest::Dumped (std::string link, const QueueHistograms &histograms)
+{
+  m_link = link;
+  m_sojourns = histograms.m_sojournData.GetCount () + histograms.m_sojournControl.GetCount ();
+  m_sojournP99 = histograms.m_sojournData.GetQuantile (0.99);
+}
+
+void
+PrioQueueHistogramTest::DoRun (void)
+{
+  ObjectFactory factory;
+  factory.SetTypeId ("ns3::PrioQueue");
+  factory.Set ("MaxPackets", UintegerValue (100));
+  factory.Set ("Histograms", BooleanValue (true));
+  m_queue = factory.Create<PrioQueue> ();
+  m_queue->SetLinkIDString ("0_0_1");
+  m_queue->TraceConnectWithoutContext ("Histograms", MakeCallback (&PrioQueueHistogramTest::Dumped, this));
+
+  Ptr<Packet> data = MakeHistogramPacket (100);
+  uint32_t size = data->GetSize ();
+  m_queue->Enqueue (data);
+  m_queue->Enqueue (MakeHistogramPacket (100));
+  m_queue->Enqueue (MakeHistogramPacket (100));
+  m_queue->Enqueue (MakeHistogramPacket (0));
+  Simulator::Schedule (MilliSeconds (1), &PrioQueueHistogramTest::Drain, this);
+  Simulator::Stop (MilliSeconds (2));
+  Simulator::Run ();
+
+  const QueueHistograms &h = m_queue->GetHistograms ();
+  NS_TEST_ASSERT_MSG_EQ (h.m_occupancyData.GetCount (), 3, "data arrivals");
+  NS_TEST_ASSERT_MSG_EQ (h.m_occupancyData.GetMin (), 0, "first arrival finds the queue empty");
+  NS_TEST_ASSERT_MSG_EQ (h.m_occupancyData.GetMax (), 2 * size, "third arrival finds two packets");
+  NS_TEST_ASSERT_MSG_EQ (h.m_occupancyControl.GetCount (), 1, "control arrival");
+  NS_TEST_ASSERT_MSG_EQ (h.m_occupancyControl.GetMax (), 3 * size, "control arrival behind the data");
+  NS_TEST_ASSERT_MSG_EQ (h.m_sojournData.GetCount (), 3, "data departures");
+  NS_TEST_ASSERT_MSG_EQ (h.m_sojournControl.GetCount (), 1, "control departure");
+  NS_TEST_ASSERT_MSG_EQ (h.m_sojournData.GetQuantile (0.5), 1000000, "every packet waited 1ms");
+  NS_TEST_ASSERT_MSG_EQ (m_queue->pkt_arrival.size (), 0, "no arrival left once drained");
+
+  m_queue->DumpHistograms ();
+  NS_TEST_ASSERT_MSG_EQ (m_link, "0_0_1", "trace carries the link id");
+  NS_TEST_ASSERT_MSG_EQ (m_sojourns, 4, "trace carries the histograms");
+  NS_TEST_ASSERT_MSG_EQ (m_sojournP99, 1000000, "trace carries the sojourn times");
+  NS_TEST_ASSERT_MSG_EQ (h.m_sojournData.GetCount (), 0, "histograms restart once dumped");
+
+  m_queue = 0;
+  Simulator::Destroy ();
+}
+
+static class QueueHistogramsTestSuite : public TestSuite
+{
+public:
+  QueueHistogramsTestSuite ()
+    : TestSuite ("queue-histograms", UNIT)
+  {
+    AddTestCase (new LogLinearHistogramTest (), TestCase::QUICK);
+    AddTestCase (new PrioQueueHistogramTest (), TestCase::QUICK);
+  }
+} g_queueHistogramsTestSuite;
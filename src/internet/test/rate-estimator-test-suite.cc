@@ -0,0 +1,100 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+
+#include <algorithm>
+#include <cmath>
+#include "ns3/test.h"
+#include "ns3/rate-estimator.h"
+
+using namespace ns3;
+
+class RateDecayTest : public TestCase
+{
+public:
+  RateDecayTest ();
+private:
+  virtual void DoRun (void);
+};
+
+RateDecayTest::RateDecayTest ()
+  : TestCase ("the table decay stays within its error bound of exp")
+{
+}
+
+void
+RateDecayTest::DoRun (void)
+{
+  RateDecay exact (10000.0);
+  RateDecay fast (10000.0, true);
+  NS_TEST_ASSERT_MSG_EQ (exact.Get (0.0), 1.0, "same timestep keeps the weight");
+  NS_TEST_ASSERT_MSG_EQ (fast.Get (0.0), 1.0, "same timestep keeps the weight");
+  NS_TEST_ASSERT_MSG_EQ (exact.Get (1234.0), std::exp ((-1.0 * 1234.0) / 10000.0), "exact decay is exp");
+
+  double worst = 0.0;
+  for (double dt = 0.5; dt < 300000.0; dt *= 1.01)
+    {
+      double e = std::exp (-dt / 10000.0);
+      worst = std::max (worst, std::fabs (fast.Get (dt) - e) / e);
+    }
+  NS_TEST_ASSERT_MSG_LT (worst, 2e-6, "relative error of the table");
+  NS_TEST_ASSERT_MSG_EQ (fast.Get (400000.0), 0.0, "weight vanishes after 32 time constants");
+}
+
+class EwmaRateTest : public TestCase
+{
+public:
+  EwmaRateTest ();
+private:
+  virtual void DoRun (void);
+};
+
+EwmaRateTest::EwmaRateTest ()
+  : TestCase ("ewma, window and kalman rates follow their samples")
+{
+}
+
+void
+EwmaRateTest::DoRun (void)
+{
+  RateDecay decay (10000.0);
+  EwmaRate ewma;
+  ewma.Reset (10000.0);
+  ewma.Update (5000.0, decay.Get (1000.0));
+  double e = std::exp (-1000.0 / 10000.0);
+  NS_TEST_ASSERT_MSG_EQ_TOL (ewma.rate, (1.0 - e) * 5000.0 + e * 10000.0, 1e-9, "one update");
+  double before = ewma.rate;
+  ewma.Update (1.0, decay.Get (0.0));
+  NS_TEST_ASSERT_MSG_EQ (ewma.rate, before, "samples of the same timestep are folded at no weight");
+
+  // 1500 bytes every 1.2us is 10Gbps; the window is 96us
+  WindowRate window;
+  double now = 0.0;
+  for (uint32_t i = 0; i < 1000; i++)
+    {
+      window.Add (1500.0, now, 96000.0);
+      now += 1200.0;
+    }
+  NS_TEST_ASSERT_MSG_EQ_TOL (window.GetRate (now, 96000.0), 10000.0, 10000.0 / 8, "window rate within one bucket");
+  NS_TEST_ASSERT_MSG_EQ (window.GetRate (now + 200000.0, 96000.0), 0.0, "idle window");
+
+  KalmanRate kalman;
+  kalman.Update (8000.0, 0.0, 1.0, 1.0e6);
+  NS_TEST_ASSERT_MSG_EQ (kalman.rate, 8000.0, "first sample sets the rate");
+  for (uint32_t i = 0; i < 200; i++)
+    {
+      kalman.Update ((i % 2) ? 9000.0 : 11000.0, 1000.0, 1.0, 1.0e6);
+    }
+  NS_TEST_ASSERT_MSG_EQ_TOL (kalman.rate, 10000.0, 500.0, "noisy samples average out");
+  kalman.Update (2000.0, 1.0e9, 1.0, 1.0e6);
+  NS_TEST_ASSERT_MSG_EQ_TOL (kalman.rate, 2000.0, 10.0, "a sample after a long gap is trusted");
+}
+
+static class RateEstimatorTestSuite : public TestSuite
+{
+public:
+  RateEstimatorTestSuite ()
+    : TestSuite ("rate-estimator", UNIT)
+  {
+    AddTestCase (new RateDecayTest (), TestCase::QUICK);
+    AddTestCase (new EwmaRateTest (), TestCase::QUICK);
+  }
+} g_rateEstimatorTestSuite;
@@ -0,0 +1,91 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+
+#include "ns3/test.h"
+#include "ns3/tracker.h"
+
+using namespace ns3;
+
+static FlowData
+MakeFlow (uint32_t fid, double size, double deadline, bool deadlineBound)
+{
+  return FlowData (0, 1, 0.0, size, fid, 1.0, 1, 1, size, deadline, 0.0, deadlineBound);
+}
+
+class TrackerOrderTest : public TestCase
+{
+public:
+  TrackerOrderTest ();
+private:
+  virtual void DoRun (void);
+  void Dumped (const FlowData &fd);
+};
+
+static uint32_t g_lastStopped;
+static uint32_t g_dumped;
+
+static void
+TrackerStopped (uint32_t fid)
+{
+  g_lastStopped = fid;
+}
+
+TrackerOrderTest::TrackerOrderTest ()
+  : TestCase ("EDF and SRPT heads follow starts, stops and size updates")
+{
+}
+
+void
+TrackerOrderTest::Dumped (const FlowData &fd)
+{
+  g_dumped++;
+}
+
+void
+TrackerOrderTest::DoRun (void)
+{
+  Ptr<Tracker> tracker = CreateObject<Tracker> ();
+  tracker->register_callback (&TrackerStopped);
+  tracker->TraceConnectWithoutContext ("FlowDump", MakeCallback (&TrackerOrderTest::Dumped, this));
+
+  tracker->registerEvent (1, MakeFlow (1, 3000, 0, false));
+  tracker->registerEvent (1, MakeFlow (2, 1000, 0, false));
+  tracker->registerEvent (1, MakeFlow (3, 2000, 0, false));
+  tracker->registerEvent (1, MakeFlow (4, 500, 0.3, true));
+  tracker->registerEvent (1, MakeFlow (5, 500, 0.1, true));
+
+  NS_TEST_ASSERT_MSG_EQ (tracker->GetNFlows (), 3, "flows without deadline");
+  NS_TEST_ASSERT_MSG_EQ (tracker->GetNDeadlineFlows (), 2, "deadline bound flows");
+  NS_TEST_ASSERT_MSG_EQ (tracker->GetShortestRemainingFlow ()->flow_id, 2, "SRPT head");
+  NS_TEST_ASSERT_MSG_EQ (tracker->GetEarliestDeadlineFlow ()->flow_id, 5, "EDF head");
+
+  // flow 1 has sent all but 100 bytes and moves to the front
+  tracker->UpdateFlowRemainingSize (FlowData (1), 2900, 1);
+  NS_TEST_ASSERT_MSG_EQ (tracker->GetShortestRemainingFlow ()->flow_id, 1, "SRPT head after update");
+  NS_TEST_ASSERT_MSG_EQ_TOL (tracker->GetFlow (1)->flow_rem_size, 100, 1e-9, "remaining size");
+
+  tracker->registerEvent (2, FlowData (5));
+  NS_TEST_ASSERT_MSG_EQ (g_lastStopped, 5, "scheduler callback not invoked");
+  NS_TEST_ASSERT_MSG_EQ (tracker->GetEarliestDeadlineFlow ()->flow_id, 4, "EDF head after stop");
+  NS_TEST_ASSERT_MSG_EQ ((tracker->GetFlow (5) == 0), true, "stopped flow still tracked");
+
+  tracker->registerEvent (2, FlowData (1));
+  NS_TEST_ASSERT_MSG_EQ (tracker->GetShortestRemainingFlow ()->flow_id, 2, "SRPT head after stop");
+
+  g_dumped = 0;
+  tracker->dataDump ();
+  NS_TEST_ASSERT_MSG_EQ (g_dumped, 3, "dump did not visit every flow");
+
+  tracker->registerEvent (2, FlowData (4));
+  NS_TEST_ASSERT_MSG_EQ ((tracker->GetEarliestDeadlineFlow () == 0), true, "EDF head of an empty order");
+  tracker->Dispose ();
+}
+
+static class TrackerTestSuite : public TestSuite
+{
+public:
+  TrackerTestSuite ()
+    : TestSuite ("flow-tracker", UNIT)
+  {
+    AddTestCase (new TrackerOrderTest (), TestCase::QUICK);
+  }
+} g_trackerTestSuite;
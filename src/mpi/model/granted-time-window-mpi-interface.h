@@ -25,11 +25,13 @@
 
 #include <stdint.h>
 #include <list>
+#include <vector>
 
 #include "ns3/nstime.h"
 #include "ns3/buffer.h"
 
 #include "parallel-communication-interface.h"
+#include "mpi-packet-batch.h"
 
 #ifdef NS3_MPI
 #include "mpi.h"
@@ -39,12 +41,6 @@ typedef void* MPI_Request;
 
 namespace ns3 {
 
-/**
- * maximum MPI message size for easy
- * buffer creation
- */
-const uint32_t MAX_MPI_MSG_SIZE = 2000;
-
 /**
  * \ingroup mpi
  *
@@ -128,9 +124,16 @@ public:
    * \param node destination node
    * \param dev destination device
    *
-   * Serialize and send a packet to the specified node and net device
+   * Serialize a packet for the specified node and net device into the
+   * batch of its MPI task.  The batch is sent by FlushSendBuffers, or
+   * first if the packet does not fit in it.
    */
   virtual void SendPacket (Ptr<Packet> p, const Time &rxTime, uint32_t node, uint32_t dev);
+  /**
+   * Send the batches of all MPI tasks.  Called at the end of each
+   * granted time window, before the counts of the LBTS computation.
+   */
+  static void FlushSendBuffers ();
   /**
    * Check for received messages complete
    */
@@ -149,6 +152,11 @@ public:
   static uint32_t GetTxCount ();
 
 private:
+  /**
+   * \param rank MPI task the batch is sent to
+   */
+  static void Flush (uint32_t rank);
+
   static uint32_t m_sid;
   static uint32_t m_size;
 
@@ -168,6 +176,9 @@ private:
 
   // List of pending non-blocking sends
   static std::list<SentBuffer> m_pendingTx;
+
+  // Packets not sent yet, by MPI task
+  static std::vector<MpiPacketBatch> m_batches;
 };
 
 } // namespace ns3
@@ -0,0 +1,169 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include <cstring>
+
+#include "mpi-packet-batch.h"
+#include "mpi-receiver.h"
+
+#include "ns3/node.h"
+#include "ns3/node-list.h"
+#include "ns3/net-device.h"
+#include "ns3/packet.h"
+#include "ns3/simulator.h"
+#include "ns3/log.h"
+#include "ns3/abort.h"
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("MpiPacketBatch");
+
+namespace {
+
+const uint32_t BATCH_HEADER_SIZE = sizeof (uint64_t) + 2 * sizeof (uint32_t);
+const uint32_t RECORD_HEADER_SIZE = sizeof (uint64_t) + 4 * sizeof (uint32_t);
+
+uint32_t
+Padded (uint32_t size)
+{
+  return (size + 7) & ~7U;
+}
+
+} // anonymous namespace
+
+MpiPacketBatch::MpiPacketBatch ()
+  : m_buffer (BATCH_HEADER_SIZE, 0),
+    m_packets (0)
+{
+}
+
+bool
+MpiPacketBatch::Add (Ptr<Packet> p, const Time &rxTime, uint32_t node, uint32_t dev)
+{
+  NS_LOG_FUNCTION (this << p << rxTime.GetTimeStep () << node << dev);
+
+  uint32_t serializedSize = p->GetSerializedSize ();
+  uint32_t offset = m_buffer.size ();
+  uint32_t recordSize = RECORD_HEADER_SIZE + Padded (serializedSize);
+  if (offset + recordSize > MAX_MPI_BATCH_SIZE && m_packets > 0)
+    {
+      return false;
+    }
+  NS_ABORT_MSG_IF (BATCH_HEADER_SIZE + recordSize > MAX_MPI_BATCH_SIZE,
+                   "Packet of " << serializedSize << " bytes exceeds the MPI message size");
+  m_buffer.resize (offset + recordSize, 0);
+
+  // Add the time, dest node and dest device
+  uint64_t* pTime = reinterpret_cast<uint64_t *> (&m_buffer[offset]);
+  *pTime++ = rxTime.GetInteger ();
+  uint32_t* pData = reinterpret_cast<uint32_t *> (pTime);
+  *pData++ = node;
+  *pData++ = dev;
+  *pData++ = serializedSize;
+  *pData++ = 0;
+  // Serialize the packet
+  p->Serialize (reinterpret_cast<uint8_t *> (pData), serializedSize);
+  m_packets++;
+  return true;
+}
+
+uint32_t
+MpiPacketBatch::GetNPackets (void) const
+{
+  return m_packets;
+}
+
+uint8_t*
+MpiPacketBatch::Release (const Time &guarantee, uint32_t &size)
+{
+  NS_LOG_FUNCTION (this << guarantee.GetTimeStep ());
+
+  uint64_t* pTime = reinterpret_cast<uint64_t *> (&m_buffer[0]);
+  *pTime++ = guarantee.GetInteger ();
+  uint32_t* pData = reinterpret_cast<uint32_t *> (pTime);
+  *pData++ = m_packets;
+  *pData++ = 0;
+
+  size = m_buffer.size ();
+  uint8_t* message = new uint8_t[size];
+  std::memcpy (message, &m_buffer[0], size);
+  m_buffer.resize (BATCH_HEADER_SIZE);
+  m_packets = 0;
+  return message;
+}
+
+uint32_t
+MpiPacketBatch::Deliver (const uint8_t* message, uint32_t size, Time &guarantee)
+{
+  NS_LOG_FUNCTION (size);
+
+  const uint64_t* pTime = reinterpret_cast<const uint64_t *> (message);
+  guarantee = Time (*pTime++);
+  const uint32_t* pData = reinterpret_cast<const uint32_t *> (pTime);
+  uint32_t packets = *pData++;
+
+  // Consecutive packets mostly cross the same link, so the receiver of
+  // the last one is kept instead of searching the devices each time
+  uint32_t lastNode = 0;
+  uint32_t lastDev = 0;
+  Ptr<Node> pNode = 0;
+  Ptr<MpiReceiver> pMpiRec = 0;
+
+  uint32_t offset = BATCH_HEADER_SIZE;
+  for (uint32_t n = 0; n < packets; ++n)
+    {
+      NS_ASSERT (offset + RECORD_HEADER_SIZE <= size);
+      pTime = reinterpret_cast<const uint64_t *> (message + offset);
+      Time rxTime (*pTime++);
+      pData = reinterpret_cast<const uint32_t *> (pTime);
+      uint32_t node = *pData++;
+      uint32_t dev = *pData++;
+      uint32_t serializedSize = *pData++;
+      pData++;
+
+      Ptr<Packet> p = Create<Packet> (reinterpret_cast<const uint8_t *> (pData), serializedSize, true);
+
+      // Find the correct node/device to schedule receive event
+      if (pMpiRec == 0 || node != lastNode || dev != lastDev)
+        {
+          pNode = NodeList::GetNode (node);
+          pMpiRec = 0;
+          uint32_t nDevices = pNode->GetNDevices ();
+          for (uint32_t i = 0; i < nDevices; ++i)
+            {
+              Ptr<NetDevice> pThisDev = pNode->GetDevice (i);
+              if (pThisDev->GetIfIndex () == dev)
+                {
+                  pMpiRec = pThisDev->GetObject<MpiReceiver> ();
+                  break;
+                }
+            }
+          NS_ASSERT (pNode && pMpiRec);
+          lastNode = node;
+          lastDev = dev;
+        }
+
+      // Schedule the rx event
+      Simulator::ScheduleWithContext (pNode->GetId (), rxTime - Simulator::Now (),
+                                      &MpiReceiver::Receive, pMpiRec, p);
+
+      offset += RECORD_HEADER_SIZE + Padded (serializedSize);
+    }
+  NS_ASSERT (offset == size);
+  return packets;
+}
+
+} // namespace ns3
@@ -0,0 +1,107 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef NS3_MPI_PACKET_BATCH_H
+#define NS3_MPI_PACKET_BATCH_H
+
+#include <stdint.h>
+#include <vector>
+
+#include "ns3/nstime.h"
+#include "ns3/ptr.h"
+
+namespace ns3 {
+
+class Packet;
+
+/**
+ * Size of the receive buffers, and so the largest message a batch
+ * grows to before it is flushed.
+ */
+const uint32_t MAX_MPI_BATCH_SIZE = 64 * 1024;
+
+/**
+ * \ingroup mpi
+ *
+ * \brief Packets bound for one remote rank, sent as one MPI message
+ *
+ * Both MPI interfaces pack the packets crossing to a rank into a batch
+ * and send it at the next synchronization point, or when the next packet
+ * would not fit in the receive buffers, instead of posting one send per
+ * packet.
+ *
+ * \internal
+ * The MPI buffer format is a header followed by one record per packet.
+ *
+ * uint64_t guarantee time for the Null Message algorithm, 0 for the granted time window
+ * uint32_t number of records, 0 for a Null Message
+ * uint32_t 0
+ *
+ * uint64_t time the packet should be delivered
+ * uint32_t node id of destination
+ * uint32_t dev id on destination
+ * uint32_t size of the serialized packet
+ * uint32_t 0
+ * uint8_t[] serialized packet, padded to a multiple of 8 bytes
+ *
+ * The headers of the PPP/Prio/IPv4/TCP stack are already bytes of the
+ * packet buffer; Packet::Serialize adds only the tags, and the metadata
+ * when it is enabled.
+ */
+class MpiPacketBatch
+{
+public:
+  MpiPacketBatch ();
+
+  /**
+   * \param p packet to send
+   * \param rxTime received time at destination node
+   * \param node destination node
+   * \param dev destination device
+   * \return false, leaving the batch as it was, if the packet does not
+   * fit in the batch any more
+   */
+  bool Add (Ptr<Packet> p, const Time &rxTime, uint32_t node, uint32_t dev);
+  /**
+   * \return number of packets in the batch
+   */
+  uint32_t GetNPackets (void) const;
+  /**
+   * \param guarantee guarantee time written in the header
+   * \param size set to the size of the message
+   * \return the message, allocated with new [], leaving the batch empty
+   */
+  uint8_t* Release (const Time &guarantee, uint32_t &size);
+
+  /**
+   * \param message received message
+   * \param size size of the message
+   * \param guarantee set to the guarantee time of the message
+   * \return number of packets in the message
+   *
+   * Schedule the receive event of every packet in the message on its
+   * MpiReceiver.
+   */
+  static uint32_t Deliver (const uint8_t* message, uint32_t size, Time &guarantee);
+
+private:
+  std::vector<uint8_t> m_buffer;
+  uint32_t m_packets;
+};
+
+} // namespace ns3
+
+#endif /* NS3_MPI_PACKET_BATCH_H */
@@ -46,10 +46,27 @@ MpiReceiver::Receive (Ptr<Packet> p)
   m_rxCallback (p);
 }
 
+Time
+MpiReceiver::GetTransmitReadyTime (void) const
+{
+  if (m_txReadyCallback.IsNull ())
+    {
+      return Time (0);
+    }
+  return m_txReadyCallback ();
+}
+
+void
+MpiReceiver::SetTransmitReadyCallback (Callback<Time> callback)
+{
+  m_txReadyCallback = callback;
+}
+
 void
 MpiReceiver::DoDispose(void)
 {
   m_rxCallback = MakeNullCallback<void, Ptr<Packet> >();
+  m_txReadyCallback = MakeNullCallback<Time> ();
 }
 
 } // namespace ns3
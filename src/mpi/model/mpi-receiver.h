@@ -23,6 +23,7 @@
 
 #include "ns3/object.h"
 #include "ns3/packet.h"
+#include "ns3/nstime.h"
 
 namespace ns3 {
 
@@ -38,6 +39,10 @@ namespace ns3 {
  * device.  In addition, we must hook up a NetDevice::Receive() method
  * to the callback.  So the two steps to enable MPI capability are to
  * aggregate this object to a NetDevice, and to set the callback.
+ *
+ * A device may also report when it can next start to transmit, which
+ * lets the Null Message algorithm look further ahead than the link delay
+ * while the device is busy.
  */
 class MpiReceiver : public Object
 {
@@ -55,10 +60,22 @@ public:
    * \param callback the callback itself
    */
   void SetReceiveCallback (Callback<void, Ptr<Packet> > callback);
+  /**
+   * \brief Earliest time the device can start to transmit a packet it
+   * has not sent yet
+   * \return the time, 0 if the device does not report its transmit state
+   */
+  Time GetTransmitReadyTime (void) const;
+  /**
+   * \brief Set the callback reporting the transmit state of the device
+   * \param callback the callback itself
+   */
+  void SetTransmitReadyCallback (Callback<Time> callback);
 private:
   virtual void DoDispose (void);
 
   Callback<void, Ptr<Packet> > m_rxCallback;
+  Callback<Time> m_txReadyCallback;
 };
 
 } // namespace ns3
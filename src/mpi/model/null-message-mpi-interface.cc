@@ -45,14 +45,6 @@ NS_LOG_COMPONENT_DEFINE ("NullMessageMpiInterface");
 
 namespace ns3 {
 
-/**
- * maximum MPI message size for easy
- * buffer creation
- */
-#ifdef NS3_MPI
-const uint32_t NULL_MESSAGE_MAX_MPI_MSG_SIZE = 2000;
-#endif
-
 NullMessageSentBuffer::NullMessageSentBuffer ()
 {
   m_buffer = 0;
@@ -88,6 +80,7 @@ uint32_t              NullMessageMpiInterface::g_numNeighbors = 0;
 bool                  NullMessageMpiInterface::g_initialized = false;
 bool                  NullMessageMpiInterface::g_enabled = false;
 std::list<NullMessageSentBuffer> NullMessageMpiInterface::g_pendingTx;
+std::vector<MpiPacketBatch> NullMessageMpiInterface::g_batches;
 
 MPI_Request* NullMessageMpiInterface::g_requests;
 char**       NullMessageMpiInterface::g_pRxBuffers;
@@ -184,12 +177,13 @@ NullMessageMpiInterface::InitializeSendReceiveBuffers(void)
       Ptr<RemoteChannelBundle> bundle = RemoteChannelBundleManager::Find(rank);
       if (bundle) 
         {
-          g_pRxBuffers[index] = new char[NULL_MESSAGE_MAX_MPI_MSG_SIZE];
-          MPI_Irecv (g_pRxBuffers[index], NULL_MESSAGE_MAX_MPI_MSG_SIZE, MPI_CHAR, rank, 0,
+          g_pRxBuffers[index] = new char[MAX_MPI_BATCH_SIZE];
+          MPI_Irecv (g_pRxBuffers[index], MAX_MPI_BATCH_SIZE, MPI_CHAR, rank, 0,
                      MPI_COMM_WORLD, &g_requests[index]);
           ++index;
         }
     }
+  g_batches.resize (g_size);
 #endif
 }
 
@@ -206,32 +200,13 @@ NullMessageMpiInterface::SendPacket (Ptr<Packet> p, const Time& rxTime, uint32_t
   Ptr<Node> destNode = NodeList::GetNode (node);
   uint32_t nodeSysId = destNode->GetSystemId ();
 
-  NullMessageSentBuffer sendBuf;
-  g_pendingTx.push_back (sendBuf);
-  std::list<NullMessageSentBuffer>::reverse_iterator iter = g_pendingTx.rbegin (); // Points to the last element
-
-  uint32_t serializedSize = p->GetSerializedSize ();
-  uint32_t bufferSize = serializedSize + ( 2 * sizeof (uint64_t) ) + ( 2 * sizeof (uint32_t) );
-  uint8_t* buffer =  new uint8_t[bufferSize];
-  iter->SetBuffer (buffer);
-  // Add the time, dest node and dest device
-  uint64_t t = rxTime.GetInteger ();
-  uint64_t* pTime = reinterpret_cast <uint64_t *> (buffer);
-  *pTime++ = t;
-
-  Time guarantee_update = NullMessageSimulatorImpl::GetInstance ()->CalculateGuaranteeTime (nodeSysId);
-  *pTime++ = guarantee_update.GetTimeStep ();
-
-  uint32_t* pData = reinterpret_cast<uint32_t *> (pTime);
-  *pData++ = node;
-  *pData++ = dev;
-  // Serialize the packet
-  p->Serialize (reinterpret_cast<uint8_t *> (pData), serializedSize);
-
-  MPI_Isend (reinterpret_cast<void *> (iter->GetBuffer ()), bufferSize, MPI_CHAR, nodeSysId,
-             0, MPI_COMM_WORLD, (iter->GetRequest ()));
-
-  NullMessageSimulatorImpl::GetInstance ()->RescheduleNullMessageEvent (nodeSysId);
+  if (!g_batches[nodeSysId].Add (p, rxTime, node, dev))
+    {
+      // A full batch goes out now and stands in for the next Null Message
+      Flush (nodeSysId, NullMessageSimulatorImpl::GetInstance ()->CalculateGuaranteeTime (nodeSysId));
+      NullMessageSimulatorImpl::GetInstance ()->RescheduleNullMessageEvent (nodeSysId);
+      g_batches[nodeSysId].Add (p, rxTime, node, dev);
+    }
 
 #endif
 }
@@ -244,26 +219,43 @@ NullMessageMpiInterface::SendNullMessage (const Time& guarantee_update, Ptr<Remo
   NS_ASSERT (g_enabled);
 
 #ifdef NS3_MPI
+  Flush (bundle->GetSystemId (), guarantee_update);
+#endif
+}
 
+void
+NullMessageMpiInterface::FlushSendBuffers (void)
+{
+  NS_LOG_FUNCTION_NOARGS ();
+
+  NS_ASSERT (g_enabled);
+
+#ifdef NS3_MPI
+  for (uint32_t rank = 0; rank < g_batches.size (); ++rank)
+    {
+      if (g_batches[rank].GetNPackets () > 0)
+        {
+          Flush (rank, NullMessageSimulatorImpl::GetInstance ()->CalculateGuaranteeTime (rank));
+          NullMessageSimulatorImpl::GetInstance ()->RescheduleNullMessageEvent (rank);
+        }
+    }
+#endif
+}
+
+void
+NullMessageMpiInterface::Flush (uint32_t rank, const Time& guarantee_update)
+{
+  NS_LOG_FUNCTION (rank << guarantee_update.GetTimeStep ());
+
+#ifdef NS3_MPI
   NullMessageSentBuffer sendBuf;
   g_pendingTx.push_back (sendBuf);
   std::list<NullMessageSentBuffer>::reverse_iterator iter = g_pendingTx.rbegin (); // Points to the last element
 
-  uint32_t bufferSize = 2 * sizeof (uint64_t) + 2 * sizeof (uint32_t);
-  uint8_t* buffer =  new uint8_t[bufferSize];
-  iter->SetBuffer (buffer);
-  // Add the time, dest node and dest device
-  uint64_t* pTime = reinterpret_cast <uint64_t *> (buffer);
-  *pTime++ = 0;
-  *pTime++ = guarantee_update.GetInteger ();
-  uint32_t* pData = reinterpret_cast<uint32_t *> (pTime);
-  *pData++ = 0;
-  *pData++ = 0;
-
-  // Find the system id for the destination MPI rank
-  uint32_t nodeSysId = bundle->GetSystemId ();
-
-  MPI_Isend (reinterpret_cast<void *> (iter->GetBuffer ()), bufferSize, MPI_CHAR, nodeSysId,
+  uint32_t bufferSize;
+  iter->SetBuffer (g_batches[rank].Release (guarantee_update, bufferSize));
+
+  MPI_Isend (reinterpret_cast<void *> (iter->GetBuffer ()), bufferSize, MPI_CHAR, rank,
              0, MPI_COMM_WORLD, (iter->GetRequest ()));
 #endif
 }
@@ -327,53 +319,19 @@ NullMessageMpiInterface::ReceiveMessages (bool blocking)
           int count;
           MPI_Get_count (&status, MPI_CHAR, &count);
 
-          // Get the meta data first
-          uint64_t* pTime = reinterpret_cast<uint64_t *> (g_pRxBuffers[index]);
-          uint64_t time = *pTime++;
-          uint64_t guaranteeUpdate = *pTime++;
-
-          uint32_t* pData = reinterpret_cast<uint32_t *> (pTime);
-          uint32_t node = *pData++;
-          uint32_t dev  = *pData++;
-
-          Time rxTime (time);
-
-          // rxtime == 0 means this is a Null Message
-          if (rxTime > Time (0))
-            {
-              count -= sizeof (time) + sizeof (guaranteeUpdate) + sizeof (node) + sizeof (dev);
-
-              Ptr<Packet> p = Create<Packet> (reinterpret_cast<uint8_t *> (pData), count, true);
-
-              // Find the correct node/device to schedule receive event
-              Ptr<Node> pNode = NodeList::GetNode (node);
-              Ptr<MpiReceiver> pMpiRec = 0;
-              uint32_t nDevices = pNode->GetNDevices ();
-              for (uint32_t i = 0; i < nDevices; ++i)
-                {
-                  Ptr<NetDevice> pThisDev = pNode->GetDevice (i);
-                  if (pThisDev->GetIfIndex () == dev)
-                    {
-                      pMpiRec = pThisDev->GetObject<MpiReceiver> ();
-                      break;
-                    }
-                }
-              NS_ASSERT (pNode && pMpiRec);
-
-              // Schedule the rx event
-              Simulator::ScheduleWithContext (pNode->GetId (), rxTime - Simulator::Now (),
-                                              &MpiReceiver::Receive, pMpiRec, p);
-
-            }
+          // Schedule the rx events of the packets in the message, none
+          // for a Null Message
+          Time guaranteeUpdate;
+          MpiPacketBatch::Deliver (reinterpret_cast<uint8_t *> (g_pRxBuffers[index]), count, guaranteeUpdate);
 
           // Update guarantee time for both packet receives and Null Messages.
           Ptr<RemoteChannelBundle> bundle = RemoteChannelBundleManager::Find (status.MPI_SOURCE);
           NS_ASSERT (bundle);
 
-          bundle->SetGuaranteeTime (Time (guaranteeUpdate));
+          bundle->SetGuaranteeTime (guaranteeUpdate);
 
           // Re-queue the next read
-          MPI_Irecv (g_pRxBuffers[index], NULL_MESSAGE_MAX_MPI_MSG_SIZE, MPI_CHAR, status.MPI_SOURCE, 0,
+          MPI_Irecv (g_pRxBuffers[index], MAX_MPI_BATCH_SIZE, MPI_CHAR, status.MPI_SOURCE, 0,
                      MPI_COMM_WORLD, &g_requests[index]);
 
         }
@@ -446,6 +404,7 @@ NullMessageMpiInterface::Disable ()
       delete [] g_requests;
 
       g_pendingTx.clear ();
+      g_batches.clear ();
 
       g_enabled = false;
       g_initialized = false;
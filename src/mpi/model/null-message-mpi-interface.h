@@ -23,6 +23,7 @@
 #define NS3_NULLMESSAGE_MPI_INTERFACE_H
 
 #include "parallel-communication-interface.h"
+#include "mpi-packet-batch.h"
 
 #include <ns3/nstime.h>
 #include <ns3/buffer.h>
@@ -34,6 +35,7 @@ typedef void* MPI_Request;
 #endif
 
 #include <list>
+#include <vector>
 
 namespace ns3 {
 
@@ -128,16 +130,14 @@ public:
    * \param node destination node
    * \param dev destination device
    *
-   * Serialize and send a packet to the specified node and net device.
+   * Serialize a packet for the specified node and net device into the
+   * batch of its MPI task.  The batch is sent with the next Null Message
+   * to the task, before this task blocks, or first if the packet does
+   * not fit in it.
    *
    * \internal
-   * The MPI buffer format packs a delivery information and the serialized packet.
-   *
-   * uint64_t time the packed should be delivered
-   * uint64_t guarantee time for the Null Message algorithm.
-   * uint32_t node id of destination
-   * unit32_t dev id on destination
-   * uint8_t[] serialized packet
+   * See MpiPacketBatch for the MPI buffer format.  The batch carries the
+   * guarantee time for the Null Message algorithm.
    */
   virtual void SendPacket (Ptr<Packet> p, const Time &rxTime, uint32_t node, uint32_t dev);
   /**
@@ -155,16 +155,16 @@ public:
    * MPI task.
    *
    * \internal
-   * The Null Message MPI buffer format is based on the format for sending a packet with
-   * several fields set to 0 to signal that it is a Null Message.  Overloading the normal packet
-   * format simplifies receive logic.
-   *
-   * uint64_t 0 must be zero for Null Message
-   * uint64_t guarantee time
-   * uint32_t 0 must be zero for Null Message
-   * uint32_t 0 must be zero for Null Message
+   * The Null Message is the batch of packets for the remote task, with
+   * no packets if none were sent since the last message.  Overloading
+   * the packet format simplifies receive logic.
    */
   static void SendNullMessage (const Time& guaranteeUpdate, Ptr<RemoteChannelBundle> bundle);
+  /**
+   * Send the batches of packets of all remote tasks.  Called before
+   * blocking, so that no task waits on packets held here.
+   */
+  static void FlushSendBuffers (void);
   /**
    * Non-blocking check for received messages complete.  Will
    * receive all messages that are queued up locally.
@@ -198,6 +198,13 @@ private:
    * receive all messages that are queued up locally.
    */
   static void ReceiveMessages (bool blocking = false);
+  /**
+   * \param rank remote task
+   * \param guaranteeUpdate guarantee time sent with the batch
+   *
+   * Send the batch of packets of the remote task, possibly empty.
+   */
+  static void Flush (uint32_t rank, const Time& guaranteeUpdate);
 
   // System ID (rank) for this task
   static uint32_t g_sid;
@@ -219,6 +226,9 @@ private:
 
   // List of pending non-blocking sends
   static std::list<NullMessageSentBuffer> g_pendingTx;
+
+  // Packets not sent yet, by MPI task
+  static std::vector<MpiPacketBatch> g_batches;
 };
 
 } // namespace ns3
@@ -25,6 +25,7 @@
 #include "remote-channel-bundle-manager.h"
 #include "remote-channel-bundle.h"
 #include "mpi-interface.h"
+#include "mpi-receiver.h"
 
 #include <ns3/simulator.h>
 #include <ns3/scheduler.h>
@@ -195,7 +196,7 @@ NullMessageSimulatorImpl::CalculateLookAhead (void)
 
               TimeValue delay;
               channel->GetAttribute ("Delay", delay);
-              remoteChannelBundle->AddChannel (channel, delay.Get () );
+              remoteChannelBundle->AddChannel (channel, delay.Get (), localNetDevice->GetObject<MpiReceiver> ());
             }
         }
     }
@@ -341,6 +342,9 @@ NullMessageSimulatorImpl::HandleArrivingMessagesBlocking (void)
 {
   NS_LOG_FUNCTION (this);
 
+  // Nothing may be held back while this task waits on the others
+  NullMessageMpiInterface::FlushSendBuffers ();
+
   NullMessageMpiInterface::ReceiveMessagesBlocking ();
 
   CalculateSafeTime ();
@@ -579,14 +583,14 @@ Time NullMessageSimulatorImpl::CalculateGuaranteeTime (uint32_t nodeSysId)
   Ptr<RemoteChannelBundle> bundle = RemoteChannelBundleManager::Find (nodeSysId);
   NS_ASSERT (bundle);
 
-  return Min (NullMessageSimulatorImpl::GetInstance ()->Next (), GetSafeTime ()) + bundle->GetDelay ();
+  return bundle->CalculateGuaranteeTime (Min (NullMessageSimulatorImpl::GetInstance ()->Next (), GetSafeTime ()));
 }
 
 void NullMessageSimulatorImpl::NullMessageEventHandler(RemoteChannelBundle* bundle)
 {
   NS_LOG_FUNCTION (this << bundle);
 
-  Time time = Min (Next (), GetSafeTime ()) + bundle->GetDelay ();
+  Time time = bundle->CalculateGuaranteeTime (Min (Next (), GetSafeTime ()));
   NullMessageMpiInterface::SendNullMessage (time, bundle);
 
   ScheduleNullMessageEvent (bundle);
@@ -53,10 +53,15 @@ RemoteChannelBundle::RemoteChannelBundle (const uint32_t remoteSystemId)
 }
 
 void
-RemoteChannelBundle::AddChannel (Ptr<Channel> channel, Time delay)
+RemoteChannelBundle::AddChannel (Ptr<Channel> channel, Time delay, Ptr<MpiReceiver> sender)
 {
   m_channels[channel->GetId ()] = channel;
   m_delay = ns3::Min (m_delay, delay);
+
+  Link link;
+  link.sender = sender;
+  link.delay = delay;
+  m_links.push_back (link);
 }
 
 uint32_t
@@ -85,6 +90,27 @@ RemoteChannelBundle::GetDelay (void) const
   return m_delay;
 }
 
+Time
+RemoteChannelBundle::CalculateGuaranteeTime (Time start) const
+{
+  if (m_links.empty ())
+    {
+      return start + m_delay;
+    }
+
+  Time guarantee = NS_TIME_INFINITY;
+  for (std::vector<Link>::const_iterator link = m_links.begin (); link != m_links.end (); ++link)
+    {
+      Time txStart = start;
+      if (link->sender != 0)
+        {
+          txStart = ns3::Max (start, link->sender->GetTransmitReadyTime ());
+        }
+      guarantee = ns3::Min (guarantee, txStart + link->delay);
+    }
+  return guarantee;
+}
+
 void
 RemoteChannelBundle::SetEventId (EventId id)
 {
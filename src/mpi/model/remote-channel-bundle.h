@@ -23,12 +23,14 @@
 #define NS3_REMOTE_CHANNEL_BUNDLE
 
 #include "null-message-simulator-impl.h"
+#include "mpi-receiver.h"
 
 #include <ns3/channel.h>
 #include <ns3/ptr.h>
 #include <ns3/pointer.h>
 
 #include <map>
+#include <vector>
 
 namespace ns3 {
 
@@ -58,8 +60,10 @@ public:
   /**
    * \param channel to add to the bundle
    * \param delay time for the channel (usually the latency)
+   * \param sender MpiReceiver of the local device sending on the channel,
+   * 0 if its transmit state is unknown
    */
-  void AddChannel (Ptr<Channel> channel, Time delay);
+  void AddChannel (Ptr<Channel> channel, Time delay, Ptr<MpiReceiver> sender = 0);
 
   /**
    * \return SystemID for remote side of this bundle
@@ -84,6 +88,17 @@ public:
    */
   Time GetDelay (void) const;
 
+  /**
+   * \param start earliest time any local event can send a packet
+   * \return guarantee time for the remote task
+   *
+   * No packet sent from now on will arrive on any outgoing channel in
+   * this bundle before the returned time.  A busy local device sends its
+   * next packet no earlier than the end of its current transmission, so
+   * the bound exceeds start + GetDelay () while the devices are loaded.
+   */
+  Time CalculateGuaranteeTime (Time start) const;
+
   /**
    * Set the event ID of the Null Message send event current scheduled
    * for this channel.
@@ -139,6 +154,17 @@ private:
    */
   Time m_delay;
 
+  /*
+   * Local sending end and delay of each channel, for the guarantee time
+   * sent to remote_rank.
+   */
+  struct Link
+  {
+    Ptr<MpiReceiver> sender;
+    Time delay;
+  };
+  std::vector<Link> m_links;
+
   /*
    * Event scheduled to send Null Message for this bundle.
    */
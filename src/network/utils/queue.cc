@@ -47,7 +47,8 @@ Queue::Queue() :
   m_nPackets (0),
   m_nTotalReceivedPackets (0),
   m_nTotalDroppedBytes (0),
-  m_nTotalDroppedPackets (0)
+  m_nTotalDroppedPackets (0),
+  m_fluidRate (0.0)
 {
   NS_LOG_FUNCTION (this);
 }
@@ -187,6 +188,19 @@ Queue::ResetStatistics (void)
   m_nTotalDroppedPackets = 0;
 }
 
+void
+Queue::SetFluidRate (double bps)
+{
+  NS_LOG_FUNCTION (this << bps);
+  m_fluidRate = bps;
+}
+
+double
+Queue::GetFluidRate (void) const
+{
+  return m_fluidRate;
+}
+
 void
 Queue::Drop (Ptr<Packet> p)
 {
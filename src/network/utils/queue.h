@@ -126,6 +126,17 @@ public:
    * received bytes.
    */
   void ResetStatistics (void);
+  /**
+   * Reserve part of the link for fluid traffic that shares this queue
+   * without being carried by packets, see ns3::FluidSimulator.  The device
+   * serves the packets at what is left of its rate.
+   * \param bps the reserved rate in bits per second
+   */
+  void SetFluidRate (double bps);
+  /**
+   * \return The rate reserved by fluid traffic, in bits per second
+   */
+  double GetFluidRate (void) const;
 
   /**
    * \brief Enumeration of the modes supported in the class.
@@ -202,6 +213,7 @@ private:
   uint32_t m_nTotalReceivedPackets; //!< Total received packets
   uint32_t m_nTotalDroppedBytes;    //!< Total dropped bytes
   uint32_t m_nTotalDroppedPackets;  //!< Total dropped packets
+  double m_fluidRate;               //!< Rate reserved by fluid traffic, bps
 };
 
 } // namespace ns3
@@ -0,0 +1,276 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+
+#include "ns3/log.h"
+#include "ns3/abort.h"
+#include "ns3/ipv4.h"
+#include "ns3/ipv4-global-routing.h"
+#include "ns3/ipv4-routing-helper.h"
+#include "ns3/clos-topology-helper.h"
+
+NS_LOG_COMPONENT_DEFINE ("ClosTopologyHelper");
+
+namespace ns3 {
+
+ClosTopologyHelper::ClosTopologyHelper (uint32_t nSpines, uint32_t nLeaves, uint32_t nHostsPerLeaf,
+                                        PointToPointHelper fabricHelper, PointToPointHelper edgeHelper)
+  : m_nPods (1),
+    m_nSpinesPerPod (nSpines),
+    m_nLeavesPerPod (nLeaves),
+    m_nHostsPerLeaf (nHostsPerLeaf),
+    m_nCoresPerSpine (0)
+{
+  PointToPointHelper coreHelper;
+  Build (coreHelper, fabricHelper, edgeHelper);
+}
+
+ClosTopologyHelper::ClosTopologyHelper (uint32_t nPods, uint32_t nSpinesPerPod, uint32_t nLeavesPerPod,
+                                        uint32_t nHostsPerLeaf, uint32_t nCoresPerSpine,
+                                        PointToPointHelper coreHelper, PointToPointHelper fabricHelper,
+                                        PointToPointHelper edgeHelper)
+  : m_nPods (nPods),
+    m_nSpinesPerPod (nSpinesPerPod),
+    m_nLeavesPerPod (nLeavesPerPod),
+    m_nHostsPerLeaf (nHostsPerLeaf),
+    m_nCoresPerSpine (nCoresPerSpine)
+{
+  NS_ABORT_MSG_IF (nPods > 1 && nCoresPerSpine == 0, "ClosTopologyHelper: " << nPods << " pods without cores");
+  Build (coreHelper, fabricHelper, edgeHelper);
+}
+
+ClosTopologyHelper::~ClosTopologyHelper ()
+{
+}
+
+ClosTopologyHelper
+ClosTopologyHelper::FatTree (uint32_t k, PointToPointHelper coreHelper,
+                             PointToPointHelper fabricHelper, PointToPointHelper edgeHelper)
+{
+  NS_ABORT_MSG_IF (k < 2 || k % 2, "ClosTopologyHelper::FatTree(): k must be even, not " << k);
+  return ClosTopologyHelper (k, k / 2, k / 2, k / 2, k / 2, coreHelper, fabricHelper, edgeHelper);
+}
+
+void
+ClosTopologyHelper::Build (PointToPointHelper &coreHelper, PointToPointHelper &fabricHelper,
+                           PointToPointHelper &edgeHelper)
+{
+  NS_LOG_FUNCTION (this << m_nPods << m_nSpinesPerPod << m_nLeavesPerPod << m_nHostsPerLeaf << m_nCoresPerSpine);
+  uint32_t nLeaves = m_nPods * m_nLeavesPerPod;
+  uint32_t nSpines = m_nPods * m_nSpinesPerPod;
+  uint32_t nCores = m_nSpinesPerPod * m_nCoresPerSpine;
+
+  m_hosts.Create (nLeaves * m_nHostsPerLeaf);
+  m_leaves.Create (nLeaves);
+  m_spines.Create (nSpines);
+  m_cores.Create (nCores);
+
+  m_fabricLinks.reserve (nSpines * m_nLeavesPerPod);
+  m_coreLinks.reserve (nCores * m_nPods);
+  m_edgeLinks.reserve (m_hosts.GetN ());
+
+  for (uint32_t pod = 0; pod < m_nPods; pod++)
+    {
+      for (uint32_t s = 0; s < m_nSpinesPerPod; s++)
+        {
+          Ptr<Node> spine = m_spines.Get (pod * m_nSpinesPerPod + s);
+          for (uint32_t l = 0; l < m_nLeavesPerPod; l++)
+            {
+              m_fabricLinks.push_back (fabricHelper.Install (spine, m_leaves.Get (pod * m_nLeavesPerPod + l)));
+            }
+        }
+    }
+  for (uint32_t c = 0; c < nCores; c++)
+    {
+      for (uint32_t pod = 0; pod < m_nPods; pod++)
+        {
+          Ptr<Node> spine = m_spines.Get (pod * m_nSpinesPerPod + c / m_nCoresPerSpine);
+          m_coreLinks.push_back (coreHelper.Install (m_cores.Get (c), spine));
+        }
+    }
+  for (uint32_t h = 0; h < m_hosts.GetN (); h++)
+    {
+      m_edgeLinks.push_back (edgeHelper.Install (m_leaves.Get (h / m_nHostsPerLeaf), m_hosts.Get (h)));
+    }
+}
+
+NodeContainer
+ClosTopologyHelper::GetHosts (void) const
+{
+  return m_hosts;
+}
+
+NodeContainer
+ClosTopologyHelper::GetLeaves (void) const
+{
+  return m_leaves;
+}
+
+NodeContainer
+ClosTopologyHelper::GetSpines (void) const
+{
+  return m_spines;
+}
+
+NodeContainer
+ClosTopologyHelper::GetCores (void) const
+{
+  return m_cores;
+}
+
+Ptr<Node>
+ClosTopologyHelper::GetHost (uint32_t i) const
+{
+  return m_hosts.Get (i);
+}
+
+Ipv4Address
+ClosTopologyHelper::GetHostIpv4Address (uint32_t i) const
+{
+  NS_ASSERT_MSG (i < m_edgeInterfaces.size (), "ClosTopologyHelper: addresses not assigned");
+  return m_edgeInterfaces[i].GetAddress (1);
+}
+
+const std::vector<NetDeviceContainer> &
+ClosTopologyHelper::GetEdgeLinks (void) const
+{
+  return m_edgeLinks;
+}
+
+const std::vector<NetDeviceContainer> &
+ClosTopologyHelper::GetFabricLinks (void) const
+{
+  return m_fabricLinks;
+}
+
+const std::vector<NetDeviceContainer> &
+ClosTopologyHelper::GetCoreLinks (void) const
+{
+  return m_coreLinks;
+}
+
+void
+ClosTopologyHelper::InstallStack (InternetStackHelper stack)
+{
+  stack.Install (m_hosts);
+  stack.Install (m_leaves);
+  stack.Install (m_spines);
+  stack.Install (m_cores);
+}
+
+void
+ClosTopologyHelper::AssignIpv4Addresses (Ipv4FabricAddressHelper address)
+{
+  NS_LOG_FUNCTION (this);
+  address.SetTopology (m_nPods, m_nLeavesPerPod, m_nHostsPerLeaf);
+  m_fabricInterfaces.reserve (m_fabricLinks.size ());
+  for (uint32_t i = 0; i < m_fabricLinks.size (); i++)
+    {
+      m_fabricInterfaces.push_back (address.AssignFabricLink (m_fabricLinks[i]));
+    }
+  m_coreInterfaces.reserve (m_coreLinks.size ());
+  for (uint32_t i = 0; i < m_coreLinks.size (); i++)
+    {
+      m_coreInterfaces.push_back (address.AssignFabricLink (m_coreLinks[i]));
+    }
+  m_edgeInterfaces.reserve (m_edgeLinks.size ());
+  for (uint32_t h = 0; h < m_edgeLinks.size (); h++)
+    {
+      uint32_t leaf = h / m_nHostsPerLeaf;
+      m_edgeInterfaces.push_back (address.AssignHostLink (m_edgeLinks[h], leaf / m_nLeavesPerPod,
+                                                          leaf % m_nLeavesPerPod, h % m_nHostsPerLeaf));
+    }
+  m_address = address;
+}
+
+Ptr<Ipv4GlobalRouting>
+ClosTopologyHelper::GetRouting (Ptr<Node> node) const
+{
+  Ptr<Ipv4> ipv4 = node->GetObject<Ipv4> ();
+  NS_ASSERT_MSG (ipv4, "ClosTopologyHelper: stack not installed");
+  Ptr<Ipv4GlobalRouting> routing = Ipv4RoutingHelper::GetRouting<Ipv4GlobalRouting> (ipv4->GetRoutingProtocol ());
+  NS_ABORT_MSG_UNLESS (routing, "ClosTopologyHelper: node " << node->GetId () << " has no global routing");
+  return routing;
+}
+
+void
+ClosTopologyHelper::AddRoute (const Ipv4InterfaceContainer &link, uint32_t from,
+                              Ipv4Address network, Ipv4Mask mask)
+{
+  std::pair<Ptr<Ipv4>, uint32_t> end = link.Get (from);
+  Ptr<Ipv4GlobalRouting> routing = GetRouting (end.first->GetObject<Node> ());
+  routing->AddNetworkRouteTo (network, mask, link.GetAddress (1 - from), end.second);
+}
+
+void
+ClosTopologyHelper::PopulateRoutes (void)
+{
+  NS_LOG_FUNCTION (this);
+  NS_ASSERT_MSG (m_edgeInterfaces.size () == m_edgeLinks.size (), "ClosTopologyHelper: addresses not assigned");
+  Ipv4Mask leafMask = m_address.GetLeafMask ();
+  Ipv4Mask podMask = m_address.GetPodMask ();
+
+  // hosts have a single uplink
+  for (uint32_t h = 0; h < m_edgeInterfaces.size (); h++)
+    {
+      AddRoute (m_edgeInterfaces[h], 1, m_address.GetHostLinksNetwork (), m_address.GetHostLinksMask ());
+    }
+
+  // the routes of a node never overlap: global routing spreads over every
+  // matching route instead of taking the longest match
+  for (uint32_t pod = 0; pod < m_nPods; pod++)
+    {
+      for (uint32_t s = 0; s < m_nSpinesPerPod; s++)
+        {
+          uint32_t spine = pod * m_nSpinesPerPod + s;
+          for (uint32_t l = 0; l < m_nLeavesPerPod; l++)
+            {
+              const Ipv4InterfaceContainer &down = m_fabricInterfaces[spine * m_nLeavesPerPod + l];
+              // spine to the leaves of its pod
+              AddRoute (down, 0, m_address.GetLeafNetwork (pod, l), leafMask);
+            }
+          for (uint32_t other = 0; other < m_nPods; other++)
+            {
+              if (other == pod)
+                {
+                  continue;
+                }
+              // spine to the other pods, over its cores
+              for (uint32_t c = s * m_nCoresPerSpine; c < (s + 1) * m_nCoresPerSpine; c++)
+                {
+                  AddRoute (m_coreInterfaces[c * m_nPods + pod], 1, m_address.GetPodNetwork (other), podMask);
+                }
+            }
+        }
+
+      for (uint32_t l = 0; l < m_nLeavesPerPod; l++)
+        {
+          // leaf to the other leaves of its pod and to the other pods, over
+          // every spine of its pod
+          for (uint32_t s = 0; s < m_nSpinesPerPod; s++)
+            {
+              const Ipv4InterfaceContainer &up = m_fabricInterfaces[(pod * m_nSpinesPerPod + s) * m_nLeavesPerPod + l];
+              for (uint32_t other = 0; other < m_nLeavesPerPod; other++)
+                {
+                  if (other != l)
+                    {
+                      AddRoute (up, 1, m_address.GetLeafNetwork (pod, other), leafMask);
+                    }
+                }
+              for (uint32_t other = 0; other < m_nPods; other++)
+                {
+                  if (other != pod)
+                    {
+                      AddRoute (up, 1, m_address.GetPodNetwork (other), podMask);
+                    }
+                }
+            }
+        }
+    }
+
+  // cores to every pod
+  for (uint32_t i = 0; i < m_coreInterfaces.size (); i++)
+    {
+      AddRoute (m_coreInterfaces[i], 0, m_address.GetPodNetwork (i % m_nPods), podMask);
+    }
+}
+
+} // namespace ns3
@@ -0,0 +1,109 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+
+#include "ns3/test.h"
+#include "ns3/simulator.h"
+#include "ns3/string.h"
+#include "ns3/packet.h"
+#include "ns3/socket.h"
+#include "ns3/udp-socket-factory.h"
+#include "ns3/inet-socket-address.h"
+#include "ns3/ipv4-global-routing.h"
+#include "ns3/ipv4-routing-helper.h"
+#include "ns3/ipv4-address-generator.h"
+#include "ns3/clos-topology-helper.h"
+
+using namespace ns3;
+
+class ClosFatTreeTest : public TestCase
+{
+public:
+  ClosFatTreeTest ();
+private:
+  virtual void DoRun (void);
+  void Received (Ptr<Socket> socket);
+  uint32_t NRoutes (Ptr<Node> node);
+  void Send (Ptr<Socket> socket, Ipv4Address to);
+  uint32_t m_received;
+};
+
+ClosFatTreeTest::ClosFatTreeTest ()
+  : TestCase ("4-ary fat-tree: node counts, route counts and host to host delivery"),
+    m_received (0)
+{
+}
+
+void
+ClosFatTreeTest::Received (Ptr<Socket> socket)
+{
+  while (socket->Recv ())
+    {
+      m_received++;
+    }
+}
+
+uint32_t
+ClosFatTreeTest::NRoutes (Ptr<Node> node)
+{
+  return Ipv4RoutingHelper::GetRouting<Ipv4GlobalRouting> (node->GetObject<Ipv4> ()->GetRoutingProtocol ())->GetNRoutes ();
+}
+
+void
+ClosFatTreeTest::Send (Ptr<Socket> socket, Ipv4Address to)
+{
+  socket->SendTo (Create<Packet> (100), 0, InetSocketAddress (to, 9));
+}
+
+void
+ClosFatTreeTest::DoRun (void)
+{
+  PointToPointHelper link;
+  link.SetDeviceAttribute ("DataRate", StringValue ("1Gbps"));
+  link.SetChannelAttribute ("Delay", StringValue ("1us"));
+  ClosTopologyHelper clos = ClosTopologyHelper::FatTree (4, link, link, link);
+
+  NS_TEST_ASSERT_MSG_EQ (clos.GetHosts ().GetN (), 16, "hosts");
+  NS_TEST_ASSERT_MSG_EQ (clos.GetLeaves ().GetN (), 8, "leaves");
+  NS_TEST_ASSERT_MSG_EQ (clos.GetSpines ().GetN (), 8, "spines");
+  NS_TEST_ASSERT_MSG_EQ (clos.GetCores ().GetN (), 4, "cores");
+  NS_TEST_ASSERT_MSG_EQ (clos.GetCoreLinks ().size (), 16, "core links");
+
+  clos.InstallStack (InternetStackHelper ());
+  clos.AssignIpv4Addresses (Ipv4FabricAddressHelper ());
+  clos.PopulateRoutes ();
+  NS_TEST_ASSERT_MSG_EQ (clos.GetHostIpv4Address (5), Ipv4Address ("10.0.0.22"), "host 5 is host 1 of leaf 0 of pod 1");
+
+  // 1 other leaf and 3 other pods over 2 spines, 2 leaves plus 3 pods over
+  // 2 cores, and one route per pod
+  NS_TEST_ASSERT_MSG_EQ (NRoutes (clos.GetHost (0)), 1, "host routes");
+  NS_TEST_ASSERT_MSG_EQ (NRoutes (clos.GetLeaves ().Get (0)), 8, "leaf routes");
+  NS_TEST_ASSERT_MSG_EQ (NRoutes (clos.GetSpines ().Get (0)), 8, "spine routes");
+  NS_TEST_ASSERT_MSG_EQ (NRoutes (clos.GetCores ().Get (0)), 4, "core routes");
+
+  uint32_t targets[] = { 1, 2, 15 };
+  for (uint32_t i = 0; i < 3; i++)
+    {
+      Ptr<Socket> sink = Socket::CreateSocket (clos.GetHost (targets[i]), UdpSocketFactory::GetTypeId ());
+      sink->Bind (InetSocketAddress (Ipv4Address::GetAny (), 9));
+      sink->SetRecvCallback (MakeCallback (&ClosFatTreeTest::Received, this));
+    }
+  Ptr<Socket> source = Socket::CreateSocket (clos.GetHost (0), UdpSocketFactory::GetTypeId ());
+  for (uint32_t i = 0; i < 3; i++)
+    {
+      Simulator::Schedule (MicroSeconds (i), &ClosFatTreeTest::Send, this, source,
+                           clos.GetHostIpv4Address (targets[i]));
+    }
+  Simulator::Run ();
+  Simulator::Destroy ();
+  NS_TEST_ASSERT_MSG_EQ (m_received, 3, "same leaf, same pod and other pod delivery");
+  Ipv4AddressGenerator::Reset ();
+}
+
+static class ClosTopologyHelperTestSuite : public TestSuite
+{
+public:
+  ClosTopologyHelperTestSuite ()
+    : TestSuite ("clos-topology-helper", UNIT)
+  {
+    AddTestCase (new ClosFatTreeTest (), TestCase::QUICK);
+  }
+} g_closTopologyHelperTestSuite;
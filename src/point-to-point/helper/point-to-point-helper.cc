@@ -263,6 +263,8 @@ PointToPointHelper::Install (Ptr<Node> a, Ptr<Node> b)
       Ptr<MpiReceiver> mpiRecB = CreateObject<MpiReceiver> ();
       mpiRecA->SetReceiveCallback (MakeCallback (&PointToPointNetDevice::Receive, devA));
       mpiRecB->SetReceiveCallback (MakeCallback (&PointToPointNetDevice::Receive, devB));
+      mpiRecA->SetTransmitReadyCallback (MakeCallback (&PointToPointNetDevice::GetTransmitReadyTime, devA));
+      mpiRecB->SetTransmitReadyCallback (MakeCallback (&PointToPointNetDevice::GetTransmitReadyTime, devB));
       devA->AggregateObject (mpiRecA);
       devB->AggregateObject (mpiRecB);
     }
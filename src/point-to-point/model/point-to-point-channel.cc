@@ -39,6 +39,12 @@ PointToPointChannel::GetTypeId (void)
                    TimeValue (Seconds (0)),
                    MakeTimeAccessor (&PointToPointChannel::m_delay),
                    MakeTimeChecker ())
+    .AddAttribute ("ArrivalBatchWindow",
+                   "If positive, deliver the packets of a wire in trains: a packet due "
+                   "within this time of the one ahead of it is received with it",
+                   TimeValue (Seconds (0)),
+                   MakeTimeAccessor (&PointToPointChannel::m_arrivalBatchWindow),
+                   MakeTimeChecker ())
     .AddTraceSource ("TxRxPointToPoint",
                      "Trace source indicating transmission of packet from the PointToPointChannel, used by the Animation interface.",
                      MakeTraceSourceAccessor (&PointToPointChannel::m_txrxPointToPoint))
@@ -53,6 +59,7 @@ PointToPointChannel::PointToPointChannel()
   :
     Channel (),
     m_delay (Seconds (0.)),
+    m_arrivalBatchWindow (Seconds (0.)),
     m_nDevices (0)
 {
   NS_LOG_FUNCTION_NOARGS ();
@@ -93,16 +100,57 @@ PointToPointChannel::TransmitStart (
 
   uint32_t wire = src == m_link[0].m_src ? 0 : 1;
 
-
-  Simulator::ScheduleWithContext (m_link[wire].m_dst->GetNode ()->GetId (),
-                                  txTime + m_delay, &PointToPointNetDevice::Receive,
-                                  m_link[wire].m_dst, p);
+  if (m_arrivalBatchWindow > Seconds (0))
+    {
+      Link &link = m_link[wire];
+      link.m_train.push_back (std::make_pair (Simulator::Now () + txTime + m_delay, p));
+      if (!link.m_trainScheduled)
+        {
+          link.m_trainScheduled = true;
+          Simulator::ScheduleWithContext (link.m_dst->GetNode ()->GetId (), txTime + m_delay,
+                                          &PointToPointChannel::DeliverTrain, this, wire);
+        }
+    }
+  else
+    {
+      Simulator::ScheduleWithContext (m_link[wire].m_dst->GetNode ()->GetId (),
+                                      txTime + m_delay, &PointToPointNetDevice::Receive,
+                                      m_link[wire].m_dst, p);
+    }
 
   // Call the tx anim callback on the net device
   m_txrxPointToPoint (p, src, m_link[wire].m_dst, txTime, txTime + m_delay);
   return true;
 }
 
+void
+PointToPointChannel::DeliverTrain (uint32_t wire)
+{
+  NS_LOG_FUNCTION (this << wire);
+  Link &link = m_link[wire];
+  Time horizon = Simulator::Now () + m_arrivalBatchWindow;
+
+  //
+  // Arrivals on a wire are in transmit order.  The train stays scheduled
+  // while delivering so a packet sent meanwhile does not jump ahead of the
+  // ones still in flight.
+  //
+  while (!link.m_train.empty () && link.m_train.front ().first <= horizon)
+    {
+      Ptr<Packet> p = link.m_train.front ().second;
+      link.m_train.pop_front ();
+      link.m_dst->Receive (p);
+    }
+  link.m_trainScheduled = false;
+  if (!link.m_train.empty ())
+    {
+      link.m_trainScheduled = true;
+      Simulator::ScheduleWithContext (link.m_dst->GetNode ()->GetId (),
+                                      link.m_train.front ().first - Simulator::Now (),
+                                      &PointToPointChannel::DeliverTrain, this, wire);
+    }
+}
+
 uint32_t 
 PointToPointChannel::GetNDevices (void) const
 {
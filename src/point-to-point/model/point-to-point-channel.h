@@ -20,11 +20,13 @@
 #define POINT_TO_POINT_CHANNEL_H
 
 #include <list>
+#include <deque>
 #include "ns3/channel.h"
 #include "ns3/ptr.h"
 #include "ns3/nstime.h"
 #include "ns3/data-rate.h"
 #include "ns3/traced-callback.h"
+#include "ns3/packet.h"
 
 namespace ns3 {
 
@@ -43,6 +45,12 @@ class Packet;
  * There are two "wires" in the channel.  The first device connected gets the
  * [0] wire to transmit on.  The second device gets the [1] wire.  There is a
  * state (IDLE, TRANSMITTING) associated with each wire.
+ *
+ * With a positive ArrivalBatchWindow packets travel in a train: every wire
+ * keeps its packets in flight in arrival order and has at most one receive
+ * event pending, which delivers every packet that has arrived by then and
+ * those due within the window.  Packets are received up to the window
+ * early, and a receive event may run after other events of its timestamp.
  */
 class PointToPointChannel : public Channel 
 {
@@ -95,6 +103,12 @@ public:
   Time GetDelayPublic (void) const;
 
 protected:
+  /*
+   * \brief Deliver the packets of a train that have arrived
+   * \param wire the wire the train runs on
+   */
+  void DeliverTrain (uint32_t wire);
+
   /*
    * \brief Get the delay associated with this channel
    * \returns Time delay
@@ -128,6 +142,7 @@ private:
   static const int N_DEVICES = 2;
 
   Time          m_delay;
+  Time          m_arrivalBatchWindow;
   int32_t       m_nDevices;
 
   /**
@@ -157,10 +172,12 @@ private:
   class Link
   {
 public:
-    Link() : m_state (INITIALIZING), m_src (0), m_dst (0) {}
+    Link() : m_state (INITIALIZING), m_src (0), m_dst (0), m_trainScheduled (false) {}
     WireState                  m_state;
     Ptr<PointToPointNetDevice> m_src;
     Ptr<PointToPointNetDevice> m_dst;
+    std::deque<std::pair<Time, Ptr<Packet> > > m_train;  // packets in flight, in trains
+    bool                       m_trainScheduled;
   };
 
   Link    m_link[N_DEVICES];
@@ -16,6 +16,7 @@
  * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
  */
 
+#include <algorithm>
 #include "ns3/log.h"
 #include "ns3/queue.h"
 #include "ns3/simulator.h"
@@ -24,6 +25,7 @@
 #include "ns3/error-model.h"
 #include "ns3/trace-source-accessor.h"
 #include "ns3/uinteger.h"
+#include "ns3/boolean.h"
 #include "ns3/pointer.h"
 #include "point-to-point-net-device.h"
 #include "point-to-point-channel.h"
@@ -33,6 +35,9 @@ NS_LOG_COMPONENT_DEFINE ("PointToPointNetDevice");
 
 namespace ns3 {
 
+// share of the link the packets keep however much fluid traffic reserves
+static const double MIN_RESIDUAL_RATE = 0.01;
+
 NS_OBJECT_ENSURE_REGISTERED (PointToPointNetDevice);
 
 TypeId 
@@ -66,6 +71,12 @@ PointToPointNetDevice::GetTypeId (void)
                    TimeValue (Seconds (0.0)),
                    MakeTimeAccessor (&PointToPointNetDevice::m_tInterframeGap),
                    MakeTimeChecker ())
+    .AddAttribute ("FastLink",
+                   "Look up serialization times and only schedule transmit complete "
+                   "events while packets are queued",
+                   BooleanValue (false),
+                   MakeBooleanAccessor (&PointToPointNetDevice::m_fastLink),
+                   MakeBooleanChecker ())
 
     //
     // Transmit queueing discipline for the device which includes its own set
@@ -146,6 +157,7 @@ PointToPointNetDevice::GetTypeId (void)
 PointToPointNetDevice::PointToPointNetDevice () 
   :
     m_txMachineState (READY),
+    m_fastLink (false),
     m_channel (0),
     m_linkUp (false),
     m_currentPkt (0)
@@ -185,6 +197,7 @@ PointToPointNetDevice::DoDispose ()
   m_channel = 0;
   m_receiveErrorModel = 0;
   m_currentPkt = 0;
+  m_txCompleteEvent.Cancel ();
   NetDevice::DoDispose ();
 }
 
@@ -208,6 +221,28 @@ PointToPointNetDevice::SetInterframeGap (Time t)
   m_tInterframeGap = t;
 }
 
+Time
+PointToPointNetDevice::GetTxTime (uint32_t size)
+{
+  if (m_txTimes.empty () || m_txTimesRate != m_bps)
+    {
+      // one entry per byte up to an Mtu sized frame with its PPP header
+      NS_LOG_LOGIC ("Build serialization table for " << m_bps);
+      uint32_t maxSize = m_mtu + 2;
+      m_txTimes.resize (maxSize + 1);
+      for (uint32_t i = 0; i <= maxSize; i++)
+        {
+          m_txTimes[i] = Seconds (m_bps.CalculateTxTime (i));
+        }
+      m_txTimesRate = m_bps;
+    }
+  if (size < m_txTimes.size ())
+    {
+      return m_txTimes[size];
+    }
+  return Seconds (m_bps.CalculateTxTime (size));
+}
+
 bool
 PointToPointNetDevice::TransmitStart (Ptr<Packet> p)
 {
@@ -224,11 +259,43 @@ PointToPointNetDevice::TransmitStart (Ptr<Packet> p)
   m_currentPkt = p;
   m_phyTxBeginTrace (m_currentPkt);
 
-  Time txTime = Seconds (m_bps.CalculateTxTime (p->GetSize ()));
-  Time txCompleteTime = txTime + m_tInterframeGap;
+  Time txTime;
+  double fluidRate = m_queue->GetFluidRate ();
+  if (fluidRate > 0.0)
+    {
+      // fluid traffic holds part of the link, the packets get the rest
+      double residual = std::max (m_bps.GetBitRate () - fluidRate, m_bps.GetBitRate () * MIN_RESIDUAL_RATE);
+      txTime = Seconds (p->GetSize () * 8.0 / residual);
+    }
+  else if (m_fastLink)
+    {
+      txTime = GetTxTime (p->GetSize ());
+    }
+  else
+    {
+      txTime = Seconds (m_bps.CalculateTxTime (p->GetSize ()));
+    }
+
+  m_txEnd = Simulator::Now () + txTime + m_tInterframeGap;
+  if (m_fastLink)
+    {
+      //
+      // Only schedule the end of the transmission when a packet waits for
+      // it, Send () schedules it once one does.
+      //
+      if (!m_queue->IsEmpty ())
+        {
+          m_txCompleteEvent = Simulator::Schedule (txTime + m_tInterframeGap,
+                                                   &PointToPointNetDevice::TransmitComplete, this);
+        }
+    }
+  else
+    {
+      Time txCompleteTime = txTime + m_tInterframeGap;
 
-  NS_LOG_LOGIC ("Schedule TransmitCompleteEvent in " << txCompleteTime.GetSeconds () << "sec");
-  Simulator::Schedule (txCompleteTime, &PointToPointNetDevice::TransmitComplete, this);
+      NS_LOG_LOGIC ("Schedule TransmitCompleteEvent in " << txCompleteTime.GetSeconds () << "sec");
+      Simulator::Schedule (txCompleteTime, &PointToPointNetDevice::TransmitComplete, this);
+    }
 
   bool result = m_channel->TransmitStart (p, this, txTime);
   if (result == false)
@@ -238,6 +305,20 @@ PointToPointNetDevice::TransmitStart (Ptr<Packet> p)
   return result;
 }
 
+Time
+PointToPointNetDevice::GetTransmitReadyTime (void) const
+{
+  //
+  // Whichever packet the queue gives up next, even one overtaking the
+  // current head, starts after the current transmission and its gap.
+  //
+  if (m_txMachineState == BUSY)
+    {
+      return Max (m_txEnd, Simulator::Now ());
+    }
+  return Simulator::Now ();
+}
+
 void
 PointToPointNetDevice::TransmitComplete (void)
 {
@@ -515,6 +596,20 @@ PointToPointNetDevice::Send (
   if (m_queue->Enqueue (packet))
     {
       //
+      // In fast link mode nothing ends an idle transmission, so either
+      // finish it now or schedule its end for the packet to wait for.
+      //
+      if (m_fastLink && m_txMachineState == BUSY && !m_txCompleteEvent.IsRunning ())
+        {
+          if (Simulator::Now () >= m_txEnd)
+            {
+              TransmitComplete ();
+              return true;
+            }
+          m_txCompleteEvent = Simulator::Schedule (m_txEnd - Simulator::Now (),
+                                                   &PointToPointNetDevice::TransmitComplete, this);
+        }
+      //
       // If the channel is ready for transition we send the packet right now
       // 
       if (m_txMachineState == READY)
@@ -20,6 +20,7 @@
 #define POINT_TO_POINT_NET_DEVICE_H
 
 #include <cstring>
+#include <vector>
 #include "ns3/address.h"
 #include "ns3/node.h"
 #include "ns3/net-device.h"
@@ -28,6 +29,7 @@
 #include "ns3/traced-callback.h"
 #include "ns3/nstime.h"
 #include "ns3/data-rate.h"
+#include "ns3/event-id.h"
 #include "ns3/ptr.h"
 #include "ns3/mac48-address.h"
 
@@ -54,6 +56,16 @@ class ErrorModel;
  * Key parameters or objects that can be specified for this device 
  * include a queue, data rate, and interframe transmission gap (the 
  * propagation delay is set in the PointToPointChannel).
+ *
+ * With the FastLink attribute set the device trades some trace timing for
+ * fewer simulator events.  Serialization times come from a table indexed
+ * by packet size and rebuilt whenever the data rate changes.  No
+ * transmit complete event is scheduled while the queue is empty; the
+ * transmitter is found idle again the next time a packet is sent, and an
+ * event is only scheduled once a packet has to wait behind the current
+ * one.  The PhyTxEnd trace of a packet that nothing queued behind
+ * therefore fires late.  Packet timing is otherwise unchanged.  To also
+ * batch arrivals see the ArrivalBatchWindow of PointToPointChannel.
  */
 class PointToPointNetDevice : public NetDevice
 {
@@ -96,6 +108,16 @@ public:
    */
   void SetInterframeGap (Time t);
 
+  /**
+   * Earliest time a packet not sent yet can start its transmission: the
+   * end of the current transmission and its interframe gap, or now when
+   * the device is idle.  Remote channels report it to the Null Message
+   * simulator as the device's lookahead beyond the link delay.
+   *
+   * @returns the time
+   */
+  Time GetTransmitReadyTime (void) const;
+
   /**
    * Attach the device to a channel.
    *
@@ -248,6 +270,13 @@ private:
    */
   void TransmitComplete (void);
 
+  /**
+   * \param size the packet size in bytes
+   * \returns the time to serialize the packet at the current data rate,
+   * looked up in the fast link table
+   */
+  Time GetTxTime (uint32_t size);
+
   void NotifyLinkUp (void);
 
   /**
@@ -278,6 +307,28 @@ private:
    */
   Time           m_tInterframeGap;
 
+  /**
+   * True in fast link mode.
+   */
+  bool           m_fastLink;
+
+  /**
+   * The time at which the current transmission and its interframe gap end.
+   */
+  Time           m_txEnd;
+
+  /**
+   * In fast link mode, the transmit complete event, only pending while
+   * packets wait in the queue.
+   */
+  EventId        m_txCompleteEvent;
+
+  /**
+   * Serialization time by packet size, valid for m_txTimesRate.
+   */
+  std::vector<Time> m_txTimes;
+  DataRate       m_txTimesRate;
+
   /**
    * The PointToPointChannel to which this PointToPointNetDevice has been
    * attached.
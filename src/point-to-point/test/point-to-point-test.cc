@@ -1,6 +1,9 @@
 #include "ns3/test.h"
 #include "ns3/drop-tail-queue.h"
 #include "ns3/simulator.h"
+#include "ns3/boolean.h"
+#include "ns3/nstime.h"
+#include "ns3/data-rate.h"
 #include "ns3/point-to-point-net-device.h"
 #include "ns3/point-to-point-channel.h"
 
@@ -55,6 +58,104 @@ PointToPointTest::DoRun (void)
 
   Simulator::Destroy ();
 }
+
+class PointToPointFastLinkTest : public TestCase
+{
+public:
+  PointToPointFastLinkTest ();
+
+  virtual void DoRun (void);
+
+private:
+  void SendPackets (Ptr<PointToPointNetDevice> device, uint32_t n);
+  void Received (Ptr<const Packet> p);
+  std::vector<Time> Run (bool fastLink, Time batchWindow);
+
+  std::vector<Time> m_arrivals;
+};
+
+PointToPointFastLinkTest::PointToPointFastLinkTest ()
+  : TestCase ("PointToPoint fast link mode and arrival trains")
+{
+}
+
+void
+PointToPointFastLinkTest::SendPackets (Ptr<PointToPointNetDevice> device, uint32_t n)
+{
+  for (uint32_t i = 0; i < n; i++)
+    {
+      device->Send (Create<Packet> (1000 + 100 * i), device->GetBroadcast (), 0x800);
+    }
+}
+
+void
+PointToPointFastLinkTest::Received (Ptr<const Packet> p)
+{
+  m_arrivals.push_back (Simulator::Now ());
+}
+
+std::vector<Time>
+PointToPointFastLinkTest::Run (bool fastLink, Time batchWindow)
+{
+  Ptr<Node> a = CreateObject<Node> ();
+  Ptr<Node> b = CreateObject<Node> ();
+  Ptr<PointToPointNetDevice> devA = CreateObject<PointToPointNetDevice> ();
+  Ptr<PointToPointNetDevice> devB = CreateObject<PointToPointNetDevice> ();
+  Ptr<PointToPointChannel> channel = CreateObject<PointToPointChannel> ();
+  channel->SetAttribute ("Delay", TimeValue (MicroSeconds (5)));
+  channel->SetAttribute ("ArrivalBatchWindow", TimeValue (batchWindow));
+
+  devA->Attach (channel);
+  devA->SetAddress (Mac48Address::Allocate ());
+  devA->SetQueue (CreateObject<DropTailQueue> ());
+  devA->SetDataRate (DataRate ("40Gbps"));
+  devA->SetAttribute ("FastLink", BooleanValue (fastLink));
+  devB->Attach (channel);
+  devB->SetAddress (Mac48Address::Allocate ());
+  devB->SetQueue (CreateObject<DropTailQueue> ());
+  devB->TraceConnectWithoutContext ("PhyRxEnd", MakeCallback (&PointToPointFastLinkTest::Received, this));
+
+  a->AddDevice (devA);
+  b->AddDevice (devB);
+
+  // a back to back burst, lone packets on an idle link, and a packet sent
+  // while the previous one is still on the wire
+  Simulator::Schedule (Seconds (1.0), &PointToPointFastLinkTest::SendPackets, this, devA, 5);
+  Simulator::Schedule (Seconds (2.0), &PointToPointFastLinkTest::SendPackets, this, devA, 1);
+  Simulator::Schedule (Seconds (3.0), &PointToPointFastLinkTest::SendPackets, this, devA, 1);
+  Simulator::Schedule (Seconds (3.0) + NanoSeconds (100), &PointToPointFastLinkTest::SendPackets, this, devA, 1);
+
+  m_arrivals.clear ();
+  Simulator::Run ();
+  Simulator::Destroy ();
+  return m_arrivals;
+}
+
+void
+PointToPointFastLinkTest::DoRun (void)
+{
+  std::vector<Time> slow = Run (false, Seconds (0));
+  std::vector<Time> fast = Run (true, Seconds (0));
+  NS_TEST_ASSERT_MSG_EQ (slow.size (), 8, "every packet arrives");
+  NS_TEST_ASSERT_MSG_EQ (fast.size (), slow.size (), "every packet arrives in fast link mode");
+  for (uint32_t i = 0; i < slow.size () && i < fast.size (); i++)
+    {
+      NS_TEST_ASSERT_MSG_EQ (fast[i], slow[i], "arrival " << i << " moved");
+    }
+
+  // a window wider than the burst delivers it with its first packet
+  std::vector<Time> batched = Run (false, MicroSeconds (10));
+  NS_TEST_ASSERT_MSG_EQ (batched.size (), 8, "every packet arrives in batches");
+  NS_TEST_ASSERT_MSG_EQ (batched[4], slow[0], "burst delivered in one train");
+  NS_TEST_ASSERT_MSG_EQ (batched[5], slow[5], "lone packet on time");
+  std::vector<Time> fastBatched = Run (true, MicroSeconds (10));
+  NS_TEST_ASSERT_MSG_EQ (fastBatched.size (), batched.size (), "every packet arrives in fast link batches");
+  for (uint32_t i = 0; i < batched.size () && i < fastBatched.size (); i++)
+    {
+      NS_TEST_ASSERT_MSG_EQ (fastBatched[i], batched[i], "batched arrival " << i << " moved");
+    }
+}
+
 //-----------------------------------------------------------------------------
 class PointToPointTestSuite : public TestSuite
 {
@@ -66,6 +167,7 @@ PointToPointTestSuite::PointToPointTestSuite ()
   : TestSuite ("devices-point-to-point", UNIT)
 {
   AddTestCase (new PointToPointTest, TestCase::QUICK);
+  AddTestCase (new PointToPointFastLinkTest, TestCase::QUICK);
 }
 
 static PointToPointTestSuite g_pointToPointTestSuite;